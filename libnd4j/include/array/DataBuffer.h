@@ -45,6 +45,10 @@ class ND4J_EXPORT DataBuffer {
         bool _isOwnerSpecial;
         std::atomic<int> _deviceId;
 
+        const Nd4jLong _uniqueId = nextUniqueId();
+        mutable std::atomic<Nd4jLong> _generation{0};
+        std::atomic<bool> _readOnlyPrimary{false};
+
     #ifdef __CUDABLAS__
         mutable std::atomic<Nd4jLong> _counter;
         mutable std::atomic<Nd4jLong> _writePrimary;
@@ -63,6 +67,8 @@ class ND4J_EXPORT DataBuffer {
         void setSpecial(void* special, const bool isOwnerSpecial);
         void copyBufferFromHost(const void* hostBuffer, size_t sizeToCopyinBytes = 0, const Nd4jLong offsetThis = 0, const Nd4jLong offsetHostBuffer = 0);
 
+        static Nd4jLong nextUniqueId();
+
 
     public:
 
@@ -107,6 +113,21 @@ class ND4J_EXPORT DataBuffer {
         bool isPrimaryActual() const;
         bool isSpecialActual() const;
 
+        /**
+         * Process-wide id of this buffer (never reused) and the number of writes registered against it so far.
+         * Together they identify the buffer contents, so caches may key derived data on them
+         */
+        Nd4jLong uniqueId() const;
+        Nd4jLong generation() const;
+
+        /**
+         * Marks primary buffer as external read-only memory, i.e. page of read-only file mapping.
+         * makePrimaryWritable() replaces such buffer with own copy, so it must be called before anything writes into it
+         */
+        void setPrimaryReadOnly();
+        bool isPrimaryReadOnly() const;
+        void makePrimaryWritable();
+
         void expand(const uint64_t size);
 
         int deviceId() const;
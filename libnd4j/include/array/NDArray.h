@@ -1517,7 +1517,7 @@ FORCEINLINE R NDArray::templatedGet(void const* buffer, Nd4jLong index) const {
 
 //////////////////////////////////////////////////////////////////////////
 void NDArray::setShapeInfo(Nd4jLong *shapeInfo) {
-    auto buffer = ConstantShapeHelper::getInstance().bufferForShapeInfo(shapeInfo);
+    auto &buffer = ConstantShapeHelper::getInstance().bufferForShapeInfo(shapeInfo);
     _shapeInfo = buffer.primary();
     _shapeInfoD = buffer.special();
 
@@ -1536,7 +1536,7 @@ void NDArray::setShapeInfo(Nd4jLong *shapeInfo) {
 
 //////////////////////////////////////////////////////////////////////////
 void NDArray::setShapeInfo(Nd4jLong *shapeInfo, const sd::DataType dtype) {
-    auto buffer = ConstantShapeHelper::getInstance().bufferForShapeInfo(shapeInfo);
+    auto &buffer = ConstantShapeHelper::getInstance().bufferForShapeInfo(shapeInfo);
     _shapeInfo = buffer.primary();
     _shapeInfoD = buffer.special();
 
@@ -39,6 +39,8 @@ namespace sd {
             _primaryBuffer = newBuffer;
             _lenInBytes = size;
             _isOwnerPrimary = true;
+            _readOnlyPrimary = false;
+            writePrimary();
         }
     }
 
@@ -65,8 +67,11 @@ void DataBuffer::copyBufferFrom(const DataBuffer& other, size_t sizeToCopyinByte
     if(sizeToCopyinBytes == 0)
         return;
 
-    if(other._primaryBuffer != nullptr)
+    if(other._primaryBuffer != nullptr) {
+        makePrimaryWritable();
         std::memcpy(static_cast<int8_t*>(_primaryBuffer) + offsetThis * DataTypeUtils::sizeOfElement(_dataType), static_cast<const int8_t*>(other._primaryBuffer) + offsetOther * DataTypeUtils::sizeOfElement(other._dataType), sizeToCopyinBytes);
+        writePrimary();
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////
@@ -77,8 +82,11 @@ void DataBuffer::copyBufferFromHost(const void* hostBuffer, size_t sizeToCopyinB
     if(sizeToCopyinBytes == 0)
         return;
 
-    if(hostBuffer != nullptr)
+    if(hostBuffer != nullptr) {
+        makePrimaryWritable();
         std::memcpy(static_cast<int8_t*>(_primaryBuffer) + offsetThis * DataTypeUtils::sizeOfElement(_dataType), static_cast<const int8_t*>(hostBuffer) + offsetHostBuffer * DataTypeUtils::sizeOfElement(_dataType), sizeToCopyinBytes);
+        writePrimary();
+    }
 }
 
 
@@ -95,7 +103,9 @@ void DataBuffer::setSpecial(void* special, const bool isOwnerSpecail) {
 ////////////////////////////////////////////////////////////////////////
 void DataBuffer::setToZeroBuffers(const bool both) {
 
+    makePrimaryWritable();
     memset(primary(), 0, getLenInBytes());
+    writePrimary();
 }
 
 ////////////////////////////////////////////////////////////////////////
@@ -123,14 +133,15 @@ void DataBuffer::memcpy(const DataBuffer &dst, const DataBuffer &src) {
     if (src._lenInBytes > dst._lenInBytes)
         throw std::runtime_error("DataBuffer::memcpy: Source data buffer is larger than destination");
 
+    const_cast<DataBuffer&>(dst).makePrimaryWritable();
     std::memcpy(dst._primaryBuffer, src._primaryBuffer, src._lenInBytes);
-    dst.readPrimary();
+    dst.writePrimary();
 }
 
 
 ////////////////////////////////////////////////////////////////////////
-void DataBuffer::writePrimary() const    { }
-void DataBuffer::writeSpecial() const    { }
+void DataBuffer::writePrimary() const    { _generation.fetch_add(1, std::memory_order_relaxed); }
+void DataBuffer::writeSpecial() const    { _generation.fetch_add(1, std::memory_order_relaxed); }
 void DataBuffer::readPrimary()  const    { }
 void DataBuffer::readSpecial()  const    { }
 bool DataBuffer::isPrimaryActual() const { return true;}
@@ -58,7 +58,7 @@ Nd4jLong const* NDArray::platformShapeInfo() const { return shapeInfo(); }
 
 void NDArray::syncToDevice() const          { }
 void NDArray::syncToHost() const            { }
-void NDArray::tickWriteHost() const         { }
+void NDArray::tickWriteHost() const         { if (_buffer != nullptr) { _buffer->makePrimaryWritable(); _buffer->writePrimary(); } }
 void NDArray::tickWriteDevice() const       { }
 void NDArray::tickReadHost() const          { }
 void NDArray::tickReadDevice() const        { }
@@ -208,16 +208,26 @@ void NDArray::synchronize(const char* msg) const {
 }
 
 void NDArray::prepareSpecialUse(const std::vector<const NDArray*>& writeList, const std::vector<const NDArray*>& readList, bool synchronizeWritables) {
-    // no-op
+    // arrays backed by read-only memory get own copies before anything is written into them
+    for (const auto& a : writeList)
+        if (a != nullptr && a->_buffer != nullptr)
+            a->_buffer->makePrimaryWritable();
 }
 void NDArray::registerSpecialUse(const std::vector<const NDArray*>& writeList, const std::vector<const NDArray*>& readList) {
-    // no-op
+    // host-only backend: just account the writes, so buffer generations stay meaningful
+    for (const auto& a : writeList)
+        if (a != nullptr)
+            a->tickWriteHost();
 }
 void NDArray::preparePrimaryUse(const std::vector<const NDArray*>& writeList, const std::vector<const NDArray*>& readList, bool synchronizeWritables) {
-    // no-op
+    for (const auto& a : writeList)
+        if (a != nullptr && a->_buffer != nullptr)
+            a->_buffer->makePrimaryWritable();
 }
 void NDArray::registerPrimaryUse(const std::vector<const NDArray*>& writeList, const std::vector<const NDArray*>& readList) {
-    // no-op
+    for (const auto& a : writeList)
+        if (a != nullptr)
+            a->tickWriteHost();
 }
 
 void NDArray::syncShape() const {
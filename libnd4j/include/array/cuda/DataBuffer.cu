@@ -282,8 +282,8 @@ void DataBuffer::migrate() {
 }
 
 ////////////////////////////////////////////////////////////////////////
-void DataBuffer::writePrimary() const    {_writePrimary = ++_counter; }
-void DataBuffer::writeSpecial() const    { _writeSpecial = ++_counter; }
+void DataBuffer::writePrimary() const    { _writePrimary = ++_counter; _generation.fetch_add(1, std::memory_order_relaxed); }
+void DataBuffer::writeSpecial() const    { _writeSpecial = ++_counter; _generation.fetch_add(1, std::memory_order_relaxed); }
 void DataBuffer::readPrimary()  const    { _readPrimary  = ++_counter; }
 void DataBuffer::readSpecial()  const    { _readSpecial  = ++_counter; }
 bool DataBuffer::isPrimaryActual() const { return (_writePrimary.load() > _writeSpecial.load() || _readPrimary.load() > _writeSpecial.load()); }
@@ -25,6 +25,8 @@
 #include <execution/AffinityManager.h>
 #include <memory/MemoryCounter.h>
 #include <exceptions/allocation_exception.h>
+#include <cstring>
+#include <mutex>
 
 namespace sd {
     ///// IMLEMENTATION OF COMMON METHODS /////
@@ -155,11 +157,13 @@ namespace sd {
         _workspace      = other._workspace;
         _isOwnerPrimary = other._isOwnerPrimary;
         _isOwnerSpecial = other._isOwnerSpecial;
+        _readOnlyPrimary.store(other._readOnlyPrimary.load());
         _deviceId.store(other._deviceId);
 
         copyCounters(other);
 
         other._primaryBuffer = other._specialBuffer = nullptr;
+        other._readOnlyPrimary = false;
         other.setAllocFlags(false, false);
         other._lenInBytes = 0;
     }
@@ -173,6 +177,12 @@ namespace sd {
 
         deleteBuffers();
 
+        // read-only memory isn't released by deleteBuffers(), but can't be written into either
+        if (_readOnlyPrimary.load()) {
+            _primaryBuffer = nullptr;
+            _readOnlyPrimary = false;
+        }
+
         _lenInBytes    = other._lenInBytes;
         _dataType      = other._dataType;
         _workspace     = other._workspace;
@@ -199,16 +209,68 @@ namespace sd {
         _workspace      = other._workspace;
         _isOwnerPrimary = other._isOwnerPrimary;
         _isOwnerSpecial = other._isOwnerSpecial;
+        _readOnlyPrimary.store(other._readOnlyPrimary.load());
 
         copyCounters(other);
+        _generation.fetch_add(1, std::memory_order_relaxed);
 
         other._primaryBuffer = other._specialBuffer = nullptr;
+        other._readOnlyPrimary = false;
         other.setAllocFlags(false, false);
         other._lenInBytes = 0;
 
         return *this;
     }
 
+////////////////////////////////////////////////////////////////////////
+    Nd4jLong DataBuffer::nextUniqueId() {
+        static std::atomic<Nd4jLong> counter(0);
+        return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+////////////////////////////////////////////////////////////////////////
+    Nd4jLong DataBuffer::uniqueId() const {
+        return _uniqueId;
+    }
+
+////////////////////////////////////////////////////////////////////////
+    Nd4jLong DataBuffer::generation() const {
+        return _generation.load(std::memory_order_relaxed);
+    }
+
+////////////////////////////////////////////////////////////////////////
+    void DataBuffer::setPrimaryReadOnly() {
+        _readOnlyPrimary = true;
+    }
+
+////////////////////////////////////////////////////////////////////////
+    bool DataBuffer::isPrimaryReadOnly() const {
+        return _readOnlyPrimary.load();
+    }
+
+////////////////////////////////////////////////////////////////////////
+    void DataBuffer::makePrimaryWritable() {
+        if (!_readOnlyPrimary.load())
+            return;
+
+        // copies are one-off, so single lock shared by all buffers is enough
+        static std::mutex mutex;
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (!_readOnlyPrimary.load())
+            return;
+
+        auto readOnly = _primaryBuffer;
+        _primaryBuffer = nullptr;
+        allocatePrimary();
+
+        if (_primaryBuffer != nullptr)
+            std::memcpy(_primaryBuffer, readOnly, getLenInBytes());
+
+        _readOnlyPrimary = false;
+        _generation.fetch_add(1, std::memory_order_relaxed);
+    }
+
 ////////////////////////////////////////////////////////////////////////
     void* DataBuffer::primary() {
         return _primaryBuffer;
@@ -308,7 +370,9 @@ namespace sd {
 
         _primaryBuffer = buffer;
         _isOwnerPrimary = false;
+        _readOnlyPrimary = false;
         _lenInBytes = length * DataTypeUtils::sizeOf(_dataType);
+        _generation.fetch_add(1, std::memory_order_relaxed);
     }
 
     void DataBuffer::setSpecialBuffer(void *buffer, size_t length) {
@@ -318,6 +382,7 @@ namespace sd {
 
         this->setSpecial(buffer, false);
         _lenInBytes = length * DataTypeUtils::sizeOf(_dataType);
+        _generation.fetch_add(1, std::memory_order_relaxed);
     }
 
     void DataBuffer::setDataType(DataType dataType) {
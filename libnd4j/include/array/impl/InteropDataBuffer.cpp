@@ -124,6 +124,8 @@ namespace sd {
         for (const auto &v:writeList) {
             if (v == nullptr)
                 continue;
+
+            v->getDataBuffer()->writePrimary();
         }
     }
 
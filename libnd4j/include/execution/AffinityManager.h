@@ -40,6 +40,25 @@ namespace sd {
         static int numberOfDevices();
         static void setCurrentDevice(int deviceId);
         static void setCurrentNativeDevice(int deviceId);
+
+        /**
+         * These methods control NUMA placement of the calling thread. Parallel work submitted from a thread goes to workers
+         * of its current node, and memory first touched by a thread lands on that node. Without NUMA-awareness enabled
+         * in Environment everything is reported as node 0.
+         */
+        static int currentNumaNode();
+
+        /**
+         * This method assigns NUMA node to the calling thread, -1 resets assignment
+         * @return previously assigned node, or -1
+         */
+        static int setCurrentNumaNode(int node);
+
+        /**
+         * This method pins calling thread to CPUs of the given NUMA node, and makes that node current for the thread
+         * @return false if OS refused to change affinity
+         */
+        static bool bindToNumaNode(int node);
     };
 }
 
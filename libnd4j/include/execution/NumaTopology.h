@@ -0,0 +1,64 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// @author raver119@gmail.com
+//
+
+#ifndef SD_NUMATOPOLOGY_H
+#define SD_NUMATOPOLOGY_H
+
+#include <system/dll.h>
+#include <vector>
+#include <string>
+
+namespace sd {
+    /**
+     * This class holds NUMA layout of the host: which logical CPUs belong to which node.
+     * On Linux it's read from /sys/devices/system/node, everywhere else (or if sysfs isn't available)
+     * whole machine is reported as single node.
+     */
+    class ND4J_EXPORT NumaTopology {
+    private:
+        std::vector<std::vector<int>> _nodes;
+        std::vector<int> _cpuToNode;
+
+        NumaTopology();
+
+        void build(const std::vector<std::vector<int>> &nodes);
+    public:
+        ~NumaTopology() = default;
+
+        static NumaTopology& getInstance();
+
+        /**
+         * This method parses kernel cpulist format, i.e. "0-3,8,10-11"
+         * @return false if string is malformed
+         */
+        static bool parseCpuList(const std::string &list, std::vector<int> &cpus);
+
+        int numberOfNodes() const;
+
+        const std::vector<int>& cpusOfNode(int node) const;
+
+        /**
+         * This method returns NUMA node of the given logical CPU, or 0 if CPU is unknown
+         */
+        int nodeOfCpu(int cpu) const;
+    };
+}
+
+#endif //SD_NUMATOPOLOGY_H
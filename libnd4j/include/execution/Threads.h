@@ -94,6 +94,26 @@ namespace samediff {
         static Span3 build(int loop, uint64_t thread_id, uint64_t num_threads, int64_t start_x, int64_t stop_x, int64_t inc_x, int64_t start_y, int64_t stop_y, int64_t inc_y, int64_t start_z, int64_t stop_z, int64_t inc_z);
     };
 
+    /**
+     * This class caps number of threads parallel_* calls issued by current thread can use, while it's in scope.
+     * Used when several ops are executed concurrently, so they share cores instead of each one using all of them.
+     */
+    class ND4J_EXPORT ThreadsLimit {
+    private:
+        int _previous;
+    public:
+        explicit ThreadsLimit(int maxThreads);
+        ~ThreadsLimit();
+
+        ThreadsLimit(const ThreadsLimit&) = delete;
+        ThreadsLimit& operator=(const ThreadsLimit&) = delete;
+
+        /**
+         * This method returns limit set for current thread, or 0 if there's none
+         */
+        static int current();
+    };
+
     class ND4J_EXPORT Threads {
     public:
         /**
@@ -0,0 +1,160 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// @author raver119@gmail.com
+//
+
+#ifndef SAMEDIFF_WORKSTEALINGPOOL_H
+#define SAMEDIFF_WORKSTEALINGPOOL_H
+
+#include <system/dll.h>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+
+namespace samediff {
+    class WorkStealingPool;
+
+    /**
+     * This class represents a batch of tasks submitted together, i.e. all chunks of one Threads::parallel_* call.
+     * Implementations define what task with a given index does.
+     */
+    class ND4J_EXPORT TaskGroup {
+    private:
+        friend class WorkStealingPool;
+
+        std::atomic<uint32_t> _pending;
+        std::mutex _mutex;
+        std::condition_variable _condition;
+        std::exception_ptr _exception;
+
+    public:
+        TaskGroup();
+        virtual ~TaskGroup() = default;
+
+        TaskGroup(const TaskGroup&) = delete;
+        TaskGroup& operator=(const TaskGroup&) = delete;
+
+        virtual void run(uint32_t index) = 0;
+    };
+
+    /**
+     * Lambda-backed TaskGroup
+     */
+    template <typename F>
+    class LambdaTaskGroup : public TaskGroup {
+    private:
+        F _function;
+    public:
+        explicit LambdaTaskGroup(F function) : _function(function) { }
+
+        void run(uint32_t index) override {
+            _function(index);
+        }
+    };
+
+    /**
+     * Work-stealing scheduler used by Threads::parallel_* methods.
+     *
+     * Every worker has its own deque: tasks submitted from a worker (nested parallelism) go to its own deque and are
+     * popped LIFO, idle workers steal from other deques FIFO. Tasks submitted from outside are spread over all deques.
+     * Submitting thread always participates: it runs one task itself, and then keeps executing queued tasks until
+     * its own group is finished. So concurrent parallel_* calls share cores, and never block waiting for free threads.
+     *
+     * If NUMA awareness is enabled in Environment, workers are split into per-node groups pinned to CPUs of their node.
+     * Tasks are submitted to the group of the caller's current node, and thieves look for work on their own node first.
+     */
+    class ND4J_EXPORT WorkStealingPool {
+    public:
+        struct Task {
+            TaskGroup *group;
+            uint32_t index;
+        };
+
+    private:
+        struct Worker {
+            std::mutex mutex;
+            std::deque<Task> deque;
+            int node = 0;
+        };
+
+        std::vector<Worker*> _workers;
+        std::vector<std::thread> _threads;
+
+        // worker ids grouped by NUMA node, single group if NUMA awareness is off
+        std::vector<std::vector<int>> _nodeWorkers;
+        bool _pinned = false;
+
+        // number of tasks sitting in deques, used by idle workers to decide if they should sleep
+        std::atomic<int64_t> _queued;
+        std::atomic<int> _sleeping;
+        std::atomic<uint32_t> _nextWorker;
+
+        std::mutex _sleepMutex;
+        std::condition_variable _sleepCondition;
+
+        WorkStealingPool();
+        ~WorkStealingPool() = default;
+
+        void workerLoop(int workerId);
+
+        // pops task from own deque if any, or steals one from other workers, same node first
+        bool take(int workerId, int node, Task &task);
+
+        bool popBack(int workerId, Task &task);
+        bool popFront(int workerId, Task &task);
+
+        int currentNode(int workerId);
+
+        void runTask(const Task &task);
+
+        void wakeUp(int64_t numTasks);
+
+    public:
+        static WorkStealingPool& getInstance();
+
+        /**
+         * This method returns number of background worker threads
+         */
+        int numberOfWorkers() const;
+
+        /**
+         * This method returns number of worker groups, one per NUMA node if NUMA awareness is enabled
+         */
+        int numberOfNodes() const;
+
+        /**
+         * This method returns number of workers in a given group
+         */
+        int numberOfWorkers(int node) const;
+
+        /**
+         * This method executes tasks [0..numTasks) of the given group, and returns once all of them are finished.
+         * Task numTasks - 1 is executed by the calling thread. First exception thrown by any task is rethrown here
+         *
+         * @param group
+         * @param numTasks
+         */
+        void execute(TaskGroup &group, uint32_t numTasks);
+    };
+}
+
+#endif //SAMEDIFF_WORKSTEALINGPOOL_H
@@ -0,0 +1,76 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// @author raver119@gmail.com
+//
+
+#include <execution/AffinityManager.h>
+#include <execution/NumaTopology.h>
+#include <system/Environment.h>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// NUMA node explicitly assigned to the current thread, -1 means "wherever OS runs it now"
+static thread_local int _currentNumaNode = -1;
+
+namespace sd {
+    int AffinityManager::currentNumaNode() {
+        if (!Environment::getInstance().isNumaAware())
+            return 0;
+
+        if (_currentNumaNode >= 0)
+            return _currentNumaNode;
+
+#ifdef __linux__
+        auto cpu = sched_getcpu();
+        if (cpu >= 0)
+            return NumaTopology::getInstance().nodeOfCpu(cpu);
+#endif
+
+        return 0;
+    }
+
+    int AffinityManager::setCurrentNumaNode(int node) {
+        if (node >= NumaTopology::getInstance().numberOfNodes())
+            throw std::runtime_error("AffinityManager: NUMA node index is out of range");
+
+        auto previous = _currentNumaNode;
+        _currentNumaNode = node < 0 ? -1 : node;
+        return previous;
+    }
+
+    bool AffinityManager::bindToNumaNode(int node) {
+        const auto &cpus = NumaTopology::getInstance().cpusOfNode(node);
+        _currentNumaNode = node;
+
+#ifdef __linux__
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        for (auto cpu: cpus)
+            if (cpu < CPU_SETSIZE)
+                CPU_SET(cpu, &cpuset);
+
+        return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset) == 0;
+#else
+        return true;
+#endif
+    }
+}
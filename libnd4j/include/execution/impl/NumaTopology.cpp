@@ -0,0 +1,133 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// @author raver119@gmail.com
+//
+
+#include <execution/NumaTopology.h>
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <stdexcept>
+
+namespace sd {
+
+    NumaTopology::NumaTopology() {
+        std::vector<std::vector<int>> nodes;
+
+#ifdef __linux__
+        // node ids are usually dense, but there might be holes, i.e. on machines with memory-only nodes
+        for (int n = 0, missing = 0; missing < 8; n++) {
+            std::ifstream file("/sys/devices/system/node/node" + std::to_string(n) + "/cpulist");
+            if (!file.good()) {
+                missing++;
+                continue;
+            }
+
+            std::string list;
+            std::getline(file, list);
+
+            std::vector<int> cpus;
+            if (parseCpuList(list, cpus) && !cpus.empty())
+                nodes.emplace_back(cpus);
+        }
+#endif
+
+        // fallback: single node with all CPUs
+        if (nodes.empty()) {
+            std::vector<int> cpus;
+            for (int e = 0; e < (int) std::max<unsigned>(1, std::thread::hardware_concurrency()); e++)
+                cpus.emplace_back(e);
+
+            nodes.emplace_back(cpus);
+        }
+
+        build(nodes);
+    }
+
+    void NumaTopology::build(const std::vector<std::vector<int>> &nodes) {
+        _nodes = nodes;
+
+        int maxCpu = 0;
+        for (const auto &node: _nodes)
+            for (auto cpu: node)
+                maxCpu = std::max(maxCpu, cpu);
+
+        _cpuToNode.assign(maxCpu + 1, 0);
+        for (int n = 0; n < (int) _nodes.size(); n++)
+            for (auto cpu: _nodes[n])
+                _cpuToNode[cpu] = n;
+    }
+
+    NumaTopology& NumaTopology::getInstance() {
+        static NumaTopology instance;
+        return instance;
+    }
+
+    bool NumaTopology::parseCpuList(const std::string &list, std::vector<int> &cpus) {
+        std::stringstream stream(list);
+        std::string range;
+
+        while (std::getline(stream, range, ',')) {
+            // trailing newline or spaces
+            range.erase(std::remove_if(range.begin(), range.end(), ::isspace), range.end());
+            if (range.empty())
+                continue;
+
+            try {
+                auto dash = range.find('-');
+                if (dash == std::string::npos) {
+                    cpus.emplace_back(std::stoi(range));
+                } else {
+                    auto first = std::stoi(range.substr(0, dash));
+                    auto last = std::stoi(range.substr(dash + 1));
+                    if (first < 0 || last < first)
+                        return false;
+
+                    for (int e = first; e <= last; e++)
+                        cpus.emplace_back(e);
+                }
+            } catch (std::invalid_argument &e) {
+                return false;
+            } catch (std::out_of_range &e) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    int NumaTopology::numberOfNodes() const {
+        return (int) _nodes.size();
+    }
+
+    const std::vector<int>& NumaTopology::cpusOfNode(int node) const {
+        if (node < 0 || node >= (int) _nodes.size())
+            throw std::runtime_error("NumaTopology: node index is out of range");
+
+        return _nodes[node];
+    }
+
+    int NumaTopology::nodeOfCpu(int cpu) const {
+        if (cpu < 0 || cpu >= (int) _cpuToNode.size())
+            return 0;
+
+        return _cpuToNode[cpu];
+    }
+}
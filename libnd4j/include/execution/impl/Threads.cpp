@@ -18,7 +18,7 @@
 // @author raver119@gmail.com
 //
 #include <execution/Threads.h>
-#include <execution/ThreadPool.h>
+#include <execution/WorkStealingPool.h>
 #include <vector>
 #include <thread>
 #include <helpers/logger.h>
@@ -28,6 +28,37 @@
 
 namespace samediff {
 
+    // this function executes tasks [0..numTasks) via work-stealing pool, calling thread runs its share as well
+    template <typename F>
+    static void execute_(uint32_t numTasks, F function) {
+        LambdaTaskGroup<F> group(function);
+        WorkStealingPool::getInstance().execute(group, numTasks);
+    }
+
+    // 0 means no limit
+    static thread_local int _threadsLimit = 0;
+
+    ThreadsLimit::ThreadsLimit(int maxThreads) {
+        _previous = _threadsLimit;
+
+        // nested limits can only make things tighter
+        auto limit = sd::math::nd4j_max<int>(1, maxThreads);
+        _threadsLimit = _previous > 0 ? sd::math::nd4j_min<int>(_previous, limit) : limit;
+    }
+
+    ThreadsLimit::~ThreadsLimit() {
+        _threadsLimit = _previous;
+    }
+
+    int ThreadsLimit::current() {
+        return _threadsLimit;
+    }
+
+    template <typename T>
+    static FORCEINLINE T limited_(T numThreads) {
+        return _threadsLimit > 0 && numThreads > (T) _threadsLimit ? (T) _threadsLimit : numThreads;
+    }
+
     int ThreadsHelper::numberOfThreads(int maxThreads, uint64_t numberOfElements) {
         // let's see how many threads we actually need first
         auto optimalThreads = sd::math::nd4j_max<uint64_t>(1, numberOfElements / 1024);
@@ -343,6 +374,8 @@ namespace samediff {
         if (start > stop)
             throw std::runtime_error("Threads::parallel_for got start > stop");
 
+        numThreads = limited_(numThreads);
+
         auto delta = (stop - start);
 
         if (numThreads > delta)
@@ -357,35 +390,21 @@ namespace samediff {
             return 1;
         }
 
-        auto ticket = ThreadPool::getInstance().tryAcquire(numThreads);
-        if (ticket != nullptr) {
-            // if we got our threads - we'll run our jobs here
-            auto span = delta / numThreads;
-
-            for (uint32_t e = 0; e < numThreads; e++) {
-                auto start_ = span * e + start;
-                auto stop_  = start_ + span;
+        auto span = delta / numThreads;
 
-                // last thread will process tail
-                if (e == numThreads - 1)
-                    stop_ = stop;
-
-                // putting the task into the queue for a given thread
-                ticket->enqueue(e, numThreads, function, start_, stop_, increment);
-            }
+        // tasks are always accepted: if all workers are busy, calling thread will process them itself
+        execute_(numThreads, [&](uint32_t e) {
+            auto start_ = span * e + start;
+            auto stop_  = start_ + span;
 
-            // block and wait till all threads finished the job
-            ticket->waitAndRelease();
+            // last thread will process tail
+            if (e == numThreads - 1)
+                stop_ = stop;
 
-            // we tell that parallelism request succeeded
-            return numThreads;
-        } else {
-            // if there were no threads available - we'll execute function right within current thread
-            function(0, start, stop, increment);
+            function(e, start_, stop_, increment);
+        });
 
-            // we tell that parallelism request declined
-            return 1;
-        }
+        return numThreads;
     }
 
     int Threads::parallel_for(FUNC_1D function, int64_t start, int64_t stop, int64_t increment, uint32_t numThreads) {
@@ -414,6 +433,8 @@ namespace samediff {
         if (startY > stopY)
             throw std::runtime_error("Threads::parallel_for got startY > stopY");
 
+        numThreads = limited_(numThreads);
+
         // number of elements per loop
         auto delta_x = (stopX - startX);
         auto delta_y = (stopY - startY);
@@ -449,27 +470,14 @@ namespace samediff {
             // but we still mimic multithreaded execution
             return numThreads;
         } else {
-            auto ticket = ThreadPool::getInstance().tryAcquire(numThreads);
-            if (ticket != nullptr) {
-
-                for (int e = 0; e < numThreads; e++) {
-                    auto threadId = numThreads - e - 1;
-                    auto span = Span2::build(splitLoop, threadId, numThreads, startX, stopX, incX, startY, stopY, incY);
+            execute_(numThreads, [&](uint32_t e) {
+                auto threadId = numThreads - e - 1;
+                auto span = Span2::build(splitLoop, threadId, numThreads, startX, stopX, incX, startY, stopY, incY);
 
-                    ticket->enqueue(e, numThreads, function, span.startX(), span.stopX(), span.incX(), span.startY(), span.stopY(), span.incY());
-                }
-
-                // block until all threads finish their job
-                ticket->waitAndRelease();
-
-                return numThreads;
-            } else {
-                // if there were no threads available - we'll execute function right within current thread
-                function(0, startX, stopX, incX, startY, stopY, incY);
+                function(e, span.startX(), span.stopX(), span.incX(), span.startY(), span.stopY(), span.incY());
+            });
 
-                // we tell that parallelism request declined
-                return 1;
-            }
+            return numThreads;
         };
     }
 
@@ -484,6 +492,8 @@ namespace samediff {
         if (startZ > stopZ)
             throw std::runtime_error("Threads::parallel_for got startZ > stopZ");
 
+        numThreads = limited_(numThreads);
+
         auto delta_x = stopX - startX;
         auto delta_y = stopY - startY;
         auto delta_z = stopZ - startZ;
@@ -499,53 +509,23 @@ namespace samediff {
             return 1;
         }
 
-        auto ticket = ThreadPool::getInstance().tryAcquire(numThreads);
-        if (ticket != nullptr) {
-            auto splitLoop = ThreadsHelper::pickLoop3d(numThreads, itersX, itersY, itersZ);
-
-            for (int e = 0; e < numThreads; e++) {
-                auto thread_id = numThreads - e - 1;
-                auto span = Span3::build(splitLoop, thread_id, numThreads, startX, stopX, incX, startY, stopY, incY, startZ, stopZ, incZ);
-
-                ticket->enqueue(e, numThreads, function, span.startX(), span.stopX(), span.incX(), span.startY(), span.stopY(), span.incY(), span.startZ(), span.stopZ(), span.incZ());
-            }
+        auto splitLoop = ThreadsHelper::pickLoop3d(numThreads, itersX, itersY, itersZ);
 
-            // block until we're done
-            ticket->waitAndRelease();
+        execute_(numThreads, [&](uint32_t e) {
+            auto thread_id = numThreads - e - 1;
+            auto span = Span3::build(splitLoop, thread_id, numThreads, startX, stopX, incX, startY, stopY, incY, startZ, stopZ, incZ);
 
-            // we tell that parallelism request succeeded
-            return numThreads;
-        } else {
-            // if there were no threads available - we'll execute function right within current thread
-            function(0, startX, stopX, incX, startY, stopY, incY, startZ, stopZ, incZ);
-
-            // we tell that parallelism request declined
-            return 1;
-        }
+            function(e, span.startX(), span.stopX(), span.incX(), span.startY(), span.stopY(), span.incY(), span.startZ(), span.stopZ(), span.incZ());
+        });
 
+        // we tell that parallelism request succeeded
+        return numThreads;
     }
 
     int Threads::parallel_do(FUNC_DO function, uint64_t numThreads) {
-        auto ticket = ThreadPool::getInstance().tryAcquire(numThreads - 1);
-        if (ticket != nullptr) {
-
-            // submit tasks one by one
-            for (uint64_t e = 0; e < numThreads - 1; e++)
-                ticket->enqueue(e, numThreads, function);
-
-            function(numThreads - 1, numThreads);
-
-            ticket->waitAndRelease();
-
-            return numThreads;
-        } else {
-            // if there's no threads available - we'll execute function sequentially one by one
-            for (uint64_t e = 0; e < numThreads; e++)
-                function(e, numThreads);
-
-            return numThreads;
-        }
-
+        execute_(numThreads, [&](uint32_t e) {
+            function(e, numThreads);
+        });
 
         return numThreads;
     }
@@ -554,6 +534,8 @@ namespace samediff {
         if (start > stop)
             throw std::runtime_error("Threads::parallel_long got start > stop");
 
+        numThreads = limited_(numThreads);
+
         auto delta = (stop - start);
         if (delta == 0 || numThreads == 1)
             return function(0, start, stop, increment);
@@ -565,26 +547,17 @@ namespace samediff {
         if (numThreads == 1)
             return function(0, start, stop, increment);
 
-        auto ticket = ThreadPool::getInstance().tryAcquire(numThreads - 1);
-        if (ticket == nullptr)
-            return function(0, start, stop, increment);
-
         // create temporary array
         int64_t intermediatery[256];
         auto span = (numElements / numThreads) - (numElements % numThreads);
 
         // execute threads in parallel
-        for (uint32_t e = 0; e < numThreads; e++) {
+        execute_(numThreads, [&](uint32_t e) {
             auto start_ = span * e + start;
             auto stop_ = span * (e + 1) + start;
 
-            if (e == numThreads - 1)
-                intermediatery[e] = function(e, start_, stop, increment);
-            else
-                ticket->enqueue(e, numThreads, &intermediatery[e], function, start_, stop_, increment);
-        }
-
-        ticket->waitAndRelease();
+            intermediatery[e] = function(e, start_, e == numThreads - 1 ? stop : stop_, increment);
+        });
 
         // aggregate results in single thread
         for (uint64_t e = 1; e < numThreads; e++)
@@ -598,6 +571,8 @@ namespace samediff {
         if (start > stop)
             throw std::runtime_error("Threads::parallel_long got start > stop");
 
+        numThreads = limited_(numThreads);
+
         auto delta = (stop - start);
         if (delta == 0 || numThreads == 1)
             return function(0, start, stop, increment);
@@ -609,26 +584,17 @@ namespace samediff {
         if (numThreads == 1)
             return function(0, start, stop, increment);
 
-        auto ticket = ThreadPool::getInstance().tryAcquire(numThreads - 1);
-        if (ticket == nullptr)
-            return function(0, start, stop, increment);
-
         // create temporary array
         double intermediatery[256];
         auto span = (numElements / numThreads) - (numElements % numThreads);
 
         // execute threads in parallel
-        for (uint32_t e = 0; e < numThreads; e++) {
+        execute_(numThreads, [&](uint32_t e) {
             auto start_ = span * e + start;
             auto stop_ = span * (e + 1) + start;
 
-            if (e == numThreads - 1)
-                intermediatery[e] = function(e, start_, stop, increment);
-            else
-                ticket->enqueue(e, numThreads, &intermediatery[e], function, start_, stop_, increment);
-        }
-
-        ticket->waitAndRelease();
+            intermediatery[e] = function(e, start_, e == numThreads - 1 ? stop : stop_, increment);
+        });
 
         // aggregate results in single thread
         for (uint64_t e = 1; e < numThreads; e++)
@@ -642,6 +608,8 @@ namespace samediff {
     int  Threads::parallel_aligned_increment(FUNC_1D function, int64_t start, int64_t stop, int64_t increment, size_t type_size , uint32_t req_numThreads) {
         if (start > stop)
             throw std::runtime_error("Threads::parallel_for got start > stop");
+
+        req_numThreads = limited_(req_numThreads);
         auto num_elements = (stop - start);
         //this way we preserve increment starts offset
         //so we will parition considering delta but not total elements
@@ -668,55 +636,41 @@ namespace samediff {
         numThreads = static_cast<int>(std::ceil((double)delta / spand));
         auto span  = static_cast<Nd4jLong>(spand);
 
-        auto ticket = samediff::ThreadPool::getInstance().tryAcquire(numThreads);
-        if (ticket != nullptr) {
-            //tail_add is additional value of the last part
-            //it could be negative or positive
-            //we will spread that value across
-            auto tail_add = delta - numThreads * span;
-            Nd4jLong begin = 0;
-            Nd4jLong end = 0;
-
-            //we will try enqueu bigger parts first
-            decltype(span) span1, span2;
-            int last = 0;
-            if (tail_add >= 0) {
-                //for span == 1  , tail_add is  0 
-                last = tail_add;
-                span1 = span + 1;
-                span2 = span;
-            }
-            else {
-                last = numThreads + tail_add;// -std::abs(tail_add);
-                span1 = span;
-                span2 = span - 1;
-            }
-            for (int i = 0; i < last; i++) {
-                end = begin + span1 * increment;
-                // putting the task into the queue for a given thread
-                ticket->enqueue(i, numThreads, function, begin, end, increment);
-                begin = end;
-            }
-            for (int i = last; i < numThreads - 1; i++) {
-                end = begin + span2 * increment;
-                // putting the task into the queue for a given thread
-                ticket->enqueue(i, numThreads, function, begin, end, increment);
-                begin = end;
-            }
-            //for last one enqueue last offset as stop
-            //we need it in case our ((stop-start) % increment ) > 0
-            ticket->enqueue(numThreads - 1, numThreads, function, begin, stop, increment);
-            // block and wait till all threads finished the job
-            ticket->waitAndRelease();
-            // we tell that parallelism request succeeded
-            return numThreads;
+        //tail_add is additional value of the last part
+        //it could be negative or positive
+        //we will spread that value across
+        auto tail_add = delta - numThreads * span;
+
+        //we will try enqueu bigger parts first
+        decltype(span) span1, span2;
+        int last = 0;
+        if (tail_add >= 0) {
+            //for span == 1  , tail_add is  0
+            last = tail_add;
+            span1 = span + 1;
+            span2 = span;
         }
         else {
-            // if there were no threads available - we'll execute function right within current thread
-            function(0, start, stop, increment);
-            // we tell that parallelism request declined
-            return 1;
+            last = numThreads + tail_add;// -std::abs(tail_add);
+            span1 = span;
+            span2 = span - 1;
         }
+
+        execute_(numThreads, [&](uint32_t i) {
+            // first `last` parts are bigger ones
+            Nd4jLong begin = i < last ? i * span1 * increment : (last * span1 + (i - last) * span2) * increment;
+            Nd4jLong end = i < last ? begin + span1 * increment : begin + span2 * increment;
+
+            //for last one we use last offset as stop
+            //we need it in case our ((stop-start) % increment ) > 0
+            if (i == numThreads - 1)
+                end = stop;
+
+            function(i, begin, end, increment);
+        });
+
+        // we tell that parallelism request succeeded
+        return numThreads;
     }
 
 
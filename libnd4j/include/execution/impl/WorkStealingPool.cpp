@@ -0,0 +1,264 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// @author raver119@gmail.com
+//
+
+#include <execution/WorkStealingPool.h>
+#include <execution/AffinityManager.h>
+#include <execution/NumaTopology.h>
+#include <system/Environment.h>
+#include <algorithm>
+
+namespace samediff {
+
+    // id of the worker owned by current thread, -1 for threads outside of the pool
+    static thread_local int _currentWorker = -1;
+
+    // number of idle rounds worker spends before going to sleep
+    static const int SPIN_ROUNDS = 64;
+
+    TaskGroup::TaskGroup() : _pending(0) {
+        //
+    }
+
+    WorkStealingPool::WorkStealingPool() : _queued(0), _sleeping(0), _nextWorker(0) {
+        // calling thread always participates, so we spawn one thread less
+        auto numWorkers = std::max<int>(1, sd::Environment::getInstance().maxThreads() - 1);
+
+        // workers are split between NUMA nodes proportionally to number of CPUs each node has
+        auto &topology = sd::NumaTopology::getInstance();
+        _pinned = sd::Environment::getInstance().isNumaAware() && topology.numberOfNodes() > 1;
+        const int numNodes = _pinned ? topology.numberOfNodes() : 1;
+
+        int totalCpus = 0;
+        for (int n = 0; n < numNodes; n++)
+            totalCpus += _pinned ? (int) topology.cpusOfNode(n).size() : 1;
+
+        _nodeWorkers.resize(numNodes);
+        for (int n = 0, assigned = 0, cpus = 0; n < numNodes; n++) {
+            cpus += _pinned ? (int) topology.cpusOfNode(n).size() : 1;
+            const int limit = n == numNodes - 1 ? numWorkers : (int) ((int64_t) numWorkers * cpus / totalCpus);
+
+            for (; assigned < limit; assigned++) {
+                auto worker = new Worker();
+                worker->node = n;
+                _workers.emplace_back(worker);
+                _nodeWorkers[n].emplace_back(assigned);
+            }
+        }
+
+        for (int e = 0; e < numWorkers; e++) {
+            _threads.emplace_back(&WorkStealingPool::workerLoop, this, e);
+
+            // workers are never joined, they just die with the process
+            _threads.back().detach();
+        }
+    }
+
+    WorkStealingPool& WorkStealingPool::getInstance() {
+        // never destroyed, since detached workers might still be using it at exit
+        static auto instance = new WorkStealingPool();
+        return *instance;
+    }
+
+    int WorkStealingPool::numberOfWorkers() const {
+        return (int) _workers.size();
+    }
+
+    int WorkStealingPool::numberOfNodes() const {
+        return (int) _nodeWorkers.size();
+    }
+
+    int WorkStealingPool::numberOfWorkers(int node) const {
+        return (int) _nodeWorkers.at(node).size();
+    }
+
+    int WorkStealingPool::currentNode(int workerId) {
+        if (workerId >= 0)
+            return _workers[workerId]->node;
+
+        // external threads submit to the node they are running on (or were assigned to)
+        auto node = sd::AffinityManager::currentNumaNode();
+        if (node < 0 || node >= (int) _nodeWorkers.size())
+            node = 0;
+
+        // small pools might have no workers on some nodes, last node always has some
+        while (_nodeWorkers[node].empty())
+            node++;
+
+        return node;
+    }
+
+    void WorkStealingPool::workerLoop(int workerId) {
+        _currentWorker = workerId;
+
+        if (_pinned)
+            sd::AffinityManager::bindToNumaNode(_workers[workerId]->node);
+
+        const int node = _workers[workerId]->node;
+
+        int idle = 0;
+        while (true) {
+            Task task;
+            if (take(workerId, node, task)) {
+                runTask(task);
+                idle = 0;
+                continue;
+            }
+
+            if (++idle < SPIN_ROUNDS) {
+                std::this_thread::yield();
+                continue;
+            }
+
+            // nothing to do, going to sleep until next submission
+            std::unique_lock<std::mutex> lock(_sleepMutex);
+            _sleeping++;
+            _sleepCondition.wait(lock, [&] { return _queued.load() > 0; });
+            _sleeping--;
+            idle = 0;
+        }
+    }
+
+    bool WorkStealingPool::popBack(int workerId, Task &task) {
+        auto worker = _workers[workerId];
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        if (worker->deque.empty())
+            return false;
+
+        task = worker->deque.back();
+        worker->deque.pop_back();
+        _queued--;
+        return true;
+    }
+
+    bool WorkStealingPool::popFront(int workerId, Task &task) {
+        auto worker = _workers[workerId];
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        if (worker->deque.empty())
+            return false;
+
+        task = worker->deque.front();
+        worker->deque.pop_front();
+        _queued--;
+        return true;
+    }
+
+    bool WorkStealingPool::take(int workerId, int node, Task &task) {
+        // own deque first, newest task is the hottest one
+        if (workerId >= 0 && popBack(workerId, task))
+            return true;
+
+        // stealing oldest tasks from other workers, starting with own node
+        const int numNodes = (int) _nodeWorkers.size();
+        for (int n = 0; n < numNodes; n++) {
+            const auto &victims = _nodeWorkers[(node + n) % numNodes];
+            const int numVictims = (int) victims.size();
+            const int first = workerId >= 0 ? workerId + 1 : 0;
+
+            for (int e = 0; e < numVictims; e++) {
+                auto victim = victims[(first + e) % numVictims];
+                if (victim != workerId && popFront(victim, task))
+                    return true;
+            }
+        }
+
+        return false;
+    }
+
+    void WorkStealingPool::runTask(const Task &task) {
+        auto group = task.group;
+
+        std::exception_ptr exception;
+        try {
+            group->run(task.index);
+        } catch (...) {
+            exception = std::current_exception();
+        }
+
+        // group might be released by its owner right after _pending hits 0, so last access happens under lock
+        std::lock_guard<std::mutex> lock(group->_mutex);
+        if (exception && !group->_exception)
+            group->_exception = exception;
+
+        if (--group->_pending == 0)
+            group->_condition.notify_all();
+    }
+
+    void WorkStealingPool::wakeUp(int64_t numTasks) {
+        _queued += numTasks;
+
+        if (_sleeping.load() > 0) {
+            std::lock_guard<std::mutex> lock(_sleepMutex);
+            _sleepCondition.notify_all();
+        }
+    }
+
+    void WorkStealingPool::execute(TaskGroup &group, uint32_t numTasks) {
+        if (numTasks == 0)
+            return;
+
+        group._pending = numTasks;
+        group._exception = nullptr;
+
+        const int workerId = _currentWorker;
+        const int node = currentNode(workerId);
+
+        // nested calls go to own deque, external ones are spread over workers of the caller's node
+        if (numTasks > 1) {
+            if (workerId >= 0) {
+                auto worker = _workers[workerId];
+                std::lock_guard<std::mutex> lock(worker->mutex);
+                for (uint32_t e = 0; e < numTasks - 1; e++)
+                    worker->deque.push_back(Task{&group, e});
+            } else {
+                const auto &targets = _nodeWorkers[node];
+                const auto numTargets = (uint32_t) targets.size();
+                const auto offset = _nextWorker.fetch_add(numTasks - 1);
+                for (uint32_t e = 0; e < numTasks - 1; e++) {
+                    auto worker = _workers[targets[(offset + e) % numTargets]];
+                    std::lock_guard<std::mutex> lock(worker->mutex);
+                    worker->deque.push_back(Task{&group, e});
+                }
+            }
+
+            wakeUp(numTasks - 1);
+        }
+
+        // caller participates
+        runTask(Task{&group, numTasks - 1});
+
+        // and keeps helping until own group is done
+        while (group._pending.load() > 0) {
+            Task task;
+            if (take(workerId, node, task)) {
+                runTask(task);
+                continue;
+            }
+
+            // all remaining tasks of this group are already running somewhere
+            std::unique_lock<std::mutex> lock(group._mutex);
+            group._condition.wait(lock, [&] { return group._pending.load() == 0; });
+        }
+
+        // making sure last finisher released the lock before group goes out of scope
+        std::lock_guard<std::mutex> lock(group._mutex);
+        if (group._exception)
+            std::rethrow_exception(group._exception);
+    }
+}
@@ -0,0 +1,140 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// @author raver119@gmail.com
+//
+
+#ifndef SD_EXECUTIONPLAN_H
+#define SD_EXECUTIONPLAN_H
+
+#include <system/dll.h>
+#include <system/pointercast.h>
+#include <array/NDArray.h>
+#include <graph/Node.h>
+#include <graph/Context.h>
+#include <graph/Variable.h>
+#include <graph/RandomGenerator.h>
+#include <ops/declarable/DeclarableOp.h>
+#include <vector>
+
+namespace sd {
+    namespace graph {
+        class Graph;
+        class VariableSpace;
+
+        /**
+         * This class holds compiled form of a Graph for one set of input shapes: flat array of steps in execution order,
+         * with ops, output shapes and schedule resolved once, instead of onion traversal on every execution.
+         *
+         * Plan is compiled from arrays left in VariableSpace by a finished execution, and matches later executions
+         * only if every external input (placeholder or variable consumed by graph nodes) has exactly the same shape.
+         * For steps with static shapes output arrays are allocated (or reused) with known shapes, so shape function isn't
+         * called at all. Ops which opt out via hasStaticShapes(), or whose shape function reads input arrays instead of
+         * input shapes only, are executed the usual way.
+         *
+         * Plan belongs to the graph, and can be executed against its own VariableSpace, or against any request-local
+         * VariableSpace, i.e. VariableProxy of shared graph. Executions against own VariableSpace reuse Contexts
+         * preallocated at compile time and output arrays of previous execution. Other executions create their own Contexts
+         * and arrays, so concurrent requests may run the same plan.
+         * In AUTO mode steps are grouped into waves of independent steps, and steps of one wave are executed concurrently.
+         * Graphs with control flow, embedded graphs or external outputs are not compiled.
+         */
+        class ND4J_EXPORT ExecutionPlan {
+        private:
+            struct Step {
+                Node *node = nullptr;
+                sd::ops::DeclarableOp *op = nullptr;
+
+                // input is either an output of another step, or external input with given index
+                std::vector<std::pair<int, int>> inputs;
+                std::vector<int> externals;
+
+                std::vector<const Nd4jLong*> shapes;
+
+                // preallocated for executions against graph's own VariableSpace
+                Context *context = nullptr;
+
+                // dynamic steps go through regular shape function and VariableSpace path
+                bool dynamic = false;
+                RandomGenerator rng;
+            };
+
+            // state of one execution
+            struct Frame {
+                VariableSpace *variableSpace = nullptr;
+                bool own = false;
+                std::vector<NDArray*> bound;
+            };
+
+            // VariableSpace of the graph this plan was compiled for
+            VariableSpace *_variableSpace = nullptr;
+
+            std::vector<std::pair<int, int>> _externals;
+            std::vector<const Nd4jLong*> _signature;
+
+            std::vector<Step> _steps;
+
+            // steps [_waves[w], _waves[w + 1]) don't depend on each other
+            std::vector<int> _waves;
+            int _maxWidth = 0;
+
+            ExecutionPlan() = default;
+
+            bool bind(VariableSpace &variableSpace, std::vector<NDArray*> &bound);
+
+            Nd4jStatus executeStep(Step &step, Frame &frame);
+            Nd4jStatus executeStatic(Step &step, Frame &frame);
+            Nd4jStatus executeDynamic(Step &step, Frame &frame);
+        public:
+            ~ExecutionPlan();
+
+            ExecutionPlan(const ExecutionPlan&) = delete;
+            ExecutionPlan& operator=(const ExecutionPlan&) = delete;
+
+            /**
+             * This method compiles plan from arrays left in given VariableSpace by execution of the given graph.
+             * VariableSpace is either the graph's own one, or request-local proxy of it
+             * @return new plan, or nullptr if graph can't be compiled
+             */
+            static ExecutionPlan* compile(Graph &graph, VariableSpace &variableSpace);
+
+            /**
+             * This method checks if external inputs within given VariableSpace match this plan
+             */
+            bool matches(VariableSpace &variableSpace);
+
+            /**
+             * This method executes all steps against inputs within given VariableSpace, outputs are stored there as well
+             */
+            Nd4jStatus execute(VariableSpace &variableSpace);
+
+            int numberOfSteps();
+
+            /**
+             * This method returns number of steps executed without shape function call
+             */
+            int numberOfStaticSteps();
+
+            /**
+             * This method returns number of groups of steps executed one after another
+             */
+            int numberOfWaves();
+        };
+    }
+}
+
+#endif //SD_EXECUTIONPLAN_H
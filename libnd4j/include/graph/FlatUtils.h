@@ -26,6 +26,8 @@
 #include <graph/generated/array_generated.h>
 #include <graph/generated/node_generated.h>
 #include <array/NDArray.h>
+#include <graph/MappedFile.h>
+#include <memory>
 
 namespace sd {
     namespace graph {
@@ -37,6 +39,12 @@ namespace sd {
 
             static NDArray* fromFlatArray(const sd::graph::FlatArray* flatArray);
 
+            /**
+             * This method restores array without copying its data, if FlatArray lives within given mapping and its
+             * data is aligned and has native byte order. Otherwise data is copied, as usual
+             */
+            static NDArray* fromFlatArray(const sd::graph::FlatArray* flatArray, const std::shared_ptr<MappedFile> &mapping);
+
             static flatbuffers::Offset<FlatArray> toFlatArray(flatbuffers::FlatBufferBuilder &builder, NDArray &array);
         };
     }
@@ -29,9 +29,13 @@
 #include <graph/FrameState.h>
 #include <graph/profiling/GraphProfile.h>
 #include <system/dll.h>
+#include <array/DataBuffer.h>
+#include <memory>
 
 namespace sd {
     namespace graph {
+        class MemoryPlan;
+
         class ND4J_EXPORT FlowPath {
         private:
             MAP_IMPL<int, NodeState> _states;
@@ -41,6 +45,10 @@ namespace sd {
             void ensureFrame(int nodeId);
 
             GraphProfile _profile;
+
+            // memory plan of the graph being executed, and arena for planned variables of this execution
+            MemoryPlan* _memoryPlan = nullptr;
+            std::shared_ptr<DataBuffer> _arena;
         public:
             FlowPath() = default;
             ~FlowPath() = default;
@@ -79,6 +87,14 @@ namespace sd {
             Nd4jLong getNumberOfCycles(Nd4jLong frameId);
 
             GraphProfile* profile();
+
+            /**
+             * This method attaches memory plan and arena, so outputs of planned variables are placed within arena
+             */
+            void attachArena(MemoryPlan *plan, std::shared_ptr<DataBuffer> arena);
+
+            MemoryPlan* memoryPlan();
+            std::shared_ptr<DataBuffer> arena();
         };
     }
 }
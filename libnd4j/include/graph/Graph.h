@@ -35,6 +35,8 @@
 #include <graph/generated/graph_generated.h>
 #include <graph/generated/config_generated.h>
 #include <graph/ExecutorConfiguration.h>
+#include <graph/MemoryPlan.h>
+#include <graph/ExecutionPlan.h>
 #include <ops/declarable/OpDescriptor.h>
 
 namespace sd {
@@ -67,6 +69,15 @@ namespace sd {
             MAP_IMPL<int, Scope*> _mappedScopes;
             std::vector<Scope*> _scopes;
 
+            // shared between this graph and all its clones
+            std::shared_ptr<MemoryPlan> _memoryPlan = std::make_shared<MemoryPlan>();
+
+            // compiled plans, one per input shapes signature. they're executed against own VariableSpace or request-local proxies of it
+            std::vector<ExecutionPlan*> _executionPlans;
+            std::mutex _mutexPlans;
+            int _unplannedExecutions = 0;
+            bool _compilable = true;
+
 ////////////////////////////////////////
             Nd4jStatus validateNode(sd::graph::Node *node);
 
@@ -80,9 +91,20 @@ namespace sd {
 
             void prepareOutputs();
 
+            void dropExecutionPlans();
+
+            void fuseElementwiseChains();
+
         public:
             Graph(const FlatGraph *flatGraph = nullptr, VariableSpace *variableSpace = nullptr);
 
+#ifndef __JAVACPP_HACK__
+            /**
+             * This constructor restores graph stored within given file mapping, weights are referenced instead of copied when possible
+             */
+            Graph(const FlatGraph *flatGraph, VariableSpace *variableSpace, const std::shared_ptr<MappedFile> &mapping);
+#endif
+
             ~Graph();
 
             // this method applies toposort to nodes
@@ -139,6 +161,12 @@ namespace sd {
              */
             std::vector<sd::graph::Variable*> *fetchOutputs();
 
+            /**
+             * This method returns outputs of this graph, stored in given VariableSpace
+             * @return
+             */
+            std::vector<sd::graph::Variable*> *fetchOutputs(VariableSpace *variableSpace);
+
             /**
              * This method returns pointer to ExecutorConfiguration
              *
@@ -183,6 +211,11 @@ namespace sd {
              */
             bool hasScope(int id);
 
+            /**
+             * This method returns TRUE if graph has logic ops, scopes or embedded graphs
+             */
+            bool hasControlFlow();
+
             /**
              * This method returns clone of the graph
              */
@@ -222,6 +255,21 @@ namespace sd {
 
             void replaceState(VariableSpace *state, ExecutorConfiguration *configuration);
 
+            /**
+             * This method returns static memory plan of this graph. Plan is empty until first execution is finished
+             */
+            MemoryPlan* memoryPlan();
+
+            /**
+             * This method returns compiled execution plan matching current inputs within given VariableSpace, or nullptr if there's none
+             */
+            ExecutionPlan* executionPlan(VariableSpace *variableSpace);
+
+            /**
+             * This method is called after regular execution, and compiles execution plan for current inputs once graph is executed repeatedly
+             */
+            void compileExecutionPlan(VariableSpace *variableSpace);
+
             FORCEINLINE std::vector<int>* nodes() {
                 return _nodes;
             }
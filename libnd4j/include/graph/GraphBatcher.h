@@ -0,0 +1,131 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// @author raver119@gmail.com
+//
+
+#ifndef SD_GRAPHBATCHER_H
+#define SD_GRAPHBATCHER_H
+
+#include <system/dll.h>
+#include <system/pointercast.h>
+#include <graph/Variable.h>
+#include <graph/generated/request_generated.h>
+#include <graph/generated/result_generated.h>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace sd {
+    namespace graph {
+        /**
+         * This class implements dynamic batching of inference requests for graphs stored in GraphHolder.
+         *
+         * Requests for the same graph are queued, and first request in the queue waits up to maxDelay microseconds
+         * for other ones, or until maxBatchSize requests are collected. Inputs of compatible requests (same variables,
+         * same data types, same shapes except of dimension 0) are concatenated along dimension 0, graph is executed
+         * once, and outputs are split back. Requests that can't be batched, or batches that produce outputs without
+         * batch dimension, are executed one by one.
+         */
+        class ND4J_EXPORT GraphBatcher {
+        private:
+            struct Request {
+                std::vector<std::unique_ptr<Variable>> inputs;
+                std::vector<Variable*> outputs;
+                std::exception_ptr error;
+                std::chrono::steady_clock::time_point enqueued;
+                bool done = false;
+            };
+
+            struct Queue {
+                std::mutex mutex;
+                std::condition_variable condition;
+                std::deque<Request*> pending;
+                bool leader = false;
+            };
+
+            int _maxBatchSize;
+            Nd4jLong _maxDelay;
+
+            std::mutex _mutex;
+            MAP_IMPL<Nd4jLong, std::unique_ptr<Queue>> _queues;
+
+            // histograms: batch size, and queue time in power-of-two buckets of microseconds
+            std::mutex _mutexStats;
+            std::vector<Nd4jLong> _batchSizes;
+            std::vector<Nd4jLong> _queueTimes;
+
+            Queue& queue(Nd4jLong graphId);
+
+            void executeBatch(Nd4jLong graphId, std::vector<Request*> &batch);
+            void executeSingle(Nd4jLong graphId, Request *request);
+
+            static bool compatible(Request *a, Request *b);
+
+            // completes requests with given error, releasing outputs produced so far
+            static void fail(std::vector<Request*> &batch, std::exception_ptr error);
+        public:
+            static const int QUEUE_TIME_BUCKETS = 24;
+
+            /**
+             * @param maxBatchSize maximal number of requests executed at once
+             * @param maxDelay maximal time in microseconds request waits for others
+             */
+            explicit GraphBatcher(int maxBatchSize = 32, Nd4jLong maxDelay = 1000L);
+            ~GraphBatcher() = default;
+
+            GraphBatcher(const GraphBatcher&) = delete;
+            GraphBatcher& operator=(const GraphBatcher&) = delete;
+
+            int maxBatchSize();
+            Nd4jLong maxDelay();
+
+            /**
+             * This method executes given request, possibly together with concurrent requests for the same graph.
+             * Calling thread is blocked until its results are available
+             */
+            flatbuffers::Offset<FlatResult> execute(Nd4jLong graphId, flatbuffers::FlatBufferBuilder &builder, const FlatInferenceRequest* request);
+
+            /**
+             * Same as above, for already deserialized inputs. Inputs are owned by batcher, outputs are owned by caller
+             */
+            std::vector<Variable*> execute(Nd4jLong graphId, const std::vector<Variable*> &inputs);
+
+            /**
+             * This method returns number of executions per batch size, i.e. element 4 is number of batches of 4 requests
+             */
+            std::vector<Nd4jLong> batchSizeHistogram();
+
+            /**
+             * This method returns number of requests per queue time: element i counts requests that waited
+             * less than 2^i microseconds, and at least 2^(i-1)
+             */
+            std::vector<Nd4jLong> queueTimeHistogram();
+
+            /**
+             * This method prints out both histograms
+             */
+            void printOut();
+        };
+    }
+}
+
+#endif //SD_GRAPHBATCHER_H
@@ -49,6 +49,12 @@ namespace sd {
 
         static Nd4jStatus executeFlatNode(Graph *graph, Node *node, VariableSpace *variableSpace);
 
+        /**
+         * This method executes nodes of a single onion layer, independent nodes are executed concurrently.
+         * Layer must contain no LOGIC ops
+         */
+        static Nd4jStatus executeLayer(Graph *graph, std::vector<Node*> *layer, VariableSpace *variableSpace);
+
         /**
         * This method executes given Graph
         * @return
@@ -66,11 +72,22 @@ namespace sd {
 
         static flatbuffers::Offset<FlatResult> execute(Graph *graph, flatbuffers::FlatBufferBuilder &builder, const FlatInferenceRequest* request);
 
+        /**
+        * This method executes inference request against given VariableSpace, i.e. request variables and results stay there
+        */
+        static flatbuffers::Offset<FlatResult> execute(Graph *graph, VariableSpace *variableSpace, flatbuffers::FlatBufferBuilder &builder, const FlatInferenceRequest* request);
+
         static Graph *importFromTensorFlow(const char *fileName);
 
 
         static Graph *importFromFlatBuffers(const char *filename);
 
+        /**
+        * This method maps given FlatBuffers file into memory, and restores Graph from it.
+        * Weights are referenced within the mapping instead of being copied, so replicas of the same model share page cache
+        */
+        static Graph *importFromMappedFlatBuffers(const char *filename);
+
         static Graph *importFromFlatPointer(Nd4jPointer ptr);
     };
 
@@ -25,6 +25,8 @@
 #include <graph/Graph.h>
 #include <helpers/SimpleReadWriteLock.h>
 #include <exceptions/unknown_graph_exception.h>
+#include <functional>
+#include <vector>
 
 namespace sd {
     namespace graph {
@@ -36,6 +38,9 @@ namespace sd {
 
             GraphHolder() = default;
             ~GraphHolder() = default;
+
+            // runs func against stored graph and request-local VariableSpace, under read lock
+            void executeShared(Nd4jLong graphId, const std::function<void(Graph*, VariableSpace*)> &func);
         public:
             static GraphHolder& getInstance();
 
@@ -57,6 +62,12 @@ namespace sd {
 
             flatbuffers::Offset<FlatResult> execute(Nd4jLong graphId, flatbuffers::FlatBufferBuilder &builder, const FlatInferenceRequest* request);
 
+            /**
+             * This method executes stored graph with given input variables, and returns copies of its outputs.
+             * Input variables are moved into request-local VariableSpace, so caller must not delete them
+             */
+            std::vector<Variable*> execute(Nd4jLong graphId, const std::vector<Variable*> &inputs);
+
             void replaceGraph(Nd4jLong graphId, Graph *graph);
 
             /////////////////////////////
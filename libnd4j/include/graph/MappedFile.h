@@ -0,0 +1,65 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// @author raver119@gmail.com
+//
+
+#ifndef SD_MAPPEDFILE_H
+#define SD_MAPPEDFILE_H
+
+#include <system/dll.h>
+#include <system/pointercast.h>
+
+namespace sd {
+    namespace graph {
+        /**
+         * This class holds read-only memory mapping of a file: pages are shared with page cache
+         * (and with other mappings of the same file). Arrays pointing into the mapping have read-only DataBuffers,
+         * which are copied into own memory before the first write.
+         *
+         * On platforms without mmap file is read into memory instead.
+         */
+        class ND4J_EXPORT MappedFile {
+        private:
+            uint8_t *_data = nullptr;
+            Nd4jLong _length = 0L;
+            bool _mapped = false;
+
+        public:
+            explicit MappedFile(const char *fileName);
+            ~MappedFile();
+
+            MappedFile(const MappedFile&) = delete;
+            MappedFile& operator=(const MappedFile&) = delete;
+
+            const uint8_t* data() const;
+            Nd4jLong length();
+
+            /**
+             * This method returns true if pointer belongs to this file
+             */
+            bool contains(const void *ptr, Nd4jLong bytes);
+
+            /**
+             * This method returns true if file is actually mapped, and false if it was read into memory
+             */
+            bool isMapped();
+        };
+    }
+}
+
+#endif //SD_MAPPEDFILE_H
@@ -0,0 +1,113 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// @author raver119@gmail.com
+//
+
+#ifndef SD_MEMORYPLAN_H
+#define SD_MEMORYPLAN_H
+
+#include <system/dll.h>
+#include <system/pointercast.h>
+#include <array/NDArray.h>
+#include <array/DataBuffer.h>
+#include <graph/Variable.h>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <vector>
+
+namespace sd {
+    namespace graph {
+        class Graph;
+        class VariableSpace;
+
+        /**
+         * This class holds static memory plan of a Graph: offsets of intermediate variables within single arena.
+         *
+         * Plan is built from a finished execution: liveness of every variable produced by a node is derived from
+         * execution order of the onion (first step is the producer, last step is the last consumer), in-place nodes
+         * and arrays sharing the same buffer are merged into one group that lives as long as any of its members.
+         * Groups are placed greedily, biggest first, at the lowest offset that doesn't overlap any group alive at
+         * the same time. Graph outputs, external variables and anything aliasing them are never planned.
+         *
+         * Since liveness doesn't depend on shapes, plan stays valid for any input shapes: planned array is placed
+         * in arena only if it fits into its slot, otherwise it's allocated as usual.
+         * Graphs with control flow (logic ops, scopes, embedded graphs) are not planned.
+         */
+        class ND4J_EXPORT MemoryPlan {
+        public:
+            struct Slot {
+                Nd4jLong offset;
+                Nd4jLong bytes;
+            };
+
+        private:
+            MAP_IMPL<std::pair<int, int>, Slot> _slots;
+            Nd4jLong _arenaSize = 0L;
+            Nd4jLong _plannedBytes = 0L;
+
+            // 0: not built yet, 1: ready, -1: graph can't be planned
+            std::atomic<int> _state;
+            std::mutex _mutex;
+
+        public:
+            MemoryPlan();
+            ~MemoryPlan() = default;
+
+            MemoryPlan(const MemoryPlan&) = delete;
+            MemoryPlan& operator=(const MemoryPlan&) = delete;
+
+            /**
+             * This method builds plan from arrays left in VariableSpace by execution of the given graph.
+             * Only first call has any effect.
+             * @return true if plan is ready
+             */
+            bool build(Graph &graph, VariableSpace &variableSpace);
+
+            bool isReady();
+            bool isPlannable();
+
+            /**
+             * This method returns size of the arena required to hold all planned variables
+             */
+            Nd4jLong arenaSize();
+
+            /**
+             * This method returns total size of planned variables, i.e. memory required without buffer reuse
+             */
+            Nd4jLong plannedBytes();
+
+            int numberOfSlots();
+
+            bool hasSlot(const std::pair<int, int> &pair);
+            Slot slot(const std::pair<int, int> &pair);
+
+            /**
+             * This method creates new arena for single execution of the graph
+             */
+            std::shared_ptr<DataBuffer> createArena();
+
+            /**
+             * This method returns new array placed within arena, or nullptr if variable isn't planned or doesn't fit its slot
+             */
+            NDArray* allocate(const std::pair<int, int> &pair, const Nd4jLong *shapeInfo, const std::shared_ptr<DataBuffer> &arena, LaunchContext *context);
+        };
+    }
+}
+
+#endif //SD_MEMORYPLAN_H
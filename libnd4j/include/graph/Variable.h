@@ -28,6 +28,8 @@
 #include <graph/generated/array_generated.h>
 #include <graph/generated/node_generated.h>
 #include <graph/generated/graph_generated.h>
+#include <graph/MappedFile.h>
+#include <memory>
 
 #ifndef __JAVACPP_HACK__
 
@@ -86,6 +88,11 @@ namespace sd {
 
 #ifndef __JAVACPP_HACK__
             Variable(const sd::graph::FlatVariable *flatVariable);
+
+            /**
+             * This constructor restores Variable from FlatVariable stored within given file mapping, without copying its data when possible
+             */
+            Variable(const sd::graph::FlatVariable *flatVariable, const std::shared_ptr<MappedFile> &mapping);
 #endif
 
             ~Variable();
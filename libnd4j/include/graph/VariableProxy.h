@@ -22,12 +22,28 @@
 
 namespace sd {
     namespace graph {
+        class Node;
+
         class ND4J_EXPORT VariableProxy: public VariableSpace {
         protected:
             VariableSpace* _backed = nullptr;
             VariableSpace* _current = nullptr;
+
+            // outputs of these nodes are never taken from backing VariableSpace
+            MAP_IMPL<int, Node*> *_local = nullptr;
+            std::mutex _mutexLocal;
+
+            bool isLocal(int id);
+            Variable* localVariable(int id, int idx);
         public:
             explicit VariableProxy(VariableSpace* reference);
+
+            /**
+             * This constructor creates proxy that keeps outputs of given nodes request-local: on first access
+             * empty Variable is created within this proxy, so execution of the shared Graph never touches
+             * node states stored in backing VariableSpace
+             */
+            VariableProxy(VariableSpace* reference, MAP_IMPL<int, Node*> *nodes);
             ~VariableProxy();
 
             virtual VariableSpace& operator=(const VariableSpace& other);
@@ -63,6 +79,9 @@ namespace sd {
 
             virtual void replaceVariable(Variable *variable);
 
+            virtual void beginConcurrentAccess();
+            virtual void endConcurrentAccess();
+
             virtual void dropVariable(std::pair<int,int> &pair);
             virtual void dropVariable(int id, int idx);
 
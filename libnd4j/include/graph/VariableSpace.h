@@ -28,6 +28,7 @@
 #include <list>
 #include <unordered_map>
 #include <mutex>
+#include <atomic>
 #include <array/NDArray.h>
 #include <array/NDArrayList.h>
 #include <graph/Variable.h>
@@ -61,6 +62,11 @@ namespace sd {
 
             std::mutex _varmap;
 
+            // number of concurrent executions in progress: lookups take _varmap only while it's non-zero
+            std::atomic<int> _concurrent{0};
+
+            std::unique_lock<std::mutex> lookupLock();
+
             MAP_IMPL<int, sd::graph::Variable*> _temporary;
 
             std::vector<sd::graph::Variable*> *_handles;
@@ -112,6 +118,13 @@ namespace sd {
 
             virtual void replaceVariable(Variable *variable);
 
+            /**
+             * These methods surround concurrent execution of nodes against this VariableSpace. Writes are always guarded,
+             * while lookups are guarded only within such sections, so sequential execution doesn't pay for locking
+             */
+            virtual void beginConcurrentAccess();
+            virtual void endConcurrentAccess();
+
             // memory-related statistics
             virtual Nd4jLong externalMemory();
             virtual Nd4jLong internalMemory();
@@ -136,6 +149,25 @@ namespace sd {
             virtual void setFlowPath(FlowPath* timers);
             virtual FlowPath* flowPath();
         };
+
+        /**
+         * Scoped concurrent section of VariableSpace, see VariableSpace::beginConcurrentAccess()
+         */
+        class ConcurrentAccessGuard {
+        private:
+            VariableSpace &_variableSpace;
+        public:
+            explicit ConcurrentAccessGuard(VariableSpace &variableSpace) : _variableSpace(variableSpace) {
+                _variableSpace.beginConcurrentAccess();
+            }
+
+            ~ConcurrentAccessGuard() {
+                _variableSpace.endConcurrentAccess();
+            }
+
+            ConcurrentAccessGuard(const ConcurrentAccessGuard&) = delete;
+            ConcurrentAccessGuard& operator=(const ConcurrentAccessGuard&) = delete;
+        };
     }
 }
 
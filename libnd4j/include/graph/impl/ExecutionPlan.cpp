@@ -0,0 +1,398 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// @author raver119@gmail.com
+//
+
+#include <graph/ExecutionPlan.h>
+#include <graph/Graph.h>
+#include <graph/VariableSpace.h>
+#include <graph/VariableProxy.h>
+#include <graph/Status.h>
+#include <helpers/ConstantShapeHelper.h>
+#include <execution/Threads.h>
+#include <algorithm>
+#include <memory>
+
+namespace sd {
+    namespace graph {
+        static bool sameShape(const Nd4jLong *shapeInfo, const Nd4jLong *expected) {
+            // shapeInfo pointers usually come from ConstantShapeHelper, so comparison is cheap most of the time
+            return shapeInfo == expected || shape::equalsStrict(shapeInfo, expected);
+        }
+
+        /**
+         * VariableSpace view used to probe shape functions: it records whether shape function fetched input Variables,
+         * i.e. to read axis or shape passed as array, instead of looking at input shapes only
+         */
+        class ShapeFunctionProbe : public VariableProxy {
+        public:
+            bool touched = false;
+
+            explicit ShapeFunctionProbe(VariableSpace *variableSpace) : VariableProxy(variableSpace) { }
+
+            using VariableProxy::getVariable;
+
+            Variable* getVariable(std::pair<int,int>& pair) override {
+                touched = true;
+                return VariableProxy::getVariable(pair);
+            }
+        };
+
+        static bool readsInputValues(sd::ops::DeclarableOp *op, ContextPrototype *prototype, VariableSpace &variableSpace, ShapeList &inputShapes) {
+            ShapeFunctionProbe probe(&variableSpace);
+            Context ctx(prototype, &probe);
+
+            try {
+                delete op->calculateOutputShape(&inputShapes, ctx);
+            } catch (std::exception &e) {
+                return true;
+            }
+
+            return probe.touched;
+        }
+
+        // in-place node writes into its inputs, so nobody else is allowed to touch them at the same time
+        static bool conflicts(Node *a, Node *b) {
+            if (!a->isInplace() && !b->isInplace())
+                return false;
+
+            for (auto &p: *a->input())
+                for (auto &q: *b->input())
+                    if (p == q)
+                        return true;
+
+            return false;
+        }
+
+        ExecutionPlan::~ExecutionPlan() {
+            for (auto &step: _steps)
+                delete step.context;
+        }
+
+        ExecutionPlan* ExecutionPlan::compile(Graph &graph, VariableSpace &variableSpace) {
+            if (!graph.scopes()->empty())
+                return nullptr;
+
+            std::unique_ptr<ExecutionPlan> plan(new ExecutionPlan());
+            plan->_variableSpace = graph.getVariableSpace();
+
+            MAP_IMPL<std::pair<int, int>, int> externals;
+            auto mapped = graph.getMapped();
+            auto onion = graph.getOnion();
+
+            for (int l = 0; l < (int) onion->size(); l++) {
+                if (onion->count(l) == 0)
+                    continue;
+
+                for (auto node: *onion->at(l)) {
+                    if (node->opType() == OpType_LOGIC || node->hasGraphEmbedded() || !node->hasCustomOp() || node->hasExternalOutputs())
+                        return nullptr;
+
+                    plan->_steps.emplace_back();
+                    auto &step = plan->_steps.back();
+                    step.node = node;
+                    step.op = node->getCustomOp();
+
+                    ShapeList inputShapes;
+
+                    for (auto p: *node->input()) {
+                        if (!variableSpace.hasVariable(p))
+                            return nullptr;
+
+                        auto var = variableSpace.getVariable(p);
+                        if (var->variableType() != VariableType::NDARRAY || !var->hasNDArray())
+                            return nullptr;
+
+                        inputShapes.push_back(var->getNDArray()->shapeInfo());
+
+                        step.inputs.emplace_back(p);
+
+                        if (mapped->count(p.first) > 0) {
+                            step.externals.emplace_back(-1);
+                            continue;
+                        }
+
+                        if (externals.count(p) == 0) {
+                            externals[p] = (int) plan->_externals.size();
+                            plan->_externals.emplace_back(p);
+                            plan->_signature.emplace_back(ConstantShapeHelper::getInstance().bufferForShapeInfo(var->getNDArray()->shapeInfo()).primary());
+                        }
+
+                        step.externals.emplace_back(externals[p]);
+                    }
+
+                    std::vector<NDArray*> outputs;
+                    for (int idx = 0; variableSpace.hasVariable(node->id(), idx); idx++) {
+                        auto var = variableSpace.getVariable(node->id(), idx);
+                        if (var->variableType() != VariableType::NDARRAY || !var->hasNDArray())
+                            return nullptr;
+
+                        outputs.emplace_back(var->getNDArray());
+                        step.shapes.emplace_back(ConstantShapeHelper::getInstance().bufferForShapeInfo(var->getNDArray()->shapeInfo()).primary());
+                    }
+
+                    auto prototype = node->getContextPrototype();
+                    if (prototype->isInplace()) {
+                        // in-place outputs must be their inputs, since that's what we're going to feed them with
+                        if (outputs.size() > step.inputs.size())
+                            return nullptr;
+
+                        for (int e = 0; e < (int) outputs.size(); e++)
+                            if (outputs[e] != variableSpace.getVariable(step.inputs[e])->getNDArray())
+                                return nullptr;
+                    } else {
+                        step.dynamic = !step.op->hasStaticShapes() || readsInputValues(step.op, prototype, variableSpace, inputShapes);
+                    }
+
+                    step.context = new Context(prototype, plan->_variableSpace);
+                    step.context->setShapeFunctionOverride(!step.dynamic);
+                    step.rng = step.context->getRng();
+                }
+            }
+
+            const auto numSteps = (int) plan->_steps.size();
+            std::vector<int> waves(numSteps);
+            for (int e = 0; e < numSteps; e++)
+                waves[e] = e;
+
+            if (graph.getExecutorConfiguration()->_executionMode == ExecutionMode_AUTO) {
+                // step goes right after the last wave it depends on, while conflicting steps keep their original order
+                MAP_IMPL<int, int> producers;
+                for (int e = 0; e < numSteps; e++) {
+                    auto node = plan->_steps[e].node;
+                    int wave = 0;
+
+                    for (auto &p: *node->input())
+                        if (producers.count(p.first) > 0)
+                            wave = sd::math::nd4j_max<int>(wave, waves[producers[p.first]] + 1);
+
+                    for (int f = 0; f < e; f++)
+                        if (conflicts(node, plan->_steps[f].node))
+                            wave = sd::math::nd4j_max<int>(wave, waves[f] + 1);
+
+                    waves[e] = wave;
+                    producers[node->id()] = e;
+                }
+
+                std::vector<int> order(numSteps);
+                for (int e = 0; e < numSteps; e++)
+                    order[e] = e;
+
+                std::stable_sort(order.begin(), order.end(), [&waves](int a, int b) { return waves[a] < waves[b]; });
+
+                std::vector<Step> steps;
+                steps.reserve(numSteps);
+                std::vector<int> sorted;
+                for (auto e: order) {
+                    steps.emplace_back(plan->_steps[e]);
+                    sorted.emplace_back(waves[e]);
+                }
+
+                // contexts are owned by steps, so they are just moved over
+                for (auto &step: plan->_steps)
+                    step.context = nullptr;
+
+                plan->_steps.swap(steps);
+                waves.swap(sorted);
+            }
+
+            int maxWidth = 0;
+            for (int e = 0; e < numSteps; e++) {
+                if (e == 0 || waves[e] != waves[e - 1]) {
+                    if (!plan->_waves.empty())
+                        maxWidth = sd::math::nd4j_max<int>(maxWidth, e - plan->_waves.back());
+
+                    plan->_waves.emplace_back(e);
+                }
+            }
+
+            if (!plan->_waves.empty())
+                maxWidth = sd::math::nd4j_max<int>(maxWidth, numSteps - plan->_waves.back());
+
+            plan->_waves.emplace_back(numSteps);
+            plan->_maxWidth = maxWidth;
+
+            nd4j_debug("Execution plan compiled: %i steps, %i of them static, %i waves\n", plan->numberOfSteps(), plan->numberOfStaticSteps(), plan->numberOfWaves());
+
+            return plan.release();
+        }
+
+        bool ExecutionPlan::bind(VariableSpace &variableSpace, std::vector<NDArray*> &bound) {
+            bound.resize(_externals.size());
+
+            for (int e = 0; e < (int) _externals.size(); e++) {
+                auto &p = _externals[e];
+                if (!variableSpace.hasVariable(p))
+                    return false;
+
+                auto var = variableSpace.getVariable(p);
+                if (var->variableType() != VariableType::NDARRAY || !var->hasNDArray())
+                    return false;
+
+                auto array = var->getNDArray();
+                if (!sameShape(array->shapeInfo(), _signature[e]))
+                    return false;
+
+                bound[e] = array;
+            }
+
+            return true;
+        }
+
+        bool ExecutionPlan::matches(VariableSpace &variableSpace) {
+            std::vector<NDArray*> bound;
+            return bind(variableSpace, bound);
+        }
+
+        Nd4jStatus ExecutionPlan::execute(VariableSpace &variableSpace) {
+            Frame frame;
+            frame.variableSpace = &variableSpace;
+            frame.own = &variableSpace == _variableSpace;
+            if (!bind(variableSpace, frame.bound))
+                return ND4J_STATUS_BAD_INPUT;
+
+            const int maxThreads = sd::Environment::getInstance().maxMasterThreads();
+            std::vector<Nd4jStatus> statuses(_maxWidth, Status::OK());
+
+            for (int w = 0; w + 1 < (int) _waves.size(); w++) {
+                const auto first = _waves[w];
+                const auto numSteps = _waves[w + 1] - first;
+
+                if (numSteps == 1) {
+                    auto status = executeStep(_steps[first], frame);
+                    if (status != Status::OK())
+                        return status;
+
+                    continue;
+                }
+
+                // cores are split between concurrent steps, so their own parallel loops don't oversubscribe them
+                const int budget = sd::math::nd4j_max<int>(1, maxThreads / numSteps);
+
+                auto func = PRAGMA_THREADS_DO {
+                    for (auto e = thread_id; e < (uint64_t) numSteps; e += numThreads) {
+                        samediff::ThreadsLimit limit(budget);
+                        statuses[e] = executeStep(_steps[first + e], frame);
+                    }
+                };
+
+                {
+                    ConcurrentAccessGuard guard(variableSpace);
+                    samediff::Threads::parallel_do(func, numSteps);
+                }
+
+                for (int e = 0; e < numSteps; e++)
+                    if (statuses[e] != Status::OK())
+                        return statuses[e];
+            }
+
+            return Status::OK();
+        }
+
+        Nd4jStatus ExecutionPlan::executeStep(Step &step, Frame &frame) {
+            return step.dynamic ? executeDynamic(step, frame) : executeStatic(step, frame);
+        }
+
+        // output variable of the node, request-local VariableSpace might have no such variable yet
+        static Variable* outputVariable(VariableSpace &variableSpace, int id, int idx) {
+            std::pair<int, int> pair(id, idx);
+            if (!variableSpace.hasVariable(pair))
+                variableSpace.putVariable(pair, new Variable(nullptr, nullptr, id, idx));
+
+            return variableSpace.getVariable(pair);
+        }
+
+        Nd4jStatus ExecutionPlan::executeStatic(Step &step, Frame &frame) {
+            auto &variableSpace = *frame.variableSpace;
+
+            // shared plan can't keep per-execution state in its own Context
+            std::unique_ptr<Context> local(frame.own ? nullptr : new Context(step.node->getContextPrototype(), &variableSpace));
+            auto ctx = frame.own ? step.context : local.get();
+            ctx->setShapeFunctionOverride(true);
+            ctx->setRng(step.rng);
+
+            for (int e = 0; e < (int) step.inputs.size(); e++)
+                ctx->setInputArray(e, step.externals[e] >= 0 ? frame.bound[step.externals[e]] : variableSpace.getVariable(step.inputs[e])->getNDArray());
+
+            if (ctx->isInplace()) {
+                // op writes into its inputs, and output variables just follow them
+                for (int e = 0; e < (int) step.shapes.size(); e++) {
+                    auto var = outputVariable(variableSpace, step.node->id(), e);
+                    auto array = ctx->fastpath_in()[e];
+                    if (!var->hasNDArray() || var->getNDArray() != array) {
+                        var->setNDArray(array);
+                        var->markRemovable(false);
+                    }
+                }
+            } else {
+                for (int e = 0; e < (int) step.shapes.size(); e++) {
+                    auto var = outputVariable(variableSpace, step.node->id(), e);
+                    auto array = var->hasNDArray() ? var->getNDArray() : nullptr;
+
+                    // same input shapes give same output shapes, so arrays from previous execution are reused
+                    if (array == nullptr || !sameShape(array->shapeInfo(), step.shapes[e])) {
+                        if (array != nullptr && var->isRemovable())
+                            delete array;
+
+                        array = new NDArray(step.shapes[e], true, ctx->launchContext(), false);
+                        var->setNDArray(array);
+                        var->markRemovable(true);
+                    }
+
+                    ctx->setOutputArray(e, array);
+                }
+            }
+
+            return step.op->execute(ctx);
+        }
+
+        Nd4jStatus ExecutionPlan::executeDynamic(Step &step, Frame &frame) {
+            if (!frame.own) {
+                Context ctx(step.node->getContextPrototype(), frame.variableSpace);
+                ctx.setRng(step.rng);
+
+                return step.op->execute(&ctx);
+            }
+
+            // arrays picked up by previous execution must not leak into this one
+            auto ctx = step.context;
+            ctx->clearFastPath();
+            ctx->forbidFastPath(false);
+            ctx->setRng(step.rng);
+
+            return step.op->execute(ctx);
+        }
+
+        int ExecutionPlan::numberOfSteps() {
+            return (int) _steps.size();
+        }
+
+        int ExecutionPlan::numberOfStaticSteps() {
+            int cnt = 0;
+            for (auto &step: _steps)
+                if (!step.dynamic)
+                    cnt++;
+
+            return cnt;
+        }
+
+        int ExecutionPlan::numberOfWaves() {
+            return sd::math::nd4j_max<int>(0, (int) _waves.size() - 1);
+        }
+    }
+}
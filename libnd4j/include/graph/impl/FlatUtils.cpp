@@ -24,6 +24,8 @@
 #include <array/DataTypeUtils.h>
 #include <array/ByteOrderUtils.h>
 #include <array/NDArrayFactory.h>
+#include <helpers/BitwiseUtils.h>
+#include <system/Environment.h>
 
 
 namespace sd {
@@ -102,6 +104,36 @@ namespace sd {
             return array;
         }
 
+        NDArray* FlatUtils::fromFlatArray(const sd::graph::FlatArray *flatArray, const std::shared_ptr<MappedFile> &mapping) {
+            // device backends need their own copy anyway
+            if (mapping == nullptr || !Environment::getInstance().isCPU() || flatArray->buffer() == nullptr)
+                return fromFlatArray(flatArray);
+
+            auto rank = static_cast<int>(flatArray->shape()->Get(0));
+            std::vector<Nd4jLong> shapeInfo(shape::shapeInfoLength(rank));
+            memcpy(shapeInfo.data(), flatArray->shape()->data(), shape::shapeInfoByteLength(rank));
+
+            auto dtype = DataTypeUtils::fromFlatDataType(flatArray->dtype());
+            if (shape::isEmpty(shapeInfo.data()) || DataTypeUtils::isS(dtype))
+                return fromFlatArray(flatArray);
+
+            auto sizeOfT = DataTypeUtils::sizeOf(dtype);
+            auto bytes = shape::length(shapeInfo.data()) * sizeOfT;
+            auto data = flatArray->buffer()->data();
+
+            bool nativeOrder = ByteOrderUtils::fromFlatByteOrder(flatArray->byteOrder()) == BitwiseUtils::asByteOrder();
+            bool aligned = reinterpret_cast<uintptr_t>(data) % sizeOfT == 0;
+            if (!nativeOrder || !aligned || (Nd4jLong) flatArray->buffer()->size() < bytes || !mapping->contains(data, bytes))
+                return fromFlatArray(flatArray);
+
+            // buffer points straight into the mapping, and keeps it alive as long as any array uses it
+            std::shared_ptr<DataBuffer> buffer(new DataBuffer(const_cast<int8_t *>(data), (size_t) bytes, dtype, false), [mapping](DataBuffer *b) { delete b; });
+            if (mapping->isMapped())
+                buffer->setPrimaryReadOnly();
+
+            return new NDArray(buffer, ShapeDescriptor(shapeInfo.data(), dtype), sd::LaunchContext::defaultContext());
+        }
+
         flatbuffers::Offset<FlatArray> FlatUtils::toFlatArray(flatbuffers::FlatBufferBuilder &builder, NDArray &array) {
             auto byteVector = array.asByteVector();
 
@@ -147,5 +147,18 @@ namespace sd {
         GraphProfile* FlowPath::profile() {
             return &_profile;
         }
+
+        void FlowPath::attachArena(MemoryPlan *plan, std::shared_ptr<DataBuffer> arena) {
+            _memoryPlan = plan;
+            _arena = arena;
+        }
+
+        MemoryPlan* FlowPath::memoryPlan() {
+            return _memoryPlan;
+        }
+
+        std::shared_ptr<DataBuffer> FlowPath::arena() {
+            return _arena;
+        }
     }
 }
\ No newline at end of file
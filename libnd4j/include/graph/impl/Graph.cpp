@@ -24,8 +24,12 @@
 #include <graph/FlatUtils.h>
 #include <legacy/NativeOps.h>
 #include <vector>
+#include <set>
+#include <algorithm>
 #include <helpers/ShapeUtils.h>
+#include <helpers/ConstantTadHelper.h>
 #include <ops/declarable/OpRegistrator.h>
+#include <ops/declarable/LegacyFusedOp.h>
 #include <graph/VariableProxy.h>
 #include <exceptions/graph_exception.h>
 #include <graph/exceptions/unresolved_input_exception.h>
@@ -227,6 +231,10 @@ namespace sd {
         }
 
         std::vector<Variable *> * Graph::fetchOutputs() {
+            return fetchOutputs(_variableSpace);
+        }
+
+        std::vector<Variable *> * Graph::fetchOutputs(VariableSpace *variableSpace) {
             auto res = new std::vector<Variable *>();
 
             nd4j_debug("Graph output size: %i\n", _output.size());
@@ -235,8 +243,8 @@ namespace sd {
                 nd4j_debug("Output node: %i\n", nodeId);
 
                 for (int e = 0; e < DataTypeUtils::max<int>(); e++) {
-                    if (_variableSpace->hasVariable(nodeId, e)) {
-                        res->push_back(_variableSpace->getVariable(nodeId, e));
+                    if (variableSpace->hasVariable(nodeId, e)) {
+                        res->push_back(variableSpace->getVariable(nodeId, e));
                     } else {
                         if (e == 0) {
                             throw unresolved_output_exception::build("Can't find output variable", nodeId, e);
@@ -299,6 +307,8 @@ namespace sd {
             for (auto v: _scopes)
                 delete v;
 
+            dropExecutionPlans();
+
             delete _mapped;
             delete _nodes;
             delete _variableSpace;
@@ -308,6 +318,7 @@ namespace sd {
 
         void Graph::addNode(Node *node) {
             _built.store(false);
+            dropExecutionPlans();
 
             if (node->opType() == OpType_LOGIC) {
                 // nd4j_debug("Adding LogicOp [%i]\n", node->opNum());
@@ -697,14 +708,173 @@ namespace sd {
                 }
             }
 
-            if (_unmapped.size() == 0)
+            if (_unmapped.size() == 0) {
                 _built.store(true);
 
+                // warming up TAD cache, so first execution doesn't have to build TadPacks
+                ConstantTadHelper::getInstance().precomputeTads(*this);
+            }
+
             prepareOutputs();
 
+            // chains are looked up once outputs are known, so intermediate results we're going to drop aren't graph outputs
+            if (_built.load() && Environment::getInstance().isElementwiseFusion())
+                fuseElementwiseChains();
+
             return sd::Status::OK();
         }
 
+        static bool fusedStepKind(Node *node, ops::helpers::FusedStepKind &kind) {
+            if (!node->hasCustomOp() || node->isScoped() || dynamic_cast<ops::LegacyFusedOp*>(node->getCustomOp()) != nullptr)
+                return false;
+
+            switch (node->opType()) {
+                case OpType_TRANSFORM_SAME:
+                    kind = ops::helpers::FUSED_TRANSFORM_SAME;
+                    return node->input()->size() == 1;
+                case OpType_TRANSFORM_FLOAT:
+                    kind = ops::helpers::FUSED_TRANSFORM_FLOAT;
+                    return node->input()->size() == 1;
+                case OpType_TRANSFORM_STRICT:
+                    kind = ops::helpers::FUSED_TRANSFORM_STRICT;
+                    return node->input()->size() == 1;
+                case OpType_SCALAR:
+                    // scalar given as second input isn't supported
+                    kind = ops::helpers::FUSED_SCALAR;
+                    return node->input()->size() == 1;
+                case OpType_PAIRWISE:
+                    kind = ops::helpers::FUSED_PAIRWISE;
+                    return node->input()->size() == 2;
+                default:
+                    return false;
+            }
+        }
+
+        void Graph::fuseElementwiseChains() {
+            if (hasControlFlow() || _configuration->_outputMode == OutputMode_VARIABLE_SPACE)
+                return;
+
+            // nodes removed from onion by previous fusion rounds are still mapped, so only onion is considered here
+            std::vector<Node*> nodes;
+            MAP_IMPL<int, int> consumers;
+            for (int l = 0; l < (int) _onion->size(); l++) {
+                if (_onion->count(l) == 0)
+                    continue;
+
+                for (auto node: *_onion->at(l)) {
+                    nodes.emplace_back(node);
+
+                    for (auto &p: *node->input())
+                        consumers[p.first]++;
+                }
+            }
+
+            MAP_IMPL<int, Node*> candidates;
+            for (auto node: nodes)
+                candidates[node->id()] = node;
+
+            // intermediate result is dropped, so nobody else may need it
+            auto isIntermediate = [&](int nodeId) -> bool {
+                if (candidates.count(nodeId) == 0 || consumers[nodeId] != 1)
+                    return false;
+
+                auto node = candidates[nodeId];
+                ops::helpers::FusedStepKind kind;
+                return fusedStepKind(node, kind) && !node->hasExternalOutputs() && !node->isInplace() && std::find(_output.begin(), _output.end(), nodeId) == _output.end();
+            };
+
+            std::set<int> visited;
+            std::set<Node*> dropped;
+            for (auto t = nodes.rbegin(); t != nodes.rend(); ++t) {
+                auto tail = *t;
+                ops::helpers::FusedStepKind kind;
+                if (visited.count(tail->id()) > 0 || !fusedStepKind(tail, kind))
+                    continue;
+
+                // walking from tail towards head of the chain
+                std::vector<Node*> chain = {tail};
+                visited.insert(tail->id());
+                while (true) {
+                    auto current = chain.back();
+                    Node *previous = nullptr;
+                    for (auto &p: *current->input()) {
+                        if (p.second == 0 && visited.count(p.first) == 0 && isIntermediate(p.first)) {
+                            previous = candidates[p.first];
+                            break;
+                        }
+                    }
+
+                    if (previous == nullptr)
+                        break;
+
+                    chain.emplace_back(previous);
+                    visited.insert(previous->id());
+                }
+
+                if (chain.size() < 2)
+                    continue;
+
+                std::reverse(chain.begin(), chain.end());
+
+                auto fused = new ops::LegacyFusedOp();
+                std::vector<std::pair<int, int>> inputs = {chain[0]->input()->at(0)};
+                for (int e = 0; e < (int) chain.size(); e++) {
+                    auto node = chain[e];
+                    fusedStepKind(node, kind);
+
+                    auto op = dynamic_cast<ops::LegacyOp*>(node->getCustomOp())->clone();
+                    auto prototype = node->getContextPrototype();
+                    std::vector<Nd4jLong> iArgs(prototype->getIArguments()->begin(), prototype->getIArguments()->end());
+
+                    if (kind == ops::helpers::FUSED_PAIRWISE) {
+                        // chain value might be either X or Y operand of pairwise op
+                        bool reversed = e > 0 && node->input()->at(0).first != chain[e - 1]->id();
+                        inputs.emplace_back(node->input()->at(reversed ? 0 : 1));
+                        fused->appendStep(kind, (int) node->opNum(), op, *prototype->getTArguments(), iArgs, (int) inputs.size() - 1, reversed);
+                    } else
+                        fused->appendStep(kind, (int) node->opNum(), op, *prototype->getTArguments(), iArgs);
+                }
+
+                nd4j_debug("Fusing %i elementwise nodes into Node_%i\n", (int) chain.size(), tail->id());
+
+                // tail keeps its id, so consumers of the chain don't change
+                if (tail->isDeductable())
+                    delete tail->getCustomOp();
+
+                tail->setCustomOp(fused);
+                tail->setDeductable(true);
+
+                // in-place tail would overwrite head input otherwise
+                tail->markInplace(false);
+
+                auto block = tail->getContextPrototype();
+                block->markInplace(false);
+                block->inputs()->clear();
+                tail->input()->clear();
+                for (auto &p: inputs) {
+                    block->pickInput(p);
+                    tail->pickInput(p);
+                }
+
+                for (int e = 0; e < (int) chain.size() - 1; e++)
+                    dropped.insert(chain[e]);
+            }
+
+            if (dropped.empty())
+                return;
+
+            // dropped nodes stay mapped, and are released along with the rest of the graph
+            for (int l = 0; l < (int) _onion->size(); l++) {
+                if (_onion->count(l) == 0)
+                    continue;
+
+                auto layer = _onion->at(l);
+                layer->erase(std::remove_if(layer->begin(), layer->end(), [&](Node *node) { return dropped.count(node) > 0; }), layer->end());
+            }
+
+            dropExecutionPlans();
+        }
+
         void Graph::tagInplaceNodes() {
             // just calling, in case it wasn't built before
             if (!_built.load())
@@ -865,7 +1035,11 @@ namespace sd {
             }
         }
 
-        Graph::Graph(const FlatGraph *flatGraph, VariableSpace *variableSpace) {
+        Graph::Graph(const FlatGraph *flatGraph, VariableSpace *variableSpace) : Graph(flatGraph, variableSpace, nullptr) {
+            //
+        }
+
+        Graph::Graph(const FlatGraph *flatGraph, VariableSpace *variableSpace, const std::shared_ptr<MappedFile> &mapping) {
             this->_onion = new MAP_IMPL<int, std::vector<Node *> *>();
             this->_mapped = new MAP_IMPL<int, Node *> ();
             this->_nodes = new std::vector<int>();
@@ -892,7 +1066,7 @@ namespace sd {
                 for (unsigned int e = 0; e < flatGraph->variables()->size(); e++) {
                     auto flatVar = flatGraph->variables()->Get(e);
 
-                    auto var = new Variable(flatVar);
+                    auto var = new Variable(flatVar, mapping);
                     std::pair<int, int> pair(flatVar->id()->first(), flatVar->id()->second());
                     _variableSpace->putVariable(pair, var);
 
@@ -1281,10 +1455,13 @@ namespace sd {
         }
 
         void Graph::forgetVariableSpace() {
+            dropExecutionPlans();
             _variableSpace = nullptr;
         }
 
         void Graph::replaceState(VariableSpace *state, ExecutorConfiguration *configuration) {
+            dropExecutionPlans();
+
             delete _variableSpace;
             delete _configuration;
 
@@ -1296,6 +1473,7 @@ namespace sd {
             auto clone = new Graph();
 
             clone->replaceState(new VariableProxy(this->_variableSpace), this->_configuration->clone());
+            clone->_memoryPlan = _memoryPlan;
 
             // transfer nodes
             for (int e = 0; e < _nodes->size(); e++)
@@ -1347,6 +1525,7 @@ namespace sd {
             auto clone = new Graph();
 
             clone->replaceState(this->_variableSpace->clone(), this->_configuration->clone());
+            clone->_memoryPlan = _memoryPlan;
 
             // transfer nodes
             for (int e = 0; e < _nodes->size(); e++)
@@ -1406,6 +1585,60 @@ namespace sd {
             return _mappedScopes.count(id) > 0;
         }
 
+        bool Graph::hasControlFlow() {
+            if (!_scopes.empty())
+                return true;
+
+            for (auto &v: *_mapped)
+                if (v.second->opType() == OpType_LOGIC || v.second->hasGraphEmbedded())
+                    return true;
+
+            return false;
+        }
+
+        MemoryPlan* Graph::memoryPlan() {
+            return _memoryPlan.get();
+        }
+
+        // plans are compiled only for graphs executed more than once, either directly or via request-local proxies
+        static const int MAX_EXECUTION_PLANS = 8;
+
+        ExecutionPlan* Graph::executionPlan(VariableSpace *variableSpace) {
+            std::lock_guard<std::mutex> lock(_mutexPlans);
+            for (auto plan: _executionPlans)
+                if (plan->matches(*variableSpace))
+                    return plan;
+
+            return nullptr;
+        }
+
+        void Graph::compileExecutionPlan(VariableSpace *variableSpace) {
+            std::lock_guard<std::mutex> lock(_mutexPlans);
+            if (!_compilable || _executionPlans.size() >= MAX_EXECUTION_PLANS)
+                return;
+
+            if (++_unplannedExecutions < 2)
+                return;
+
+            auto plan = ExecutionPlan::compile(*this, *variableSpace);
+            if (plan == nullptr) {
+                _compilable = false;
+                return;
+            }
+
+            _executionPlans.emplace_back(plan);
+        }
+
+        void Graph::dropExecutionPlans() {
+            std::lock_guard<std::mutex> lock(_mutexPlans);
+            for (auto plan: _executionPlans)
+                delete plan;
+
+            _executionPlans.clear();
+            _unplannedExecutions = 0;
+            _compilable = true;
+        }
+
         Nd4jLong Graph::hashCode() {
             if (!_built.load())
                 this->buildGraph();
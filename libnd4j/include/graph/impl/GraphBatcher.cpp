@@ -0,0 +1,340 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// @author raver119@gmail.com
+//
+
+#include <graph/GraphBatcher.h>
+#include <graph/GraphHolder.h>
+#include <graph/ExecutionResult.h>
+#include <exceptions/no_results_exception.h>
+
+namespace sd {
+    namespace graph {
+        GraphBatcher::GraphBatcher(int maxBatchSize, Nd4jLong maxDelay) {
+            if (maxBatchSize < 1)
+                throw std::runtime_error("GraphBatcher: maxBatchSize must be positive");
+
+            if (maxDelay < 0)
+                throw std::runtime_error("GraphBatcher: maxDelay can't be negative");
+
+            _maxBatchSize = maxBatchSize;
+            _maxDelay = maxDelay;
+
+            _batchSizes.resize(maxBatchSize + 1, 0L);
+            _queueTimes.resize(QUEUE_TIME_BUCKETS, 0L);
+        }
+
+        int GraphBatcher::maxBatchSize() {
+            return _maxBatchSize;
+        }
+
+        Nd4jLong GraphBatcher::maxDelay() {
+            return _maxDelay;
+        }
+
+        GraphBatcher::Queue& GraphBatcher::queue(Nd4jLong graphId) {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            auto &q = _queues[graphId];
+            if (q == nullptr)
+                q.reset(new Queue());
+
+            return *q;
+        }
+
+        bool GraphBatcher::compatible(Request *a, Request *b) {
+            if (a->inputs.empty() || a->inputs.size() != b->inputs.size())
+                return false;
+
+            // all inputs of a request must share the same batch size
+            Nd4jLong na = -1;
+            Nd4jLong nb = -1;
+            for (int e = 0; e < (int) a->inputs.size(); e++) {
+                auto va = a->inputs[e].get();
+                auto vb = b->inputs[e].get();
+
+                if (va->id() != vb->id() || va->index() != vb->index() || *va->getName() != *vb->getName())
+                    return false;
+
+                if (!va->hasNDArray() || !vb->hasNDArray())
+                    return false;
+
+                auto x = va->getNDArray();
+                auto y = vb->getNDArray();
+                if (x->dataType() != y->dataType() || x->rankOf() != y->rankOf() || x->rankOf() == 0 || x->isEmpty() || y->isEmpty() || x->isS())
+                    return false;
+
+                for (int d = 1; d < x->rankOf(); d++)
+                    if (x->sizeAt(d) != y->sizeAt(d))
+                        return false;
+
+                if (na < 0) {
+                    na = x->sizeAt(0);
+                    nb = y->sizeAt(0);
+                } else if (x->sizeAt(0) != na || y->sizeAt(0) != nb) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        void GraphBatcher::fail(std::vector<Request*> &batch, std::exception_ptr error) {
+            for (auto r: batch) {
+                for (auto v: r->outputs)
+                    delete v;
+
+                r->outputs.clear();
+                r->error = error;
+            }
+        }
+
+        flatbuffers::Offset<FlatResult> GraphBatcher::execute(Nd4jLong graphId, flatbuffers::FlatBufferBuilder &builder, const FlatInferenceRequest* request) {
+            std::vector<Variable*> inputs;
+            if (request != nullptr && request->variables() != nullptr) {
+                auto vars = request->variables();
+                for (int e = 0; e < (int) vars->size(); e++)
+                    inputs.emplace_back(new Variable(vars->Get(e)));
+            }
+
+            auto outputs = execute(graphId, inputs);
+            if (outputs.empty())
+                throw no_results_exception(graphId);
+
+            ExecutionResult result;
+            for (auto v: outputs)
+                result.emplace_back(v);
+
+            auto t = result.asFlatResult(builder);
+
+            for (auto v: outputs)
+                delete v;
+
+            return t;
+        }
+
+        std::vector<Variable*> GraphBatcher::execute(Nd4jLong graphId, const std::vector<Variable*> &inputs) {
+            Request request;
+            for (auto v: inputs)
+                request.inputs.emplace_back(v);
+
+            request.enqueued = std::chrono::steady_clock::now();
+
+            auto &q = queue(graphId);
+            std::unique_lock<std::mutex> lock(q.mutex);
+            q.pending.emplace_back(&request);
+            q.condition.notify_all();
+
+            while (!request.done) {
+                if (q.leader) {
+                    q.condition.wait(lock);
+                    continue;
+                }
+
+                // nobody is collecting a batch right now, so this thread does, even if its own request isn't in front
+                q.leader = true;
+
+                auto deadline = q.pending.front()->enqueued + std::chrono::microseconds(_maxDelay);
+                q.condition.wait_until(lock, deadline, [&] { return (int) q.pending.size() >= _maxBatchSize; });
+
+                std::vector<Request*> batch;
+                auto front = q.pending.front();
+                batch.emplace_back(front);
+                q.pending.pop_front();
+
+                for (auto it = q.pending.begin(); it != q.pending.end() && (int) batch.size() < _maxBatchSize; ) {
+                    if (compatible(front, *it)) {
+                        batch.emplace_back(*it);
+                        it = q.pending.erase(it);
+                    } else
+                        it++;
+                }
+
+                lock.unlock();
+                try {
+                    executeBatch(graphId, batch);
+                } catch (...) {
+                    // every request of the batch must be completed, otherwise its thread would wait forever
+                    fail(batch, std::current_exception());
+                }
+                lock.lock();
+
+                for (auto r: batch)
+                    r->done = true;
+
+                q.leader = false;
+                q.condition.notify_all();
+            }
+
+            lock.unlock();
+
+            if (request.error)
+                std::rethrow_exception(request.error);
+
+            return request.outputs;
+        }
+
+        void GraphBatcher::executeSingle(Nd4jLong graphId, Request *request) {
+            try {
+                // GraphHolder takes ownership of inputs
+                std::vector<Variable*> inputs;
+                for (auto &v: request->inputs)
+                    inputs.emplace_back(v.release());
+
+                request->inputs.clear();
+
+                request->outputs = GraphHolder::getInstance().execute(graphId, inputs);
+            } catch (...) {
+                request->error = std::current_exception();
+            }
+        }
+
+        void GraphBatcher::executeBatch(Nd4jLong graphId, std::vector<Request*> &batch) {
+            auto started = std::chrono::steady_clock::now();
+            {
+                std::lock_guard<std::mutex> lock(_mutexStats);
+                _batchSizes[batch.size()]++;
+
+                for (auto r: batch) {
+                    auto us = std::chrono::duration_cast<std::chrono::microseconds>(started - r->enqueued).count();
+                    int bucket = 0;
+                    while (bucket < QUEUE_TIME_BUCKETS - 1 && (1LL << bucket) <= us)
+                        bucket++;
+
+                    _queueTimes[bucket]++;
+                }
+            }
+
+            if (batch.size() == 1) {
+                executeSingle(graphId, batch.front());
+                return;
+            }
+
+            std::vector<Nd4jLong> sizes;
+            Nd4jLong total = 0;
+            for (auto r: batch) {
+                sizes.emplace_back(r->inputs.front()->getNDArray()->sizeAt(0));
+                total += sizes.back();
+            }
+
+            std::vector<std::unique_ptr<Variable>> outputs;
+            try {
+                // concatenating inputs along dimension 0
+                std::vector<std::unique_ptr<Variable>> inputs;
+                auto front = batch.front();
+                for (int e = 0; e < (int) front->inputs.size(); e++) {
+                    auto proto = front->inputs[e].get();
+                    auto rank = proto->getNDArray()->rankOf();
+
+                    auto shape = proto->getNDArray()->getShapeAsVector();
+                    shape[0] = total;
+
+                    std::unique_ptr<NDArray> array(new NDArray('c', shape, proto->getNDArray()->dataType()));
+
+                    Nd4jLong from = 0;
+                    for (int r = 0; r < (int) batch.size(); r++) {
+                        std::vector<Nd4jLong> idx(2 * rank, 0);
+                        idx[0] = from;
+                        idx[1] = from + sizes[r];
+
+                        auto view = (*array)(idx, true);
+                        view.assign(batch[r]->inputs[e]->getNDArray());
+
+                        from += sizes[r];
+                    }
+
+                    inputs.emplace_back(new Variable(array.get(), proto->getName()->c_str(), proto->id(), proto->index()));
+                    array.release();
+                }
+
+                // GraphHolder takes ownership of inputs
+                std::vector<Variable*> released;
+                for (auto &v: inputs)
+                    released.emplace_back(v.release());
+
+                for (auto v: GraphHolder::getInstance().execute(graphId, released))
+                    outputs.emplace_back(v);
+            } catch (...) {
+                fail(batch, std::current_exception());
+                return;
+            }
+
+            // outputs without batch dimension (i.e. reductions over the whole batch) can't be split back
+            bool splittable = !outputs.empty();
+            for (auto &v: outputs)
+                if (!v->hasNDArray() || v->getNDArray()->rankOf() == 0 || v->getNDArray()->sizeAt(0) != total)
+                    splittable = false;
+
+            if (!splittable) {
+                outputs.clear();
+
+                for (auto r: batch)
+                    executeSingle(graphId, r);
+
+                return;
+            }
+
+            try {
+                Nd4jLong from = 0;
+                for (int r = 0; r < (int) batch.size(); r++) {
+                    for (auto &v: outputs) {
+                        auto array = v->getNDArray();
+
+                        std::vector<Nd4jLong> idx(2 * array->rankOf(), 0);
+                        idx[0] = from;
+                        idx[1] = from + sizes[r];
+
+                        auto view = (*array)(idx, true);
+                        std::unique_ptr<NDArray> slice(new NDArray(view.dup()));
+                        batch[r]->outputs.emplace_back(new Variable(slice.get(), v->getName()->c_str(), v->id(), v->index()));
+                        slice.release();
+                    }
+
+                    from += sizes[r];
+                }
+            } catch (...) {
+                fail(batch, std::current_exception());
+            }
+        }
+
+        std::vector<Nd4jLong> GraphBatcher::batchSizeHistogram() {
+            std::lock_guard<std::mutex> lock(_mutexStats);
+            return _batchSizes;
+        }
+
+        std::vector<Nd4jLong> GraphBatcher::queueTimeHistogram() {
+            std::lock_guard<std::mutex> lock(_mutexStats);
+            return _queueTimes;
+        }
+
+        void GraphBatcher::printOut() {
+            auto batchSizes = batchSizeHistogram();
+            auto queueTimes = queueTimeHistogram();
+
+            nd4j_printf("Batch sizes:\n", "");
+            for (int e = 1; e < (int) batchSizes.size(); e++)
+                if (batchSizes[e] > 0)
+                    nd4j_printf("  %3i: %lld\n", e, batchSizes[e]);
+
+            nd4j_printf("Queue time, us:\n", "");
+            for (int e = 0; e < (int) queueTimes.size(); e++)
+                if (queueTimes[e] > 0)
+                    nd4j_printf("  < %lld: %lld\n", 1LL << e, queueTimes[e]);
+        }
+    }
+}
@@ -55,6 +55,10 @@
 #include <exceptions/graph_execution_exception.h>
 #include <exceptions/no_results_exception.h>
 #include <graph/FlatUtils.h>
+#include <graph/MemoryPlan.h>
+#include <graph/ExecutionPlan.h>
+#include <graph/MappedFile.h>
+#include <execution/Threads.h>
 
 namespace sd{
 namespace graph {
@@ -199,6 +203,148 @@ namespace graph {
 }
 
 
+/**
+ * This method checks if given node should be skipped, and marks it inactive if so. We can skip node in two cases:
+ * 1) If previous node was disabled
+ * 2) If previous node was divergent node (i.e. IF op) and code went other way
+ */
+static bool hasInactiveInputs(Graph *graph, Node *node, FlowPath *flowPath) {
+    for (int e = 0; e < node->input()->size(); e++) {
+        auto inputId = node->input()->at(e);
+
+        // not a node. skipping checks
+        if (graph->getMapped()->count(inputId.first) == 0)
+            continue;
+
+        Node *prevNode = graph->getMapped()->at(inputId.first);
+        if (!flowPath->isNodeActive(inputId.first)) {
+            flowPath->markNodeActive(node->id(), false);
+
+            nd4j_debug("Skipping Node_%i due to inactive input [%i]\n", node->id(), inputId.first);
+            return true;
+
+        } else if (prevNode->isDivergencePoint()) { // literally checking for switch here
+            if (flowPath->branch(inputId.first) != inputId.second) {
+                flowPath->markNodeActive(node->id(), false);
+                nd4j_debug("Skipping Node_%i due to divergent branch [%i]\n", node->id(), inputId.first);
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+/**
+ * This method checks if two nodes of the same layer can't be executed concurrently: in-place node writes into its inputs,
+ * so nobody else is allowed to touch them at the same time
+ */
+static bool conflicts(Node *a, Node *b) {
+    if (!a->isInplace() && !b->isInplace())
+        return false;
+
+    for (auto &p: *a->input())
+        for (auto &q: *b->input())
+            if (p == q)
+                return true;
+
+    return false;
+}
+
+Nd4jStatus GraphExecutioner::executeLayer(Graph *graph, std::vector<Node*> *layer, VariableSpace *variableSpace) {
+    auto flowPath = variableSpace->flowPath();
+
+    // FlowPath isn't thread-safe, so node states are updated before and after concurrent part
+    std::vector<Node*> pending;
+    for (auto node: *layer) {
+        if (hasInactiveInputs(graph, node, flowPath))
+            continue;
+
+        flowPath->markNodeActive(node->id(), true);
+        pending.emplace_back(node);
+    }
+
+    std::vector<Node*> wave;
+    std::vector<Nd4jStatus> statuses;
+    std::vector<Nd4jLong> times;
+    const int maxThreads = sd::Environment::getInstance().maxMasterThreads();
+
+    while (!pending.empty()) {
+        // onion might put a node into the same layer as some of its inputs, so layer is split into waves of nodes
+        // that depend neither on each other, nor on nodes left for later. original order is kept for conflicting nodes
+        wave.clear();
+        std::vector<Node*> rest;
+        for (auto node: pending) {
+            bool ready = true;
+            for (auto &p: *node->input()) {
+                for (auto other: pending) {
+                    if (other != node && other->id() == p.first) {
+                        ready = false;
+                        break;
+                    }
+                }
+
+                if (!ready)
+                    break;
+            }
+
+            for (int e = 0; ready && e < (int) rest.size(); e++)
+                if (conflicts(node, rest[e]))
+                    ready = false;
+
+            for (int e = 0; ready && e < (int) wave.size(); e++)
+                if (conflicts(node, wave[e]))
+                    ready = false;
+
+            if (ready)
+                wave.emplace_back(node);
+            else
+                rest.emplace_back(node);
+        }
+
+        if (wave.empty())
+            return Status::THROW("GraphExecutioner: circular dependency within layer");
+
+        const auto numNodes = (int) wave.size();
+        statuses.assign(numNodes, Status::OK());
+        times.assign(numNodes, 0L);
+
+        // cores are split between concurrent nodes, so their own parallel loops don't oversubscribe them
+        const int budget = sd::math::nd4j_max<int>(1, maxThreads / numNodes);
+
+        auto func = PRAGMA_THREADS_DO {
+            for (auto e = thread_id; e < (uint64_t) numNodes; e += numThreads) {
+                samediff::ThreadsLimit limit(budget);
+
+                auto timeStart = std::chrono::system_clock::now();
+                statuses[e] = executeFlatNode(graph, wave[e], variableSpace);
+                auto timeEnd = std::chrono::system_clock::now();
+
+                times[e] = std::chrono::duration_cast<std::chrono::nanoseconds>(timeEnd - timeStart).count();
+            }
+        };
+
+        if (numNodes > 1) {
+            ConcurrentAccessGuard guard(*variableSpace);
+            samediff::Threads::parallel_do(func, numNodes);
+        } else
+            func(0, 1);
+
+        for (int e = 0; e < numNodes; e++) {
+            flowPath->setOuterTime(wave[e]->id(), times[e]);
+
+            if (statuses[e] != Status::OK())
+                return statuses[e];
+
+            flowPath->markExecuted(wave[e]->id(), true);
+        }
+
+        pending = rest;
+    }
+
+    return Status::OK();
+}
+
 /**
  * This method executes given Graph instance, and returns error code.
  *
@@ -227,13 +373,48 @@ Nd4jStatus GraphExecutioner::execute(Graph *graph, VariableSpace* variableSpace)
         }
     }
 
+    // repeated executions with the same input shapes go through compiled plan instead of onion traversal
+    auto executionPlan = Environment::getInstance().isProfiling() || Environment::getInstance().isDebugAndVerbose() ? nullptr : graph->executionPlan(__variableSpace);
+    if (executionPlan != nullptr) {
+        auto status = executionPlan->execute(*__variableSpace);
+
+        if (status == Status::OK() && __variableSpace->launchContext()->getWorkspace() != nullptr) {
+            auto m = __variableSpace->launchContext()->getWorkspace()->getAllocatedSize();
+            sd::memory::MemoryRegistrator::getInstance().setGraphMemoryFootprintIfGreater(graph->hashCode(), m);
+        }
+
+        if (tempFlow) {
+            delete flowPath;
+            __variableSpace->setFlowPath(nullptr);
+        }
+
+        return status;
+    }
+
+    // intermediate variables are placed within single arena, once previous execution allowed to plan them
+    struct ArenaGuard {
+        FlowPath *flowPath;
+        ~ArenaGuard() {
+            if (flowPath != nullptr)
+                flowPath->attachArena(nullptr, nullptr);
+        }
+    } arenaGuard{nullptr};
+
+    auto memoryPlan = graph->memoryPlan();
+    const bool planMemory = Environment::getInstance().isCPU() && Environment::getInstance().isMemoryPlanning();
+    if (planMemory && memoryPlan->arenaSize() > 0 && flowPath->memoryPlan() == nullptr) {
+        flowPath->attachArena(memoryPlan, memoryPlan->createArena());
+        arenaGuard.flowPath = flowPath;
+    }
+
     // optionally saving graph build time
     if (Environment::getInstance().isProfiling())
         flowPath->profile()->setBuildTime(GraphProfile::relativeTime(tb0));
 
     Nd4jLong timeStart = Environment::getInstance().isProfiling() ? GraphProfile::currentTime() : 0L;
 
-    bool pe = graph->getExecutorConfiguration()->_executionMode == ExecutionMode_AUTO;
+    // in AUTO mode independent nodes within a layer are executed concurrently, unless we're profiling or debugging
+    bool pe = graph->getExecutorConfiguration()->_executionMode == ExecutionMode_AUTO && !Environment::getInstance().isProfiling() && !Environment::getInstance().isDebugAndVerbose();
 
 
     // basically if at some point code diverges, code branch might be _DISABLED_, and all nodes within that branch will be disabled as well
@@ -249,6 +430,30 @@ Nd4jStatus GraphExecutioner::execute(Graph *graph, VariableSpace* variableSpace)
     for (int l = 0; l < (int) graph->getOnion()->size(); l++) {
         int layerSize = graph->getOnion()->count(l) == 1 ? graph->getOnion()->at(l)->size() : 0;
 
+        // loops need sequential execution, since Enter/Exit/NextIteration change execution position
+        if (pe && layerSize > 1 && frames.empty()) {
+            auto layer = graph->getOnion()->at(l);
+
+            bool concurrent = true;
+            for (auto node: *layer)
+                if (node->opType() == OpType_LOGIC || node->hasGraphEmbedded()) {
+                    concurrent = false;
+                    break;
+                }
+
+            if (concurrent) {
+                exec_counter += layerSize;
+                if (exec_counter > 10000)
+                    return Status::THROW("Early termination hit");
+
+                auto status = executeLayer(graph, layer, __variableSpace);
+                if (status != Status::OK())
+                    return status;
+
+                continue;
+            }
+        }
+
         int n = 0;
 // this omp block will probably never be the case
         for (; n < layerSize; n++) {
@@ -301,36 +506,7 @@ Nd4jStatus GraphExecutioner::execute(Graph *graph, VariableSpace* variableSpace)
 
                 } else {
                     // let's check for input nodes, if they are disabled or contain divergents
-                    for (int e = 0; e < node->input()->size(); e++) {
-                        auto inputId = node->input()->at(e);
-
-                        // not a node. skipping checks
-                        if (graph->getMapped()->count(inputId.first) == 0)
-                            continue;
-
-                        /**
-                         * We can skip current node, in two cases:
-                         * 1) If previous node was disabled
-                         * 2) If previous node was divergent node (i.e. IF op) and code went other way
-                         */
-                        Node *prevNode = graph->getMapped()->at(inputId.first);
-                        if (!flowPath->isNodeActive(inputId.first)) {
-                            shouldSkip = true;
-                            flowPath->markNodeActive(node->id(), false);
-
-                            nd4j_debug("Skipping Node_%i due to inactive input [%i]\n", node->id(), inputId.first);
-                            break;
-
-                        } else if (prevNode->isDivergencePoint()) { // literally checking for switch here
-                            if (flowPath->branch(inputId.first) != inputId.second) {
-                                shouldSkip = true;
-                                flowPath->markNodeActive(node->id(), false);
-                                nd4j_debug("Skipping Node_%i due to divergent branch [%i]\n", node->id(),
-                                           inputId.first);
-                                break;
-                            }
-                        }
-                    }
+                    shouldSkip = hasInactiveInputs(graph, node, flowPath);
                 }
 
                 if (shouldSkip)
@@ -487,6 +663,17 @@ Nd4jStatus GraphExecutioner::execute(Graph *graph, VariableSpace* variableSpace)
         //flowPath->profile().printOut();
     }
 
+    // arena is released with the last planned array, and plan is built after first successful execution
+    if (arenaGuard.flowPath != nullptr) {
+        flowPath->attachArena(nullptr, nullptr);
+        arenaGuard.flowPath = nullptr;
+    } else if (planMemory && memoryPlan->isPlannable() && !memoryPlan->isReady()) {
+        memoryPlan->build(*graph, *__variableSpace);
+    }
+
+    if (!Environment::getInstance().isProfiling())
+        graph->compileExecutionPlan(__variableSpace);
+
     // saving memory footprint for current run
     if (__variableSpace->launchContext()->getWorkspace() != nullptr) {
         auto m = __variableSpace->launchContext()->getWorkspace()->getAllocatedSize();
@@ -847,8 +1034,11 @@ uint8_t* readFlatBuffers(const char * filename) {
 }
 
 flatbuffers::Offset<FlatResult> GraphExecutioner::execute(Graph *graph, flatbuffers::FlatBufferBuilder &builder, const FlatInferenceRequest* request) {
+    return execute(graph, graph->getVariableSpace(), builder, request);
+}
+
+flatbuffers::Offset<FlatResult> GraphExecutioner::execute(Graph *graph, VariableSpace *varSpace, flatbuffers::FlatBufferBuilder &builder, const FlatInferenceRequest* request) {
     ExecutionResult result;
-    auto varSpace = graph->getVariableSpace();
 
     if (request != nullptr && request->variables() != nullptr) {
         auto vars = request->variables();
@@ -862,11 +1052,11 @@ flatbuffers::Offset<FlatResult> GraphExecutioner::execute(Graph *graph, flatbuff
     if (Environment::getInstance().isDebugAndVerbose())
         graph->printOut();
 
-    auto status = GraphExecutioner::execute(graph);
+    auto status = GraphExecutioner::execute(graph, varSpace);
     if (status != sd::Status::OK())
         throw graph_execution_exception(request->id());
 
-    auto outputs = graph->fetchOutputs();
+    auto outputs = graph->fetchOutputs(varSpace);
 
     if (outputs->size() == 0)
         throw no_results_exception(request->id());
@@ -896,6 +1086,18 @@ flatbuffers::Offset<FlatResult> GraphExecutioner::execute(Graph *graph, flatbuff
             return restoredGraph;
         }
 
+        Graph* GraphExecutioner::importFromMappedFlatBuffers(const char *filename) {
+            auto mapping = std::make_shared<MappedFile>(filename);
+
+            flatbuffers::Verifier verifier(mapping->data(), (size_t) mapping->length());
+            if (!VerifyFlatGraphBuffer(verifier))
+                throw std::runtime_error("FlatBuffers file is malformed");
+
+            // mapping itself is released together with the last array referencing it
+            auto fg = GetFlatGraph(mapping->data());
+            return new Graph(fg, nullptr, mapping);
+        }
+
         Graph *GraphExecutioner::importFromFlatPointer(Nd4jPointer ptr) {
             auto fg = GetFlatGraph(reinterpret_cast<uint8_t *>(ptr));
             auto restoredGraph = new Graph(fg);
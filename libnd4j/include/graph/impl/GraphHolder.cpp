@@ -20,8 +20,11 @@
 
 #include <graph/GraphHolder.h>
 #include <graph/GraphExecutioner.h>
+#include <graph/VariableProxy.h>
 #include <exceptions/graph_exists_exception.h>
 #include <exceptions/graph_execution_exception.h>
+#include <graph/Status.h>
+#include <memory>
 
 namespace sd {
     namespace graph {
@@ -110,19 +113,72 @@ namespace sd {
 
 
 
-        flatbuffers::Offset<FlatResult> GraphHolder::execute(Nd4jLong graphId, flatbuffers::FlatBufferBuilder &builder, const FlatInferenceRequest* request) {
+        void GraphHolder::executeShared(Nd4jLong graphId, const std::function<void(Graph*, VariableSpace*)> &func) {
             if (!hasGraph(graphId))
                 throw unknown_graph_exception(graphId);
 
+            // building graph mutates it, so that's done once, before any concurrent request
+            auto graph = pullGraph(graphId);
+            if (!graph->built()) {
+                lockWrite(graphId);
+                try {
+                    if (!graph->built())
+                        graph->buildGraph();
+                } catch (...) {
+                    unlockWrite(graphId);
+                    throw;
+                }
+                unlockWrite(graphId);
+            }
+
             lockRead(graphId);
 
-            auto graph = cloneGraph(graphId);
-            auto res = GraphExecutioner::execute(graph, builder, request);
-            delete graph;
+            try {
+                if (graph->hasControlFlow()) {
+                    // logic ops work with VariableSpace of the graph itself, so request needs its own copy of the graph
+                    std::unique_ptr<Graph> clone(cloneGraph(graphId));
+                    func(clone.get(), clone->getVariableSpace());
+                } else {
+                    // topology and weights are shared, request inputs and activations live within proxy only
+                    VariableProxy proxy(graph->getVariableSpace(), graph->getMapped());
+                    func(graph, &proxy);
+                }
+            } catch (...) {
+                unlockRead(graphId);
+                throw;
+            }
 
             unlockRead(graphId);
+        }
+
+        flatbuffers::Offset<FlatResult> GraphHolder::execute(Nd4jLong graphId, flatbuffers::FlatBufferBuilder &builder, const FlatInferenceRequest* request) {
+            flatbuffers::Offset<FlatResult> res;
+
+            executeShared(graphId, [&](Graph *graph, VariableSpace *variableSpace) {
+                res = GraphExecutioner::execute(graph, variableSpace, builder, request);
+            });
 
             return res;
         }
+
+        std::vector<Variable*> GraphHolder::execute(Nd4jLong graphId, const std::vector<Variable*> &inputs) {
+            std::vector<Variable*> result;
+
+            executeShared(graphId, [&](Graph *graph, VariableSpace *variableSpace) {
+                for (auto v: inputs)
+                    variableSpace->replaceVariable(v);
+
+                auto status = GraphExecutioner::execute(graph, variableSpace);
+                if (status != Status::OK())
+                    throw graph_execution_exception(graphId);
+
+                // outputs live within request-local VariableSpace, so they're copied out
+                std::unique_ptr<std::vector<Variable*>> outputs(graph->fetchOutputs(variableSpace));
+                for (auto v: *outputs)
+                    result.emplace_back(v->clone());
+            });
+
+            return result;
+        }
     }
 }
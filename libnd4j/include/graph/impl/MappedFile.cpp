@@ -0,0 +1,102 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// @author raver119@gmail.com
+//
+
+#include <graph/MappedFile.h>
+#include <helpers/logger.h>
+#include <stdexcept>
+#include <fstream>
+
+#if !defined(_WIN32) && !defined(_WIN64)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace sd {
+    namespace graph {
+        MappedFile::MappedFile(const char *fileName) {
+#if defined(_WIN32) || defined(_WIN64)
+            std::ifstream in(fileName, std::ios::binary | std::ios::ate);
+            if (!in.is_open()) {
+                nd4j_printf("File [%s] wasn't found. Please check path and permissions\n", fileName);
+                throw std::runtime_error("File not found");
+            }
+
+            _length = (Nd4jLong) in.tellg();
+            _data = new uint8_t[_length];
+
+            in.seekg(0, std::ios::beg);
+            in.read(reinterpret_cast<char *>(_data), _length);
+#else
+            int fd = open(fileName, O_RDONLY);
+            if (fd < 0) {
+                nd4j_printf("File [%s] wasn't found. Please check path and permissions\n", fileName);
+                throw std::runtime_error("File not found");
+            }
+
+            struct stat st;
+            if (fstat(fd, &st) != 0 || st.st_size == 0) {
+                close(fd);
+                throw std::runtime_error("MappedFile: unable to get file size");
+            }
+
+            _length = (Nd4jLong) st.st_size;
+
+            // mapping is read-only: arrays pointing into it are copied into own memory before the first write
+            auto ptr = mmap(nullptr, (size_t) _length, PROT_READ, MAP_PRIVATE, fd, 0);
+
+            // mapping stays valid after descriptor is closed
+            close(fd);
+
+            if (ptr == MAP_FAILED)
+                throw std::runtime_error("MappedFile: mmap failed");
+
+            _data = reinterpret_cast<uint8_t *>(ptr);
+            _mapped = true;
+#endif
+        }
+
+        MappedFile::~MappedFile() {
+#if defined(_WIN32) || defined(_WIN64)
+            delete[] _data;
+#else
+            munmap(_data, (size_t) _length);
+#endif
+        }
+
+        const uint8_t* MappedFile::data() const {
+            return _data;
+        }
+
+        Nd4jLong MappedFile::length() {
+            return _length;
+        }
+
+        bool MappedFile::contains(const void *ptr, Nd4jLong bytes) {
+            auto p = reinterpret_cast<const uint8_t *>(ptr);
+            return p >= _data && bytes >= 0 && p + bytes <= _data + _length;
+        }
+
+        bool MappedFile::isMapped() {
+            return _mapped;
+        }
+    }
+}
@@ -0,0 +1,286 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// @author raver119@gmail.com
+//
+
+#include <graph/MemoryPlan.h>
+#include <graph/Graph.h>
+#include <graph/VariableSpace.h>
+#include <array/DataTypeUtils.h>
+#include <algorithm>
+#include <set>
+
+namespace sd {
+    namespace graph {
+        // every slot starts at this alignment, so offset is always a multiple of element size
+        static const Nd4jLong SLOT_ALIGNMENT = 64;
+
+        MemoryPlan::MemoryPlan() : _state(0) {
+            //
+        }
+
+        bool MemoryPlan::isReady() {
+            return _state.load(std::memory_order_acquire) > 0;
+        }
+
+        bool MemoryPlan::isPlannable() {
+            return _state.load(std::memory_order_acquire) >= 0;
+        }
+
+        Nd4jLong MemoryPlan::arenaSize() {
+            return isReady() ? _arenaSize : 0L;
+        }
+
+        Nd4jLong MemoryPlan::plannedBytes() {
+            return isReady() ? _plannedBytes : 0L;
+        }
+
+        int MemoryPlan::numberOfSlots() {
+            return isReady() ? (int) _slots.size() : 0;
+        }
+
+        bool MemoryPlan::hasSlot(const std::pair<int, int> &pair) {
+            return isReady() && _slots.count(pair) > 0;
+        }
+
+        MemoryPlan::Slot MemoryPlan::slot(const std::pair<int, int> &pair) {
+            if (!hasSlot(pair))
+                throw std::runtime_error("MemoryPlan: variable has no slot");
+
+            return _slots.at(pair);
+        }
+
+        std::shared_ptr<DataBuffer> MemoryPlan::createArena() {
+            if (arenaSize() == 0)
+                return nullptr;
+
+            return std::make_shared<DataBuffer>(_arenaSize, DataType::INT8, nullptr, false);
+        }
+
+        NDArray* MemoryPlan::allocate(const std::pair<int, int> &pair, const Nd4jLong *shapeInfo, const std::shared_ptr<DataBuffer> &arena, LaunchContext *context) {
+            if (arena == nullptr || !hasSlot(pair))
+                return nullptr;
+
+            auto dtype = ArrayOptions::dataType(shapeInfo);
+            if (ArrayOptions::arrayType(shapeInfo) == ArrayType::EMPTY || DataTypeUtils::isS(dtype) || shape::elementWiseStride(shapeInfo) != 1)
+                return nullptr;
+
+            const auto &s = _slots.at(pair);
+            const auto sizeOfT = (Nd4jLong) DataTypeUtils::sizeOfElement(dtype);
+            if (shape::length(shapeInfo) * sizeOfT > s.bytes)
+                return nullptr;
+
+            return new NDArray(arena, ShapeDescriptor(shapeInfo), context, s.offset / sizeOfT);
+        }
+
+        bool MemoryPlan::build(Graph &graph, VariableSpace &variableSpace) {
+            if (_state.load() != 0)
+                return isReady();
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_state.load() != 0)
+                return isReady();
+
+            // control flow makes execution order dynamic, so liveness can't be derived from onion
+            if (!graph.scopes()->empty()) {
+                _state = -1;
+                return false;
+            }
+
+            // every variable produced by a node, with lifetime in steps of execution order
+            std::vector<std::pair<int, int>> variables;
+            std::vector<int> parents;
+            std::vector<int> first;
+            std::vector<int> last;
+            std::vector<Nd4jLong> bytes;
+            std::vector<bool> pinned;
+            MAP_IMPL<std::pair<int, int>, int> indices;
+
+            // buffers that belong to node outputs, and buffers owned by someone else
+            MAP_IMPL<DataBuffer*, int> buffers;
+            std::set<DataBuffer*> external;
+
+            auto find = [&](int e) -> int {
+                while (parents[e] != e) {
+                    parents[e] = parents[parents[e]];
+                    e = parents[e];
+                }
+                return e;
+            };
+
+            auto unite = [&](int a, int b) {
+                a = find(a);
+                b = find(b);
+                if (a != b)
+                    parents[b] = a;
+            };
+
+            std::set<int> outputs(graph.output()->begin(), graph.output()->end());
+
+            // nodes of the same layer might be executed concurrently, so the whole layer is one step then
+            const bool concurrent = graph.getExecutorConfiguration()->_executionMode == ExecutionMode_AUTO;
+
+            auto onion = graph.getOnion();
+            int step = 0;
+            for (int l = 0; l < (int) onion->size(); l++) {
+                if (onion->count(l) == 0)
+                    continue;
+
+                for (auto node: *onion->at(l)) {
+                    if (node->opType() == OpType_LOGIC || node->hasGraphEmbedded() || !node->hasCustomOp()) {
+                        _state = -1;
+                        return false;
+                    }
+
+                    for (int idx = 0; variableSpace.hasVariable(node->id(), idx); idx++) {
+                        std::pair<int, int> pair(node->id(), idx);
+                        auto var = variableSpace.getVariable(pair);
+
+                        const int e = (int) variables.size();
+                        variables.emplace_back(pair);
+                        parents.emplace_back(e);
+                        first.emplace_back(step);
+                        last.emplace_back(step);
+                        bytes.emplace_back(0L);
+                        pinned.emplace_back(outputs.count(node->id()) > 0 || node->hasExternalOutputs());
+                        indices[pair] = e;
+
+                        auto array = var->hasNDArray() ? var->getNDArray() : nullptr;
+                        if (array == nullptr || array->isEmpty() || array->isS()) {
+                            pinned[e] = true;
+                            continue;
+                        }
+
+                        bytes[e] = array->lengthOf() * array->sizeOfT();
+
+                        // arrays sharing a buffer must share a slot too
+                        auto buffer = array->getDataBuffer().get();
+                        if (buffers.count(buffer) > 0)
+                            unite(buffers[buffer], e);
+                        else
+                            buffers[buffer] = e;
+                    }
+
+                    int k = 0;
+                    for (auto p: *node->input()) {
+                        if (indices.count(p) > 0) {
+                            const auto e = indices[p];
+                            last[e] = step;
+
+                            // in-place node writes its k-th output into its k-th input
+                            std::pair<int, int> out(node->id(), k);
+                            if (node->isInplace() && indices.count(out) > 0)
+                                unite(e, indices[out]);
+                        } else if (variableSpace.hasVariable(p) && variableSpace.getVariable(p)->hasNDArray()) {
+                            external.insert(variableSpace.getVariable(p)->getNDArray()->getDataBuffer().get());
+                        }
+
+                        k++;
+                    }
+
+                    if (!concurrent)
+                        step++;
+                }
+
+                if (concurrent)
+                    step++;
+            }
+
+            // merging members into groups
+            const int numVariables = (int) variables.size();
+            std::vector<int> groupFirst(numVariables, step);
+            std::vector<int> groupLast(numVariables, -1);
+            std::vector<Nd4jLong> groupBytes(numVariables, 0L);
+            std::vector<bool> groupPinned(numVariables, false);
+
+            for (auto &b: buffers)
+                if (external.count(b.first) > 0)
+                    pinned[b.second] = true;
+
+            for (int e = 0; e < numVariables; e++) {
+                auto g = find(e);
+                groupFirst[g] = std::min(groupFirst[g], first[e]);
+                groupLast[g] = std::max(groupLast[g], last[e]);
+                groupBytes[g] = std::max(groupBytes[g], bytes[e]);
+                groupPinned[g] = groupPinned[g] || pinned[e];
+            }
+
+            std::vector<int> groups;
+            for (int e = 0; e < numVariables; e++)
+                if (find(e) == e && !groupPinned[e] && groupBytes[e] > 0)
+                    groups.emplace_back(e);
+
+            // biggest first, ties are broken by execution order
+            std::sort(groups.begin(), groups.end(), [&](int a, int b) {
+                return groupBytes[a] != groupBytes[b] ? groupBytes[a] > groupBytes[b] : groupFirst[a] < groupFirst[b];
+            });
+
+            std::vector<Nd4jLong> offsets(numVariables, 0L);
+            std::vector<int> placed;
+            Nd4jLong arenaSize = 0L;
+            Nd4jLong plannedBytes = 0L;
+
+            for (auto g: groups) {
+                const auto size = (groupBytes[g] + SLOT_ALIGNMENT - 1) / SLOT_ALIGNMENT * SLOT_ALIGNMENT;
+
+                // groups alive at the same time, ordered by offset
+                std::vector<int> conflicts;
+                for (auto p: placed)
+                    if (groupFirst[p] <= groupLast[g] && groupFirst[g] <= groupLast[p])
+                        conflicts.emplace_back(p);
+
+                std::sort(conflicts.begin(), conflicts.end(), [&](int a, int b) { return offsets[a] < offsets[b]; });
+
+                // lowest gap that fits
+                Nd4jLong offset = 0L;
+                for (auto c: conflicts) {
+                    if (offset + size <= offsets[c])
+                        break;
+
+                    const auto end = offsets[c] + (groupBytes[c] + SLOT_ALIGNMENT - 1) / SLOT_ALIGNMENT * SLOT_ALIGNMENT;
+                    offset = std::max(offset, end);
+                }
+
+                offsets[g] = offset;
+                placed.emplace_back(g);
+
+                arenaSize = std::max(arenaSize, offset + size);
+                plannedBytes += size;
+            }
+
+            for (auto g: placed)
+                groupBytes[g] = (groupBytes[g] + SLOT_ALIGNMENT - 1) / SLOT_ALIGNMENT * SLOT_ALIGNMENT;
+
+            for (int e = 0; e < numVariables; e++) {
+                auto g = find(e);
+                if (groupPinned[g] || groupBytes[g] == 0)
+                    continue;
+
+                _slots[variables[e]] = Slot{offsets[g], groupBytes[g]};
+            }
+
+            _arenaSize = arenaSize;
+            _plannedBytes = plannedBytes;
+
+            nd4j_debug("Memory plan built: %i slots, %lld bytes arena instead of %lld bytes\n", (int) _slots.size(), arenaSize, plannedBytes);
+
+            _state.store(1, std::memory_order_release);
+            return true;
+        }
+    }
+}
@@ -192,7 +192,11 @@ namespace sd {
         }
 
 
-        sd::graph::Variable::Variable(const sd::graph::FlatVariable *flatVariable) {
+        sd::graph::Variable::Variable(const sd::graph::FlatVariable *flatVariable) : Variable(flatVariable, nullptr) {
+            //
+        }
+
+        sd::graph::Variable::Variable(const sd::graph::FlatVariable *flatVariable, const std::shared_ptr<MappedFile> &mapping) {
             auto vid = flatVariable->id();
             this->_id = vid->first();
             this->_index = vid->second();
@@ -211,7 +215,7 @@ namespace sd {
                         // ?????
                         if (flatVariable->ndarray() != nullptr) {
                             auto ar = flatVariable->ndarray();
-                            _ndarray = sd::graph::FlatUtils::fromFlatArray(ar);
+                            _ndarray = sd::graph::FlatUtils::fromFlatArray(ar, mapping);
                         }
 
                         _variableType = VariableType::NDARRAY;
@@ -223,9 +227,9 @@ namespace sd {
 
                         auto ar = flatVariable->ndarray();
                         if (ar->dtype() == DType_UTF8) {
-                            _ndarray = sd::graph::FlatUtils::fromFlatArray(ar);
+                            _ndarray = sd::graph::FlatUtils::fromFlatArray(ar, mapping);
                         } else {
-                            _ndarray = sd::graph::FlatUtils::fromFlatArray(ar);
+                            _ndarray = sd::graph::FlatUtils::fromFlatArray(ar, mapping);
                         }
 
                         _variableType = VariableType::NDARRAY;
@@ -236,7 +240,7 @@ namespace sd {
                         // ?????
                         if (flatVariable->ndarray() != nullptr) {
                             auto ar = flatVariable->ndarray();
-                            _ndarray = sd::graph::FlatUtils::fromFlatArray(ar);
+                            _ndarray = sd::graph::FlatUtils::fromFlatArray(ar, mapping);
                             // _ndarray->triggerAllocationFlag(true);
                         }
 
@@ -249,7 +253,7 @@ namespace sd {
 
                         if (flatVariable->ndarray() != nullptr) {
                             auto ar = flatVariable->ndarray();
-                            _ndarray = sd::graph::FlatUtils::fromFlatArray(ar);
+                            _ndarray = sd::graph::FlatUtils::fromFlatArray(ar, mapping);
                             // _ndarray->triggerAllocationFlag(true);
 
                             _variableType = VariableType::NDARRAY;
@@ -20,6 +20,7 @@
 
 #include <system/dll.h>
 #include <graph/VariableProxy.h>
+#include <graph/Node.h>
 
 namespace sd {
     namespace graph {
@@ -32,6 +33,44 @@ namespace sd {
             _current = new VariableSpace();
         }
 
+        VariableProxy::VariableProxy(VariableSpace* ref, MAP_IMPL<int, Node*> *nodes) : VariableProxy(ref) {
+            _local = nodes;
+        }
+
+        bool VariableProxy::isLocal(int id) {
+            return _local != nullptr && _local->count(id) > 0;
+        }
+
+        Variable* VariableProxy::localVariable(int id, int idx) {
+            std::lock_guard<std::mutex> lock(_mutexLocal);
+            if (_current->hasVariable(id, idx))
+                return _current->getVariable(id, idx);
+
+            auto origVar = _backed->getVariable(id, idx);
+            auto var = new Variable(nullptr, nullptr, id, idx);
+            var->setName(origVar->getName());
+            var->markRemovable(origVar->isRemovable());
+
+            // node writing into external variable shares its array
+            if (_local->at(id)->hasExternalOutputs() && origVar->hasNDArray())
+                var->setNDArray(origVar->getNDArray());
+
+            std::pair<int, int> pair(id, idx);
+            _current->putVariable(pair, var);
+
+            return var;
+        }
+
+        
+        void VariableProxy::beginConcurrentAccess() {
+            // backing VariableSpace is only read through proxy
+            _current->beginConcurrentAccess();
+        }
+
+        void VariableProxy::endConcurrentAccess() {
+            _current->endConcurrentAccess();
+        }
+
         
         VariableProxy::~VariableProxy() {
             delete _current;
@@ -111,6 +150,9 @@ namespace sd {
 
         
         sd::graph::Variable *VariableProxy::getVariable(int id) {
+            if (isLocal(id) && _backed->hasVariable(id))
+                return localVariable(id, 0);
+
             if (_current->hasVariable(id))
                 return _current->getVariable(id);
             
@@ -123,6 +165,9 @@ namespace sd {
 
         
         sd::graph::Variable *VariableProxy::getVariable(int id, int idx) {
+            if (isLocal(id) && _backed->hasVariable(id, idx))
+                return localVariable(id, idx);
+
             if (_current->hasVariable(id, idx))
                 return _current->getVariable(id, idx);
             
@@ -135,6 +180,9 @@ namespace sd {
 
         
         sd::graph::Variable *VariableProxy::getVariable(std::pair<int,int>& pair) {
+            if (isLocal(pair.first) && _backed->hasVariable(pair))
+                return localVariable(pair.first, pair.second);
+
             if (_current->hasVariable(pair))
                 return _current->getVariable(pair);
             
@@ -150,8 +198,13 @@ namespace sd {
             if (_current->hasVariable(symbol))
                 return _current->getVariable(symbol);
             
-            if (_backed->hasVariable(symbol))
-                return _backed->getVariable(symbol);
+            if (_backed->hasVariable(symbol)) {
+                auto var = _backed->getVariable(symbol);
+                if (isLocal(var->id()))
+                    return localVariable(var->id(), var->index());
+
+                return var;
+            }
 
             nd4j_printf("Unable to get Variable to proxy: [%s]\n", symbol->c_str());
             throw std::runtime_error("Bad arguments");
@@ -261,7 +314,7 @@ namespace sd {
 
         
         sd::graph::VariableSpace* VariableProxy::clone() {
-            auto clone = new VariableProxy(_backed);
+            auto clone = new VariableProxy(_backed, _local);
 
             delete clone->_current;
             clone->_current = _current->clone();
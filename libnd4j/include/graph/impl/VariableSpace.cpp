@@ -81,6 +81,21 @@ namespace sd {
             this->_handles->push_back(variable);
         }
 
+        std::unique_lock<std::mutex> VariableSpace::lookupLock() {
+            if (_concurrent.load(std::memory_order_acquire) > 0)
+                return std::unique_lock<std::mutex>(_varmap);
+
+            return std::unique_lock<std::mutex>();
+        }
+
+        void VariableSpace::beginConcurrentAccess() {
+            _concurrent.fetch_add(1, std::memory_order_acq_rel);
+        }
+
+        void VariableSpace::endConcurrentAccess() {
+            _concurrent.fetch_sub(1, std::memory_order_acq_rel);
+        }
+
         std::vector<sd::graph::Variable*> * sd::graph::VariableSpace::getPlaceholders() {
             return &_placeholders;
         }
@@ -90,10 +105,12 @@ namespace sd {
         }
 
         bool sd::graph::VariableSpace::hasVariable(std::string *symbol) {
+            auto lock = lookupLock();
             return _symbolic.count(*symbol) == 1;
         }
 
         sd::graph::Variable * sd::graph::VariableSpace::getVariable(std::string *symbol) {
+            auto lock = lookupLock();
             return _symbolic.at(*symbol);
         }
 
@@ -132,8 +149,9 @@ namespace sd {
         }
 
         sd::graph::Variable * sd::graph::VariableSpace::getVariable(std::pair<int, int>& pair) {
+            auto lock = lookupLock();
             if (pair.first < 0)
-                return getVariable(pair.first);
+                return _variables.at(pair.first);
             else
                 return _paired.at(pair);
 
@@ -142,10 +160,12 @@ namespace sd {
         }
 
         bool sd::graph::VariableSpace::hasVariable(int id) {
+            auto lock = lookupLock();
             return _variables.count(id) == 1 || _temporary.count(id) == 1;
         }
 
         bool sd::graph::VariableSpace::hasVariable(std::pair<int,int>& id) {
+            auto lock = lookupLock();
             return _paired.count(id) > 0;
         }
 
@@ -228,19 +248,21 @@ namespace sd {
         void sd::graph::VariableSpace::putVariable(std::pair<int,int>& pair, Variable *variable) {
             silentPutVariable(pair, variable);
 
-            if (variable->isPlaceholder())
+            if (variable->isPlaceholder()) {
+                std::lock_guard<std::mutex> lock(_varmap);
                 _placeholders.push_back(variable);
+            }
 
             // copying duplicate for compatibility
             if (pair.second == 0 && !this->hasVariable(pair.first)) {
                 this->putVariable(pair.first, variable);
             } else {
+                _varmap.lock();
+
                 if (variable->getName() != nullptr && variable->getName()->length() != 0) {
                     _symbolic[*(variable->getName())] = variable;
                 }
 
-                _varmap.lock();
-
                 _handles->push_back(variable);
 
                 _varmap.unlock();
@@ -248,10 +270,13 @@ namespace sd {
         }
 
         void VariableSpace::trackList(sd::NDArrayList* list) {
+            std::lock_guard<std::mutex> lock(_varmap);
             _lists.emplace_back(list);
         }
 
         void sd::graph::VariableSpace::putVariable(int id, Variable *variable) {
+            _varmap.lock();
+
             // we don't want to add variables more then once
             if (_variables.count(id) > 0 || _temporary.count(id) > 0) {
                 auto local = id < 0 ? _variables.at(id) : _temporary.at(id);
@@ -264,11 +289,10 @@ namespace sd {
                     local->markRemovable(variable->isRemovable());
                 }
 
+                _varmap.unlock();
                 return;
             }
 
-            _varmap.lock();
-
             _handles->emplace_back(variable);
 
             if (_auto_counter >= id)
@@ -300,8 +324,10 @@ namespace sd {
             if (!hasVariable(pair)) {
                 this->silentPutVariable(pair, variable);
 
-                if (variable->isPlaceholder())
+                if (variable->isPlaceholder()) {
+                    std::lock_guard<std::mutex> lock(_varmap);
                     _placeholders.push_back(variable);
+                }
             }
         }
 
@@ -326,6 +352,7 @@ namespace sd {
         }
 
         sd::graph::Variable * sd::graph::VariableSpace::getVariable(int id) {
+            auto lock = lookupLock();
             if (id < 0) {
                 return _variables.at(id);
             } else {
@@ -30,18 +30,19 @@
 #include <array/ConstantShapeBuffer.h>
 #include <memory/Workspace.h>
 #include <system/op_boilerplate.h>
+#include <helpers/ShardedCache.h>
 
 namespace sd {
 
     class ND4J_EXPORT ConstantShapeHelper {
     private:
-        std::mutex _mutex;
-        std::vector<MAP_IMPL<ShapeDescriptor, ConstantShapeBuffer>> _cache;
+        // one cache per device, hits are lock-free
+        std::vector<ShardedCache<ShapeDescriptor, ConstantShapeBuffer>*> _cache;
 
 
         ConstantShapeHelper();
     public:
-        ~ConstantShapeHelper() = default;
+        ~ConstantShapeHelper();
 
         static ConstantShapeHelper & getInstance();
 
@@ -77,7 +78,7 @@ namespace sd {
             if (deviceId > _cache.size())
                 throw std::runtime_error("deviceId > number of actual devices");
 
-            return _cache[deviceId].size();
+            return _cache[deviceId]->size();
         }
 
         /**
@@ -88,10 +89,16 @@ namespace sd {
             int total = 0;
 
             for (int e = 0; e < _cache.size(); e++)
-                total += _cache[e].size();
+                total += _cache[e]->size();
 
             return total;
         }
+
+        /**
+         * These methods return cache statistics, summed over all devices
+         */
+        Nd4jLong cacheHits();
+        Nd4jLong cacheMisses();
     };
 }
 
@@ -27,20 +27,36 @@
 #include <system/pointercast.h>
 #include <map>
 #include <vector>
-#include <mutex>
 #include <array/ShapeDescriptor.h>
 #include <array/TadDescriptor.h>
 #include <array/TadPack.h>
+#include <helpers/ShardedCache.h>
 
 namespace sd {
+    namespace graph {
+        class Graph;
+    }
+
+    /**
+     * TadPack weight is the number of bytes it holds: TAD shape plus offsets, and device copy of offsets if any
+     */
+    struct TadPackWeigher {
+        Nd4jLong operator()(const TadPack &pack) const {
+            Nd4jLong bytes = (pack.shapeInfoLength() + pack.numberOfTads()) * sizeof(Nd4jLong);
+            if (pack.specialOffsets() != nullptr && pack.specialOffsets() != pack.primaryOffsets())
+                bytes += pack.numberOfTads() * sizeof(Nd4jLong);
+
+            return bytes;
+        }
+    };
+
     class ND4J_EXPORT ConstantTadHelper {
     private:
-        std::mutex _mutex;
-        std::vector<MAP_IMPL<TadDescriptor, TadPack>> _cache;
+        std::vector<ShardedCache<TadDescriptor, TadPack, std::hash<TadDescriptor>, TadPackWeigher>*> _cache;
 
         ConstantTadHelper();
     public:
-        ~ConstantTadHelper() = default;
+        ~ConstantTadHelper();
 
         static ConstantTadHelper & getInstance();
 
@@ -58,6 +74,31 @@ namespace sd {
         TadPack tadForDimensions(ShapeDescriptor &descriptor, std::vector<int> &dimensions, const bool keepUnitiesInShape = false);
         TadPack tadForDimensions(TadDescriptor &descriptor);
 
+        /**
+         * This method builds TadPacks for all graph nodes that have dimensions defined and input shapes known before execution:
+         * arrays available in VariableSpace, or outputs of previous nodes with shapes inferred from those,
+         * so first execution of the graph doesn't have to compute them
+         *
+         * @param graph
+         * @return number of TadPacks requested
+         */
+        int precomputeTads(sd::graph::Graph &graph);
+
+        /**
+         * This method sets limit (in bytes) for memory used by cached TadPacks on each device. 0 means no limit.
+         * TadPacks are returned by value, so eviction never invalidates packs already handed out
+         */
+        void setCacheLimit(Nd4jLong bytes);
+        Nd4jLong cacheLimit();
+
+        /**
+         * These methods return memory used by cached TadPacks, and cache statistics, summed over all devices
+         */
+        Nd4jLong cachedMemory();
+        Nd4jLong cacheHits();
+        Nd4jLong cacheMisses();
+        Nd4jLong cacheEvictions();
+
         /**
          * This method returns number of cached TAD shapes/offsets on specific device
          * @return
@@ -66,7 +107,7 @@ namespace sd {
             if (deviceId > _cache.size())
                 throw std::runtime_error("deviceId > number of actual devices");
 
-            return _cache[deviceId].size();
+            return _cache[deviceId]->size();
         }
 
         /**
@@ -77,7 +118,7 @@ namespace sd {
             int total = 0;
 
             for (int e = 0; e < _cache.size(); e++)
-                total += _cache[e].size();
+                total += _cache[e]->size();
 
             return total;
         }
@@ -0,0 +1,142 @@
+/*******************************************************************************
+ * Copyright (c) 2015-2018 Skymind, Inc.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+#ifndef LIBND4J_ISADISPATCH_H
+#define LIBND4J_ISADISPATCH_H
+
+#include <system/op_boilerplate.h>
+#include <system/openmp_pragmas.h>
+#include <system/Environment.h>
+
+/**
+ * Runtime ISA dispatch is available for GCC/Clang x86 host builds only. Builds that already target AVX-512
+ * as baseline (F_AVX512) have nothing to dispatch to, so only generic variant is compiled there
+ */
+#if !defined(__CUDACC__) && !defined(SD_NO_ISA_DISPATCH) && !defined(__AVX512F__) && (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define SD_ISA_DISPATCH 1
+#define SD_TARGET_AVX2 __attribute__((target("avx,avx2,fma")))
+#define SD_TARGET_AVX512 __attribute__((target("avx,avx2,fma,avx512f,avx512vl,avx512bw,avx512dq,avx512cd")))
+#endif
+
+namespace sd {
+
+    /**
+     * ISA levels, numbering follows binaryLevel()/optimalLevel() from NativeOps
+     */
+    enum IsaLevel {
+        ISA_UNKNOWN = 0,
+        ISA_GENERIC = 1,
+        ISA_AVX2 = 2,
+        ISA_AVX512 = 3,
+    };
+
+    /**
+     * This class compiles Kernel::run once per supported ISA, and calls the best variant allowed by Environment::isaLevel().
+     * Kernel::run must be FORCEINLINE, so its body (and ops it calls) gets generated with target ISA enabled
+     */
+    template <typename Kernel>
+    class IsaDispatch {
+    public:
+        template <typename... Args>
+        static auto generic(Args... args) -> decltype(Kernel::run(args...)) {
+            return Kernel::run(args...);
+        }
+
+#ifdef SD_ISA_DISPATCH
+        template <typename... Args>
+        SD_TARGET_AVX2 static auto avx2(Args... args) -> decltype(Kernel::run(args...)) {
+            return Kernel::run(args...);
+        }
+
+        template <typename... Args>
+        SD_TARGET_AVX512 static auto avx512(Args... args) -> decltype(Kernel::run(args...)) {
+            return Kernel::run(args...);
+        }
+#endif
+
+        template <typename... Args>
+        static FORCEINLINE auto exec(Args... args) -> decltype(Kernel::run(args...)) {
+#ifdef SD_ISA_DISPATCH
+            switch (sd::Environment::getInstance().isaLevel()) {
+                case ISA_AVX512:
+                    return avx512(args...);
+                case ISA_AVX2:
+                    return avx2(args...);
+                default:
+                    return generic(args...);
+            }
+#else
+            return generic(args...);
+#endif
+        }
+    };
+
+    namespace kernels {
+
+        // z[i] = op(x[i]) for contiguous x and z
+        template <typename X, typename Z, typename E, typename OpType>
+        struct TransformKernel {
+            static FORCEINLINE void run(const X *x, Z *z, E *extraParams, Nd4jLong start, Nd4jLong stop) {
+                for (auto i = start; i < stop; i++)
+                    z[i] = OpType::op(x[i], extraParams);
+            }
+        };
+
+        // z[i] = op(x[i], scalar) for contiguous x and z
+        template <typename X, typename Y, typename Z, typename OpType>
+        struct ScalarKernel {
+            static FORCEINLINE void run(const X *x, Z *z, Y scalar, Z *extraParams, Nd4jLong start, Nd4jLong stop) {
+                PRAGMA_OMP_SIMD
+                for (auto i = start; i < stop; i++)
+                    z[i] = OpType::op(x[i], scalar, extraParams);
+            }
+        };
+
+        // z[i] = op(x[i], y[i]) for contiguous x, y and z
+        template <typename X, typename Y, typename Z, typename OpType>
+        struct PairwiseKernel {
+            static FORCEINLINE void run(const X *x, const Y *y, Z *z, Z *extraParams, Nd4jLong start, Nd4jLong stop) {
+                PRAGMA_OMP_SIMD
+                for (auto i = start; i < stop; i++)
+                    z[i] = OpType::op(x[i], y[i], extraParams);
+            }
+        };
+
+        // z[i] = op(x[i], y[i]) for single contiguous tad, broadcast ops have no extra params
+        template <typename X, typename Y, typename Z, typename OpType>
+        struct BroadcastKernel {
+            static FORCEINLINE void run(const X *x, const Y *y, Z *z, Nd4jLong length) {
+                PRAGMA_OMP_SIMD
+                for (Nd4jLong i = 0; i < length; i++)
+                    z[i] = OpType::op(x[i], y[i]);
+            }
+        };
+
+        // accumulates op(x[i]) over contiguous vector, starting from given accumulator
+        template <typename X, typename E, typename OpType>
+        struct ReduceKernel {
+            template <typename S>
+            static FORCEINLINE S run(const X *x, Nd4jLong length, S s, E *extraParams) {
+                for (Nd4jLong i = 0; i < length; i++)
+                    s = OpType::update(s, OpType::op(x[i], extraParams), extraParams);
+
+                return s;
+            }
+        };
+    }
+}
+
+#endif //LIBND4J_ISADISPATCH_H
@@ -32,6 +32,9 @@
 #include <helpers/ConstantTadHelper.h>
 #include <system/openmp_pragmas.h>
 #include <execution/Threads.h>
+#include <helpers/IsaDispatch.h>
+#include <helpers/LowPrecision.h>
+#include <helpers/NDIterator.h>
 
 namespace sd {
 
@@ -143,8 +146,7 @@ static void reduceExec21(const X *x, const Nd4jLong *xShapeInfo, Z* z, const Nd4
             auto s = OpType::startingValue(x0);
 
             if(xStrd1 == 1)
-                for (uint i1 = 0; i1 < xAxis1; ++i1)
-                    s = OpType::update(s, OpType::op(x0[i1], extraParams), extraParams);
+                s = sd::LowPrecision::reduce<X, E, OpType>(x0, static_cast<Nd4jLong>(xAxis1), s, extraParams);
             else
                 for (uint i1 = 0; i1 < xAxis1; ++i1)
                     s = OpType::update(s, OpType::op(x0[i1 * xStrd1], extraParams), extraParams);
@@ -228,8 +230,7 @@ void reduceExec32(const X *x, const Nd4jLong *xShapeInfo, Z* z, const Nd4jLong *
                 auto s = OpType::startingValue(x1);
 
                 if(xStrd2 == 1)
-                    for (uint i2 = 0; i2 < xAxis2; ++i2)
-                        s = OpType::update(s, OpType::op(x1[i2], extraParams), extraParams);
+                    s = sd::LowPrecision::reduce<X, E, OpType>(x1, static_cast<Nd4jLong>(xAxis2), s, extraParams);
                 else
                     for (uint i2 = 0; i2 < xAxis2; ++i2)
                         s = OpType::update(s, OpType::op(x1[i2 * xStrd2], extraParams), extraParams);
@@ -380,8 +381,7 @@ void reduceExec43(const X *x, const Nd4jLong *xShapeInfo, Z* z, const Nd4jLong *
                     auto s = OpType::startingValue(x2);
 
                     if(xStrd3 == 1)
-                        for (uint i3 = 0; i3 < xAxis3; ++i3)
-                            s = OpType::update(s, OpType::op(x2[i3], extraParams), extraParams);
+                        s = sd::LowPrecision::reduce<X, E, OpType>(x2, static_cast<Nd4jLong>(xAxis3), s, extraParams);
                     else
                         for (uint i3 = 0; i3 < xAxis3; ++i3)
                             s = OpType::update(s, OpType::op(x2[i3*xStrd3], extraParams), extraParams);
@@ -619,8 +619,7 @@ void reduceExec54(const X *x, const Nd4jLong *xShapeInfo, Z* z, const Nd4jLong *
                         auto s = OpType::startingValue(x3);
 
                        if(xStrd4 == 1)
-                            for (uint i4 = 0; i4 < xAxis4; ++i4)
-                                s = OpType::update(s, OpType::op(x3[i4], extraParams), extraParams);
+                            s = sd::LowPrecision::reduce<X, E, OpType>(x3, static_cast<Nd4jLong>(xAxis4), s, extraParams);
                         else
                             for (uint i4 = 0; i4 < xAxis4; ++i4)
                                 s = OpType::update(s, OpType::op(x3[i4*xStrd4], extraParams), extraParams);
@@ -647,7 +646,6 @@ void reduceDefault(sd::memory::Workspace* workspace, const X *x, const Nd4jLong
     Nd4jLong* innerXTadShapeInfo = sd::ShapeBuilders::createSubArrShapeInfo(xShapeInfo, dims+zRank, tadRank);
 
     const bool sameOffsets1 = shape::haveSameShapeAndStrides(zShapeInfo, outerXTadShapeInfo);
-    const bool sameOffsets2 = shape::haveSameShapeAndStrides(zShapeInfo, innerXTadShapeInfo);
 
     const Nd4jLong zLen   = shape::length(zShapeInfo);
     const Nd4jLong tadLen = shape::length(innerXTadShapeInfo);
@@ -662,11 +660,10 @@ void reduceDefault(sd::memory::Workspace* workspace, const X *x, const Nd4jLong
         shape::calcOffsets(outerXTadShapeInfo, outerXTadOffsets);
     }
 
-    Nd4jLong* innerXTadOffsets = zOffsets;
-    if(!sameOffsets2) {
-        ALLOCATE(innerXTadOffsets, workspace, tadLen, Nd4jLong);
-        shape::calcOffsets(innerXTadShapeInfo, innerXTadOffsets);
-    }
+    // elements of every tad are visited in the same order as before, only adjacent contiguous dimensions are merged
+    const Nd4jLong* innerShapeInfos[1] = {innerXTadShapeInfo};
+    const sd::NDIterator<1> inner(innerShapeInfos, false);
+    const auto innerStride = inner.innerStride(0);
 
     auto func = PRAGMA_THREADS_FOR{
 
@@ -675,8 +672,15 @@ void reduceDefault(sd::memory::Workspace* workspace, const X *x, const Nd4jLong
             const auto tad = x + outerXTadOffsets[i];
             auto s = OpType::startingValue(tad);
 
-            for (Nd4jLong j = 0; j < tadLen; j++)
-                s = OpType::update(s, OpType::op(tad[innerXTadOffsets[j]], extraParams), extraParams);
+            inner.forEachRow(0, tadLen, [&](const Nd4jLong *o, Nd4jLong length) {
+                const auto row = tad + o[0];
+
+                if (innerStride == 1)
+                    s = sd::LowPrecision::reduce<X, E, OpType>(row, length, s, extraParams);
+                else
+                    for (Nd4jLong j = 0; j < length; j++)
+                        s = OpType::update(s, OpType::op(row[j * innerStride], extraParams), extraParams);
+            });
 
             z[zOffsets[i]] = OpType::postProcess(s, tadLen, extraParams);
         }
@@ -689,8 +693,6 @@ void reduceDefault(sd::memory::Workspace* workspace, const X *x, const Nd4jLong
     RELEASE(zOffsets, workspace);
     if(!sameOffsets1)
         RELEASE(outerXTadOffsets, workspace);
-    if(!sameOffsets2)
-        RELEASE(innerXTadOffsets, workspace);
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -757,8 +759,7 @@ void sd::ReductionLoops<X, Z, E>::loopReduce(sd::memory::Workspace* workspace, c
             auto span = samediff::Span::build(threadId, numThreads, 0, len, 1);
             int64_t start = span.startX(), stop = span.stopX();
 
-            for (auto i = start; i < stop; i++)
-                z[i] = OpType::op(x[i], extraParams);
+            sd::LowPrecision::transform<X, Z, E, OpType>(x, z, extraParams, start, stop);
         }
         break;
 
@@ -0,0 +1,333 @@
+/*******************************************************************************
+ * Copyright (c) 2015-2018 Skymind, Inc.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+#ifndef LIBND4J_LOWPRECISION_H
+#define LIBND4J_LOWPRECISION_H
+
+#include <cstring>
+#include <types/float16.h>
+#include <types/bfloat16.h>
+#include <math/templatemath.h>
+#include <helpers/IsaDispatch.h>
+
+/**
+ * F16C conversions are used either when build targets F16C as baseline, or via runtime dispatch: every CPU
+ * with AVX2 level (see Environment::isaLevel()) has F16C as well
+ */
+#if defined(SD_ISA_DISPATCH)
+#define SD_HAS_F16C 1
+#define SD_TARGET_F16C __attribute__((target("avx,f16c")))
+#elif defined(__F16C__) && !defined(__CUDACC__)
+#define SD_HAS_F16C 1
+#define SD_TARGET_F16C
+#endif
+
+#ifdef SD_HAS_F16C
+#include <immintrin.h>
+#endif
+
+namespace sd {
+
+    // number of elements converted to fp32 and processed at once, tile buffers live on stack
+    static const Nd4jLong LOW_PRECISION_TILE = 256;
+
+    /**
+     * Type used for computations over given storage type: half and bfloat16 values are processed as fp32
+     */
+    template <typename T>
+    struct ComputeType {
+        typedef T type;
+        static const bool lowPrecision = false;
+    };
+
+    template <>
+    struct ComputeType<float16> {
+        typedef float type;
+        static const bool lowPrecision = true;
+    };
+
+    template <>
+    struct ComputeType<bfloat16> {
+        typedef float type;
+        static const bool lowPrecision = true;
+    };
+
+    /**
+     * Same op, instantiated for compute types of its template arguments, i.e. simdOps::Exp<float16> becomes simdOps::Exp<float>
+     */
+    template <typename OpType>
+    struct ComputeOp {
+        typedef OpType type;
+        static const bool rebound = false;
+    };
+
+    template <template <typename...> class Op, typename... Ts>
+    struct ComputeOp<Op<Ts...>> {
+        typedef Op<typename ComputeType<Ts>::type...> type;
+        static const bool rebound = true;
+    };
+
+    namespace kernels {
+
+        // bfloat16 is the upper half of fp32, so conversions are plain integer ops and vectorize with any ISA
+        struct BfloatToFloatKernel {
+            static FORCEINLINE void run(const bfloat16 *x, float *z, Nd4jLong length) {
+                PRAGMA_OMP_SIMD
+                for (Nd4jLong i = 0; i < length; i++) {
+                    const uint32_t bits = static_cast<uint32_t>(static_cast<uint16_t>(x[i]._data)) << 16;
+                    float f;
+                    memcpy(&f, &bits, sizeof(float));
+                    z[i] = f;
+                }
+            }
+        };
+
+        // round to nearest even, any NaN becomes canonical 0x7FC0, same as bfloat16::operator=(float)
+        struct FloatToBfloatKernel {
+            static FORCEINLINE void run(const float *x, bfloat16 *z, Nd4jLong length) {
+                PRAGMA_OMP_SIMD
+                for (Nd4jLong i = 0; i < length; i++) {
+                    uint32_t bits;
+                    memcpy(&bits, &x[i], sizeof(float));
+                    const uint32_t rounded = (bits + 0x7fffu + ((bits >> 16) & 1u)) >> 16;
+
+                    // rounding would carry NaN payload into exponent or sign, so NaNs are selected away without a branch
+                    const uint32_t nanMask = 0u - static_cast<uint32_t>((bits & 0x7fffffffu) > 0x7f800000u);
+                    z[i]._data = static_cast<int16_t>((rounded & ~nanMask) | (0x7fc0u & nanMask));
+                }
+            }
+        };
+    }
+
+    class LowPrecision {
+    private:
+#ifdef SD_HAS_F16C
+        static SD_TARGET_F16C void halfToFloatF16C(const float16 *x, float *z, Nd4jLong length) {
+            Nd4jLong i = 0;
+            for (; i + 8 <= length; i += 8)
+                _mm256_storeu_ps(z + i, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i *>(x + i))));
+
+            for (; i < length; i++)
+                z[i] = _cvtsh_ss(x[i].data.getX());
+        }
+
+        static SD_TARGET_F16C void floatToHalfF16C(const float *x, float16 *z, Nd4jLong length) {
+            Nd4jLong i = 0;
+            for (; i + 8 <= length; i += 8)
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(z + i), _mm256_cvtps_ph(_mm256_loadu_ps(x + i), _MM_FROUND_TO_NEAREST_INT));
+
+            for (; i < length; i++)
+                *z[i].data.getXP() = _cvtss_sh(x[i], _MM_FROUND_TO_NEAREST_INT);
+        }
+
+        static FORCEINLINE bool hasF16C() {
+#ifdef SD_ISA_DISPATCH
+            return sd::Environment::getInstance().isaLevel() >= ISA_AVX2;
+#else
+            return true;
+#endif
+        }
+#endif
+
+    public:
+        /**
+         * Bulk conversions between low precision types and fp32
+         */
+        static void toFloat(const float16 *x, float *z, Nd4jLong length) {
+#ifdef SD_HAS_F16C
+            if (hasF16C()) {
+                halfToFloatF16C(x, z, length);
+                return;
+            }
+#endif
+            for (Nd4jLong i = 0; i < length; i++)
+                z[i] = static_cast<float>(x[i]);
+        }
+
+        static void fromFloat(const float *x, float16 *z, Nd4jLong length) {
+#ifdef SD_HAS_F16C
+            if (hasF16C()) {
+                floatToHalfF16C(x, z, length);
+                return;
+            }
+#endif
+            for (Nd4jLong i = 0; i < length; i++)
+                z[i] = x[i];
+        }
+
+        static void toFloat(const bfloat16 *x, float *z, Nd4jLong length) {
+            sd::IsaDispatch<sd::kernels::BfloatToFloatKernel>::exec(x, z, length);
+        }
+
+        static void fromFloat(const float *x, bfloat16 *z, Nd4jLong length) {
+            sd::IsaDispatch<sd::kernels::FloatToBfloatKernel>::exec(x, z, length);
+        }
+
+        template <typename T>
+        static void toFloat(const T *x, float *z, Nd4jLong length) {
+            for (Nd4jLong i = 0; i < length; i++)
+                z[i] = static_cast<float>(x[i]);
+        }
+
+        template <typename T>
+        static void fromFloat(const float *x, T *z, Nd4jLong length) {
+            for (Nd4jLong i = 0; i < length; i++)
+                z[i] = static_cast<T>(x[i]);
+        }
+
+        /**
+         * z[i] = static_cast<T>(static_cast<float>(x[i])), going through fp32 tiles if either side is low precision type
+         */
+        template <typename S, typename T>
+        static void cast(const S *x, T *z, Nd4jLong length) {
+            if (!ComputeType<S>::lowPrecision && !ComputeType<T>::lowPrecision) {
+                for (Nd4jLong i = 0; i < length; i++)
+                    z[i] = static_cast<T>(static_cast<float>(x[i]));
+
+                return;
+            }
+
+            float tile[LOW_PRECISION_TILE];
+            for (Nd4jLong i = 0; i < length; i += LOW_PRECISION_TILE) {
+                const auto len = sd::math::nd4j_min<Nd4jLong>(LOW_PRECISION_TILE, length - i);
+                toFloat(x + i, tile, len);
+                fromFloat(tile, z + i, len);
+            }
+        }
+
+        /**
+         * z[i] = op(x[i]) for contiguous x and z within [start, stop)
+         */
+        template <typename X, typename Z, typename E, typename OpType>
+        static void transform(const X *x, Z *z, E *extraParams, Nd4jLong start, Nd4jLong stop);
+
+        /**
+         * accumulates op(x[i]) over contiguous vector, starting from given accumulator
+         */
+        template <typename X, typename E, typename OpType, typename S>
+        static S reduce(const X *x, Nd4jLong length, S s, E *extraParams);
+    };
+
+    namespace kernels {
+
+        // tile i/o for one operand: low precision data goes through fp32 buffer, anything else is used in place
+        template <typename T, bool lowPrecision = ComputeType<T>::lowPrecision>
+        struct TileIO {
+            static FORCEINLINE const T* load(const T *x, T *buffer, Nd4jLong length) { return x; }
+            static FORCEINLINE T* target(T *z, T *buffer) { return z; }
+            static FORCEINLINE void store(const T *buffer, T *z, Nd4jLong length) { }
+        };
+
+        template <typename T>
+        struct TileIO<T, true> {
+            static FORCEINLINE const float* load(const T *x, float *buffer, Nd4jLong length) {
+                LowPrecision::toFloat(x, buffer, length);
+                return buffer;
+            }
+
+            static FORCEINLINE float* target(T *z, float *buffer) { return buffer; }
+
+            static FORCEINLINE void store(const float *buffer, T *z, Nd4jLong length) {
+                LowPrecision::fromFloat(buffer, z, length);
+            }
+        };
+
+        template <typename X, typename Z, typename E, typename OpType, bool tiled = (ComputeType<X>::lowPrecision || ComputeType<Z>::lowPrecision) && ComputeOp<OpType>::rebound>
+        struct TiledTransform {
+            static FORCEINLINE void exec(const X *x, Z *z, E *extraParams, Nd4jLong start, Nd4jLong stop) {
+                sd::IsaDispatch<TransformKernel<X, Z, E, OpType>>::exec(x, z, extraParams, start, stop);
+            }
+        };
+
+        template <typename X, typename Z, typename E, typename OpType>
+        struct TiledTransform<X, Z, E, OpType, true> {
+            static void exec(const X *x, Z *z, E *extraParams, Nd4jLong start, Nd4jLong stop) {
+                // extra params would have to be converted as well, and their length isn't known here
+                if (extraParams != nullptr) {
+                    sd::IsaDispatch<TransformKernel<X, Z, E, OpType>>::exec(x, z, extraParams, start, stop);
+                    return;
+                }
+
+                typedef typename ComputeType<X>::type XF;
+                typedef typename ComputeType<Z>::type ZF;
+                typedef typename ComputeType<E>::type EF;
+                typedef typename ComputeOp<OpType>::type OpF;
+
+                XF xTile[LOW_PRECISION_TILE];
+                ZF zTile[LOW_PRECISION_TILE];
+                EF *noParams = nullptr;
+
+                for (auto i = start; i < stop; i += LOW_PRECISION_TILE) {
+                    const auto len = sd::math::nd4j_min<Nd4jLong>(LOW_PRECISION_TILE, stop - i);
+
+                    const XF *xf = TileIO<X>::load(x + i, xTile, len);
+                    ZF *zf = TileIO<Z>::target(z + i, zTile);
+
+                    sd::IsaDispatch<TransformKernel<XF, ZF, EF, OpF>>::exec(xf, zf, noParams, (Nd4jLong) 0, len);
+
+                    TileIO<Z>::store(zf, z + i, len);
+                }
+            }
+        };
+
+        template <typename X, typename E, typename OpType, bool tiled = ComputeType<X>::lowPrecision && ComputeOp<OpType>::rebound>
+        struct TiledReduce {
+            template <typename S>
+            static FORCEINLINE S exec(const X *x, Nd4jLong length, S s, E *extraParams) {
+                return sd::IsaDispatch<ReduceKernel<X, E, OpType>>::exec(x, length, s, extraParams);
+            }
+        };
+
+        template <typename X, typename E, typename OpType>
+        struct TiledReduce<X, E, OpType, true> {
+            template <typename S>
+            static S exec(const X *x, Nd4jLong length, S s, E *extraParams) {
+                if (extraParams != nullptr)
+                    return sd::IsaDispatch<ReduceKernel<X, E, OpType>>::exec(x, length, s, extraParams);
+
+                typedef typename ComputeType<E>::type EF;
+                typedef typename ComputeOp<OpType>::type OpF;
+
+                // accumulator stays in fp32 along the whole row
+                auto sf = static_cast<typename ComputeType<S>::type>(s);
+                float tile[LOW_PRECISION_TILE];
+                EF *noParams = nullptr;
+
+                for (Nd4jLong i = 0; i < length; i += LOW_PRECISION_TILE) {
+                    const auto len = sd::math::nd4j_min<Nd4jLong>(LOW_PRECISION_TILE, length - i);
+                    LowPrecision::toFloat(x + i, tile, len);
+
+                    const float *xf = tile;
+                    sf = sd::IsaDispatch<ReduceKernel<float, EF, OpF>>::exec(xf, len, sf, noParams);
+                }
+
+                return static_cast<S>(sf);
+            }
+        };
+    }
+
+    template <typename X, typename Z, typename E, typename OpType>
+    void LowPrecision::transform(const X *x, Z *z, E *extraParams, Nd4jLong start, Nd4jLong stop) {
+        sd::kernels::TiledTransform<X, Z, E, OpType>::exec(x, z, extraParams, start, stop);
+    }
+
+    template <typename X, typename E, typename OpType, typename S>
+    S LowPrecision::reduce(const X *x, Nd4jLong length, S s, E *extraParams) {
+        return sd::kernels::TiledReduce<X, E, OpType>::exec(x, length, s, extraParams);
+    }
+}
+
+#endif //LIBND4J_LOWPRECISION_H
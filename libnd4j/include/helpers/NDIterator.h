@@ -0,0 +1,240 @@
+/*******************************************************************************
+ * Copyright (c) 2015-2018 Skymind, Inc.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+#ifndef LIBND4J_NDITERATOR_H
+#define LIBND4J_NDITERATOR_H
+
+#include <system/op_boilerplate.h>
+#include <system/pointercast.h>
+#include <helpers/shape.h>
+#include <math/templatemath.h>
+
+namespace sd {
+
+    /**
+     * Odometer-style iterator over N arrays sharing the same logical shape, each with its own strides
+     * (zero stride means the array is broadcasted along that dimension).
+     *
+     * Iteration space is simplified once, on construction:
+     *   - unit dimensions are dropped
+     *   - optionally, dimensions are reordered by descending stride of the first array, so the one
+     *     contiguous in memory becomes innermost
+     *   - adjacent dimensions that are contiguous with respect to each other in every array are merged
+     *
+     * Element offsets are never recomputed from coordinates: forEachRow() walks the space row by row,
+     * carrying stride increments across dimensions, and hands every innermost row to the caller
+     */
+    template <int N>
+    class NDIterator {
+    private:
+        int _rank = 0;
+        bool _valid = true;
+        Nd4jLong _shape[MAX_RANK];
+        Nd4jLong _strides[N][MAX_RANK];
+
+        void init(int rank, const Nd4jLong *shape, const Nd4jLong *const *strides, bool reorder) {
+            int dims[MAX_RANK];
+            int numDims = 0;
+
+            for (int d = 0; d < rank; d++)
+                if (shape[d] != 1)
+                    dims[numDims++] = d;
+
+            // stable insertion sort, so dimensions with equal strides keep their relative order
+            if (reorder) {
+                for (int i = 1; i < numDims; i++) {
+                    auto d = dims[i];
+                    auto s = strideAbs(strides[0][d]);
+                    int j = i - 1;
+                    while (j >= 0 && strideAbs(strides[0][dims[j]]) < s) {
+                        dims[j + 1] = dims[j];
+                        j--;
+                    }
+                    dims[j + 1] = d;
+                }
+            }
+
+            _rank = 0;
+            for (int i = 0; i < numDims; i++) {
+                const auto d = dims[i];
+
+                if (_rank > 0) {
+                    const int prev = _rank - 1;
+                    bool mergeable = true;
+                    for (int a = 0; a < N && mergeable; a++)
+                        mergeable = _strides[a][prev] == strides[a][d] * shape[d];
+
+                    if (mergeable) {
+                        _shape[prev] *= shape[d];
+                        for (int a = 0; a < N; a++)
+                            _strides[a][prev] = strides[a][d];
+
+                        continue;
+                    }
+                }
+
+                _shape[_rank] = shape[d];
+                for (int a = 0; a < N; a++)
+                    _strides[a][_rank] = strides[a][d];
+
+                _rank++;
+            }
+
+            // scalar-like space is represented as single row of one element
+            if (_rank == 0) {
+                _rank = 1;
+                _shape[0] = 1;
+                for (int a = 0; a < N; a++)
+                    _strides[a][0] = 0;
+            }
+        }
+
+        static FORCEINLINE Nd4jLong strideAbs(Nd4jLong stride) {
+            return stride < 0 ? -stride : stride;
+        }
+
+    public:
+        /**
+         * @param rank - rank of the iteration space
+         * @param shape - shape of the iteration space
+         * @param strides - strides of every array along each dimension of the iteration space
+         * @param reorder - if false, elements are visited in c order of given shape
+         */
+        NDIterator(int rank, const Nd4jLong *shape, const Nd4jLong *const *strides, bool reorder = true) {
+            init(rank, shape, strides, reorder);
+        }
+
+        /**
+         * This constructor takes arrays themselves: their shapes must be equal once unit dimensions are dropped,
+         * otherwise iterator is marked as invalid. Elements are matched the same way shape::indexOffset() matches them
+         */
+        explicit NDIterator(const Nd4jLong *const *shapeInfos, bool reorder = true) {
+            Nd4jLong shape[MAX_RANK];
+            Nd4jLong strides[N][MAX_RANK];
+            const Nd4jLong *stridesPtrs[N];
+            int rank = -1;
+
+            for (int a = 0; a < N; a++) {
+                const int aRank = shape::rank(shapeInfos[a]);
+                const auto aShape = shape::shapeOf(const_cast<Nd4jLong *>(shapeInfos[a]));
+                const auto aStride = shape::stride(const_cast<Nd4jLong *>(shapeInfos[a]));
+
+                int r = 0;
+                for (int d = 0; d < aRank; d++) {
+                    if (aShape[d] == 1)
+                        continue;
+
+                    if (a == 0)
+                        shape[r] = aShape[d];
+                    else if (r >= rank || shape[r] != aShape[d])
+                        _valid = false;
+
+                    if (_valid)
+                        strides[a][r] = aStride[d];
+
+                    r++;
+                }
+
+                if (a == 0)
+                    rank = r;
+                else if (r != rank)
+                    _valid = false;
+
+                stridesPtrs[a] = strides[a];
+            }
+
+            if (_valid)
+                init(rank, shape, stridesPtrs, reorder);
+        }
+
+        FORCEINLINE bool valid() const {
+            return _valid;
+        }
+
+        FORCEINLINE int rank() const {
+            return _rank;
+        }
+
+        FORCEINLINE Nd4jLong innerStride(int array) const {
+            return _strides[array][_rank - 1];
+        }
+
+        Nd4jLong length() const {
+            Nd4jLong len = 1;
+            for (int d = 0; d < _rank; d++)
+                len *= _shape[d];
+
+            return len;
+        }
+
+        /**
+         * This method calls function(offsets, length) for every innermost row within [start, stop) range of iteration space,
+         * offsets hold position of the first element of the row within each array, rows are strided by innerStride()
+         */
+        template <typename F>
+        FORCEINLINE void forEachRow(Nd4jLong start, Nd4jLong stop, F function) const {
+            if (start >= stop)
+                return;
+
+            const int last = _rank - 1;
+            const Nd4jLong inner = _shape[last];
+
+            Nd4jLong coords[MAX_RANK];
+            Nd4jLong offsets[N];
+
+            auto index = start;
+            for (int d = last; d >= 0; d--) {
+                coords[d] = index % _shape[d];
+                index /= _shape[d];
+            }
+
+            for (int a = 0; a < N; a++) {
+                offsets[a] = 0;
+                for (int d = 0; d <= last; d++)
+                    offsets[a] += coords[d] * _strides[a][d];
+            }
+
+            auto remaining = stop - start;
+            while (true) {
+                const Nd4jLong length = sd::math::nd4j_min<Nd4jLong>(inner - coords[last], remaining);
+                function(offsets, length);
+
+                remaining -= length;
+                if (remaining == 0)
+                    break;
+
+                // back to the start of the row, then carry into outer dimensions
+                for (int a = 0; a < N; a++)
+                    offsets[a] -= coords[last] * _strides[a][last];
+                coords[last] = 0;
+
+                for (int d = last - 1; d >= 0; d--) {
+                    if (++coords[d] < _shape[d]) {
+                        for (int a = 0; a < N; a++)
+                            offsets[a] += _strides[a][d];
+                        break;
+                    }
+
+                    for (int a = 0; a < N; a++)
+                        offsets[a] -= (_shape[d] - 1) * _strides[a][d];
+                    coords[d] = 0;
+                }
+            }
+        }
+    };
+}
+
+#endif //LIBND4J_NDITERATOR_H
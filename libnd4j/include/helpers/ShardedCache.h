@@ -0,0 +1,414 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+//  @author raver119@gmail.com
+//
+
+#ifndef SD_SHARDEDCACHE_H
+#define SD_SHARDEDCACHE_H
+
+#include <system/pointercast.h>
+#include <system/op_boilerplate.h>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+
+namespace sd {
+
+    /**
+     * Default weigher: every cached entry costs 1, so cache limit is expressed in number of entries
+     */
+    template <typename V>
+    struct UnitWeigher {
+        Nd4jLong operator()(const V &value) const {
+            return 1;
+        }
+    };
+
+    /**
+     * Read-mostly concurrent cache used for constant shapes and TADs.
+     *
+     * Keys are spread over a fixed number of shards, every shard is a fixed-size array of bucket chains.
+     * Lookups are lock-free: chains are only ever published with release stores, so a hit costs one
+     * hash, a few acquire loads and key comparisons. Insertions and evictions are serialized per shard.
+     * find() and getOrCreate() return values by copy, so V is expected to be a cheap handle (i.e. holding shared_ptr to actual data).
+     *
+     * By default entries are never released before the cache itself, so lookups don't write to shared entries or shard state
+     * (hit counters are striped by thread), and entryFor() returns references that stay valid for lifetime of the cache.
+     *
+     * Evicting cache can be bounded by total weight of entries (see W). When a shard goes over its share
+     * of the limit, CLOCK (second-chance) sweep evicts entries that weren't hit since previous sweep, down to 3/4 of the limit.
+     * Evicted entries are unlinked and released once no reader is active in their shard: every lookup registers itself
+     * in shard reader counter until it's done copying the value, and sweep only deletes retired entries when that counter is 0.
+     */
+    template <typename K, typename V, typename H = std::hash<K>, typename W = UnitWeigher<V>>
+    class ShardedCache {
+    public:
+        static const int NUM_SHARDS = 16;
+        static const int NUM_BUCKETS = 256;
+
+        // smallest per-shard limit, keeps sweeps rare
+        static const Nd4jLong MIN_SHARD_LIMIT = 64;
+
+        // number of hit counters, every thread always updates the same one
+        static const int NUM_STRIPES = 16;
+
+    private:
+        struct Entry {
+            const K key;
+            V value;
+            const size_t hash;
+            const Nd4jLong weight;
+            std::atomic<Entry*> next;
+            std::atomic<bool> referenced;
+
+            Entry(const K &k, const V &v, size_t h, Nd4jLong w) : key(k), value(v), hash(h), weight(w), next(nullptr), referenced(true) { }
+        };
+
+        struct Shard {
+            std::mutex mutex;
+            std::atomic<Entry*> buckets[NUM_BUCKETS];
+            std::atomic<Nd4jLong> entries;
+            std::atomic<Nd4jLong> weight;
+            std::atomic<Nd4jLong> misses;
+            std::atomic<Nd4jLong> evictions;
+
+            // number of lookups in progress, retired entries can't be released while it's not 0
+            std::atomic<Nd4jLong> readers;
+
+            // entries that were unlinked, but might still be visible to readers
+            std::vector<Entry*> retired;
+
+            Shard() : entries(0), weight(0), misses(0), evictions(0), readers(0) {
+                for (int e = 0; e < NUM_BUCKETS; e++)
+                    buckets[e].store(nullptr, std::memory_order_relaxed);
+            }
+        };
+
+        // counter padded to its own cache line
+        struct Stripe {
+            std::atomic<Nd4jLong> value;
+            char padding[64 - sizeof(std::atomic<Nd4jLong>)];
+
+            Stripe() : value(0) { }
+        };
+
+        Shard _shards[NUM_SHARDS];
+        Stripe _hits[NUM_STRIPES];
+        const bool _evicting;
+        std::atomic<Nd4jLong> _limit;
+        H _hasher;
+        W _weigher;
+
+        FORCEINLINE Shard& shardFor(size_t hash) {
+            return _shards[hash % NUM_SHARDS];
+        }
+
+        FORCEINLINE std::atomic<Entry*>& bucketFor(Shard &shard, size_t hash) {
+            return shard.buckets[(hash / NUM_SHARDS) % NUM_BUCKETS];
+        }
+
+        static FORCEINLINE int stripe() {
+            static std::atomic<int> threads(0);
+            static thread_local int index = threads.fetch_add(1, std::memory_order_relaxed) % NUM_STRIPES;
+            return index;
+        }
+
+        FORCEINLINE void hit() {
+            _hits[stripe()].value.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // registers lookup in shard for its lifetime, so entries found by it aren't released underneath. Does nothing for non-evicting cache
+        class ReaderGuard {
+        private:
+            Shard *_shard;
+        public:
+            explicit ReaderGuard(Shard *shard) : _shard(shard) {
+                if (_shard != nullptr)
+                    _shard->readers.fetch_add(1, std::memory_order_seq_cst);
+            }
+
+            ~ReaderGuard() {
+                if (_shard != nullptr)
+                    _shard->readers.fetch_sub(1, std::memory_order_release);
+            }
+        };
+
+        // inserts new entry, must be called under shard lock
+        template <typename F>
+        Entry* insert(Shard &shard, const K &key, size_t hash, F &factory) {
+            shard.misses.fetch_add(1, std::memory_order_relaxed);
+
+            V value = factory();
+            const auto weight = _weigher(value);
+            auto e = new Entry(key, value, hash, weight);
+
+            auto &bucket = bucketFor(shard, hash);
+            e->next.store(bucket.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            bucket.store(e, std::memory_order_release);
+
+            shard.entries.fetch_add(1, std::memory_order_relaxed);
+            shard.weight.fetch_add(weight, std::memory_order_relaxed);
+
+            const auto limit = _limit.load(std::memory_order_relaxed);
+            if (limit > 0) {
+                const auto shardLimit = std::max<Nd4jLong>(MIN_SHARD_LIMIT, limit / NUM_SHARDS);
+                if (shard.weight.load(std::memory_order_relaxed) > shardLimit)
+                    evict(shard, std::max<Nd4jLong>(weight, shardLimit - shardLimit / 4), e);
+            }
+
+            return e;
+        }
+
+        FORCEINLINE Entry* lookup(Shard &shard, const K &key, size_t hash) {
+            for (auto e = bucketFor(shard, hash).load(std::memory_order_acquire); e != nullptr; e = e->next.load(std::memory_order_acquire))
+                if (e->hash == hash && e->key == key)
+                    return e;
+
+            return nullptr;
+        }
+
+        // releases retired entries if there are no readers that could still see them, must be called under shard lock
+        void reclaim(Shard &shard) {
+            if (shard.retired.empty())
+                return;
+
+            // pairs with seq_cst increment in ReaderGuard: lookups that aren't counted yet can only observe chains without retired entries
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (shard.readers.load(std::memory_order_seq_cst) != 0)
+                return;
+
+            for (auto e: shard.retired)
+                delete e;
+
+            shard.retired.clear();
+        }
+
+        // CLOCK sweep, must be called under shard lock. Entry keep is never evicted
+        void evict(Shard &shard, Nd4jLong target, Entry *keep) {
+            // first pass gives a second chance to recently used entries, second pass evicts unconditionally
+            for (int pass = 0; pass < 2 && shard.weight.load(std::memory_order_relaxed) > target; pass++) {
+                for (int b = 0; b < NUM_BUCKETS && shard.weight.load(std::memory_order_relaxed) > target; b++) {
+                    std::atomic<Entry*> *link = &shard.buckets[b];
+
+                    for (auto e = link->load(std::memory_order_relaxed); e != nullptr; e = link->load(std::memory_order_relaxed)) {
+                        if (e == keep || (pass == 0 && e->referenced.load(std::memory_order_relaxed))) {
+                            e->referenced.store(false, std::memory_order_relaxed);
+                            link = &e->next;
+                            continue;
+                        }
+
+                        // unlink, but keep e->next intact for readers that are standing on this entry
+                        link->store(e->next.load(std::memory_order_relaxed), std::memory_order_release);
+                        shard.retired.emplace_back(e);
+                        shard.entries.fetch_sub(1, std::memory_order_relaxed);
+                        shard.weight.fetch_sub(e->weight, std::memory_order_relaxed);
+                        shard.evictions.fetch_add(1, std::memory_order_relaxed);
+
+                        if (shard.weight.load(std::memory_order_relaxed) <= target)
+                            break;
+                    }
+                }
+            }
+
+            reclaim(shard);
+        }
+
+    public:
+        /**
+         * Only evicting cache accepts limit, but lookups in it have to register themselves as readers
+         */
+        explicit ShardedCache(bool evicting = false) : _evicting(evicting), _limit(0) { }
+
+        ~ShardedCache() {
+            for (auto &shard: _shards) {
+                for (auto e: shard.retired)
+                    delete e;
+
+                for (auto &bucket: shard.buckets) {
+                    auto e = bucket.load(std::memory_order_relaxed);
+                    while (e != nullptr) {
+                        auto n = e->next.load(std::memory_order_relaxed);
+                        delete e;
+                        e = n;
+                    }
+                }
+            }
+        }
+
+        ShardedCache(const ShardedCache&) = delete;
+        ShardedCache& operator=(const ShardedCache&) = delete;
+
+        /**
+         * This method copies cached value into value and returns true, or returns false if key isn't cached. It never blocks.
+         */
+        bool find(const K &key, V &value) {
+            const auto hash = _hasher(key);
+            auto &shard = shardFor(hash);
+
+            ReaderGuard guard(_evicting ? &shard : nullptr);
+            auto e = lookup(shard, key, hash);
+            if (e == nullptr)
+                return false;
+
+            // avoid writing to shared cache line if flag is already set
+            if (_evicting && !e->referenced.load(std::memory_order_relaxed))
+                e->referenced.store(true, std::memory_order_relaxed);
+
+            hit();
+            value = e->value;
+            return true;
+        }
+
+        /**
+         * This method returns true if key is cached. Doesn't affect statistics
+         */
+        bool contains(const K &key) {
+            const auto hash = _hasher(key);
+            auto &shard = shardFor(hash);
+
+            ReaderGuard guard(_evicting ? &shard : nullptr);
+            return lookup(shard, key, hash) != nullptr;
+        }
+
+        /**
+         * This method returns copy of cached value for a given key, or creates it with factory under shard lock
+         */
+        template <typename F>
+        V getOrCreate(const K &key, F factory) {
+            V value;
+            if (find(key, value))
+                return value;
+
+            const auto hash = _hasher(key);
+            auto &shard = shardFor(hash);
+
+            // entries are only released under this lock, so no reader registration is needed below
+            std::lock_guard<std::mutex> lock(shard.mutex);
+
+            // someone could have created this entry while we were waiting for lock
+            auto e = lookup(shard, key, hash);
+            if (e != nullptr) {
+                hit();
+                return e->value;
+            }
+
+            return insert(shard, key, hash, factory)->value;
+        }
+
+        /**
+         * This method returns reference to cached value for a given key, creating it with factory under shard lock if needed.
+         * Only available for non-evicting cache, where entries live as long as the cache itself
+         */
+        template <typename F>
+        V& entryFor(const K &key, F factory) {
+            if (_evicting)
+                throw std::runtime_error("ShardedCache: references can't be taken from evicting cache");
+
+            const auto hash = _hasher(key);
+            auto &shard = shardFor(hash);
+
+            auto e = lookup(shard, key, hash);
+            if (e != nullptr) {
+                hit();
+                return e->value;
+            }
+
+            std::lock_guard<std::mutex> lock(shard.mutex);
+
+            e = lookup(shard, key, hash);
+            if (e != nullptr) {
+                hit();
+                return e->value;
+            }
+
+            return insert(shard, key, hash, factory)->value;
+        }
+
+        /**
+         * This method sets limit for total weight of cached entries. 0 means no limit.
+         * Limit is split evenly between shards, and every shard keeps at least MIN_SHARD_LIMIT weight
+         */
+        void setLimit(Nd4jLong limit) {
+            if (!_evicting && limit != 0)
+                throw std::runtime_error("ShardedCache: limit can only be set for evicting cache");
+
+            _limit.store(limit);
+        }
+
+        Nd4jLong limit() const {
+            return _limit.load();
+        }
+
+        Nd4jLong size() const {
+            Nd4jLong result = 0;
+            for (const auto &shard: _shards)
+                result += shard.entries.load(std::memory_order_relaxed);
+
+            return result;
+        }
+
+        Nd4jLong weight() const {
+            Nd4jLong result = 0;
+            for (const auto &shard: _shards)
+                result += shard.weight.load(std::memory_order_relaxed);
+
+            return result;
+        }
+
+        Nd4jLong hits() const {
+            Nd4jLong result = 0;
+            for (const auto &stripe: _hits)
+                result += stripe.value.load(std::memory_order_relaxed);
+
+            return result;
+        }
+
+        Nd4jLong misses() const {
+            Nd4jLong result = 0;
+            for (const auto &shard: _shards)
+                result += shard.misses.load(std::memory_order_relaxed);
+
+            return result;
+        }
+
+        Nd4jLong evictions() const {
+            Nd4jLong result = 0;
+            for (const auto &shard: _shards)
+                result += shard.evictions.load(std::memory_order_relaxed);
+
+            return result;
+        }
+    };
+
+    template <typename K, typename V, typename H, typename W>
+    const int ShardedCache<K, V, H, W>::NUM_SHARDS;
+
+    template <typename K, typename V, typename H, typename W>
+    const int ShardedCache<K, V, H, W>::NUM_BUCKETS;
+
+    template <typename K, typename V, typename H, typename W>
+    const Nd4jLong ShardedCache<K, V, H, W>::MIN_SHARD_LIMIT;
+
+    template <typename K, typename V, typename H, typename W>
+    const int ShardedCache<K, V, H, W>::NUM_STRIPES;
+}
+
+#endif //SD_SHARDEDCACHE_H
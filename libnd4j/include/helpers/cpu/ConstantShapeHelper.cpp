@@ -29,10 +29,13 @@
 namespace sd {
     ConstantShapeHelper::ConstantShapeHelper() {
         _cache.resize(32);
-        for (int e = 0; e < 32; e++) {
-            MAP_IMPL<ShapeDescriptor, ConstantShapeBuffer> cache;
-            _cache[e] = cache;
-        }
+        for (int e = 0; e < 32; e++)
+            _cache[e] = new ShardedCache<ShapeDescriptor, ConstantShapeBuffer>();
+    }
+
+    ConstantShapeHelper::~ConstantShapeHelper() {
+        for (auto c: _cache)
+            delete c;
     }
 
     ConstantShapeHelper& ConstantShapeHelper::getInstance() {
@@ -54,17 +57,10 @@ ConstantShapeBuffer& ConstantShapeHelper::bufferForShapeInfo(const sd::DataType
 ConstantShapeBuffer& ConstantShapeHelper::bufferForShapeInfo(const ShapeDescriptor &descriptor) {
   int deviceId = 0;
 
-  std::lock_guard<std::mutex> lock(_mutex);
-
-  if (_cache[deviceId].count(descriptor) == 0) {
+  return _cache[deviceId]->entryFor(descriptor, [&]() -> ConstantShapeBuffer {
     auto hPtr = std::make_shared<PointerWrapper>(descriptor.toShapeInfo(), std::make_shared<PrimaryPointerDeallocator>());
-    ConstantShapeBuffer buffer(hPtr);
-    ShapeDescriptor descriptor1(descriptor);
-    _cache[deviceId][descriptor1] = buffer;
-    return _cache[deviceId][descriptor1];
-  } else {
-    return _cache[deviceId].at(descriptor);
-  }
+    return ConstantShapeBuffer(hPtr);
+  });
 }
 
 ConstantShapeBuffer& ConstantShapeHelper::bufferForShapeInfo(const Nd4jLong *shapeInfo) {
@@ -73,13 +69,28 @@ ConstantShapeBuffer& ConstantShapeHelper::bufferForShapeInfo(const Nd4jLong *sha
     }
 
     bool ConstantShapeHelper::checkBufferExistenceForShapeInfo(ShapeDescriptor &descriptor) {
-        bool result;
         int deviceId = 0;
-        std::lock_guard<std::mutex> lock(_mutex);
 
-        return _cache[deviceId].count(descriptor) != 0;
+        return _cache[deviceId]->contains(descriptor);
     }
 
+    Nd4jLong ConstantShapeHelper::cacheHits() {
+        Nd4jLong result = 0;
+        for (auto c: _cache)
+            result += c->hits();
+
+        return result;
+    }
+
+    Nd4jLong ConstantShapeHelper::cacheMisses() {
+        Nd4jLong result = 0;
+        for (auto c: _cache)
+            result += c->misses();
+
+        return result;
+    }
+
+
     const Nd4jLong* ConstantShapeHelper::createShapeInfo(const sd::DataType dataType, const char order, const int rank, const Nd4jLong* shape) {
         ShapeDescriptor descriptor(dataType, order, shape, rank);
         return bufferForShapeInfo(descriptor).primary();
@@ -30,8 +30,12 @@
 namespace sd {
 
     ConstantTadHelper::ConstantTadHelper() {
-        MAP_IMPL<TadDescriptor, TadPack> pack;
-        _cache.emplace_back(pack);
+        _cache.emplace_back(new ShardedCache<TadDescriptor, TadPack, std::hash<TadDescriptor>, TadPackWeigher>(true));
+    }
+
+    ConstantTadHelper::~ConstantTadHelper() {
+        for (auto cache: _cache)
+            delete cache;
     }
 
     ConstantTadHelper& ConstantTadHelper::getInstance() {
@@ -60,9 +64,8 @@ namespace sd {
     TadPack ConstantTadHelper::tadForDimensions(TadDescriptor &descriptor) {
         const int deviceId = 0;
 
-        std::lock_guard<std::mutex> lock(_mutex);
-        if (_cache[deviceId].count(descriptor) == 0) {
-          // if there's no TadPack matching this descriptor - create one
+        return _cache[deviceId]->getOrCreate(descriptor, [&descriptor]() -> TadPack {
+            // if there's no TadPack matching this descriptor - create one
             const auto shapeInfo = descriptor.originalShape().toShapeInfo();
             const int rank = shape::rank(shapeInfo);
             const std::vector<int> dimsToExclude = ShapeUtils::evalDimsToExclude(rank, descriptor.axis());
@@ -78,12 +81,52 @@ namespace sd {
             ConstantShapeBuffer shapeBuffer(sPtr);
             ConstantOffsetsBuffer offsetsBuffer(oPtr);
             TadPack t(shapeBuffer, offsetsBuffer, numOfSubArrs);
-            _cache[deviceId][descriptor] = t;
 
             delete[] shapeInfo;
-        }
 
-        return _cache[deviceId][descriptor];
+            return t;
+        });
+    }
+
+    void ConstantTadHelper::setCacheLimit(Nd4jLong bytes) {
+        for (auto cache: _cache)
+            cache->setLimit(bytes);
+    }
+
+    Nd4jLong ConstantTadHelper::cacheLimit() {
+        return _cache[0]->limit();
+    }
+
+    Nd4jLong ConstantTadHelper::cachedMemory() {
+        Nd4jLong result = 0;
+        for (auto cache: _cache)
+            result += cache->weight();
+
+        return result;
+    }
+
+    Nd4jLong ConstantTadHelper::cacheHits() {
+        Nd4jLong result = 0;
+        for (auto cache: _cache)
+            result += cache->hits();
+
+        return result;
+    }
+
+    Nd4jLong ConstantTadHelper::cacheMisses() {
+        Nd4jLong result = 0;
+        for (auto cache: _cache)
+            result += cache->misses();
+
+        return result;
+    }
+
+    Nd4jLong ConstantTadHelper::cacheEvictions() {
+        Nd4jLong result = 0;
+        for (auto cache: _cache)
+            result += cache->evictions();
+
+        return result;
     }
 }
 
@@ -24,6 +24,7 @@
 #include <helpers/ShapeUtils.h>
 #include <exceptions/datatype_exception.h>
 #include <execution/Threads.h>
+#include <ops/gemm.h>
 
 
 namespace sd {
@@ -39,61 +40,16 @@ static  void usualGemm(const NDArray* vA, const NDArray* vB, NDArray* vC,
     const T2* B = vB->bufferAsT<T2>();
           T3* C = vC->bufferAsT<T3>();
 
-    const T3 alphaZ = alpha;
-    const T3 betaZ  = beta;
-
-    const bool betaPersent = beta;
-
-    const Nd4jLong* aShapeInfo = vA->shapeInfo();
-    const Nd4jLong* bShapeInfo = vB->shapeInfo();
-    const Nd4jLong* cShapeInfo = vC->shapeInfo();
-
-    const int aRank = vA->rankOf();
-    const int bRank = vB->rankOf();
-    const int cRank = vC->rankOf();
-
-    const Nd4jLong cLen = vC->lengthOf();
+    const Nd4jLong M = vC->sizeAt(cMaxis);
+    const Nd4jLong N = vC->sizeAt(cNaxis);
+    const Nd4jLong K = vA->sizeAt(aKaxis);
 
-    const int K = vA->sizeAt(aKaxis);
-
-    auto func = PRAGMA_THREADS_FOR {
-
-        std::vector<Nd4jLong> aCoords(2), bCoords(2), cCoords(2);
-
-        for (auto i = start; i < stop; ++i) {
-
-            // evaluate C coordinates
-            shape::index2coordsCPU(start, i, cShapeInfo, cCoords.data());
-
-            // evaluate A coordinates
-            aCoords[aMaxis] = cCoords[cMaxis];
-            aCoords[aKaxis] = 0;
-
-            // evaluate B coordinates
-            bCoords[bKaxis] = 0;
-            bCoords[bNaxis] = cCoords[cNaxis];
-
-            auto aOffset = shape::getOffset(aShapeInfo, aCoords.data());
-            auto bOffset = shape::getOffset(bShapeInfo, bCoords.data());
-
-            T3 val = A[aOffset] * B[bOffset];                       // first iteration
-
-            for (int j = 1; j < K; ++j) {                          // rest iterations
-                aOffset += shape::stride(aShapeInfo)[aKaxis];
-                bOffset += shape::stride(bShapeInfo)[bKaxis];
-                val = val + A[aOffset] * B[bOffset];
-            }
-
-            auto cOffset = shape::getOffset(cShapeInfo, cCoords.data());
-
-            if(betaPersent)
-                C[cOffset] = alphaZ * val + betaZ * C[cOffset];
-            else
-                C[cOffset] = alphaZ * val;
-        }
-    };
-
-    samediff::Threads::parallel_tad(func, 0, cLen);
+    // strides are passed as is, so that any c/f/strided view is handled without copies
+    sd::blas::BlockedGEMM<T1, T2, T3>::op(M, N, K, alpha,
+                                          A, vA->strideAt(aMaxis), vA->strideAt(aKaxis),
+                                          B, vB->strideAt(bKaxis), vB->strideAt(bNaxis),
+                                          beta,
+                                          C, vC->strideAt(cMaxis), vC->strideAt(cNaxis));
 }
 
 
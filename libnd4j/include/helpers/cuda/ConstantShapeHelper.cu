@@ -34,10 +34,13 @@ namespace sd {
         auto numDevices = AffinityManager::numberOfDevices();
 
         _cache.resize(numDevices);
-        for (int e = 0; e < numDevices; e++) {
-            MAP_IMPL<ShapeDescriptor, ConstantShapeBuffer> cache;
-            _cache[e] = cache;
-        }
+        for (int e = 0; e < numDevices; e++)
+            _cache[e] = new ShardedCache<ShapeDescriptor, ConstantShapeBuffer>();
+    }
+
+    ConstantShapeHelper::~ConstantShapeHelper() {
+        for (auto c: _cache)
+            delete c;
     }
 
     ConstantShapeHelper& ConstantShapeHelper::getInstance() {
@@ -55,35 +58,44 @@ ConstantShapeBuffer& ConstantShapeHelper::bufferForShapeInfo(const sd::DataType
         return bufferForShapeInfo(descriptor);
     }
 
-ConstantShapeBuffer&  ConstantShapeHelper::bufferForShapeInfo(const ShapeDescriptor &descriptor) {
+ConstantShapeBuffer& ConstantShapeHelper::bufferForShapeInfo(const ShapeDescriptor &descriptor) {
         int deviceId = AffinityManager::currentDeviceId();
 
-        std::lock_guard<std::mutex> lock(_mutex);
-
-        if (_cache[deviceId].count(descriptor) == 0) {
+        return _cache[deviceId]->entryFor(descriptor, [&]() -> ConstantShapeBuffer {
           auto hPtr = std::make_shared<PointerWrapper>(descriptor.toShapeInfo(), std::make_shared<PrimaryPointerDeallocator>());
           auto dPtr = std::make_shared<PointerWrapper>(ConstantHelper::getInstance().replicatePointer(hPtr->pointer(), shape::shapeInfoByteLength(hPtr->pointerAsT<Nd4jLong>())), std::make_shared<CudaPointerDeallocator>());
-          ConstantShapeBuffer buffer(hPtr, dPtr);
-          ShapeDescriptor descriptor1(descriptor);
-          _cache[deviceId][descriptor1] = buffer;
-          return _cache[deviceId][descriptor1];
-        } else {
-          return _cache[deviceId].at(descriptor);
-        }
+          return ConstantShapeBuffer(hPtr, dPtr);
+        });
     }
 
-ConstantShapeBuffer&  ConstantShapeHelper::bufferForShapeInfo(const Nd4jLong *shapeInfo) {
+ConstantShapeBuffer& ConstantShapeHelper::bufferForShapeInfo(const Nd4jLong *shapeInfo) {
         ShapeDescriptor descriptor(shapeInfo);
         return bufferForShapeInfo(descriptor);
     }
 
     bool ConstantShapeHelper::checkBufferExistenceForShapeInfo(ShapeDescriptor &descriptor) {
         auto deviceId = AffinityManager::currentDeviceId();
-        std::lock_guard<std::mutex> lock(_mutex);
 
-        return _cache[deviceId].count(descriptor) != 0;
+        return _cache[deviceId]->contains(descriptor);
+    }
+
+    Nd4jLong ConstantShapeHelper::cacheHits() {
+        Nd4jLong result = 0;
+        for (auto c: _cache)
+            result += c->hits();
+
+        return result;
     }
 
+    Nd4jLong ConstantShapeHelper::cacheMisses() {
+        Nd4jLong result = 0;
+        for (auto c: _cache)
+            result += c->misses();
+
+        return result;
+    }
+
+
     Nd4jLong const* ConstantShapeHelper::createShapeInfo(const sd::DataType dataType, const char order, const int rank, const Nd4jLong* shape) {
         ShapeDescriptor descriptor(dataType, order, shape, rank);
         return bufferForShapeInfo(descriptor).primary();
@@ -137,7 +149,7 @@ ConstantShapeBuffer&  ConstantShapeHelper::bufferForShapeInfo(const Nd4jLong *sh
     }
 
 ////////////////////////////////////////////////////////////////////////
-ConstantShapeBuffer&  ConstantShapeHelper::createShapeInfoWithUnitiesForBroadcast(const Nd4jLong* maxShapeInfo, const Nd4jLong* minShapeInfo, sd::memory::Workspace* workspace, const std::vector<int>& dimensions) {
+ConstantShapeBuffer& ConstantShapeHelper::createShapeInfoWithUnitiesForBroadcast(const Nd4jLong* maxShapeInfo, const Nd4jLong* minShapeInfo, sd::memory::Workspace* workspace, const std::vector<int>& dimensions) {
 
     Nd4jLong* newShapeInfo = nullptr;
     ALLOCATE(newShapeInfo, workspace, shape::shapeInfoLength(shape::rank(maxShapeInfo)), Nd4jLong);
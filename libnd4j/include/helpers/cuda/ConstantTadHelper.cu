@@ -32,10 +32,13 @@ namespace sd {
     ConstantTadHelper::ConstantTadHelper() {
         auto numDevices = AffinityManager::numberOfDevices();
 
-        for (int e = 0; e < numDevices; e++) {
-            MAP_IMPL<TadDescriptor, TadPack> pack;
-            _cache.emplace_back(pack);
-        }
+        for (int e = 0; e < numDevices; e++)
+            _cache.emplace_back(new ShardedCache<TadDescriptor, TadPack, std::hash<TadDescriptor>, TadPackWeigher>(true));
+    }
+
+    ConstantTadHelper::~ConstantTadHelper() {
+        for (auto cache: _cache)
+            delete cache;
     }
 
     ConstantTadHelper& ConstantTadHelper::getInstance() {
@@ -64,9 +67,7 @@ namespace sd {
     TadPack ConstantTadHelper::tadForDimensions(TadDescriptor &descriptor) {
         const int deviceId = AffinityManager::currentDeviceId();
 
-        std::lock_guard<std::mutex> lock(_mutex);
-
-        if (_cache[deviceId].count(descriptor) == 0) {
+        return _cache[deviceId]->getOrCreate(descriptor, [&descriptor]() -> TadPack {
             const auto shapeInfo = descriptor.originalShape().toShapeInfo();
             const int rank = shape::rank(shapeInfo);
             const std::vector<int> dimsToExclude = ShapeUtils::evalDimsToExclude(rank, descriptor.axis());
@@ -91,23 +92,55 @@ namespace sd {
             // TODO: add deallocator here?
             auto ssPtr = std::make_shared<PointerWrapper>(ConstantHelper::getInstance().replicatePointer(sPtr->pointer(), shape::shapeInfoByteLength(subArrRank)));
 
-
-
             ConstantShapeBuffer shapesBuffer(sPtr, ssPtr);
             ConstantOffsetsBuffer offsetsBuffer(oPtr, std::make_shared<PointerWrapper>(soPtr, std::make_shared<CudaPointerDeallocator>()));
 
             TadPack t(shapesBuffer, offsetsBuffer, numOfSubArrs);
-            _cache[deviceId][descriptor] = t;
-
-            TadPack r = _cache[deviceId][descriptor];
 
             delete[] shapeInfo;
 
-            return r;
-        } else {
-            TadPack r = _cache[deviceId][descriptor];
+            return t;
+        });
+    }
+
+    void ConstantTadHelper::setCacheLimit(Nd4jLong bytes) {
+        for (auto cache: _cache)
+            cache->setLimit(bytes);
+    }
+
+    Nd4jLong ConstantTadHelper::cacheLimit() {
+        return _cache[0]->limit();
+    }
+
+    Nd4jLong ConstantTadHelper::cachedMemory() {
+        Nd4jLong result = 0;
+        for (auto cache: _cache)
+            result += cache->weight();
+
+        return result;
+    }
+
+    Nd4jLong ConstantTadHelper::cacheHits() {
+        Nd4jLong result = 0;
+        for (auto cache: _cache)
+            result += cache->hits();
+
+        return result;
+    }
+
+    Nd4jLong ConstantTadHelper::cacheMisses() {
+        Nd4jLong result = 0;
+        for (auto cache: _cache)
+            result += cache->misses();
+
+        return result;
+    }
+
+    Nd4jLong ConstantTadHelper::cacheEvictions() {
+        Nd4jLong result = 0;
+        for (auto cache: _cache)
+            result += cache->evictions();
 
-            return r;
-        }
+        return result;
     }
 }
\ No newline at end of file
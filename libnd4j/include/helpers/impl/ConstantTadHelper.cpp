@@ -0,0 +1,132 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+//  @author raver119@gmail.com
+//
+
+#include <helpers/ConstantTadHelper.h>
+#include <helpers/ConstantShapeHelper.h>
+#include <graph/Graph.h>
+#include <graph/VariableProxy.h>
+#include <memory>
+
+namespace sd {
+    /**
+     * VariableSpace view used to infer shapes before execution: it refuses to hand out Variables, so shape functions
+     * reading input arrays (i.e. axis or shape passed as array) fail instead of looking at arrays which don't exist yet
+     */
+    class ShapeOnlyVariableSpace : public sd::graph::VariableProxy {
+    public:
+        explicit ShapeOnlyVariableSpace(sd::graph::VariableSpace *variableSpace) : VariableProxy(variableSpace) { }
+
+        sd::graph::Variable* getVariable(int id) override {
+            throw std::runtime_error("ShapeOnlyVariableSpace: input arrays aren't available");
+        }
+
+        sd::graph::Variable* getVariable(int id, int idx) override {
+            throw std::runtime_error("ShapeOnlyVariableSpace: input arrays aren't available");
+        }
+
+        sd::graph::Variable* getVariable(std::pair<int,int>& pair) override {
+            throw std::runtime_error("ShapeOnlyVariableSpace: input arrays aren't available");
+        }
+
+        sd::graph::Variable* getVariable(std::string *symbol) override {
+            throw std::runtime_error("ShapeOnlyVariableSpace: input arrays aren't available");
+        }
+    };
+
+    static bool tadsForShape(ConstantTadHelper &helper, const Nd4jLong *shapeInfo, const std::vector<int> &dimensions) {
+        if (shape::isEmpty(shapeInfo) || shape::rank(shapeInfo) == 0)
+            return false;
+
+        // same normalization ops apply to dimensions before asking for TADs
+        const int rank = shape::rank(shapeInfo);
+        std::vector<int> axis;
+        for (auto d: dimensions) {
+            if (d < -rank || d >= rank)
+                break;
+
+            axis.emplace_back(d < 0 ? d + rank : d);
+        }
+
+        // MAX_INT or anything else out of range means whole array, so there's no TAD to build
+        if (axis.size() != dimensions.size())
+            return false;
+
+        helper.tadForDimensions(shapeInfo, axis);
+        return true;
+    }
+
+    int ConstantTadHelper::precomputeTads(sd::graph::Graph &graph) {
+        auto variableSpace = graph.getVariableSpace();
+        ShapeOnlyVariableSpace probe(variableSpace);
+
+        // output shapes of nodes, inferred along the way
+        MAP_IMPL<std::pair<int, int>, const Nd4jLong*> inferred;
+        int cnt = 0;
+
+        auto onion = graph.getOnion();
+        for (int l = 0; l < (int) onion->size(); l++) {
+            if (onion->count(l) == 0)
+                continue;
+
+            for (auto node: *onion->at(l)) {
+                // input shape is known if it's array provided before execution (constant, variable or placeholder), or inferred output
+                std::vector<const Nd4jLong*> inputShapes;
+                bool known = true;
+                for (auto &p: *node->input()) {
+                    const Nd4jLong *shapeInfo = nullptr;
+                    if (inferred.count(p) > 0) {
+                        shapeInfo = inferred[p];
+                    } else if (variableSpace->hasVariable(p)) {
+                        auto var = variableSpace->getVariable(p);
+                        if (var->hasNDArray())
+                            shapeInfo = var->getNDArray()->shapeInfo();
+                    }
+
+                    if (shapeInfo == nullptr) {
+                        known = false;
+                        continue;
+                    }
+
+                    inputShapes.emplace_back(shapeInfo);
+
+                    if (!node->getDimensions()->empty() && tadsForShape(*this, shapeInfo, *node->getDimensions()))
+                        cnt++;
+                }
+
+                if (!known || !node->hasCustomOp() || node->opType() == OpType_LOGIC || node->getContextPrototype() == nullptr)
+                    continue;
+
+                // shapes further down stay unknown if shape function needs input arrays
+                try {
+                    sd::graph::Context ctx(node->getContextPrototype(), &probe);
+                    ShapeList shapes(inputShapes);
+                    std::unique_ptr<ShapeList> outputs(node->getCustomOp()->calculateOutputShape(&shapes, ctx));
+
+                    for (int e = 0; e < outputs->size(); e++)
+                        inferred[std::pair<int, int>(node->id(), e)] = ConstantShapeHelper::getInstance().bufferForShapeInfo(outputs->at(e)).primary();
+                } catch (std::exception &e) {
+                    continue;
+                }
+            }
+        }
+
+        return cnt;
+    }
+}
@@ -663,6 +663,29 @@ ND4J_EXPORT int getDeviceMajor(int deviceId);
  */
 ND4J_EXPORT Nd4jLong getCachedMemory(int deviceId);
 
+/**
+ * These methods return ConstantShapeHelper cache statistics: number of cached shapes, hits and misses. Shapes are never evicted
+ * @return
+ */
+ND4J_EXPORT Nd4jLong getShapeCacheEntries();
+ND4J_EXPORT Nd4jLong getShapeCacheHits();
+ND4J_EXPORT Nd4jLong getShapeCacheMisses();
+
+/**
+ * These methods return ConstantTadHelper cache statistics: memory used by cached TadPacks (in bytes), hits, misses and evictions
+ * @return
+ */
+ND4J_EXPORT Nd4jLong getTadCacheMemory();
+ND4J_EXPORT Nd4jLong getTadCacheHits();
+ND4J_EXPORT Nd4jLong getTadCacheMisses();
+ND4J_EXPORT Nd4jLong getTadCacheEvictions();
+
+/**
+ * This method sets max memory (in bytes) used by cached TadPacks per device, 0 means no limit
+ * @param bytes
+ */
+ND4J_EXPORT void setTadCacheLimit(Nd4jLong bytes);
+
 /**
  *
  * @param ptrToDeviceId
@@ -76,6 +76,7 @@ bool experimentalSupport = false;
 #include <performance/benchmarking/FullBenchmarkSuit.h>
 #include <performance/benchmarking/LightBenchmarkSuit.h>
 #include <execution/Threads.h>
+#include <helpers/IsaDispatch.h>
 
 #ifdef CPU_FEATURES
 #include <cpuinfo_x86.h>
@@ -107,6 +108,8 @@ void execIndexReduceScalar(Nd4jPointer *extraPointers,
                                                 OpaqueDataBuffer *dbZ, const Nd4jLong *hZShapeInfo, const Nd4jLong *dZShapeInfo) {
     try {
         NativeOpExecutioner::execIndexReduceScalar(nullptr, opNum, dbX->primary(), hXShapeInfo, dbX->special(), dXShapeInfo, extraParams, dbZ->primary(), hZShapeInfo, dbZ->special(), dZShapeInfo);
+
+        InteropDataBuffer::registerPrimaryUse({dbZ}, {dbX});
     } catch (std::exception &e) {
         sd::LaunchContext::defaultContext()->errorReference()->setErrorCode(1);
         sd::LaunchContext::defaultContext()->errorReference()->setErrorMessage(e.what());
@@ -155,6 +158,8 @@ void  execIndexReduce(Nd4jPointer *extraPointers,int opNum,
                                              dimensionLength,
                                              hTADShapeInfo,
                                              hTADOffsets);
+
+        InteropDataBuffer::registerPrimaryUse({dbZ}, {dbX});
     } catch (std::exception &e) {
         sd::LaunchContext::defaultContext()->errorReference()->setErrorCode(1);
         sd::LaunchContext::defaultContext()->errorReference()->setErrorMessage(e.what());
@@ -206,6 +211,8 @@ void execBroadcast(Nd4jPointer *extraPointers,
                                            dbZ->special(), dZShapeInfo,
                                            dimension,
                                            dimensionLength, hTADShapeInfo, hTADOffsets, hTADShapeInfoZ, hTADOffsetsZ);
+
+        InteropDataBuffer::registerPrimaryUse({dbZ}, {dbX, dbY});
     } catch (std::exception &e) {
         sd::LaunchContext::defaultContext()->errorReference()->setErrorCode(1);
         sd::LaunchContext::defaultContext()->errorReference()->setErrorMessage(e.what());
@@ -247,6 +254,8 @@ void execBroadcastBool(Nd4jPointer *extraPointers,
                                                dimension,
                                                dimensionLength, hTADShapeInfo, hTADOffsets, hTADShapeInfoZ,
                                                hTADOffsetsZ);
+
+        InteropDataBuffer::registerPrimaryUse({dbZ}, {dbX, dbY});
     } catch (std::exception &e) {
         sd::LaunchContext::defaultContext()->errorReference()->setErrorCode(1);
         sd::LaunchContext::defaultContext()->errorReference()->setErrorMessage(e.what());
@@ -288,6 +297,8 @@ void execPairwiseTransform(
                                                    dbZ->special(),
                                                    dZShapeInfo,
                                                    extraParams);
+
+        InteropDataBuffer::registerPrimaryUse({dbZ}, {dbX, dbY});
     } catch (std::exception &e) {
         sd::LaunchContext::defaultContext()->errorReference()->setErrorCode(1);
         sd::LaunchContext::defaultContext()->errorReference()->setErrorMessage(e.what());
@@ -318,6 +329,8 @@ void execPairwiseTransformBool(
                                                        dbZ->special(),
                                                        dZShapeInfo,
                                                        extraParams);
+
+        InteropDataBuffer::registerPrimaryUse({dbZ}, {dbX, dbY});
     } catch (std::exception &e) {
         sd::LaunchContext::defaultContext()->errorReference()->setErrorCode(1);
         sd::LaunchContext::defaultContext()->errorReference()->setErrorMessage(e.what());
@@ -352,6 +365,8 @@ void execReduceFloat(
                                                    hZShapeInfo,
                                                    dbZ->special(),
                                                    dZShapeInfo);
+
+        InteropDataBuffer::registerPrimaryUse({dbZ}, {dbX});
     } catch (std::exception &e) {
         sd::LaunchContext::defaultContext()->errorReference()->setErrorCode(1);
         sd::LaunchContext::defaultContext()->errorReference()->setErrorMessage(e.what());
@@ -377,6 +392,8 @@ void execReduceSame(
                                                   hZShapeInfo,
                                                   dbZ->special(),
                                                   dZShapeInfo);
+
+        InteropDataBuffer::registerPrimaryUse({dbZ}, {dbX});
     } catch (std::exception &e) {
         sd::LaunchContext::defaultContext()->errorReference()->setErrorCode(1);
         sd::LaunchContext::defaultContext()->errorReference()->setErrorMessage(e.what());
@@ -401,6 +418,8 @@ void execReduceBool(
                                                   hZShapeInfo,
                                                   dbZ->special(),
                                                   dZShapeInfo);
+
+        InteropDataBuffer::registerPrimaryUse({dbZ}, {dbX});
     } catch (std::exception &e) {
         sd::LaunchContext::defaultContext()->errorReference()->setErrorCode(1);
         sd::LaunchContext::defaultContext()->errorReference()->setErrorMessage(e.what());
@@ -425,6 +444,8 @@ void execReduceLong(
                                                   hZShapeInfo,
                                                   dbZ->special(),
                                                   dZShapeInfo);
+
+        InteropDataBuffer::registerPrimaryUse({dbZ}, {dbX});
     } catch (std::exception &e) {
         sd::LaunchContext::defaultContext()->errorReference()->setErrorCode(1);
         sd::LaunchContext::defaultContext()->errorReference()->setErrorMessage(e.what());
@@ -467,6 +488,8 @@ void execReduceFloat2(Nd4jPointer *extraPointers,
         std::vector<int> dims = (zLen != 1) ? ShapeUtils::evalDimsForReduceOp(shape::rank(hXShapeInfo), dimensions) : std::vector<int>();
         NativeOpExecutioner::execReduceFloat(nullptr, opNum, dbX->primary(), hXShapeInfo, dbX->special(), dXShapeInfo, extraParams, dbZ->primary(), zShapeInfoH, dbZ->special(), zShapeInfoD, dims.data(), dims.size());
 
+
+        InteropDataBuffer::registerPrimaryUse({dbZ}, {dbX});
     } catch (std::exception &e) {
         sd::LaunchContext::defaultContext()->errorReference()->setErrorCode(1);
         sd::LaunchContext::defaultContext()->errorReference()->setErrorMessage(e.what());
@@ -500,6 +523,8 @@ void execReduceBool2(Nd4jPointer *extraPointers,
         std::vector<int> dims = (zLen != 1) ? ShapeUtils::evalDimsForReduceOp(shape::rank(hXShapeInfo), dimensions) : std::vector<int>();
         NativeOpExecutioner::execReduceBool(nullptr, opNum, dbX->primary(), hXShapeInfo, dbX->special(), dXShapeInfo, extraParams, dbZ->primary(), zShapeInfoH, dbZ->special(), zShapeInfoD, dims.data(), dims.size());
 
+
+        InteropDataBuffer::registerPrimaryUse({dbZ}, {dbX});
     } catch (std::exception &e) {
         sd::LaunchContext::defaultContext()->errorReference()->setErrorCode(1);
         sd::LaunchContext::defaultContext()->errorReference()->setErrorMessage(e.what());
@@ -532,6 +557,8 @@ void execReduceSame2(Nd4jPointer *extraPointers,
         std::vector<int> dims = (zLen != 1) ? ShapeUtils::evalDimsForReduceOp(shape::rank(hXShapeInfo), dimensions) : std::vector<int>();
         NativeOpExecutioner::execReduceSame(nullptr, opNum, dbX->primary(), hXShapeInfo, dbX->special(), dXShapeInfo, extraParams, dbZ->primary(), zShapeInfoH, dbZ->special(), zShapeInfoD, dims.data(), dims.size());
 
+
+        InteropDataBuffer::registerPrimaryUse({dbZ}, {dbX});
     } catch (std::exception &e) {
         sd::LaunchContext::defaultContext()->errorReference()->setErrorCode(1);
         sd::LaunchContext::defaultContext()->errorReference()->setErrorMessage(e.what());
@@ -564,6 +591,8 @@ void execReduceLong2(Nd4jPointer *extraPointers,
         std::vector<int> dims = (zLen != 1) ? ShapeUtils::evalDimsForReduceOp(shape::rank(hXShapeInfo), dimensions) : std::vector<int>();
         NativeOpExecutioner::execReduceLong(nullptr, opNum, dbX->primary(), hXShapeInfo, dbX->special(), dXShapeInfo, extraParams, dbZ->primary(), zShapeInfoH, dbZ->special(), zShapeInfoD, dims.data(), dims.size());
 
+
+        InteropDataBuffer::registerPrimaryUse({dbZ}, {dbX});
     } catch (std::exception &e) {
         sd::LaunchContext::defaultContext()->errorReference()->setErrorCode(1);
         sd::LaunchContext::defaultContext()->errorReference()->setErrorMessage(e.what());
@@ -590,6 +619,8 @@ void execReduce3(Nd4jPointer *extraPointers,
     try {
         NativeOpExecutioner::execReduce3(nullptr, opNum, dbX->primary(), hXShapeInfo, dbX->special(), dXShapeInfo, extraParams, dbY->primary(), hYShapeInfo,
                                          dbY->special(), dYShapeInfo, dbZ->primary(), hZShapeInfo, dbZ->special(), dZShapeInfo);
+
+        InteropDataBuffer::registerPrimaryUse({dbZ}, {dbX, dbY});
     } catch (std::exception &e) {
         sd::LaunchContext::defaultContext()->errorReference()->setErrorCode(1);
         sd::LaunchContext::defaultContext()->errorReference()->setErrorMessage(e.what());
@@ -613,6 +644,8 @@ void execReduce3Scalar(Nd4jPointer *extraPointers,int opNum,
     try {
         NativeOpExecutioner::execReduce3Scalar(nullptr, opNum, dbX->primary(), hXShapeInfo, dbX->special(), dXShapeInfo, extraParams, dbY->primary(),
                                                hYShapeInfo, dbY->special(), dYShapeInfo, dbZ->primary(), hZShapeInfo, dbZ->special(), dZShapeInfo);
+
+        InteropDataBuffer::registerPrimaryUse({dbZ}, {dbX, dbY});
     } catch (std::exception &e) {
         sd::LaunchContext::defaultContext()->errorReference()->setErrorCode(1);
         sd::LaunchContext::defaultContext()->errorReference()->setErrorMessage(e.what());
@@ -662,6 +695,8 @@ void execReduce3Tad(Nd4jPointer *extraPointers,
                                                 hZShapeInfo, dbZ->special(), dZShapeInfo, dimension, dimensionLength, hTADShapeInfo,
                                                 hTADOffsets, nullptr, nullptr);
         }
+
+        InteropDataBuffer::registerPrimaryUse({dbZ}, {dbX, dbY});
     } catch (std::exception &e) {
         sd::LaunchContext::defaultContext()->errorReference()->setErrorCode(1);
         sd::LaunchContext::defaultContext()->errorReference()->setErrorMessage(e.what());
@@ -706,6 +741,8 @@ void execScalar(
                                         dbScalar->special(),
                                         dScalarShapeInfo,
                                         extraParams);
+
+        InteropDataBuffer::registerPrimaryUse({dbZ}, {dbX});
     } catch (std::exception &e) {
         sd::LaunchContext::defaultContext()->errorReference()->setErrorCode(1);
         sd::LaunchContext::defaultContext()->errorReference()->setErrorMessage(e.what());
@@ -735,6 +772,8 @@ void execScalarBool(
                                             dbScalar->special(),
                                             dScalarShapeInfo,
                                             extraParams);
+
+        InteropDataBuffer::registerPrimaryUse({dbZ}, {dbX});
     } catch (std::exception &e) {
         sd::LaunchContext::defaultContext()->errorReference()->setErrorCode(1);
         sd::LaunchContext::defaultContext()->errorReference()->setErrorMessage(e.what());
@@ -767,6 +806,8 @@ void execSummaryStatsScalar(Nd4jPointer *extraPointers,
                                                     dbZ->special(),
                                                     dZShapeInfo,
                                                     biasCorrected);
+
+        InteropDataBuffer::registerPrimaryUse({dbZ}, {dbX});
     } catch (std::exception &e) {
         sd::LaunchContext::defaultContext()->errorReference()->setErrorCode(1);
         sd::LaunchContext::defaultContext()->errorReference()->setErrorMessage(e.what());
@@ -800,6 +841,8 @@ void execSummaryStats(Nd4jPointer *extraPointers,
                                               dbZ->special(),
                                               dZShapeInfo,
                                               biasCorrected);
+
+        InteropDataBuffer::registerPrimaryUse({dbZ}, {dbX});
     } catch (std::exception &e) {
         sd::LaunchContext::defaultContext()->errorReference()->setErrorCode(1);
         sd::LaunchContext::defaultContext()->errorReference()->setErrorMessage(e.what());
@@ -845,6 +888,8 @@ void execSummaryStatsTad(Nd4jPointer *extraPointers,
                                               tadShapeInfo,
                                               tadOffsets,
                                               biasCorrected);
+
+        InteropDataBuffer::registerPrimaryUse({dbZ}, {dbX});
     } catch (std::exception &e) {
         sd::LaunchContext::defaultContext()->errorReference()->setErrorCode(1);
         sd::LaunchContext::defaultContext()->errorReference()->setErrorMessage(e.what());
@@ -881,6 +926,8 @@ void execTransformFloat(
                                                 extraParams,
                                                 nullptr,
                                                 nullptr);
+
+        InteropDataBuffer::registerPrimaryUse({dbZ}, {dbX});
     } catch (std::exception &e) {
         sd::LaunchContext::defaultContext()->errorReference()->setErrorCode(1);
         sd::LaunchContext::defaultContext()->errorReference()->setErrorMessage(e.what());
@@ -907,6 +954,8 @@ void execTransformSame(
                                                extraParams,
                                                nullptr,
                                                nullptr);
+
+        InteropDataBuffer::registerPrimaryUse({dbZ}, {dbX});
     } catch (std::exception &e) {
         sd::LaunchContext::defaultContext()->errorReference()->setErrorCode(1);
         sd::LaunchContext::defaultContext()->errorReference()->setErrorMessage(e.what());
@@ -933,6 +982,8 @@ void execTransformBool(
                                                extraParams,
                                                nullptr,
                                                nullptr);
+
+        InteropDataBuffer::registerPrimaryUse({dbZ}, {dbX});
     } catch (std::exception &e) {
         sd::LaunchContext::defaultContext()->errorReference()->setErrorCode(1);
         sd::LaunchContext::defaultContext()->errorReference()->setErrorMessage(e.what());
@@ -959,6 +1010,8 @@ void execTransformAny(
                                               extraParams,
                                               nullptr,
                                               nullptr);
+
+        InteropDataBuffer::registerPrimaryUse({dbZ}, {dbX});
     } catch (std::exception &e) {
         sd::LaunchContext::defaultContext()->errorReference()->setErrorCode(1);
         sd::LaunchContext::defaultContext()->errorReference()->setErrorMessage(e.what());
@@ -985,6 +1038,8 @@ void execTransformStrict(
                                                  extraParams,
                                                  nullptr,
                                                  nullptr);
+
+        InteropDataBuffer::registerPrimaryUse({dbZ}, {dbX});
     } catch (std::exception &e) {
         sd::LaunchContext::defaultContext()->errorReference()->setErrorCode(1);
         sd::LaunchContext::defaultContext()->errorReference()->setErrorMessage(e.what());
@@ -1009,6 +1064,8 @@ void execReduce3All(Nd4jPointer *extraPointers,
         NativeOpExecutioner::execReduce3All(nullptr, opNum, dbX->primary(), hXShapeInfo, dbX->special(), dXShapeInfo, extraParamsVals, dbY->primary(),
                                             hYShapeInfo, dbY->special(), dYShapeInfo, dbZ->primary(), hZShapeInfo, dbZ->special(), dZShapeInfo, dimension,
                                             dimensionLength, xTadShapeInfo, xOffsets, yTadShapeInfo, yOffsets);
+
+        InteropDataBuffer::registerPrimaryUse({dbZ}, {dbX, dbY});
     } catch (std::exception &e) {
         sd::LaunchContext::defaultContext()->errorReference()->setErrorCode(1);
         sd::LaunchContext::defaultContext()->errorReference()->setErrorMessage(e.what());
@@ -1319,6 +1376,8 @@ void pullRows(Nd4jPointer *extraPointers,
         auto xType = sd::ArrayOptions::dataType(hXShapeInfo);
 
         BUILD_SINGLE_SELECTOR(xType, pullRowsGeneric, (dbX->primary(), hXShapeInfo, dbZ->primary(), hZShapeInfo, n, indexes, tadShapeInfo, tadOffsets, zTadShapeInfo, zTadOffsets), LIBND4J_TYPES);
+
+        InteropDataBuffer::registerPrimaryUse({dbZ}, {dbX});
     } catch (std::exception &e) {
         sd::LaunchContext::defaultContext()->errorReference()->setErrorCode(1);
         sd::LaunchContext::defaultContext()->errorReference()->setErrorMessage(e.what());
@@ -1591,6 +1650,8 @@ void execScalarTad(Nd4jPointer *extraPointers,
                                         tadOffsets,
                                         tadShapeInfoZ,
                                         tadOffsetsZ);
+
+        InteropDataBuffer::registerPrimaryUse({dbZ}, {dbX});
     } catch (std::exception &e) {
         sd::LaunchContext::defaultContext()->errorReference()->setErrorCode(1);
         sd::LaunchContext::defaultContext()->errorReference()->setErrorMessage(e.what());
@@ -1631,6 +1692,8 @@ void execScalarBoolTad(Nd4jPointer *extraPointers,
                                             tadOffsets,
                                             tadShapeInfoZ,
                                             tadOffsetsZ);
+
+        InteropDataBuffer::registerPrimaryUse({dbZ}, {dbX});
     } catch (std::exception &e) {
         sd::LaunchContext::defaultContext()->errorReference()->setErrorCode(1);
         sd::LaunchContext::defaultContext()->errorReference()->setErrorMessage(e.what());
@@ -1711,6 +1774,8 @@ void execRandom(Nd4jPointer *extraPointers,
                                  void *extraArguments) {
     try {
         NativeOpExecutioner::execRandom(nullptr, opNum, state, dbZ->primary(), hZShapeInfo, dbZ->special(), dZShapeInfo, extraArguments);
+
+        InteropDataBuffer::registerPrimaryUse({dbZ}, {});
     } catch (std::exception &e) {
         sd::LaunchContext::defaultContext()->errorReference()->setErrorCode(1);
         sd::LaunchContext::defaultContext()->errorReference()->setErrorMessage(e.what());
@@ -1726,6 +1791,8 @@ void execRandom3(Nd4jPointer *extraPointers,
                                  void *extraArguments) {
     try {
         NativeOpExecutioner::execRandom(nullptr, opNum, state, dbX->primary(), hXShapeInfo, dbX->special(), dXShapeInfo, dbY->primary(), hYShapeInfo, dbY->special(), dYShapeInfo, dbZ->primary(), hZShapeInfo, dbZ->special(), dZShapeInfo, extraArguments);
+
+        InteropDataBuffer::registerPrimaryUse({dbZ}, {dbX, dbY});
     } catch (std::exception &e) {
         sd::LaunchContext::defaultContext()->errorReference()->setErrorCode(1);
         sd::LaunchContext::defaultContext()->errorReference()->setErrorMessage(e.what());
@@ -1740,6 +1807,8 @@ void execRandom2(Nd4jPointer *extraPointers,
                                  void *extraArguments) {
     try {
         NativeOpExecutioner::execRandom(nullptr, opNum, state, dbX->primary(), hXShapeInfo, dbX->special(), dXShapeInfo, dbZ->primary(), hZShapeInfo, dbZ->special(), dZShapeInfo, extraArguments);
+
+        InteropDataBuffer::registerPrimaryUse({dbZ}, {dbX});
     } catch (std::exception &e) {
         sd::LaunchContext::defaultContext()->errorReference()->setErrorCode(1);
         sd::LaunchContext::defaultContext()->errorReference()->setErrorMessage(e.what());
@@ -2986,6 +3055,38 @@ Nd4jLong getCachedMemory(int deviceId) {
     return sd::ConstantHelper::getInstance().getCachedAmount(deviceId);
 }
 
+Nd4jLong getShapeCacheEntries() {
+    return sd::ConstantShapeHelper::getInstance().totalCachedEntries();
+}
+
+Nd4jLong getShapeCacheHits() {
+    return sd::ConstantShapeHelper::getInstance().cacheHits();
+}
+
+Nd4jLong getShapeCacheMisses() {
+    return sd::ConstantShapeHelper::getInstance().cacheMisses();
+}
+
+Nd4jLong getTadCacheMemory() {
+    return sd::ConstantTadHelper::getInstance().cachedMemory();
+}
+
+Nd4jLong getTadCacheHits() {
+    return sd::ConstantTadHelper::getInstance().cacheHits();
+}
+
+Nd4jLong getTadCacheMisses() {
+    return sd::ConstantTadHelper::getInstance().cacheMisses();
+}
+
+Nd4jLong getTadCacheEvictions() {
+    return sd::ConstantTadHelper::getInstance().cacheEvictions();
+}
+
+void setTadCacheLimit(Nd4jLong bytes) {
+    sd::ConstantTadHelper::getInstance().setCacheLimit(bytes);
+}
+
 const char* runFullBenchmarkSuit(bool printOut) {
     try {
         sd::FullBenchmarkSuit suit;
@@ -3111,8 +3212,14 @@ bool isOptimalRequirementsMet() {
 
     if (b == o)
         return true;
-    else
-        return false;
+
+#ifdef SD_ISA_DISPATCH
+    // hot loops pick their ISA variant at runtime, so lower binary level only affects the rest of the code
+    if (b < o && sd::Environment::getInstance().isaLevel() == o)
+        return true;
+#endif
+
+    return false;
 #else
     return true;
 #endif
@@ -3658,6 +3658,38 @@ Nd4jLong getCachedMemory(int deviceId) {
     return sd::ConstantHelper::getInstance().getCachedAmount(deviceId);
 }
 
+Nd4jLong getShapeCacheEntries() {
+    return sd::ConstantShapeHelper::getInstance().totalCachedEntries();
+}
+
+Nd4jLong getShapeCacheHits() {
+    return sd::ConstantShapeHelper::getInstance().cacheHits();
+}
+
+Nd4jLong getShapeCacheMisses() {
+    return sd::ConstantShapeHelper::getInstance().cacheMisses();
+}
+
+Nd4jLong getTadCacheMemory() {
+    return sd::ConstantTadHelper::getInstance().cachedMemory();
+}
+
+Nd4jLong getTadCacheHits() {
+    return sd::ConstantTadHelper::getInstance().cacheHits();
+}
+
+Nd4jLong getTadCacheMisses() {
+    return sd::ConstantTadHelper::getInstance().cacheMisses();
+}
+
+Nd4jLong getTadCacheEvictions() {
+    return sd::ConstantTadHelper::getInstance().cacheEvictions();
+}
+
+void setTadCacheLimit(Nd4jLong bytes) {
+    sd::ConstantTadHelper::getInstance().setCacheLimit(bytes);
+}
+
 sd::LaunchContext* defaultLaunchContext() {
     return LaunchContext::defaultContext();
 }
@@ -21,12 +21,18 @@
 #include <iostream>
 #include <cstdlib>
 #include <stdexcept>
+#include <algorithm>
 #include <string>
 #include "system/Environment.h"
 #include <helpers/StringUtils.h>
 #include <thread>
 #include <helpers/logger.h>
 #include <memory/MemoryCounter.h>
+#include <helpers/IsaDispatch.h>
+
+#ifdef CPU_FEATURES
+#include <cpuinfo_x86.h>
+#endif
 
 #ifdef _OPENMP
 
@@ -43,6 +49,33 @@
 
 namespace sd {
 
+    static int detectIsaLevel() {
+#if defined(__CUDABLAS__)
+        return ISA_UNKNOWN;
+#elif defined(CPU_FEATURES)
+        auto features = cpu_features::GetX86Info().features;
+
+        if (features.avx && features.avx2 && features.fma3 && features.avx512f && features.avx512vl && features.avx512bw && features.avx512dq && features.avx512cd && features.f16c)
+            return ISA_AVX512;
+        else if (features.avx && features.avx2 && features.fma3 && features.f16c)
+            return ISA_AVX2;
+        else
+            return ISA_GENERIC;
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+        __builtin_cpu_init();
+
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") && __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vl")
+            && __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512cd") && __builtin_cpu_supports("f16c"))
+            return ISA_AVX512;
+        else if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") && __builtin_cpu_supports("f16c"))
+            return ISA_AVX2;
+        else
+            return ISA_GENERIC;
+#else
+        return ISA_UNKNOWN;
+#endif
+    }
+
     sd::Environment::Environment() {
         _tadThreshold.store(1);
         _elementThreshold.store(1024);
@@ -54,6 +87,8 @@ namespace sd {
         _dataType.store(sd::DataType::FLOAT32);
         _maxThreads = std::thread::hardware_concurrency();
         _maxMasterThreads = _maxThreads.load();
+        _maxIsaLevel = detectIsaLevel();
+        _isaLevel.store(_maxIsaLevel);
 
 #ifndef ANDROID
         const char* omp_threads = std::getenv("OMP_NUM_THREADS");
@@ -163,10 +198,50 @@ namespace sd {
             }
         }
 
+        /**
+         * If this env var is defined - worker threads will be grouped and pinned per NUMA node
+         */
+        const char* numa_aware = std::getenv("SD_NUMA_AWARE");
+        if (numa_aware != nullptr) {
+            _numaAware = true;
+        }
+
+        /**
+         * If this env var is defined - chains of elementwise ops within graphs will be fused
+         */
+        const char* fuse_elementwise = std::getenv("SD_FUSE_ELEMENTWISE");
+        if (fuse_elementwise != nullptr) {
+            _elementwiseFusion = true;
+        }
+
+        /**
+         * If this env var is defined - intermediate results of graphs won't be placed into preallocated arena
+         */
+        const char* disable_memory_planning = std::getenv("SD_DISABLE_MEMORY_PLANNING");
+        if (disable_memory_planning != nullptr) {
+            _memoryPlanning = false;
+        }
+
         const char* blas_fallback = std::getenv("SD_BLAS_FALLBACK");
         if (blas_fallback != nullptr) {
             _blasFallback = true;
         }
+
+        /**
+         * This var caps ISA level used by loops with runtime dispatch, i.e. SD_MAX_ISA_LEVEL=2 disables AVX-512 variants
+         */
+        const char* max_isa_level = std::getenv("SD_MAX_ISA_LEVEL");
+        if (max_isa_level != nullptr) {
+            try {
+                std::string t(max_isa_level);
+                int val = std::stoi(t);
+                setIsaLevel(val);
+            } catch (std::invalid_argument &e) {
+                // just do nothing
+            } catch (std::out_of_range &e) {
+                // still do nothing
+            }
+        }
 #endif
 
 #ifdef __CUDABLAS__
@@ -314,6 +389,46 @@ namespace sd {
         _maxMasterThreads = max;
     }
 
+    bool Environment::isNumaAware() {
+        return _numaAware.load();
+    }
+
+    void Environment::setNumaAware(bool reallyAware) {
+        _numaAware = reallyAware;
+    }
+
+    bool Environment::isElementwiseFusion() {
+        return _elementwiseFusion.load();
+    }
+
+    void Environment::setElementwiseFusion(bool reallyFuse) {
+        _elementwiseFusion = reallyFuse;
+    }
+
+    bool Environment::isMemoryPlanning() {
+        return _memoryPlanning.load();
+    }
+
+    void Environment::setMemoryPlanning(bool reallyPlan) {
+        _memoryPlanning = reallyPlan;
+    }
+
+    int Environment::isaLevel() {
+        return _isaLevel.load();
+    }
+
+    int Environment::maxIsaLevel() {
+        return _maxIsaLevel;
+    }
+
+    void Environment::setIsaLevel(int level) {
+        // host can't run anything above detected level, and unknown level means there's nothing to dispatch
+        if (_maxIsaLevel == ISA_UNKNOWN)
+            return;
+
+        _isaLevel = std::max<int>(ISA_GENERIC, std::min<int>(level, _maxIsaLevel));
+    }
+
     bool Environment::precisionBoostAllowed() {
         return _precBoost.load();
     }
@@ -26,12 +26,43 @@
 #include <helpers/ConstantTadHelper.h>
 #include <execution/Threads.h>
 #include <helpers/ShapeUtils.h>
+#include <helpers/IsaDispatch.h>
+#include <helpers/NDIterator.h>
 
 using namespace simdOps;
 
 namespace functions {
 namespace broadcast {
 
+        // one row of N-D iteration space, z[f] = op(x[f], y[f]) with arbitrary strides
+        template <typename X, typename Y, typename Z, typename OpType>
+        static FORCEINLINE void broadcastRow(const X *x, Nd4jLong xStride, const Y *y, Nd4jLong yStride, Z *z, Nd4jLong zStride, Nd4jLong length) {
+            if (xStride == 1 && yStride == 1 && zStride == 1) {
+                PRAGMA_OMP_SIMD
+                for (Nd4jLong f = 0; f < length; f++)
+                    z[f] = OpType::op(x[f], y[f]);
+            }
+            else if (xStride == 1 && yStride == 0 && zStride == 1) {
+                const auto v = *y;
+
+                PRAGMA_OMP_SIMD
+                for (Nd4jLong f = 0; f < length; f++)
+                    z[f] = OpType::op(x[f], v);
+            }
+            else if (xStride == 0 && yStride == 1 && zStride == 1) {
+                const auto v = *x;
+
+                PRAGMA_OMP_SIMD
+                for (Nd4jLong f = 0; f < length; f++)
+                    z[f] = OpType::op(v, y[f]);
+            }
+            else {
+                PRAGMA_OMP_SIMD
+                for (Nd4jLong f = 0; f < length; f++)
+                    z[f * zStride] = OpType::op(x[f * xStride], y[f * yStride]);
+            }
+        }
+
         template <typename X, typename Y, typename Z>
         void Broadcast<X, Y, Z>::execInverse(const int opNum,
                                              const void *x, const Nd4jLong *xShapeInfo,
@@ -139,9 +170,7 @@ namespace broadcast {
                         auto oX = x + tadOffsets[i];
                         auto oZ = z + zTadOffset[i];
 
-                        PRAGMA_OMP_SIMD
-                        for (unsigned int f = 0; f < tadLength; f++)
-                            oZ[f] = OpType::op(oX[f], y[f]);
+                        sd::IsaDispatch<sd::kernels::BroadcastKernel<X, Y, Z, OpType>>::exec(oX, y, oZ, static_cast<Nd4jLong>(tadLength));
                     }
                 }
                 else if(kindOfLoop == sd::LoopKind::EWSNONZERO){
@@ -182,191 +211,78 @@ namespace broadcast {
                             oZ[f] = OpType::op(oX[f], oY);
                     }
                 }
-                else if (kindOfLoop == sd::LoopKind::BROADCAST_3D) {
-
-                    int xRank = shape::rank(xShapeInfo);
-                    int yRank = shape::rank(yShapeInfo);
-
-                    auto  xStrides = shape::stride(xShapeInfo);
-                    auto  zStrides = shape::stride(zShapeInfo);
-
-                    Nd4jLong  yStrides[3] = { 0,0,0 };
-                    sd::ShapeUtils::copyCertainStridesFromShapeInfo(yShapeInfo, xRank, dimensionLength, dimension, yStrides);
-
-                    uint64_t nSize1 = shape::sizeAt(zShapeInfo, 1);
-                    uint64_t nSize2 = shape::sizeAt(zShapeInfo, 2);
+                else if (kindOfLoop == sd::LoopKind::BROADCAST_3D || kindOfLoop == sd::LoopKind::BROADCAST_4D || kindOfLoop == sd::LoopKind::BROADCAST_5D) {
+                    // outer dimension (3D) or two of them (4D, 5D) are split between threads, all the rest is walked by iterator
+                    const int rank = shape::rank(zShapeInfo);
+                    const int outer = kindOfLoop == sd::LoopKind::BROADCAST_3D ? 1 : 2;
 
-                    for (auto index0 = start; index0 < stop; index0++) {
+                    auto zShape = shape::shapeOf(zShapeInfo);
+                    auto zStrides = shape::stride(zShapeInfo);
 
-                        PRAGMA_OMP_SIMD
-                            for (uint64_t index1 = 0; index1 < nSize1; index1++) {
-                                for (uint64_t index2 = 0; index2 < nSize2; index2++) {
-                                    auto rX = x + (xStrides[0] * index0 + xStrides[1] * index1 + xStrides[2] * index2);
-                                    auto rY = y + (yStrides[0] * index0 + yStrides[1] * index1 + yStrides[2] * index2);
-                                    auto rZ = z + (zStrides[0] * index0 + zStrides[1] * index1 + zStrides[2] * index2);
-                                    *rZ = OpType::op(*rX, *rY);
-                                }
-                            }
+                    Nd4jLong xStrides[MAX_RANK] = {};
+                    Nd4jLong yStrides[MAX_RANK] = {};
+                    sd::ShapeUtils::copyCertainStridesFromShapeInfo(xShapeInfo, rank, 0, nullptr, xStrides);
+                    sd::ShapeUtils::copyCertainStridesFromShapeInfo(yShapeInfo, rank, dimensionLength, dimension, yStrides);
 
-                    }
-
-                }
-                else if (kindOfLoop == sd::LoopKind::BROADCAST_4D) {
+                    const Nd4jLong *strides[3] = {zStrides + outer, xStrides + outer, yStrides + outer};
+                    const sd::NDIterator<3> iter(rank - outer, zShape + outer, strides);
 
-                    int xRank = shape::rank(xShapeInfo);
-                    int yRank = shape::rank(yShapeInfo);
-
-                    auto  xStrides = shape::stride(xShapeInfo);
-                    auto  zStrides = shape::stride(zShapeInfo);
-
-                    Nd4jLong  yStrides[4] = { 0,0,0,0 };
-                    sd::ShapeUtils::copyCertainStridesFromShapeInfo(yShapeInfo, xRank, dimensionLength, dimension, yStrides);
-
-                    uint64_t nSize1 = shape::sizeAt(zShapeInfo, 1);
-                    uint64_t nSize2 = shape::sizeAt(zShapeInfo, 2);
-                    uint64_t nSize3 = shape::sizeAt(zShapeInfo, 3);
+                    const auto innerLength = iter.length();
+                    const auto zs = iter.innerStride(0);
+                    const auto xs = iter.innerStride(1);
+                    const auto ys = iter.innerStride(2);
+                    const uint64_t nSize1 = outer == 2 ? zShape[1] : 1;
 
                     for (auto i = start; i < stop; i++) {
+                        const uint64_t index0 = i / nSize1;
+                        const uint64_t index1 = i % nSize1;
 
-                        uint64_t index0 = i / nSize1;
-                        uint64_t index1 = i % nSize1;
-
-                        PRAGMA_OMP_SIMD
-                            for (uint64_t index2 = 0; index2 < nSize2; index2++) {
-                                for (uint64_t index3 = 0; index3 < nSize3; index3++) {
-                                    auto rX = x + (xStrides[0] * index0 + xStrides[1] * index1 + xStrides[2] * index2 + xStrides[3] * index3);
-                                    auto rY = y + (yStrides[0] * index0 + yStrides[1] * index1 + yStrides[2] * index2 + yStrides[3] * index3);
-                                    auto rZ = z + (zStrides[0] * index0 + zStrides[1] * index1 + zStrides[2] * index2 + zStrides[3] * index3);
-                                    *rZ = OpType::op(*rX, *rY);
-                                }
-                            }
-                    }
-
-                }
-                else if (kindOfLoop == sd::LoopKind::BROADCAST_5D) {
-
-                    int xRank = shape::rank(xShapeInfo);
-                    int yRank = shape::rank(yShapeInfo);
-
-                    auto  xStrides = shape::stride(xShapeInfo);
-                    auto  zStrides = shape::stride(zShapeInfo);
-
-                    Nd4jLong  yStrides[5] = { 0,0,0,0,0 };
-                    sd::ShapeUtils::copyCertainStridesFromShapeInfo(yShapeInfo, xRank, dimensionLength, dimension, yStrides);
-
-                    uint32_t nSize1 = shape::sizeAt(zShapeInfo, 1);
-                    uint32_t nSize2 = shape::sizeAt(zShapeInfo, 2);
-                    uint32_t nSize3 = shape::sizeAt(zShapeInfo, 3);
-                    uint32_t nSize4 = shape::sizeAt(zShapeInfo, 4);
-
-                    for (auto i = start; i < stop; i++) {
-
-                        uint32_t index0 = i / nSize1;
-                        uint32_t index1 = i % nSize1;
-
-                        PRAGMA_OMP_SIMD
-                            for (uint32_t index2 = 0; index2 < nSize2; index2++) {
-                                for (uint32_t index3 = 0; index3 < nSize3; index3++) {
-                                    for (uint32_t index4 = 0; index4 < nSize4; index4++) {
-                                        auto rX = x + (xStrides[0] * index0 + xStrides[1] * index1 + xStrides[2] * index2 + xStrides[3] * index3 + xStrides[4] * index4);
-                                        auto rY = y + (yStrides[0] * index0 + yStrides[1] * index1 + yStrides[2] * index2 + yStrides[3] * index3 + yStrides[4] * index4);
-                                        auto rZ = z + (zStrides[0] * index0 + zStrides[1] * index1 + zStrides[2] * index2 + zStrides[3] * index3 + zStrides[4] * index4);
-
-                                        *rZ = OpType::op(*rX, *rY);
-                                    }
-                                }
-                            }
-                    }
-
-                }
-                else if(shape::haveSameShapeAndStrides(xTadShapeShapeInfo, yShapeInfo) && shape::haveSameShapeAndStrides(xTadShapeShapeInfo, zTadShapeInfo)) {
-                    uint tadShapeShapeInfoCast[MAX_RANK];
-                    bool canCastX = sd::DataTypeUtils::castShapeInfo(xTadShapeShapeInfo, tadShapeShapeInfoCast);
-
-                    for (auto i = start; i < stop; i++) {
-                        auto oX = x + tadOffsets[i];
-                        auto oZ = z + zTadOffset[i];
+                        auto oX = x + xStrides[0] * index0 + xStrides[1] * index1;
+                        auto oY = y + yStrides[0] * index0 + yStrides[1] * index1;
+                        auto oZ = z + zStrides[0] * index0 + zStrides[1] * index1;
 
-                        PRAGMA_OMP_SIMD
-                        for (unsigned int f = 0; f < tadLength; f++) {
-                            auto offset = shape::indexOffset(f, xTadShapeShapeInfo, tadShapeShapeInfoCast, canCastX);
-                            oZ[offset] = OpType::op(oX[offset], y[offset]);
-                        }
+                        iter.forEachRow(0, innerLength, [&](const Nd4jLong *o, Nd4jLong length) {
+                            broadcastRow<X, Y, Z, OpType>(oX + o[1], xs, oY + o[2], ys, oZ + o[0], zs, length);
+                        });
                     }
                 }
-                else if(shape::haveSameShapeAndStrides(xTadShapeShapeInfo, yShapeInfo)) {
-                    uint tadShapeShapeInfoCast[MAX_RANK];
-                    uint tadShapeInfoZCast[MAX_RANK];
-                    bool canCastX = sd::DataTypeUtils::castShapeInfo(xTadShapeShapeInfo, tadShapeShapeInfoCast);
-                    bool canCastZ = sd::DataTypeUtils::castShapeInfo(zTadShapeInfo, tadShapeInfoZCast);
+                else {
+                    const Nd4jLong *shapeInfos[3] = {zTadShapeInfo, xTadShapeShapeInfo, yShapeInfo};
+                    const sd::NDIterator<3> iter(shapeInfos);
 
+                    if (iter.valid()) {
+                        const auto zs = iter.innerStride(0);
+                        const auto xs = iter.innerStride(1);
+                        const auto ys = iter.innerStride(2);
 
-                    for (auto i = start; i < stop; i++) {
-                        auto oZ = z + zTadOffset[i];
-                        auto oX = x + tadOffsets[i];
+                        for (auto i = start; i < stop; i++) {
+                            auto oX = x + tadOffsets[i];
+                            auto oZ = z + zTadOffset[i];
 
-                        PRAGMA_OMP_SIMD
-                        for (unsigned int f = 0; f < tadLength; f++) {
-                            auto offset = shape::indexOffset(f, xTadShapeShapeInfo, tadShapeShapeInfoCast, canCastX);
-                            auto zOffset = shape::indexOffset(f, zTadShapeInfo, tadShapeInfoZCast, canCastZ);
-                            oZ[zOffset] = OpType::op(oX[offset], y[offset]);
+                            iter.forEachRow(0, tadLength, [&](const Nd4jLong *o, Nd4jLong length) {
+                                broadcastRow<X, Y, Z, OpType>(oX + o[1], xs, y + o[2], ys, oZ + o[0], zs, length);
+                            });
                         }
                     }
-                }
-                else if(shape::haveSameShapeAndStrides(xTadShapeShapeInfo, zTadShapeInfo)) {
-                    uint tadShapeShapeInfoCast[MAX_RANK];
-                    uint yShapeInfoCast[MAX_RANK];
-                    bool canCastX = sd::DataTypeUtils::castShapeInfo(xTadShapeShapeInfo, tadShapeShapeInfoCast);
-                    bool canCastY = sd::DataTypeUtils::castShapeInfo(yShapeInfo, yShapeInfoCast);
-
-                    for (auto i = start; i < stop; i++) {
-                        auto oZ = z + zTadOffset[i];
-                        auto oX = x + tadOffsets[i];
-
-                        PRAGMA_OMP_SIMD
-                        for (unsigned int f = 0; f < tadLength; f++) {
-                            auto offset = shape::indexOffset(f, xTadShapeShapeInfo, tadShapeShapeInfoCast, canCastX);
-                            auto yOffset = shape::indexOffset(f, yShapeInfo, yShapeInfoCast, canCastY);
-                            oZ[offset] = OpType::op(oX[offset], y[yOffset]);
-                        }
-                    }
-                }
-                else if(shape::haveSameShapeAndStrides(yShapeInfo, zTadShapeInfo)) {
-                    uint tadShapeShapeInfoCast[MAX_RANK];
-                    uint yShapeInfoCast[MAX_RANK];
-                    bool canCastX = sd::DataTypeUtils::castShapeInfo(xTadShapeShapeInfo, tadShapeShapeInfoCast);
-                    bool canCastY = sd::DataTypeUtils::castShapeInfo(yShapeInfo, yShapeInfoCast);
-
-                    for (auto i = start; i < stop; i++) {
-                        auto oZ = z + zTadOffset[i];
-                        auto oX = x + tadOffsets[i];
-
-                        PRAGMA_OMP_SIMD
-                        for (unsigned int f = 0; f < tadLength; f++) {
-                            auto xOffset = shape::indexOffset(f, xTadShapeShapeInfo, tadShapeShapeInfoCast, canCastX);
-                            auto offset = shape::indexOffset(f, yShapeInfo, yShapeInfoCast, canCastY);
-                            oZ[offset] = OpType::op(oX[xOffset], y[offset]);
-                        }
-                    }
-                }
-                else {
-                    uint tadShapeShapeInfoCast[MAX_RANK];
-                    uint tadShapeInfoZCast[MAX_RANK];
-                    uint yShapeInfoCast[MAX_RANK];
-                    bool canCastX = sd::DataTypeUtils::castShapeInfo(xTadShapeShapeInfo, tadShapeShapeInfoCast);
-                    bool canCastY = sd::DataTypeUtils::castShapeInfo(yShapeInfo, yShapeInfoCast);
-                    bool canCastZ = sd::DataTypeUtils::castShapeInfo(zTadShapeInfo, tadShapeInfoZCast);
-
-                    for (auto i = start; i < stop; i++) {
-                        auto oZ = z + zTadOffset[i];
-                        auto oX = x + tadOffsets[i];
-
-                        PRAGMA_OMP_SIMD
-                        for (unsigned int f = 0; f < tadLength; f++) {
-                            auto xOffset = shape::indexOffset(f, xTadShapeShapeInfo, tadShapeShapeInfoCast, canCastX);
-                            auto yOffset = shape::indexOffset(f, yShapeInfo, yShapeInfoCast, canCastY);
-                            auto zOffset = shape::indexOffset(f, zTadShapeInfo, tadShapeInfoZCast, canCastZ);
-                            oZ[zOffset] = OpType::op(oX[xOffset], y[yOffset]);
+                    else {
+                        uint tadShapeShapeInfoCast[MAX_RANK];
+                        uint tadShapeInfoZCast[MAX_RANK];
+                        uint yShapeInfoCast[MAX_RANK];
+                        bool canCastX = sd::DataTypeUtils::castShapeInfo(xTadShapeShapeInfo, tadShapeShapeInfoCast);
+                        bool canCastY = sd::DataTypeUtils::castShapeInfo(yShapeInfo, yShapeInfoCast);
+                        bool canCastZ = sd::DataTypeUtils::castShapeInfo(zTadShapeInfo, tadShapeInfoZCast);
+
+                        for (auto i = start; i < stop; i++) {
+                            auto oZ = z + zTadOffset[i];
+                            auto oX = x + tadOffsets[i];
+
+                            PRAGMA_OMP_SIMD
+                            for (unsigned int f = 0; f < tadLength; f++) {
+                                auto xOffset = shape::indexOffset(f, xTadShapeShapeInfo, tadShapeShapeInfoCast, canCastX);
+                                auto yOffset = shape::indexOffset(f, yShapeInfo, yShapeInfoCast, canCastY);
+                                auto zOffset = shape::indexOffset(f, zTadShapeInfo, tadShapeInfoZCast, canCastZ);
+                                oZ[zOffset] = OpType::op(oX[xOffset], y[yOffset]);
+                            }
                         }
                     }
                 }
@@ -429,9 +345,7 @@ namespace broadcast {
                     auto oY = y + tadOffsets[i];
                     auto oZ = z + zTadOffset[i];
 
-                    PRAGMA_OMP_SIMD
-                    for (unsigned int f = 0; f < tadLength; f++)
-                        oZ[f] = OpType::op(x[f], oY[f]);
+                    sd::IsaDispatch<sd::kernels::BroadcastKernel<X, Y, Z, OpType>>::exec(x, oY, oZ, static_cast<Nd4jLong>(tadLength));
                 }
             }
             else if(kindOfLoop == sd::LoopKind::EWSNONZERO) {
@@ -444,95 +358,45 @@ namespace broadcast {
                         oZ[f * zEws] = OpType::op(x[f * xEws], oY[f * yEws]);
                 };
             }
-            else if(shape::haveSameShapeAndStrides(yTadShapeShapeInfo, xShapeInfo) && shape::haveSameShapeAndStrides(yTadShapeShapeInfo, zTadShapeInfo)) {
-                uint tadShapeShapeInfoCast[MAX_RANK];
-                bool canCastY = sd::DataTypeUtils::castShapeInfo(yTadShapeShapeInfo, tadShapeShapeInfoCast);
-
-                for (auto i = start; i < stop; i++) {
-                    auto oY = x + tadOffsets[i];
-                    auto oZ = z + zTadOffset[i];
-
-                    PRAGMA_OMP_SIMD
-                    for (unsigned int f = 0; f < tadLength; f++) {
-                        auto offset = shape::indexOffset(f, yTadShapeShapeInfo, tadShapeShapeInfoCast, canCastY);
-                        oZ[offset] = OpType::op(x[offset], oY[offset]);
-                    }
-                };
-            }
-            else if(shape::haveSameShapeAndStrides(yTadShapeShapeInfo, xShapeInfo)) {
-                uint tadShapeShapeInfoCast[MAX_RANK];
-                uint tadShapeInfoZCast[MAX_RANK];
-                bool canCastY = sd::DataTypeUtils::castShapeInfo(yTadShapeShapeInfo, tadShapeShapeInfoCast);
-                bool canCastZ = sd::DataTypeUtils::castShapeInfo(zTadShapeInfo, tadShapeInfoZCast);
-
-                for (auto i = start; i < stop; i++) {
-                    auto oZ = z + zTadOffset[i];
-                    auto oY = y + tadOffsets[i];
-
-                    PRAGMA_OMP_SIMD
-                    for (unsigned int f = 0; f < tadLength; f++) {
-                        auto offset = shape::indexOffset(f, yTadShapeShapeInfo, tadShapeShapeInfoCast, canCastY);
-                        auto zOffset = shape::indexOffset(f, zTadShapeInfo, tadShapeInfoZCast, canCastZ);
-                        oZ[zOffset] = OpType::op(x[offset], oY[offset]);
-                    }
-                };
-            }
-            else if(shape::haveSameShapeAndStrides(yTadShapeShapeInfo, zTadShapeInfo)) {
-                uint tadShapeShapeInfoCast[MAX_RANK];
-                uint xShapeInfoCast[MAX_RANK];
-                bool canCastX = sd::DataTypeUtils::castShapeInfo(xShapeInfo, xShapeInfoCast);
-                bool canCastY = sd::DataTypeUtils::castShapeInfo(yTadShapeShapeInfo, tadShapeShapeInfoCast);
-
-                for (auto i = start; i < stop; i++) {
-                    auto oZ = z + zTadOffset[i];
-                    auto oY = y + tadOffsets[i];
+            else {
+                const Nd4jLong *shapeInfos[3] = {zTadShapeInfo, xShapeInfo, yTadShapeShapeInfo};
+                const sd::NDIterator<3> iter(shapeInfos);
 
-                    PRAGMA_OMP_SIMD
-                    for (unsigned int f = 0; f < tadLength; f++) {
-                        auto offset = shape::indexOffset(f, yTadShapeShapeInfo, tadShapeShapeInfoCast, canCastY);
-                        auto xOffset = shape::indexOffset(f, yShapeInfo, xShapeInfoCast, canCastX);
-                        oZ[offset] = OpType::op(x[xOffset], oY[offset]);
-                    }
-                };
-            }
-            else if(shape::haveSameShapeAndStrides(xShapeInfo, zTadShapeInfo)) {
-                uint tadShapeShapeInfoCast[MAX_RANK];
-                uint xShapeInfoCast[MAX_RANK];
-                bool canCastX = sd::DataTypeUtils::castShapeInfo(xShapeInfo, xShapeInfoCast);
-                bool canCastY = sd::DataTypeUtils::castShapeInfo(yTadShapeShapeInfo, tadShapeShapeInfoCast);
+                if (iter.valid()) {
+                    const auto zs = iter.innerStride(0);
+                    const auto xs = iter.innerStride(1);
+                    const auto ys = iter.innerStride(2);
 
-                for (auto i = start; i < stop; i++) {
-                    auto oZ = z + zTadOffset[i];
-                    auto oY = y + tadOffsets[i];
+                    for (auto i = start; i < stop; i++) {
+                        auto oY = y + tadOffsets[i];
+                        auto oZ = z + zTadOffset[i];
 
-                    PRAGMA_OMP_SIMD
-                    for (unsigned int f = 0; f < tadLength; f++) {
-                        auto yOffset = shape::indexOffset(f, yTadShapeShapeInfo, tadShapeShapeInfoCast, canCastY);
-                        auto offset = shape::indexOffset(f, xShapeInfo, xShapeInfoCast, canCastX);
-                        oZ[offset] = OpType::op(x[offset], oY[yOffset]);
+                        iter.forEachRow(0, tadLength, [&](const Nd4jLong *o, Nd4jLong length) {
+                            broadcastRow<X, Y, Z, OpType>(x + o[1], xs, oY + o[2], ys, oZ + o[0], zs, length);
+                        });
                     }
-                };
-            }
-            else {
-                uint tadShapeShapeInfoCast[MAX_RANK];
-                uint tadShapeInfoZCast[MAX_RANK];
-                uint xShapeInfoCast[MAX_RANK];
-                bool canCastX = sd::DataTypeUtils::castShapeInfo(xShapeInfo, xShapeInfoCast);
-                bool canCastY = sd::DataTypeUtils::castShapeInfo(yTadShapeShapeInfo, tadShapeShapeInfoCast);
-                bool canCastZ = sd::DataTypeUtils::castShapeInfo(zTadShapeInfo, tadShapeInfoZCast);
+                }
+                else {
+                    uint tadShapeShapeInfoCast[MAX_RANK];
+                    uint tadShapeInfoZCast[MAX_RANK];
+                    uint xShapeInfoCast[MAX_RANK];
+                    bool canCastX = sd::DataTypeUtils::castShapeInfo(xShapeInfo, xShapeInfoCast);
+                    bool canCastY = sd::DataTypeUtils::castShapeInfo(yTadShapeShapeInfo, tadShapeShapeInfoCast);
+                    bool canCastZ = sd::DataTypeUtils::castShapeInfo(zTadShapeInfo, tadShapeInfoZCast);
 
-                for (auto i = start; i < stop; i++) {
-                    auto oZ = z + zTadOffset[i];
-                    auto oY = y + tadOffsets[i];
+                    for (auto i = start; i < stop; i++) {
+                        auto oZ = z + zTadOffset[i];
+                        auto oY = y + tadOffsets[i];
 
-                    PRAGMA_OMP_SIMD
-                    for (unsigned int f = 0; f < tadLength; f++) {
-                        auto xOffset = shape::indexOffset(f, xShapeInfo, xShapeInfoCast, canCastX);
-                        auto yOffset = shape::indexOffset(f, yTadShapeShapeInfo, tadShapeShapeInfoCast, canCastY);
-                        auto zOffset = shape::indexOffset(f, zTadShapeInfo, tadShapeInfoZCast, canCastZ);
-                        oZ[zOffset] = OpType::op(x[xOffset], oY[yOffset]);
-                    }
-                };
+                        PRAGMA_OMP_SIMD
+                        for (unsigned int f = 0; f < tadLength; f++) {
+                            auto xOffset = shape::indexOffset(f, xShapeInfo, xShapeInfoCast, canCastX);
+                            auto yOffset = shape::indexOffset(f, yTadShapeShapeInfo, tadShapeShapeInfoCast, canCastY);
+                            auto zOffset = shape::indexOffset(f, zTadShapeInfo, tadShapeInfoZCast, canCastZ);
+                            oZ[zOffset] = OpType::op(x[xOffset], oY[yOffset]);
+                        }
+                    };
+                }
             }
         }
 
@@ -781,23 +645,28 @@ static void execRank5(const X *x, const Nd4jLong *xShapeInfo, const Y *y, const
 template <typename X, typename  Y, typename Z, typename OpType>
 static void execDefault(const X *x, const Nd4jLong *xShapeInfo, const Y *y, const Nd4jLong *yShapeInfo, Z* z, const Nd4jLong *zShapeInfo) {
 
-    const bool xzSameOffsets = shape::haveSameShapeAndStrides(xShapeInfo, zShapeInfo);
-    const bool yzSameOffsets = shape::haveSameShapeAndStrides(yShapeInfo, zShapeInfo);
+    const int rank = shape::rank(zShapeInfo);
 
-    auto func = PRAGMA_THREADS_FOR{
-
-        int coords[MAX_RANK];
-        Nd4jLong xOffset, yOffset, zOffset;
+    // x and y have the same rank as z, dimensions they are broadcasted along get zero stride
+    Nd4jLong xStrides[MAX_RANK];
+    Nd4jLong yStrides[MAX_RANK];
+    sd::ShapeUtils::copyCertainStridesFromShapeInfo(xShapeInfo, rank, 0, nullptr, xStrides);
+    sd::ShapeUtils::copyCertainStridesFromShapeInfo(yShapeInfo, rank, 0, nullptr, yStrides);
 
-        for (auto i = start; i < stop; ++i) {
+    const Nd4jLong *strides[3] = {shape::stride(zShapeInfo), xStrides, yStrides};
+    const sd::NDIterator<3> iter(rank, shape::shapeOf(zShapeInfo), strides);
 
-            shape::getOffsetBroadcast(start, i, zShapeInfo, xShapeInfo, yShapeInfo, xzSameOffsets, yzSameOffsets, coords, zOffset, xOffset, yOffset);
+    const auto zs = iter.innerStride(0);
+    const auto xs = iter.innerStride(1);
+    const auto ys = iter.innerStride(2);
 
-            z[zOffset] = OpType::op(x[xOffset], y[yOffset]);
-        }
+    auto func = PRAGMA_THREADS_FOR{
+        iter.forEachRow(start, stop, [&](const Nd4jLong *o, Nd4jLong length) {
+            broadcastRow<X, Y, Z, OpType>(x + o[1], xs, y + o[2], ys, z + o[0], zs, length);
+        });
     };
 
-    samediff::Threads::parallel_for(func, 0, shape::length(zShapeInfo));
+    samediff::Threads::parallel_for(func, 0, iter.length());
 }
 
 ////////////////////////////////////////////////////////////////////////
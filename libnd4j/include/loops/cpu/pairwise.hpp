@@ -27,6 +27,8 @@
 #include <system/op_boilerplate.h>
 #include <helpers/OmpLaunchHelper.h>
 #include <execution/Threads.h>
+#include <helpers/IsaDispatch.h>
+#include <helpers/NDIterator.h>
 
 using namespace simdOps;
 
@@ -69,9 +71,7 @@ namespace functions {
             auto extraParams = reinterpret_cast<Z *>(vextraParams);
 
             if (xEws == 1 && yEws == 1 && zEws == 1) {
-                PRAGMA_OMP_SIMD
-                for (auto i = start; i < stop; i++)
-                        z[i] = OpType::op(x[i], y[i], extraParams);
+                sd::IsaDispatch<sd::kernels::PairwiseKernel<X, Y, Z, OpType>>::exec(x, y, z, extraParams, static_cast<Nd4jLong>(start), static_cast<Nd4jLong>(stop));
             }
             else {
                 PRAGMA_OMP_SIMD
@@ -119,17 +119,20 @@ namespace functions {
 
             if (shape::isScalar(yShapeInfo)) {
 
-                uint xShapeInfoCast[MAX_RANK];
-                const bool canCastX = sd::DataTypeUtils::castShapeInfo(xShapeInfo, xShapeInfoCast);
+                const Nd4jLong *shapeInfos[2] = {zShapeInfo, xShapeInfo};
+                const sd::NDIterator<2> iter(shapeInfos);
 
-                if(shape::haveSameShapeAndStrides(xShapeInfo, zShapeInfo)) {
-                    PRAGMA_OMP_SIMD
-                    for(auto i = start; i < stop; i++)  {
-                        auto offset = shape::indexOffset(i, xShapeInfo, xShapeInfoCast, canCastX);
-                        z[offset] = OpType::op(x[offset], y[0], extraParams);
-                    };
+                if (iter.valid()) {
+                    const auto zs = iter.innerStride(0);
+                    const auto xs = iter.innerStride(1);
+
+                    iter.forEachRow(start, stop, [&](const Nd4jLong *o, Nd4jLong length) {
+                        exec<OpType>(x + o[1], xs, y, 0, z + o[0], zs, extraParams, length, 0, length);
+                    });
                 }
                 else {
+                    uint xShapeInfoCast[MAX_RANK];
+                    const bool canCastX = sd::DataTypeUtils::castShapeInfo(xShapeInfo, xShapeInfoCast);
                     uint zShapeInfoCast[MAX_RANK];
                     const bool canCastZ = sd::DataTypeUtils::castShapeInfo(zShapeInfo, zShapeInfoCast);
 
@@ -155,55 +158,17 @@ namespace functions {
                 exec<OpType>(x, xEws, y, yEws, z, zEws, extraParams, shape::length(yShapeInfo), start, stop);
             }
             else {
+                const Nd4jLong *shapeInfos[3] = {zShapeInfo, xShapeInfo, yShapeInfo};
+                const sd::NDIterator<3> iter(shapeInfos);
 
-                if(shape::haveSameShapeAndStrides(xShapeInfo, yShapeInfo) && shape::haveSameShapeAndStrides(xShapeInfo, zShapeInfo)) {
-                    uint xShapeInfoCast[MAX_RANK];
-                    bool canCastX = sd::DataTypeUtils::castShapeInfo(xShapeInfo, xShapeInfoCast);
+                if (iter.valid()) {
+                    const auto zs = iter.innerStride(0);
+                    const auto xs = iter.innerStride(1);
+                    const auto ys = iter.innerStride(2);
 
-                    PRAGMA_OMP_SIMD
-                    for (auto i = start; i < stop; i++)  {
-                        auto offset = shape::indexOffset(i, xShapeInfo, xShapeInfoCast, canCastX);
-                        z[offset] = OpType::op(x[offset], y[offset], extraParams);
-                    }
-                }
-                else if(shape::haveSameShapeAndStrides(xShapeInfo, yShapeInfo)) {
-                    uint xShapeInfoCast[MAX_RANK];
-                    uint zShapeInfoCast[MAX_RANK];
-                    bool canCastX = sd::DataTypeUtils::castShapeInfo(xShapeInfo, xShapeInfoCast);
-                    bool canCastZ = sd::DataTypeUtils::castShapeInfo(zShapeInfo, zShapeInfoCast);
-
-                    PRAGMA_OMP_SIMD
-                    for (auto i = start; i < stop; i++)  {
-                        auto offset  = shape::indexOffset(i, xShapeInfo, xShapeInfoCast, canCastX);
-                        auto zOffset = shape::indexOffset(i, zShapeInfo, zShapeInfoCast, canCastZ);
-                        z[zOffset] = OpType::op(x[offset], y[offset], extraParams);
-                    };
-                }
-                else if(shape::haveSameShapeAndStrides(xShapeInfo, zShapeInfo)) {
-                    uint xShapeInfoCast[MAX_RANK];
-                    uint yShapeInfoCast[MAX_RANK];
-                    bool canCastX = sd::DataTypeUtils::castShapeInfo(xShapeInfo, xShapeInfoCast);
-                    bool canCastY = sd::DataTypeUtils::castShapeInfo(yShapeInfo, yShapeInfoCast);
-
-                    PRAGMA_OMP_SIMD
-                    for (auto i = start; i < stop; i++)  {
-                        auto offset  = shape::indexOffset(i, xShapeInfo, xShapeInfoCast, canCastX);
-                        auto yOffset = shape::indexOffset(i, yShapeInfo, yShapeInfoCast, canCastY);
-                        z[offset] = OpType::op(x[offset], y[yOffset], extraParams);
-                    };
-                }
-                else if(shape::haveSameShapeAndStrides(yShapeInfo, zShapeInfo)) {
-                    uint xShapeInfoCast[MAX_RANK];
-                    uint yShapeInfoCast[MAX_RANK];
-                    bool canCastX = sd::DataTypeUtils::castShapeInfo(xShapeInfo, xShapeInfoCast);
-                    bool canCastY = sd::DataTypeUtils::castShapeInfo(yShapeInfo, yShapeInfoCast);
-
-                    PRAGMA_OMP_SIMD
-                    for (auto i = start; i < stop; i++)  {
-                        auto xOffset = shape::indexOffset(i, xShapeInfo, xShapeInfoCast, canCastX);
-                        auto offset  = shape::indexOffset(i, yShapeInfo, yShapeInfoCast, canCastY);
-                        z[offset] = OpType::op(x[xOffset], y[offset], extraParams);
-                    };
+                    iter.forEachRow(start, stop, [&](const Nd4jLong *o, Nd4jLong length) {
+                        exec<OpType>(x + o[1], xs, y + o[2], ys, z + o[0], zs, extraParams, length, 0, length);
+                    });
                 }
                 else {
                     uint xShapeInfoCast[MAX_RANK];
@@ -23,6 +23,8 @@
 #include <types/types.h>
 #include <helpers/LoopKind.h>
 #include <execution/Threads.h>
+#include <helpers/IsaDispatch.h>
+#include <helpers/NDIterator.h>
 #include "../legacy_ops.h"
 
 using namespace simdOps;
@@ -61,7 +63,27 @@ void ScalarTransform<X, Y, Z>::transform(const void *vx, const Nd4jLong *xShapeI
     sd::LoopKind::Kind kindOfLoop = sd::LoopKind::deduceKindOfLoopXZ(xTadShapeInfo, zTadShapeInfo);
 
     if (kindOfLoop != sd::LoopKind::EWS1 && kindOfLoop != sd::LoopKind::EWSNONZERO) {
-        printf("ScalarTransform<X, Z>::transform: super-bad loop visited. Shouldn't ever happen\n");
+        // tads without element-wise stride (i.e. taken from permuted views) are walked row by row
+        const Nd4jLong *shapeInfos[2] = {zTadShapeInfo, xTadShapeInfo};
+        const sd::NDIterator<2> iter(shapeInfos);
+
+        if (!iter.valid()) {
+            printf("ScalarTransform<X, Z>::transform: super-bad loop visited. Shouldn't ever happen\n");
+            return;
+        }
+
+        const auto zs = iter.innerStride(0);
+        const auto xs = iter.innerStride(1);
+
+        for (auto r = start; r < stop; r++) {
+            auto oZ = z + zTadOffsets[r];
+            auto oX = x + xTadOffsets[r];
+
+            iter.forEachRow(0, tadLength, [&](const Nd4jLong *o, Nd4jLong length) {
+                transform<OpType>(oX + o[1], xs, oZ + o[0], zs, scalars + r, extraParams, length, 0, length);
+            });
+        }
+
         return;
     }
 
@@ -153,18 +175,20 @@ void ScalarTransform<X, Y, Z>::transform(const void *vx, const Nd4jLong *xShapeI
         transform<OpType>(x, xEws, z, zEws, vscalar, extraParams, len, start, stop);
     }
     else {
+        const Nd4jLong *shapeInfos[2] = {zShapeInfo, xShapeInfo};
+        const sd::NDIterator<2> iter(shapeInfos);
 
-        uint xShapeInfoCast[MAX_RANK];
-        const bool canCastX = sd::DataTypeUtils::castShapeInfo<uint>(xShapeInfo, xShapeInfoCast);
+        if (iter.valid()) {
+            const auto zs = iter.innerStride(0);
+            const auto xs = iter.innerStride(1);
 
-        if(shape::haveSameShapeAndStrides(xShapeInfo, zShapeInfo)) {
-            PRAGMA_OMP_SIMD
-            for (auto i = start; i < stop; i++) {
-                auto offset = shape::indexOffset(i, xShapeInfo, xShapeInfoCast, canCastX);
-                z[offset] = OpType::op(x[offset], scalar, extraParams);
-            };
+            iter.forEachRow(start, stop, [&](const Nd4jLong *o, Nd4jLong length) {
+                transform<OpType>(x + o[1], xs, z + o[0], zs, vscalar, extraParams, length, 0, length);
+            });
         }
         else {
+            uint xShapeInfoCast[MAX_RANK];
+            const bool canCastX = sd::DataTypeUtils::castShapeInfo<uint>(xShapeInfo, xShapeInfoCast);
             uint zShapeInfoCast[MAX_RANK];
             const bool canCastZ = sd::DataTypeUtils::castShapeInfo<uint>(zShapeInfo, zShapeInfoCast);
 
@@ -193,9 +217,7 @@ void ScalarTransform<X, Y, Z>::transform(const void *vx, Nd4jLong xEws,
     auto extraParams = reinterpret_cast<Z *>(vextraParams);
 
     if (xEws == 1 && zEws == 1) {
-        PRAGMA_OMP_SIMD
-        for (auto i = start; i < stop; i++)
-            z[i] = OpType::op(x[i], scalar, extraParams);
+        sd::IsaDispatch<sd::kernels::ScalarKernel<X, Y, Z, OpType>>::exec(x, z, scalar, extraParams, static_cast<Nd4jLong>(start), static_cast<Nd4jLong>(stop));
     }
     else {
         PRAGMA_OMP_SIMD
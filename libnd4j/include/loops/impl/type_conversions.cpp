@@ -23,6 +23,8 @@
 #include <loops/type_conversions.h>
 #include <helpers/OmpLaunchHelper.h>
 #include <execution/Threads.h>
+#include <helpers/LowPrecision.h>
+#include <vector>
 
 namespace sd {
 
@@ -89,84 +91,241 @@ namespace sd {
         samediff::Threads::parallel_for(func,  0, N);
     }
 
+    // elements are scanned in chunks, so every chunk knows where its part of encoded output starts before anything is written
+    static const Nd4jLong THRESHOLD_CHUNK = 65536;
+
+    struct ThresholdChunk {
+        // filled by scan
+        Nd4jLong count;
+        Nd4jLong first;
+        Nd4jLong last;
+        bool firstNegative;
+        // varint bytes taken by all elements except the first one, whose delta depends on previous chunks
+        Nd4jLong bytes;
+
+        // filled by planning
+        Nd4jLong allowed;
+        Nd4jLong elementOffset;
+        Nd4jLong byteOffset;
+        Nd4jLong previous;
+    };
+
+    template <typename T>
+    static FORCEINLINE int thresholdSign(T value, T tt, T mtt) {
+        if (value >= tt)
+            return 1;
+
+        if (value <= mtt)
+            return -1;
+
+        return 0;
+    }
+
+    static FORCEINLINE uint64_t varintValue(Nd4jLong index, Nd4jLong previous, bool negative) {
+        return (static_cast<uint64_t>(index - previous) << 1) | (negative ? 1 : 0);
+    }
+
+    static FORCEINLINE Nd4jLong varintLength(uint64_t value) {
+        Nd4jLong length = 1;
+        while (value >= 0x80) {
+            value >>= 7;
+            length++;
+        }
+
+        return length;
+    }
+
+    static FORCEINLINE uint8_t* varintWrite(uint8_t *stream, uint64_t value) {
+        while (value >= 0x80) {
+            *stream++ = static_cast<uint8_t>(value | 0x80);
+            value >>= 7;
+        }
+
+        *stream++ = static_cast<uint8_t>(value);
+        return stream;
+    }
+
+    /**
+     * This function calls function(delta, negative) for every varint that starts within [start, stop) bytes of the stream.
+     * Varint starts right after a byte without continuation bit, so any byte range can be walked independently
+     */
+    template <typename F>
+    static FORCEINLINE void varintForEach(const uint8_t *stream, Nd4jLong length, Nd4jLong start, Nd4jLong stop, F function) {
+        auto p = start;
+        while (p > 0 && p < stop && (stream[p - 1] & 0x80))
+            p++;
+
+        while (p < stop) {
+            uint64_t value = 0;
+            int shift = 0;
+            uint8_t byte;
+            do {
+                byte = stream[p++];
+                if (shift < 64)
+                    value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+                shift += 7;
+            } while ((byte & 0x80) && p < length);
+
+            function(static_cast<Nd4jLong>(value >> 1), (value & 1) != 0);
+        }
+    }
+
+    template <typename T>
+    static std::vector<ThresholdChunk> thresholdScan(const T *x, Nd4jLong N, T tt, bool varint) {
+        const T mtt = -tt;
+        const auto numChunks = (N + THRESHOLD_CHUNK - 1) / THRESHOLD_CHUNK;
+        std::vector<ThresholdChunk> chunks(numChunks);
+
+        auto func = PRAGMA_THREADS_FOR {
+            for (auto c = start; c < stop; c++) {
+                auto &chunk = chunks[c];
+                chunk.count = 0;
+                chunk.first = -1;
+                chunk.last = -1;
+                chunk.firstNegative = false;
+                chunk.bytes = 0;
+
+                const auto end = sd::math::nd4j_min<Nd4jLong>(N, (c + 1) * THRESHOLD_CHUNK);
+                for (Nd4jLong e = c * THRESHOLD_CHUNK; e < end; e++) {
+                    const auto sign = thresholdSign(x[e], tt, mtt);
+                    if (sign == 0)
+                        continue;
+
+                    if (chunk.count == 0) {
+                        chunk.first = e;
+                        chunk.firstNegative = sign < 0;
+                    } else if (varint)
+                        chunk.bytes += varintLength(varintValue(e, chunk.last, sign < 0));
+
+                    chunk.last = e;
+                    chunk.count++;
+                }
+            }
+        };
+
+        samediff::Threads::parallel_for(func, 0, numChunks);
+
+        return chunks;
+    }
+
+    /**
+     * This function decides how many elements every chunk encodes, and where they go. Elements are taken in index order,
+     * until either number of elements or number of bytes reaches its limit
+     */
+    template <typename T>
+    static void thresholdPlan(const T *x, Nd4jLong N, T tt, bool varint, std::vector<ThresholdChunk> &chunks, Nd4jLong maxElements, Nd4jLong maxBytes, Nd4jLong &elements, Nd4jLong &bytes) {
+        const T mtt = -tt;
+        Nd4jLong previous = -1;
+        bool exhausted = false;
+
+        elements = 0;
+        bytes = 0;
+
+        for (size_t c = 0; c < chunks.size(); c++) {
+            auto &chunk = chunks[c];
+            chunk.allowed = 0;
+            chunk.elementOffset = elements;
+            chunk.byteOffset = bytes;
+            chunk.previous = previous;
+
+            if (exhausted || chunk.count == 0)
+                continue;
+
+            const auto chunkBytes = varint ? chunk.bytes + varintLength(varintValue(chunk.first, previous, chunk.firstNegative)) : chunk.count * static_cast<Nd4jLong>(sizeof(int));
+            if (elements + chunk.count <= maxElements && bytes + chunkBytes <= maxBytes) {
+                chunk.allowed = chunk.count;
+                elements += chunk.count;
+                bytes += chunkBytes;
+                previous = chunk.last;
+                continue;
+            }
+
+            // this chunk fits partially, and nothing is encoded after it
+            exhausted = true;
+            const auto end = sd::math::nd4j_min<Nd4jLong>(N, (c + 1) * THRESHOLD_CHUNK);
+            for (Nd4jLong e = c * THRESHOLD_CHUNK; e < end && elements < maxElements; e++) {
+                const auto sign = thresholdSign(x[e], tt, mtt);
+                if (sign == 0)
+                    continue;
+
+                const auto length = varint ? varintLength(varintValue(e, previous, sign < 0)) : static_cast<Nd4jLong>(sizeof(int));
+                if (bytes + length > maxBytes)
+                    break;
+
+                bytes += length;
+                elements++;
+                chunk.allowed++;
+                previous = e;
+            }
+        }
+    }
+
     template <typename T>
     void TypeCast::convertToThreshold(Nd4jPointer * extras, void *dx, Nd4jLong N, void *dz) {
-        // we suppose that first 4 bytes are integer, second 4 bytes are float
-        // integer: enc length
-        // integer: dec length
-        // float: threshold
+        // header: limit, length, threshold, encoding type. varint header has 64-bit fields on top of that
         FloatBits fb;
         auto x = reinterpret_cast<T *>(dx);
         auto z = reinterpret_cast<int *>(dz);
-        int limit = z[0];
+        const Nd4jLong limit = z[0];
         fb.i_ = z[2];
-        float threshold = fb.f_;
-
-        // TODO: int limit is sad thing here, 2B elements limitation
-        auto l = static_cast<int>(N);
-        z[1] = l;
-
-#ifdef _OPENMP
-        int threads = OmpLaunchHelper::betterThreads(N);
-        auto span = OmpLaunchHelper::betterSpan(N, threads);
-#else
-        int threads = 1;
-        auto span = N;
-#endif
+        const bool varint = z[3] == THRESHOLD_VARINT_ENCODING;
+        auto hz = reinterpret_cast<Nd4jLong *>(z + THRESHOLD_HEADER_LENGTH);
 
+        if (!varint && N > DataTypeUtils::max<int>())
+            throw std::runtime_error("convertToThreshold: flexible encoding supports arrays with length <= MAX_INT only");
 
-        T tt = static_cast<T>(threshold);
-        T mtt = -tt;
-
-        // we use 3 as offset, since first 12 bytes are occupied with header
-        int flimit = limit + 4;
-        volatile int cnt = 4;
-        volatile bool flag = false;
-        PRAGMA_OMP_PARALLEL_THREADS(threads)
-        {
-            int tid = omp_get_thread_num();
-            int start = span * tid;
-            int stop = span * (tid + 1);
-            if (stop > l)
-                stop = l;
-
-            for (int e = start; e < stop; e++) {
-                bool flag_load;
-PRAGMA_OMP_ATOMIC_ARGS(read)
-                flag_load = flag;
-                if (flag_load)
-                    break;
+        z[1] = N > DataTypeUtils::max<int>() ? -1 : static_cast<int>(N);
+
+        const T tt = static_cast<T>(fb.f_);
+        const T mtt = -tt;
+
+        // for varint encoding, stream length holds its capacity on input
+        const Nd4jLong maxBytes = varint ? hz[2] : limit * static_cast<Nd4jLong>(sizeof(int));
+
+        auto chunks = thresholdScan<T>(x, N, tt, varint);
 
-                T cUpd = x[e];
-                if (cUpd >= tt) {
-                    int idx;
-PRAGMA_OMP_ATOMIC_ARGS(capture)
-                    idx = cnt++;
-
-                    if (idx >= flimit) {
-PRAGMA_OMP_ATOMIC_ARGS(write)
-                        flag = true;
-                        break;
-                    }
-
-                    z[idx] = e + 1;
-                    x[e] -= tt;
-                } else if (cUpd <= mtt) {
-                    int idx;
-PRAGMA_OMP_ATOMIC_ARGS(capture)
-                    idx = cnt++;
-
-                    if (idx >= flimit) {
-PRAGMA_OMP_ATOMIC_ARGS(write)
-                        flag = true;
-                        break;
-                    }
-
-
-                    z[idx] = -e - 1;
-                    x[e] += tt;
+        Nd4jLong elements, bytes;
+        thresholdPlan<T>(x, N, tt, varint, chunks, limit, maxBytes, elements, bytes);
+
+        auto indices = z + THRESHOLD_HEADER_LENGTH;
+        auto stream = reinterpret_cast<uint8_t *>(z + THRESHOLD_VARINT_HEADER_LENGTH);
+
+        // every chunk writes into its own part of output, so there's no synchronization here
+        auto func = PRAGMA_THREADS_FOR {
+            for (auto c = start; c < stop; c++) {
+                const auto &chunk = chunks[c];
+                auto idx = indices + chunk.elementOffset;
+                auto ptr = stream + chunk.byteOffset;
+                auto previous = chunk.previous;
+
+                Nd4jLong written = 0;
+                for (Nd4jLong e = c * THRESHOLD_CHUNK; written < chunk.allowed; e++) {
+                    const auto sign = thresholdSign(x[e], tt, mtt);
+                    if (sign == 0)
+                        continue;
+
+                    if (varint)
+                        ptr = varintWrite(ptr, varintValue(e, previous, sign < 0));
+                    else
+                        *idx++ = sign > 0 ? static_cast<int>(e + 1) : static_cast<int>(-e - 1);
+
+                    if (sign > 0)
+                        x[e] -= tt;
+                    else
+                        x[e] += tt;
+
+                    previous = e;
+                    written++;
                 }
             }
+        };
+
+        samediff::Threads::parallel_for(func, 0, chunks.size());
+
+        if (varint) {
+            hz[0] = N;
+            hz[1] = elements;
+            hz[2] = bytes;
         }
     }
 
@@ -175,22 +334,84 @@ PRAGMA_OMP_ATOMIC_ARGS(write)
         FloatBits fb;
         auto z = reinterpret_cast<T *>(dz);
         auto x = reinterpret_cast<const int *>(dx);
-        int limit = x[0];
         fb.i_ = x[2];
-        float threshold = fb.f_;
+        const T threshold = static_cast<T>(fb.f_);
+        const T mthreshold = static_cast<T>(-fb.f_);
+
+        if (x[3] != THRESHOLD_VARINT_ENCODING) {
+            const Nd4jLong limit = x[0];
+            auto indices = x + THRESHOLD_HEADER_LENGTH;
+
+            // every index is unique, so elements can be updated in parallel
+            auto func = PRAGMA_THREADS_FOR {
+                for (auto e = start; e < stop; e++) {
+                    int el = indices[e];
 
-        // we use 3 as offset, since first 12 bytes are occupied with header
-        int flimit = limit + 4;
+                    // slots left empty by encoder
+                    if (el == 0)
+                        continue;
+
+                    Nd4jLong ael = sd::math::nd4j_abs<int>(el) - 1;
+                    z[ael] += el > 0 ? threshold : mthreshold;
+                }
+            };
+
+            samediff::Threads::parallel_for(func, 0, limit);
+            return;
+        }
+
+        auto hx = reinterpret_cast<const Nd4jLong *>(x + THRESHOLD_HEADER_LENGTH);
+        auto stream = reinterpret_cast<const uint8_t *>(x + THRESHOLD_VARINT_HEADER_LENGTH);
+        const auto bytes = hx[2];
+        const auto numRanges = (bytes + THRESHOLD_CHUNK - 1) / THRESHOLD_CHUNK;
+
+        // indices are deltas from previous element, so every byte range needs the sum of deltas stored before it
+        std::vector<Nd4jLong> bases(numRanges + 1, 0);
+
+        auto sums = PRAGMA_THREADS_FOR {
+            for (auto r = start; r < stop; r++) {
+                Nd4jLong sum = 0;
+                varintForEach(stream, bytes, r * THRESHOLD_CHUNK, sd::math::nd4j_min<Nd4jLong>(bytes, (r + 1) * THRESHOLD_CHUNK), [&](Nd4jLong delta, bool negative) {
+                    sum += delta;
+                });
+
+                bases[r + 1] = sum;
+            }
+        };
+
+        samediff::Threads::parallel_for(sums, 0, numRanges);
+
+        bases[0] = -1;
+        for (Nd4jLong r = 1; r <= numRanges; r++)
+            bases[r] += bases[r - 1];
 
         auto func = PRAGMA_THREADS_FOR {
-            for (auto e = start; e < stop; e++) {
-                int el = x[e];
-                int ael = sd::math::nd4j_abs<int>(el) - 1;
-                z[ael] += el > 0 ? static_cast<T>(threshold) : static_cast<T>(-threshold);
+            for (auto r = start; r < stop; r++) {
+                auto index = bases[r];
+                varintForEach(stream, bytes, r * THRESHOLD_CHUNK, sd::math::nd4j_min<Nd4jLong>(bytes, (r + 1) * THRESHOLD_CHUNK), [&](Nd4jLong delta, bool negative) {
+                    index += delta;
+
+                    // malformed stream can produce zero delta for the first element, or overflow the running sum
+                    if (index >= 0 && index < N)
+                        z[index] += negative ? mthreshold : threshold;
+                });
             }
         };
 
-        samediff::Threads::parallel_for(func,  4, flimit);
+        samediff::Threads::parallel_for(func, 0, numRanges);
+    }
+
+    template <typename T>
+    Nd4jLong TypeCast::estimateThresholdVarint(const void *dx, Nd4jLong N, float threshold, Nd4jLong limit) {
+        auto x = reinterpret_cast<const T *>(dx);
+        const T tt = static_cast<T>(threshold);
+
+        auto chunks = thresholdScan<T>(x, N, tt, true);
+
+        Nd4jLong elements, bytes;
+        thresholdPlan<T>(x, N, tt, true, chunks, limit, DataTypeUtils::max<Nd4jLong>(), elements, bytes);
+
+        return bytes;
     }
 
     /**
@@ -208,9 +429,7 @@ PRAGMA_OMP_ATOMIC_ARGS(write)
         auto z = reinterpret_cast<T *>(dz);
 
         auto func = PRAGMA_THREADS_FOR {
-            for (auto i = start; i < stop; i++) {
-                z[i] = static_cast<T>(static_cast<float>(x[i]));
-            }
+            LowPrecision::cast<S, T>(x + start, z + start, stop - start);
         };
         samediff::Threads::parallel_for(func,  0, N);
     };
@@ -225,6 +444,11 @@ PRAGMA_OMP_ATOMIC_ARGS(write)
     template void TypeCast::convertToThreshold<float16>(Nd4jPointer * extras, void *dx, Nd4jLong N, void *dz);
     template void TypeCast::convertToThreshold<bfloat16>(Nd4jPointer * extras, void *dx, Nd4jLong N, void *dz);
 
+    template Nd4jLong TypeCast::estimateThresholdVarint<double>(const void *dx, Nd4jLong N, float threshold, Nd4jLong limit);
+    template Nd4jLong TypeCast::estimateThresholdVarint<float>(const void *dx, Nd4jLong N, float threshold, Nd4jLong limit);
+    template Nd4jLong TypeCast::estimateThresholdVarint<float16>(const void *dx, Nd4jLong N, float threshold, Nd4jLong limit);
+    template Nd4jLong TypeCast::estimateThresholdVarint<bfloat16>(const void *dx, Nd4jLong N, float threshold, Nd4jLong limit);
+
     template void TypeCast::convertFromQuantized<double>(Nd4jPointer * extras, void *dx, Nd4jLong N, void *dz);
     template void TypeCast::convertFromQuantized<float>(Nd4jPointer * extras, void *dx, Nd4jLong N, void *dz);
     template void TypeCast::convertFromQuantized<float16>(Nd4jPointer * extras, void *dx, Nd4jLong N, void *dz);
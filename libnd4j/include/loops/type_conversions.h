@@ -56,6 +56,23 @@ namespace sd {
         int i_;
     } FloatBits;
 
+    /**
+     * Threshold-encoded buffers start with 4 integers: [limit, length, threshold, encoding type]
+     *
+     * THRESHOLD_FLEXIBLE_ENCODING: header is followed by signed 1-based int32 indices of encoded elements
+     * THRESHOLD_VARINT_ENCODING: header is extended with 3 int64 values [length, number of encoded elements, stream length in bytes],
+     * and followed by byte stream. Every element is stored there as LEB128 varint of ((index - previousIndex) << 1 | sign)
+     */
+    enum ThresholdEncoding {
+        THRESHOLD_FLEXIBLE_ENCODING = 0,
+        THRESHOLD_BITMAP_ENCODING = 1,
+        THRESHOLD_VARINT_ENCODING = 2,
+    };
+
+    // header lengths, in int32 elements
+    static const int THRESHOLD_HEADER_LENGTH = 4;
+    static const int THRESHOLD_VARINT_HEADER_LENGTH = 10;
+
 
     class TypeCast {
 
@@ -69,6 +86,12 @@ namespace sd {
         template <typename T>
         static _CUDA_H void convertFromThreshold(Nd4jPointer * extras, const void *dx, Nd4jLong N, void *dz);
 
+        /**
+         * This method returns length of varint stream (in bytes, header excluded) threshold encoding of given array would produce
+         */
+        template <typename T>
+        static _CUDA_H Nd4jLong estimateThresholdVarint(const void *dx, Nd4jLong N, float threshold, Nd4jLong limit);
+
         FORCEINLINE static _CUDA_H Nd4jLong estimateQuantizedSize(Nd4jLong rawSize) {
             if (rawSize <= 0)
                 throw std::runtime_error("Input size for quantization can't be <= 0");
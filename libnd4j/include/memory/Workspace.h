@@ -58,6 +58,29 @@ namespace sd {
 
             bool _externalized = false;
 
+            // NUMA node host memory of this workspace was first touched on
+            int _numaNode = 0;
+
+            // chunked arena mode: overflow goes to chained chunks instead of individual spills
+            struct Chunk;
+            bool _chunked = false;
+            std::atomic<Chunk*> _chunk{nullptr};
+            std::vector<Chunk*> _chunks;
+
+            void* allocateChunked(Nd4jLong numBytes);
+            void resetChunks();
+            Nd4jLong chunkedUsage();
+
+            // per-thread sub-arena mode: threads bump-allocate from own slabs carved out of this workspace
+            bool _threadLocal = false;
+            Nd4jLong _slabSize = 0L;
+            const uint64_t _id = nextId();
+            std::atomic<uint64_t> _generation{0};
+
+            static uint64_t nextId();
+            void* allocateThreadLocal(Nd4jLong numBytes);
+            void* allocateShared(Nd4jLong numBytes);
+
             std::vector<void*> _spills;
             std::vector<void*> _spillsSecondary;
 
@@ -86,6 +109,8 @@ namespace sd {
             Nd4jLong getSpilledSecondarySize();
             Nd4jLong getUsedSecondarySize();
 
+            int numaNode();
+
             void expandBy(Nd4jLong primaryBytes, Nd4jLong secondaryBytes = 0L);
             void expandTo(Nd4jLong primaryBytes, Nd4jLong secondaryBytes = 0L);
 
@@ -94,6 +119,26 @@ namespace sd {
             void* allocateBytes(Nd4jLong numBytes);
             void* allocateBytes(MemoryType type, Nd4jLong numBytes);
 
+            /**
+             * This method switches workspace to chunked arena mode (CPU only). In this mode allocations are aligned and
+             * lock-free bump allocations, on overflow new chunk is chained instead of spilling every allocation.
+             * At scopeOut all chunks are merged into single primary buffer sized for peak usage of the finished cycle,
+             * so steady-state cycles don't allocate at all.
+             * Can be changed only while nothing is allocated from this workspace.
+             */
+            void setChunked(bool reallyChunked);
+            bool isChunked();
+
+            /**
+             * This method switches workspace to per-thread sub-arena mode (CPU only). In this mode every thread carves
+             * a slab of slabSize bytes out of this workspace, and serves its allocations from that slab without any
+             * synchronization. Allocations larger than a quarter of the slab go to workspace directly.
+             * All slabs are returned to this workspace at scopeOut.
+             * Can be changed only while nothing is allocated from this workspace.
+             */
+            void setThreadLocal(bool reallyThreadLocal, Nd4jLong slabSize = 65536L);
+            bool isThreadLocal();
+
             void scopeIn();
             void scopeOut();
 
@@ -29,10 +29,58 @@
 #include <helpers/logger.h>
 #include <math/templatemath.h>
 #include <cstring>
+#include <execution/AffinityManager.h>
 
 
 namespace sd {
     namespace memory {
+        // alignment of chunked allocations, good enough for any SIMD width we have
+        static const Nd4jLong CHUNK_ALIGNMENT = 64;
+
+        // smallest overflow chunk
+        static const Nd4jLong MIN_CHUNK_SIZE = 1024 * 1024;
+
+        // number of workspaces every thread keeps slabs for at the same time
+        static const int MAX_THREAD_SLABS = 4;
+
+        // slab of thread-local workspace owned by current thread
+        struct ThreadSlab {
+            uint64_t owner = 0;
+            uint64_t generation = 0;
+            char *ptr = nullptr;
+            Nd4jLong offset = 0;
+            Nd4jLong size = 0;
+        };
+
+        static thread_local ThreadSlab _threadSlabs[MAX_THREAD_SLABS];
+        static thread_local int _nextThreadSlab = 0;
+
+        struct Workspace::Chunk {
+            char *ptr;
+            Nd4jLong size;
+            std::atomic<Nd4jLong> offset;
+
+            // primary buffer is owned by workspace itself, chained chunks are owned by chunk
+            char *owned;
+
+            Chunk(char *buffer, Nd4jLong length, bool own) : offset(0) {
+                // aligning start of usable space
+                auto aligned = (reinterpret_cast<uintptr_t>(buffer) + CHUNK_ALIGNMENT - 1) & ~static_cast<uintptr_t>(CHUNK_ALIGNMENT - 1);
+                ptr = reinterpret_cast<char*>(aligned);
+                size = sd::math::nd4j_max<Nd4jLong>(0L, length - static_cast<Nd4jLong>(aligned - reinterpret_cast<uintptr_t>(buffer)));
+                owned = own ? buffer : nullptr;
+            }
+
+            ~Chunk() {
+                if (owned != nullptr)
+                    free(owned);
+            }
+
+            Nd4jLong used() {
+                return sd::math::nd4j_min<Nd4jLong>(offset.load(), size);
+            }
+        };
+
         Workspace::Workspace(ExternalWorkspace *external) {
             if (external->sizeHost() > 0) {
                 _ptrHost = (char *) external->pointerHost();
@@ -55,7 +103,9 @@ namespace sd {
 
                 CHECK_ALLOC(this->_ptrHost, "Failed to allocate new workspace", initialSize);
 
+                // first touch places pages on the node of the calling thread
                 memset(this->_ptrHost, 0, initialSize);
+                this->_numaNode = AffinityManager::currentNumaNode();
                 this->_allocatedHost = true;
             } else
                 this->_allocatedHost = false;
@@ -72,6 +122,10 @@ namespace sd {
 
         void Workspace::init(Nd4jLong bytes, Nd4jLong secondaryBytes) {
             if (this->_currentSize < bytes) {
+                // primary chunk points into current buffer, so it can't be replaced while chunks hold allocations
+                if (_chunked && chunkedUsage() > 0)
+                    throw std::runtime_error("Chunked workspace can't be expanded while there are allocations");
+
                 if (this->_allocatedHost && !_externalized)
                     free((void *)this->_ptrHost);
 
@@ -80,16 +134,25 @@ namespace sd {
                 CHECK_ALLOC(this->_ptrHost, "Failed to allocate new workspace", bytes);
 
                 memset(this->_ptrHost, 0, bytes);
+                this->_numaNode = AffinityManager::currentNumaNode();
                 this->_currentSize = bytes;
                 this->_allocatedHost = true;
+
+                // slabs carved from previous buffer are gone
+                _generation++;
+
+                if (_chunked)
+                    resetChunks();
             }
         }
 
         void Workspace::expandBy(Nd4jLong numBytes, Nd4jLong secondaryBytes) {
+            std::lock_guard<std::mutex> lock(_mutexAllocation);
             this->init(_currentSize + numBytes, _currentSizeSecondary + secondaryBytes);
         }
 
         void Workspace::expandTo(Nd4jLong numBytes, Nd4jLong secondaryBytes) {
+            std::lock_guard<std::mutex> lock(_mutexAllocation);
             this->init(numBytes, secondaryBytes);
         }
 
@@ -106,21 +169,170 @@ namespace sd {
         }
 
         Workspace::~Workspace() {
+            for (auto chunk: _chunks)
+                delete chunk;
+
             if (this->_allocatedHost && !_externalized)
                 free((void *)this->_ptrHost);
 
             freeSpills();
         }
 
+        void Workspace::setChunked(bool reallyChunked) {
+            std::lock_guard<std::mutex> lock(_mutexAllocation);
+            if (reallyChunked == _chunked)
+                return;
+
+            if (_offset.load() > 0 || _spillsSize.load() > 0 || chunkedUsage() > 0)
+                throw std::runtime_error("Workspace mode can't be changed while there are allocations");
+
+            _chunked = reallyChunked;
+            resetChunks();
+        }
+
+        bool Workspace::isChunked() {
+            return _chunked;
+        }
+
+        void Workspace::resetChunks() {
+            for (auto chunk: _chunks)
+                delete chunk;
+
+            _chunks.clear();
+            _chunk = nullptr;
+
+            if (_chunked && _currentSize > 0) {
+                auto primary = new Chunk(_ptrHost, _currentSize, false);
+                _chunks.emplace_back(primary);
+                _chunk = primary;
+            }
+        }
+
+        Nd4jLong Workspace::chunkedUsage() {
+            Nd4jLong used = 0;
+            for (auto chunk: _chunks)
+                used += chunk->used();
+
+            return used;
+        }
+
+        void* Workspace::allocateChunked(Nd4jLong numBytes) {
+            const auto aligned = (numBytes + CHUNK_ALIGNMENT - 1) & ~(CHUNK_ALIGNMENT - 1);
+
+            while (true) {
+                // fast path: just bumping offset of current chunk
+                auto chunk = _chunk.load(std::memory_order_acquire);
+                if (chunk != nullptr) {
+                    auto offset = chunk->offset.fetch_add(aligned, std::memory_order_relaxed);
+                    if (offset + aligned <= chunk->size)
+                        return chunk->ptr + offset;
+                }
+
+                // current chunk is exhausted, so we chain the next one, unless another thread already did that
+                std::lock_guard<std::mutex> lock(_mutexAllocation);
+                if (_chunk.load() != chunk)
+                    continue;
+
+                auto size = sd::math::nd4j_max<Nd4jLong>(aligned + CHUNK_ALIGNMENT, sd::math::nd4j_max<Nd4jLong>(MIN_CHUNK_SIZE, chunk == nullptr ? 0L : chunk->size * 2));
+                auto buffer = (char *) malloc(size);
+
+                CHECK_ALLOC(buffer, "Failed to allocate new workspace chunk", size);
+
+                auto next = new Chunk(buffer, size, true);
+                _chunks.emplace_back(next);
+                _chunk.store(next, std::memory_order_release);
+
+                nd4j_debug("Chaining workspace chunk of %lld bytes\n", size);
+            }
+        }
+
+        uint64_t Workspace::nextId() {
+            // ids are never reused, so stale slabs of destroyed workspaces can't be mistaken for slabs of new ones
+            static std::atomic<uint64_t> counter(0);
+            return ++counter;
+        }
+
+        void Workspace::setThreadLocal(bool reallyThreadLocal, Nd4jLong slabSize) {
+            if (slabSize < CHUNK_ALIGNMENT * 4)
+                throw std::runtime_error("Thread-local workspace slab size is too small");
+
+            std::lock_guard<std::mutex> lock(_mutexAllocation);
+            if (reallyThreadLocal == _threadLocal && slabSize == _slabSize)
+                return;
+
+            if (_offset.load() > 0 || _spillsSize.load() > 0 || chunkedUsage() > 0)
+                throw std::runtime_error("Workspace mode can't be changed while there are allocations");
+
+            _threadLocal = reallyThreadLocal;
+            _slabSize = slabSize;
+            _generation++;
+        }
+
+        bool Workspace::isThreadLocal() {
+            return _threadLocal;
+        }
+
+        void* Workspace::allocateThreadLocal(Nd4jLong numBytes) {
+            const auto aligned = (numBytes + CHUNK_ALIGNMENT - 1) & ~(CHUNK_ALIGNMENT - 1);
+
+            // big allocations would waste most of the slab
+            if (aligned > _slabSize / 4)
+                return allocateShared(numBytes);
+
+            const auto generation = _generation.load(std::memory_order_acquire);
+
+            ThreadSlab *slab = nullptr;
+            for (auto &s: _threadSlabs) {
+                if (s.owner == _id) {
+                    slab = &s;
+                    break;
+                }
+            }
+
+            // slabs carved before last scopeOut are gone already
+            if (slab != nullptr && slab->generation != generation)
+                slab->size = 0;
+
+            if (slab == nullptr || slab->offset + aligned > slab->size) {
+                if (slab == nullptr) {
+                    slab = &_threadSlabs[_nextThreadSlab];
+                    _nextThreadSlab = (_nextThreadSlab + 1) % MAX_THREAD_SLABS;
+                }
+
+                // extra space is reserved so slab could be aligned regardless of where parent put it
+                auto buffer = reinterpret_cast<uintptr_t>(allocateShared(_slabSize + CHUNK_ALIGNMENT));
+                auto start = (buffer + CHUNK_ALIGNMENT - 1) & ~static_cast<uintptr_t>(CHUNK_ALIGNMENT - 1);
+
+                slab->owner = _id;
+                slab->generation = generation;
+                slab->ptr = reinterpret_cast<char*>(start);
+                slab->offset = 0;
+                slab->size = _slabSize;
+            }
+
+            auto result = slab->ptr + slab->offset;
+            slab->offset += aligned;
+            return result;
+        }
+
         Nd4jLong Workspace::getUsedSize() {
             return getCurrentOffset();
         }
 
+        int Workspace::numaNode() {
+            return _numaNode;
+        }
+
         Nd4jLong Workspace::getCurrentSize() {
             return _currentSize;
         }
 
         Nd4jLong Workspace::getCurrentOffset() {
+            if (_chunked) {
+                std::lock_guard<std::mutex> lock(_mutexAllocation);
+                return chunkedUsage();
+            }
+
             return _offset.load();
         }
 
@@ -129,6 +341,15 @@ namespace sd {
             if (numBytes < 1)
                 throw allocation_exception::build("Number of bytes for allocation should be positive", numBytes);
 
+            if (_threadLocal)
+                return allocateThreadLocal(numBytes);
+
+            return allocateShared(numBytes);
+        }
+
+        void* Workspace::allocateShared(Nd4jLong numBytes) {
+            if (_chunked)
+                return allocateChunked(numBytes);
 
             //numBytes += 32;
             void* result = nullptr;
@@ -168,17 +389,59 @@ namespace sd {
         }
 
         void Workspace::scopeIn() {
-            freeSpills();
-            init(_cycleAllocations.load());
+            // chunked workspace is already resized at scopeOut
+            if (!_chunked) {
+                freeSpills();
+                init(_cycleAllocations.load());
+            }
+
+            // spills might have been released, so slabs carved from them are gone too
+            _generation++;
             _cycleAllocations = 0;
         }
 
         void Workspace::scopeOut() {
+            if (_chunked) {
+                std::lock_guard<std::mutex> lock(_mutexAllocation);
+
+                bool chained = false;
+                for (auto chunk: _chunks)
+                    chained |= chunk->owned != nullptr;
+
+                // if we had to chain chunks during this cycle - primary buffer is resized to fit whole cycle next time
+                if (chained) {
+                    auto peak = chunkedUsage() + CHUNK_ALIGNMENT;
+
+                    // chunks must be released before primary buffer is reallocated
+                    for (auto chunk: _chunks)
+                        delete chunk;
+
+                    _chunks.clear();
+                    init(peak);
+                }
+
+                resetChunks();
+            }
+
+            // all thread slabs are returned to workspace
+            _generation++;
+
             _offset = 0;
             _offsetSecondary = 0;
         }
 
         Nd4jLong Workspace::getSpilledSize() {
+            if (_chunked) {
+                // in chunked mode everything outside of primary buffer is treated as spilled
+                std::lock_guard<std::mutex> lock(_mutexAllocation);
+                Nd4jLong spilled = 0;
+                for (auto chunk: _chunks)
+                    if (chunk->owned != nullptr)
+                        spilled += chunk->size;
+
+                return spilled;
+            }
+
             return _spillsSize.load();
         }
 
@@ -211,7 +474,13 @@ namespace sd {
 
         Workspace* Workspace::clone() {
             // for clone we take whatever is higher: current allocated size, or allocated size of current loop
-            return new Workspace(sd::math::nd4j_max<Nd4jLong >(this->getCurrentSize(), this->_cycleAllocations.load()));
+            auto result = new Workspace(sd::math::nd4j_max<Nd4jLong >(this->getCurrentSize(), this->_cycleAllocations.load()));
+            result->setChunked(_chunked);
+
+            if (_threadLocal)
+                result->setThreadLocal(true, _slabSize);
+
+            return result;
         }
     }
 }
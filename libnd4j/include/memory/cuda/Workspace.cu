@@ -152,6 +152,10 @@ namespace sd {
             return getCurrentOffset();
         }
 
+        int Workspace::numaNode() {
+            return _numaNode;
+        }
+
         Nd4jLong Workspace::getCurrentSize() {
             return _currentSize;
         }
@@ -268,6 +272,29 @@ namespace sd {
             }
         }
 
+        void Workspace::setChunked(bool reallyChunked) {
+            if (reallyChunked)
+                throw std::runtime_error("Chunked workspace mode isn't supported on CUDA");
+        }
+
+        bool Workspace::isChunked() {
+            return false;
+        }
+
+        uint64_t Workspace::nextId() {
+            static std::atomic<uint64_t> counter(0);
+            return ++counter;
+        }
+
+        void Workspace::setThreadLocal(bool reallyThreadLocal, Nd4jLong slabSize) {
+            if (reallyThreadLocal)
+                throw std::runtime_error("Thread-local workspace mode isn't supported on CUDA");
+        }
+
+        bool Workspace::isThreadLocal() {
+            return false;
+        }
+
         Workspace* Workspace::clone() {
             // for clone we take whatever is higher: current allocated size, or allocated size of current loop
             return new Workspace(sd::math::nd4j_max<Nd4jLong >(this->getCurrentSize(), this->_cycleAllocations.load()));
@@ -33,11 +33,14 @@
 #include <helpers/OpArgsHolder.h>
 #include <system/dll.h>
 #include <ops/declarable/EmptyHandling.h>
+#include <ops/declarable/PlatformHelper.h>
+#include <execution/Engine.h>
 //#include <ops/declarable/declarable_ops.h>
 
 #include <chrono>
 #include <ctime>
 #include <mutex>
+#include <atomic>
 
 using namespace sd::graph;
 
@@ -69,6 +72,10 @@ namespace sd {
             std::mutex _registrator;
             bool _registered = false;
             std::string _name;
+
+            // platform helper lookup is a map access, so it's resolved once per engine
+            std::atomic<sd::ops::platforms::PlatformHelper*> _helpers[2] = {{nullptr}, {nullptr}};
+            std::atomic<bool> _helpersResolved[2] = {{false}, {false}};
         protected:
             OpDescriptor *_descriptor;
             NDArray *_scalar = nullptr;
@@ -114,6 +121,11 @@ namespace sd {
             int prepareOutputs(Context& block);
 
             virtual samediff::EmptyHandling emptyHandling();
+
+            /**
+             * This method returns platform helper registered for this op and given engine, or nullptr if there's none
+             */
+            sd::ops::platforms::PlatformHelper* platformHelper(samediff::Engine engine);
         public:
             // for special cases, like BooleanOps
             DeclarableOp();
@@ -135,6 +147,13 @@ namespace sd {
 
             virtual Nd4jStatus validateDataTypes(Context& block);
 
+            /**
+             * This method returns true if output shapes of this op depend only on input shapes and op arguments,
+             * so they stay the same for the same input shapes. Shape functions reading input arrays (i.e. axis passed as array)
+             * are detected by ExecutionPlan on its own, so only ops with other runtime-dependent shapes have to return false
+             */
+            virtual bool hasStaticShapes();
+
             /**
             *   This method should be available in each implemented Op, and should return Op output shape(s), for a given input shape(s)
             */
@@ -0,0 +1,74 @@
+/*******************************************************************************
+ * Copyright (c) 2015-2018 Skymind, Inc.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+#ifndef LIBND4J_LEGACYFUSEDOP_H
+#define LIBND4J_LEGACYFUSEDOP_H
+
+#include <ops/declarable/LegacyOp.h>
+#include <ops/declarable/helpers/fused_elementwise.h>
+
+namespace sd {
+    namespace ops {
+        /**
+        *   This class provides wrapper for chain of elementwise legacy ops (transform same/float/strict, scalar and pairwise),
+        *   executed as single op. Input 0 is the input of the first op in chain, other inputs are operands of pairwise steps.
+        *
+        *   Chain is applied in a single pass over memory whenever arrays allow that, otherwise ops are executed one by one
+        */
+        class ND4J_EXPORT LegacyFusedOp : public LegacyOp {
+        protected:
+            struct Step {
+                helpers::FusedStepKind kind;
+                int opNum;
+
+                // this op is owned by chain, and is used if fused pass isn't possible
+                LegacyOp *op;
+
+                std::vector<double> tArgs;
+                std::vector<Nd4jLong> iArgs;
+
+                // index of pairwise operand within inputs, or -1
+                int operand;
+                bool reversed;
+            };
+
+            std::vector<Step> _steps;
+
+            Nd4jStatus validateAndExecute(Context& block) override;
+
+            bool canFuse(Context& block);
+            Nd4jStatus executeFused(Context& block);
+            Nd4jStatus executeSequential(Context& block);
+
+        public:
+            LegacyFusedOp();
+            ~LegacyFusedOp();
+
+            /**
+             * This method appends op to the end of chain. Chain takes ownership of the op
+             */
+            void appendStep(helpers::FusedStepKind kind, int opNum, LegacyOp *op, const std::vector<double> &tArgs, const std::vector<Nd4jLong> &iArgs, int operand = -1, bool reversed = false);
+
+            int numberOfSteps();
+
+            ShapeList* calculateOutputShape(ShapeList* inputShape, sd::graph::Context& block) override;
+            LegacyOp* clone() override;
+        };
+    }
+}
+
+
+#endif //LIBND4J_LEGACYFUSEDOP_H
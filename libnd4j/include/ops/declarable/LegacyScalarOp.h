@@ -39,6 +39,9 @@ namespace sd {
 
             ShapeList* calculateOutputShape(ShapeList* inputShape, sd::graph::Context& block) override;
             LegacyOp* clone() override;
+
+            // scalar operand, used if neither second input nor T argument is provided
+            NDArray* scalar();
         };
     }
 }
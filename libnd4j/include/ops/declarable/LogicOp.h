@@ -39,6 +39,7 @@ namespace sd {
             LogicOp(const char *name);
 
             ShapeList* calculateOutputShape(ShapeList* inputShape, sd::graph::Context &block) override;
+            bool hasStaticShapes() override;
         };
     }
 }
@@ -21,6 +21,7 @@
 #include <system/op_boilerplate.h>
 #include <ops/declarable/CustomOperations.h>
 #include <ops/declarable/helpers/threshold.h>
+#include <loops/type_conversions.h>
 
 namespace sd {
     namespace ops {
@@ -30,19 +31,37 @@ namespace sd {
             auto encoded = OUTPUT_NULLIFIED(1);
 
             float threshold = T_ARG(0);
-
-            REQUIRE_TRUE(x->lengthOf() <= DataTypeUtils::max<int>(), 0, "encode_threshold: gradients array must have length <= MAX_INT");
-            REQUIRE_TRUE(encoded->lengthOf() >= 4, 0, "encode_threshold: array for encoded updates can't have less than 4 elements");
+            const bool varint = block.numI() > 1 && I_ARG(1) != 0;
+            const int headerLength = varint ? THRESHOLD_VARINT_HEADER_LENGTH : THRESHOLD_HEADER_LENGTH;
+
+#ifdef __CUDABLAS__
+            REQUIRE_TRUE(!varint, 0, "encode_threshold: varint encoding isn't supported on CUDA");
+#endif
+            REQUIRE_TRUE(varint || x->lengthOf() <= DataTypeUtils::max<int>(), 0, "encode_threshold: gradients array must have length <= MAX_INT");
+            REQUIRE_TRUE(encoded->lengthOf() >= headerLength, 0, "encode_threshold: array for encoded updates can't have less than %i elements", headerLength);
 //            REQUIRE_TRUE(x->platformBuffer() == updated->platformBuffer(), 0, "encode_threshold: gradients array must be the same at input and output");
 
             // filling header bytes
-            encoded->p(0, encoded->lengthOf() - 4);
-            encoded->p(1, (int) x->lengthOf());
-            encoded->p(2, reinterpret_cast<int *>(&threshold)[0]);
-            encoded->p(3, 0); // flag for FLEXIBLE_ENCODING
+            if (varint) {
+                encoded->p(0, (int) I_ARG(0));
+                encoded->p(1, x->lengthOf() <= DataTypeUtils::max<int>() ? (int) x->lengthOf() : -1);
+                encoded->p(2, reinterpret_cast<int *>(&threshold)[0]);
+                encoded->p(3, (int) THRESHOLD_VARINT_ENCODING);
+
+                // array length, number of encoded elements and capacity of the stream, the latter becomes stream length once encoded
+                auto header = reinterpret_cast<Nd4jLong *>(encoded->bufferAsT<int>() + THRESHOLD_HEADER_LENGTH);
+                header[0] = x->lengthOf();
+                header[1] = 0;
+                header[2] = (encoded->lengthOf() - headerLength) * sizeof(int);
+            } else {
+                encoded->p(0, encoded->lengthOf() - 4);
+                encoded->p(1, (int) x->lengthOf());
+                encoded->p(2, reinterpret_cast<int *>(&threshold)[0]);
+                encoded->p(3, (int) THRESHOLD_FLEXIBLE_ENCODING);
+            }
 
             // if there's no updates to process - just skip execution
-            if (encoded->lengthOf() == 4)
+            if (encoded->lengthOf() == headerLength)
                 return Status::OK();
 
             helpers::thresholdEncode(*x, *encoded, threshold);
@@ -53,17 +72,25 @@ namespace sd {
         DECLARE_SHAPE_FN(encode_threshold) {
             auto x = INPUT_VARIABLE(0);
             // we have limit option here
-            int boundary = block.numI() > 0 ? I_ARG(0) : DataTypeUtils::max<int>();
+            Nd4jLong boundary = block.numI() > 0 ? I_ARG(0) : DataTypeUtils::max<int>();
             float threshold = T_ARG(0);
 
             REQUIRE_TRUE(boundary >= 0, 0, "encode_threshold: boundary must be positive");
-            REQUIRE_TRUE(x->lengthOf() <= DataTypeUtils::max<int>(), 0, "encode_threshold: gradients array must have length <= MAX_INT");
+
+            const bool varint = block.numI() > 1 && I_ARG(1) != 0;
+            REQUIRE_TRUE(varint || x->lengthOf() <= DataTypeUtils::max<int>(), 0, "encode_threshold: gradients array must have length <= MAX_INT");
 
             // we must calculate number of elements that >= threshold
-            auto elements = sd::math::nd4j_min<int>(helpers::thresholdEstimate(*x, threshold), boundary);
+            auto elements = sd::math::nd4j_min<Nd4jLong>(helpers::thresholdEstimate(*x, threshold), boundary);
             if (elements < 2)
                 elements = 0;
 
+            // varint stream is packed into int32 elements, after extended header
+            if (varint) {
+                const auto bytes = elements > 0 ? helpers::thresholdEstimateVarint(*x, threshold, elements) : 0;
+                return SHAPELIST(x->shapeInfo(), sd::ConstantShapeHelper::getInstance().vectorShapeInfo(THRESHOLD_VARINT_HEADER_LENGTH + (bytes + 3) / 4, DataType::INT32));
+            }
+
             // result array must have 4 additional int elements for header
             return SHAPELIST(x->shapeInfo(), sd::ConstantShapeHelper::getInstance().vectorShapeInfo(elements + 4, DataType::INT32));
         }
@@ -81,8 +108,21 @@ namespace sd {
             auto updates = OUTPUT_VARIABLE(0);
 
             REQUIRE_TRUE(encoded->lengthOf() >= 4, 0, "decode_threshold: encoded array can't have length < 4");
-            REQUIRE_TRUE(updates->lengthOf() == encoded->e<int>(1), 0, "decode_threshold: updates array must have length equal to [%i]", encoded->e<int>(1));
-            REQUIRE_TRUE(encoded->e<int>(3) == 0, 0, "decode_threshold: encoded array doesn't look like threshold-encoded");
+
+            const auto encoding = encoded->e<int>(3);
+            REQUIRE_TRUE(encoding == THRESHOLD_FLEXIBLE_ENCODING || encoding == THRESHOLD_VARINT_ENCODING, 0, "decode_threshold: encoded array doesn't look like threshold-encoded");
+
+            if (encoding == THRESHOLD_VARINT_ENCODING) {
+#ifdef __CUDABLAS__
+                REQUIRE_TRUE(false, 0, "decode_threshold: varint encoding isn't supported on CUDA");
+#endif
+                REQUIRE_TRUE(encoded->lengthOf() >= THRESHOLD_VARINT_HEADER_LENGTH, 0, "decode_threshold: varint-encoded array can't have length < %i", THRESHOLD_VARINT_HEADER_LENGTH);
+
+                auto header = reinterpret_cast<const Nd4jLong *>(encoded->bufferAsT<int>() + THRESHOLD_HEADER_LENGTH);
+                REQUIRE_TRUE(updates->lengthOf() == header[0], 0, "decode_threshold: updates array must have length equal to [%lld]", header[0]);
+                REQUIRE_TRUE(header[2] <= (encoded->lengthOf() - THRESHOLD_VARINT_HEADER_LENGTH) * (Nd4jLong) sizeof(int), 0, "decode_threshold: varint stream doesn't fit into encoded array");
+            } else
+                REQUIRE_TRUE(updates->lengthOf() == encoded->e<int>(1), 0, "decode_threshold: updates array must have length equal to [%i]", encoded->e<int>(1));
 
             helpers::thresholdDecode(*encoded, *updates);
 
@@ -0,0 +1,67 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// @author raver119@gmail.com
+//
+
+#include <system/op_boilerplate.h>
+#if NOT_EXCLUDED(OP_quantization_range)
+
+#include <ops/declarable/CustomOperations.h>
+#include <ops/declarable/helpers/quantization.h>
+
+namespace sd {
+    namespace ops {
+        CUSTOM_OP_IMPL(quantization_range, 1, 3, false, -2, -2) {
+            auto input = INPUT_VARIABLE(0);
+            auto range = block.width() > 1 ? INPUT_VARIABLE(1) : nullptr;
+
+            auto outRange = OUTPUT_VARIABLE(0);
+            auto scale = OUTPUT_VARIABLE(1);
+            auto zeroPoint = OUTPUT_VARIABLE(2);
+
+            const float momentum = block.getTArguments()->size() > 0 ? T_ARG(0) : 0.f;
+
+            REQUIRE_TRUE(!input->isEmpty(), 0, "quantization_range: input array can't be empty");
+            REQUIRE_TRUE(range == nullptr || range->lengthOf() == 2, 0, "quantization_range: range should have length 2, but got %i instead", (int) range->lengthOf());
+            REQUIRE_TRUE(momentum >= 0.f && momentum < 1.f, 0, "quantization_range: momentum should be within [0, 1), but got %f instead", momentum);
+
+            helpers::quantizationRange(*input, range, momentum, *outRange, *scale, *zeroPoint);
+
+            return Status::OK();
+        }
+
+        DECLARE_SHAPE_FN(quantization_range) {
+            const auto dtype = block.getIArguments()->size() > 0 && INT_ARG(0) == 1 ? DataType::INT8 : DataType::UINT8;
+            auto rangeType = block.width() > 1 ? ArrayOptions::dataType(inputShape->at(1)) : DataType::FLOAT32;
+
+            return SHAPELIST(ConstantShapeHelper::getInstance().vectorShapeInfo(2, rangeType),
+                             ConstantShapeHelper::getInstance().scalarShapeInfo(DataType::FLOAT32),
+                             ConstantShapeHelper::getInstance().scalarShapeInfo(dtype));
+        }
+
+        DECLARE_TYPES(quantization_range) {
+            getOpDescriptor()
+                    ->setAllowedInputTypes({ALL_FLOATS})
+                    ->setAllowedOutputTypes(0, {ALL_FLOATS})
+                    ->setAllowedOutputTypes(1, {DataType::FLOAT32})
+                    ->setAllowedOutputTypes(2, {DataType::INT8, DataType::UINT8});
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,101 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// @author raver119@gmail.com
+//
+
+#include <system/op_boilerplate.h>
+#include <ops/declarable/CustomOperations.h>
+#include <ops/declarable/helpers/quantization.h>
+
+namespace sd {
+    namespace ops {
+#if NOT_EXCLUDED(OP_quantize_linear)
+        CUSTOM_OP_IMPL(quantize_linear, 3, 1, false, 0, 0) {
+            auto input = INPUT_VARIABLE(0);
+            auto scale = INPUT_VARIABLE(1);
+            auto zeroPoint = INPUT_VARIABLE(2);
+            auto output = OUTPUT_VARIABLE(0);
+
+            int axis = block.getIArguments()->size() > 0 ? INT_ARG(0) : -1;
+            if (axis < 0)
+                axis += input->rankOf();
+
+            const helpers::QuantizationParams params(*scale, *zeroPoint);
+            const Nd4jLong channels = axis >= 0 && axis < input->rankOf() ? input->sizeAt(axis) : 1;
+            REQUIRE_TRUE(params.isValid(channels), 0, "quantize_linear: scale and zero point should be either scalars or have length of channels axis %i, but got lengths %i and %i", (int) channels, (int) scale->lengthOf(), (int) zeroPoint->lengthOf());
+            REQUIRE_TRUE(params.zeroPointsFit(output->dataType()), 0, "quantize_linear: zero points should be within range of %s data type", DataTypeUtils::asString(output->dataType()).c_str());
+
+            if (input->isEmpty())
+                return Status::OK();
+
+            helpers::quantizeLinear(*input, params, axis, *output);
+
+            return Status::OK();
+        }
+
+        DECLARE_SHAPE_FN(quantize_linear) {
+            return SHAPELIST(ConstantShapeHelper::getInstance().createShapeInfo(ArrayOptions::dataType(inputShape->at(2)), inputShape->at(0)));
+        }
+
+        DECLARE_TYPES(quantize_linear) {
+            getOpDescriptor()
+                    ->setAllowedInputTypes(0, {ALL_FLOATS})
+                    ->setAllowedInputTypes(1, {ALL_FLOATS})
+                    ->setAllowedInputTypes(2, {DataType::INT8, DataType::UINT8})
+                    ->setAllowedOutputTypes({DataType::INT8, DataType::UINT8});
+        }
+#endif
+
+#if NOT_EXCLUDED(OP_dequantize_linear)
+        CUSTOM_OP_IMPL(dequantize_linear, 3, 1, false, 0, 0) {
+            auto input = INPUT_VARIABLE(0);
+            auto scale = INPUT_VARIABLE(1);
+            auto zeroPoint = INPUT_VARIABLE(2);
+            auto output = OUTPUT_VARIABLE(0);
+
+            int axis = block.getIArguments()->size() > 0 ? INT_ARG(0) : -1;
+            if (axis < 0)
+                axis += input->rankOf();
+
+            const helpers::QuantizationParams params(*scale, *zeroPoint);
+            const Nd4jLong channels = axis >= 0 && axis < input->rankOf() ? input->sizeAt(axis) : 1;
+            REQUIRE_TRUE(params.isValid(channels), 0, "dequantize_linear: scale and zero point should be either scalars or have length of channels axis %i, but got lengths %i and %i", (int) channels, (int) scale->lengthOf(), (int) zeroPoint->lengthOf());
+            REQUIRE_TRUE(params.zeroPointsFit(input->dataType()), 0, "dequantize_linear: zero points should be within range of %s data type", DataTypeUtils::asString(input->dataType()).c_str());
+
+            if (input->isEmpty())
+                return Status::OK();
+
+            helpers::dequantizeLinear(*input, params, axis, *output);
+
+            return Status::OK();
+        }
+
+        DECLARE_SHAPE_FN(dequantize_linear) {
+            return SHAPELIST(ConstantShapeHelper::getInstance().createShapeInfo(ArrayOptions::dataType(inputShape->at(1)), inputShape->at(0)));
+        }
+
+        DECLARE_TYPES(dequantize_linear) {
+            getOpDescriptor()
+                    ->setAllowedInputTypes(0, {DataType::INT8, DataType::UINT8})
+                    ->setAllowedInputTypes(1, {ALL_FLOATS})
+                    ->setAllowedInputTypes(2, {ALL_INTS})
+                    ->setAllowedOutputTypes({ALL_FLOATS});
+        }
+#endif
+    }
+}
@@ -0,0 +1,185 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// @author raver119@gmail.com
+//
+
+#include <system/op_boilerplate.h>
+#include <ops/declarable/CustomOperations.h>
+#include <ops/declarable/helpers/convolutions.h>
+#include <ops/declarable/helpers/quantization.h>
+#include <memory>
+
+namespace sd {
+    namespace ops {
+#if NOT_EXCLUDED(OP_quantized_conv2d) || NOT_EXCLUDED(OP_quantized_depthwise_conv2d)
+        /**
+         * Bias is present when number of inputs is odd, output parameters are the last two inputs of 8 or 9
+         */
+        static void quantizedConvOptionals(Context &block, const char *opName, NDArray *&bias, NDArray *&outScale, NDArray *&outZero) {
+            const int width = block.width();
+            REQUIRE_TRUE(width >= 6 && width <= 9, 0, "%s: expected from 6 to 9 inputs, but got %i", opName, width);
+
+            bias = width % 2 == 1 ? INPUT_VARIABLE(6) : nullptr;
+            outScale = width >= 8 ? INPUT_VARIABLE(width - 2) : nullptr;
+            outZero = width >= 8 ? INPUT_VARIABLE(width - 1) : nullptr;
+        }
+
+        static void quantizedConv(Context &block, NDArray *output, const char *opName, const bool depthwise) {
+            auto input = INPUT_VARIABLE(0);
+            auto weights = INPUT_VARIABLE(3);
+
+            NDArray *bias, *outScale, *outZero;
+            quantizedConvOptionals(block, opName, bias, outScale, outZero);
+
+            REQUIRE_TRUE(input->rankOf() == 4, 0, "%s: rank of input array must be equal to 4, but got %i instead !", opName, input->rankOf());
+            REQUIRE_TRUE(weights->rankOf() == 4, 0, "%s: rank of weights array must be equal to 4, but got %i instead !", opName, weights->rankOf());
+
+            int kH = INT_ARG(0) > 0 ? INT_ARG(0) : static_cast<int>(weights->sizeAt(0));   // filter(kernel) height
+            int kW = INT_ARG(1) > 0 ? INT_ARG(1) : static_cast<int>(weights->sizeAt(1));   // filter(kernel) width
+            int sH = INT_ARG(2);                                                            // strides height
+            int sW = INT_ARG(3);                                                            // strides width
+            int pH = INT_ARG(4);                                                            // paddings height
+            int pW = INT_ARG(5);                                                            // paddings width
+            int dH = INT_ARG(6);                                                            // dilations height
+            int dW = INT_ARG(7);                                                            // dilations width
+            int isSameMode = INT_ARG(8);                                                    // 0-VALID, 1-SAME
+            int isNCHW  = block.getIArguments()->size() > 9 ? !INT_ARG(9) : 1;              // INT_ARG(9): 0-NCHW, 1-NHWC
+            int wFormat = block.getIArguments()->size() > 10 ? INT_ARG(10) : 0;             // 0 - [kH, kW, iC, oC], 1 - [oC, iC, kH, kW], 2 - [oC, kH, kW, iC]
+
+            int bS, iC, iH, iW, oC, oH, oW;                             // batch size, input channels, input height/width, output channels, output height/width;
+            int indIOioC, indIiH, indWoC, indWiC, indWkH, indOoH;       // corresponding indexes
+            ConvolutionUtils::getSizesAndIndexesConv2d(isNCHW, wFormat, *input, *output, bS, iC, iH, iW, oC, oH, oW, indIOioC, indIiH, indWiC, indWoC, indWkH, indOoH);
+
+            // for depthwise convolution oC axis of weights holds channels multiplier
+            const int wC = weights->sizeAt(indWoC);
+            std::vector<Nd4jLong> expectedWeightsShape = ConvolutionUtils::expectWeightsShape(wFormat, kH, kW, iC, wC);
+            REQUIRE_TRUE(weights->isSameShape(expectedWeightsShape), 0, "%s: wrong shape of weights array, expected is %s, but got %s instead !", opName, ShapeUtils::shapeAsString(expectedWeightsShape).c_str(), ShapeUtils::shapeAsString(weights).c_str());
+            REQUIRE_TRUE(oC == (depthwise ? iC * wC : wC), 0, "%s: wrong number of output channels %i", opName, oC);
+
+            const helpers::QuantizationParams inParams(*INPUT_VARIABLE(1), *INPUT_VARIABLE(2));
+            const helpers::QuantizationParams wParams(*INPUT_VARIABLE(4), *INPUT_VARIABLE(5));
+
+            REQUIRE_TRUE(inParams.isValid(1), 0, "%s: input parameters should be scalars", opName);
+            REQUIRE_TRUE(wParams.isValid(oC), 0, "%s: weights parameters should be either scalars or have length %i, but got %i and %i instead", opName, oC, (int) INPUT_VARIABLE(4)->lengthOf(), (int) INPUT_VARIABLE(5)->lengthOf());
+            REQUIRE_TRUE(inParams.zeroPointsFit(input->dataType()) && wParams.zeroPointsFit(weights->dataType()), 0, "%s: zero points should be within range of input and weights data types", opName);
+
+            const Nd4jLong patchLength = (Nd4jLong) kH * kW * (depthwise ? 1 : iC);
+            REQUIRE_TRUE(patchLength <= helpers::QUANTIZED_MAX_DEPTH, 0, "%s: int32 accumulator allows patch length up to %i, but got %i", opName, (int) helpers::QUANTIZED_MAX_DEPTH, (int) patchLength);
+            REQUIRE_TRUE(bias == nullptr || (bias->rankOf() <= 2 && bias->lengthOf() == oC), 0, "%s: wrong shape of array with biases, expected rank, length: <=2, %i, but got %i, %i instead !", opName, oC, bias->rankOf(), (int) bias->lengthOf());
+
+            std::unique_ptr<helpers::QuantizationParams> outParams(outScale != nullptr ? new helpers::QuantizationParams(*outScale, *outZero) : nullptr);
+            REQUIRE_TRUE(outParams == nullptr || outParams->isValid(1), 0, "%s: output parameters should be scalars", opName);
+            REQUIRE_TRUE(outParams == nullptr || outParams->zeroPointsFit(output->dataType()), 0, "%s: output zero point should be within range of %s data type", opName, DataTypeUtils::asString(output->dataType()).c_str());
+
+            if (depthwise)
+                helpers::quantizedDepthwiseConv2d(*input, inParams, *weights, wParams, bias, outParams.get(), *output, kH, kW, sH, sW, pH, pW, dH, dW, isSameMode, isNCHW, wFormat);
+            else
+                helpers::quantizedConv2d(*input, inParams, *weights, wParams, bias, outParams.get(), *output, kH, kW, sH, sW, pH, pW, dH, dW, isSameMode, isNCHW, wFormat);
+        }
+
+        static const Nd4jLong* quantizedConvShape(Context &block, ShapeList *inputShape, const bool depthwise) {
+            auto inputShapeInfo   = inputShape->at(0);
+            auto weightsShapeInfo = inputShape->at(3);
+
+            int sH = INT_ARG(2);
+            int sW = INT_ARG(3);
+            int pH = INT_ARG(4);
+            int pW = INT_ARG(5);
+            int dH = INT_ARG(6);
+            int dW = INT_ARG(7);
+            int isSameMode = INT_ARG(8);
+            int isNCHW  = block.getIArguments()->size() > 9 ? !INT_ARG(9) : 1;
+            int wFormat = block.getIArguments()->size() > 10 ? INT_ARG(10) : 0;
+
+            int kH = INT_ARG(0) > 0 ? INT_ARG(0) : static_cast<int>(shape::sizeAt(weightsShapeInfo, 0));
+            int kW = INT_ARG(1) > 0 ? INT_ARG(1) : static_cast<int>(shape::sizeAt(weightsShapeInfo, 1));
+
+            const int indIOioC = isNCHW ? 1 : 3;
+            const int indIiH = isNCHW ? 2 : 1;
+
+            const Nd4jLong bS = shape::sizeAt(inputShapeInfo, 0);
+            const int iH = shape::sizeAt(inputShapeInfo, indIiH);
+            const int iW = shape::sizeAt(inputShapeInfo, indIiH + 1);
+            const Nd4jLong iC = shape::sizeAt(inputShapeInfo, indIOioC);
+            const Nd4jLong wC = shape::sizeAt(weightsShapeInfo, 0 == wFormat ? 3 : 0);
+            const Nd4jLong oC = depthwise ? iC * wC : wC;
+
+            int oH, oW;
+            ConvolutionUtils::calcOutSizePool2D(oH, oW, kH, kW, sH, sW, pH, pW, dH, dW, iH, iW, isSameMode);
+
+            const auto dtype = block.width() >= 8 ? ArrayOptions::dataType(inputShape->at(block.width() - 1)) : DataType::FLOAT32;
+            if (isNCHW)
+                return ConstantShapeHelper::getInstance().createShapeInfo(dtype, 'c', {bS, oC, (Nd4jLong) oH, (Nd4jLong) oW});
+
+            return ConstantShapeHelper::getInstance().createShapeInfo(dtype, 'c', {bS, (Nd4jLong) oH, (Nd4jLong) oW, oC});
+        }
+#endif
+
+#if NOT_EXCLUDED(OP_quantized_conv2d)
+        CUSTOM_OP_IMPL(quantized_conv2d, 6, 1, false, 0, 9) {
+            quantizedConv(block, OUTPUT_VARIABLE(0), "quantized_conv2d", false);
+
+            return Status::OK();
+        }
+
+        DECLARE_SHAPE_FN(quantized_conv2d) {
+            return SHAPELIST(quantizedConvShape(block, inputShape, false));
+        }
+
+        DECLARE_TYPES(quantized_conv2d) {
+            getOpDescriptor()
+                    ->setAllowedInputTypes(0, {DataType::INT8, DataType::UINT8})
+                    ->setAllowedInputTypes(1, {ALL_FLOATS})
+                    ->setAllowedInputTypes(2, {ALL_INTS})
+                    ->setAllowedInputTypes(3, {DataType::INT8, DataType::UINT8})
+                    ->setAllowedInputTypes(4, {ALL_FLOATS})
+                    ->setAllowedInputTypes(5, {ALL_INTS})
+                    ->setAllowedInputTypes(6, {ALL_FLOATS})
+                    ->setAllowedInputTypes(7, {ALL_FLOATS, DataType::INT8, DataType::UINT8})
+                    ->setAllowedInputTypes(8, {DataType::INT8, DataType::UINT8})
+                    ->setAllowedOutputTypes({DataType::FLOAT32, DataType::INT8, DataType::UINT8});
+        }
+#endif
+
+#if NOT_EXCLUDED(OP_quantized_depthwise_conv2d)
+        CUSTOM_OP_IMPL(quantized_depthwise_conv2d, 6, 1, false, 0, 9) {
+            quantizedConv(block, OUTPUT_VARIABLE(0), "quantized_depthwise_conv2d", true);
+
+            return Status::OK();
+        }
+
+        DECLARE_SHAPE_FN(quantized_depthwise_conv2d) {
+            return SHAPELIST(quantizedConvShape(block, inputShape, true));
+        }
+
+        DECLARE_TYPES(quantized_depthwise_conv2d) {
+            getOpDescriptor()
+                    ->setAllowedInputTypes(0, {DataType::INT8, DataType::UINT8})
+                    ->setAllowedInputTypes(1, {ALL_FLOATS})
+                    ->setAllowedInputTypes(2, {ALL_INTS})
+                    ->setAllowedInputTypes(3, {DataType::INT8, DataType::UINT8})
+                    ->setAllowedInputTypes(4, {ALL_FLOATS})
+                    ->setAllowedInputTypes(5, {ALL_INTS})
+                    ->setAllowedInputTypes(6, {ALL_FLOATS})
+                    ->setAllowedInputTypes(7, {ALL_FLOATS, DataType::INT8, DataType::UINT8})
+                    ->setAllowedInputTypes(8, {DataType::INT8, DataType::UINT8})
+                    ->setAllowedOutputTypes({DataType::FLOAT32, DataType::INT8, DataType::UINT8});
+        }
+#endif
+    }
+}
@@ -0,0 +1,153 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// @author raver119@gmail.com
+//
+
+#include <system/op_boilerplate.h>
+#include <ops/declarable/CustomOperations.h>
+#include <ops/declarable/helpers/quantization.h>
+#include <memory>
+
+namespace sd {
+    namespace ops {
+#if NOT_EXCLUDED(OP_quantized_matmul) || NOT_EXCLUDED(OP_quantized_xw_plus_b)
+        /**
+         * Validates operands shared by quantized_matmul and quantized_xw_plus_b, and runs integer GEMM.
+         * a and b are already transposed as requested
+         */
+        static void quantizedGemm(const char *opName, const NDArray &a, const NDArray &aScale, const NDArray &aZero, const NDArray &b, const NDArray &bScale, const NDArray &bZero, const NDArray *bias, const NDArray *outScale, const NDArray *outZero, NDArray &output) {
+            REQUIRE_TRUE(a.rankOf() == 2 && b.rankOf() == 2, 0, "%s: both operands should have rank 2, but got %i and %i instead", opName, a.rankOf(), b.rankOf());
+            REQUIRE_TRUE(a.sizeAt(1) == b.sizeAt(0), 0, "%s: operands have incompatible shapes %s and %s", opName, ShapeUtils::shapeAsString(&a).c_str(), ShapeUtils::shapeAsString(&b).c_str());
+
+            const helpers::QuantizationParams aParams(aScale, aZero);
+            const helpers::QuantizationParams bParams(bScale, bZero);
+            const Nd4jLong N = b.sizeAt(1);
+
+            REQUIRE_TRUE(aParams.isValid(1), 0, "%s: parameters of first operand should be scalars", opName);
+            REQUIRE_TRUE(bParams.isValid(N), 0, "%s: parameters of second operand should be either scalars or have length %i, but got %i and %i instead", opName, (int) N, (int) bScale.lengthOf(), (int) bZero.lengthOf());
+            REQUIRE_TRUE(aParams.zeroPointsFit(a.dataType()) && bParams.zeroPointsFit(b.dataType()), 0, "%s: zero points should be within range of operands data types", opName);
+            REQUIRE_TRUE(a.sizeAt(1) <= helpers::QUANTIZED_MAX_DEPTH, 0, "%s: int32 accumulator allows inner dimension up to %i, but got %i", opName, (int) helpers::QUANTIZED_MAX_DEPTH, (int) a.sizeAt(1));
+            REQUIRE_TRUE(bias == nullptr || bias->lengthOf() == N, 0, "%s: bias should have length %i, but got %i instead", opName, (int) N, (int) bias->lengthOf());
+
+            if (a.isEmpty() || b.isEmpty())
+                return;
+
+            if (outScale != nullptr) {
+                const helpers::QuantizationParams outParams(*outScale, *outZero);
+                REQUIRE_TRUE(outParams.isValid(1), 0, "%s: output parameters should be scalars", opName);
+                REQUIRE_TRUE(outParams.zeroPointsFit(output.dataType()), 0, "%s: output zero point should be within range of %s data type", opName, DataTypeUtils::asString(output.dataType()).c_str());
+
+                helpers::quantizedMatmul(a, aParams, b, bParams, bias, &outParams, output);
+            } else {
+                helpers::quantizedMatmul(a, aParams, b, bParams, bias, nullptr, output);
+            }
+        }
+
+        static const Nd4jLong* quantizedGemmShape(const Nd4jLong *aShapeInfo, const Nd4jLong *bShapeInfo, const bool transA, const bool transB, const Nd4jLong *outZeroShapeInfo) {
+            const auto dtype = outZeroShapeInfo != nullptr ? ArrayOptions::dataType(outZeroShapeInfo) : DataType::FLOAT32;
+            const Nd4jLong M = shape::sizeAt(aShapeInfo, transA ? 1 : 0);
+            const Nd4jLong N = shape::sizeAt(bShapeInfo, transB ? 0 : 1);
+
+            return ConstantShapeHelper::getInstance().createShapeInfo(dtype, 'c', {M, N});
+        }
+#endif
+
+#if NOT_EXCLUDED(OP_quantized_matmul)
+        CUSTOM_OP_IMPL(quantized_matmul, 6, 1, false, 0, -2) {
+            REQUIRE_TRUE(block.width() == 6 || block.width() == 8, 0, "quantized_matmul: expected 6 inputs, or 8 with output parameters, but got %i", (int) block.width());
+
+            auto a = INPUT_VARIABLE(0);
+            auto b = INPUT_VARIABLE(3);
+            auto output = OUTPUT_VARIABLE(0);
+
+            const bool transA = block.getIArguments()->size() > 0 && INT_ARG(0) == 1;
+            const bool transB = block.getIArguments()->size() > 1 && INT_ARG(1) == 1;
+
+            // transposed operands are views, packing handles any strides
+            std::unique_ptr<NDArray> aT(transA ? new NDArray(a->transpose()) : nullptr);
+            std::unique_ptr<NDArray> bT(transB ? new NDArray(b->transpose()) : nullptr);
+
+            quantizedGemm("quantized_matmul", transA ? *aT : *a, *INPUT_VARIABLE(1), *INPUT_VARIABLE(2), transB ? *bT : *b, *INPUT_VARIABLE(4), *INPUT_VARIABLE(5), nullptr,
+                          block.width() > 6 ? INPUT_VARIABLE(6) : nullptr, block.width() > 6 ? INPUT_VARIABLE(7) : nullptr, *output);
+
+            return Status::OK();
+        }
+
+        DECLARE_SHAPE_FN(quantized_matmul) {
+            const bool transA = block.getIArguments()->size() > 0 && INT_ARG(0) == 1;
+            const bool transB = block.getIArguments()->size() > 1 && INT_ARG(1) == 1;
+
+            return SHAPELIST(quantizedGemmShape(inputShape->at(0), inputShape->at(3), transA, transB, block.width() > 6 ? inputShape->at(7) : nullptr));
+        }
+
+        DECLARE_TYPES(quantized_matmul) {
+            getOpDescriptor()
+                    ->setAllowedInputTypes(0, {DataType::INT8, DataType::UINT8})
+                    ->setAllowedInputTypes(1, {ALL_FLOATS})
+                    ->setAllowedInputTypes(2, {ALL_INTS})
+                    ->setAllowedInputTypes(3, {DataType::INT8, DataType::UINT8})
+                    ->setAllowedInputTypes(4, {ALL_FLOATS})
+                    ->setAllowedInputTypes(5, {ALL_INTS})
+                    ->setAllowedInputTypes(6, {ALL_FLOATS})
+                    ->setAllowedInputTypes(7, {DataType::INT8, DataType::UINT8})
+                    ->setAllowedOutputTypes({DataType::FLOAT32, DataType::INT8, DataType::UINT8});
+        }
+#endif
+
+#if NOT_EXCLUDED(OP_quantized_xw_plus_b)
+        CUSTOM_OP_IMPL(quantized_xw_plus_b, 7, 1, false, 0, -2) {
+            REQUIRE_TRUE(block.width() == 7 || block.width() == 9, 0, "quantized_xw_plus_b: expected 7 inputs, or 9 with output parameters, but got %i", (int) block.width());
+
+            auto x = INPUT_VARIABLE(0);
+            auto w = INPUT_VARIABLE(3);
+            auto bias = INPUT_VARIABLE(6);
+            auto output = OUTPUT_VARIABLE(0);
+
+            const bool transW = block.getIArguments()->size() > 0 && INT_ARG(0) == 1;
+            std::unique_ptr<NDArray> wT(transW ? new NDArray(w->transpose()) : nullptr);
+
+            REQUIRE_TRUE(bias->rankOf() == 1, 0, "quantized_xw_plus_b: bias should be a vector, but got rank %i instead", bias->rankOf());
+
+            quantizedGemm("quantized_xw_plus_b", *x, *INPUT_VARIABLE(1), *INPUT_VARIABLE(2), transW ? *wT : *w, *INPUT_VARIABLE(4), *INPUT_VARIABLE(5), bias,
+                          block.width() > 7 ? INPUT_VARIABLE(7) : nullptr, block.width() > 7 ? INPUT_VARIABLE(8) : nullptr, *output);
+
+            return Status::OK();
+        }
+
+        DECLARE_SHAPE_FN(quantized_xw_plus_b) {
+            const bool transW = block.getIArguments()->size() > 0 && INT_ARG(0) == 1;
+
+            return SHAPELIST(quantizedGemmShape(inputShape->at(0), inputShape->at(3), false, transW, block.width() > 7 ? inputShape->at(8) : nullptr));
+        }
+
+        DECLARE_TYPES(quantized_xw_plus_b) {
+            getOpDescriptor()
+                    ->setAllowedInputTypes(0, {DataType::INT8, DataType::UINT8})
+                    ->setAllowedInputTypes(1, {ALL_FLOATS})
+                    ->setAllowedInputTypes(2, {ALL_INTS})
+                    ->setAllowedInputTypes(3, {DataType::INT8, DataType::UINT8})
+                    ->setAllowedInputTypes(4, {ALL_FLOATS})
+                    ->setAllowedInputTypes(5, {ALL_INTS})
+                    ->setAllowedInputTypes(6, {ALL_FLOATS})
+                    ->setAllowedInputTypes(7, {ALL_FLOATS})
+                    ->setAllowedInputTypes(8, {DataType::INT8, DataType::UINT8})
+                    ->setAllowedOutputTypes({DataType::FLOAT32, DataType::INT8, DataType::UINT8});
+        }
+#endif
+    }
+}
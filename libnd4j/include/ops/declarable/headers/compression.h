@@ -54,7 +54,29 @@ namespace sd {
         #endif
 
 
+        /**
+         * encode_threshold - encodes elements of updates with absolute value >= threshold, and subtracts threshold from them
+         *
+         * Input:
+         *      0 - updates array
+         *
+         * T arguments:
+         *      0 - threshold
+         *
+         * Int arguments:
+         *      0 - optional, max number of encoded elements
+         *      1 - optional, if non-zero delta+varint index stream is produced instead of int32 indices. Arrays longer than MAX_INT
+         *          can be encoded this way only
+         *
+         * Output:
+         *      0 - updates array, updated in place
+         *      1 - INT32 encoded array
+         */
         DECLARE_CUSTOM_OP(encode_threshold, 2, 1, true, 1, 0);
+
+        /**
+         * decode_threshold - adds threshold-encoded updates (either encoding) to given array
+         */
         DECLARE_CUSTOM_OP(decode_threshold, 2, 1, true, 0, 0);
     }
 }
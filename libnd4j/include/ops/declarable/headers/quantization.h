@@ -0,0 +1,152 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// @author raver119@gmail.com
+//
+
+#ifndef SD_HEADERS_QUANTIZATION_H
+#define SD_HEADERS_QUANTIZATION_H
+
+#include <ops/declarable/headers/common.h>
+
+namespace sd {
+    namespace ops {
+
+        /**
+         * Affine quantization, real = scale * (q - zeroPoint). Scale and zero point are either scalars,
+         * or vectors for per-channel quantization. Values are rounded half to even, same as ONNX QuantizeLinear
+         *
+         * Input:
+         *      0 - float input
+         *      1 - scale, scalar or vector
+         *      2 - zero point, INT8 or UINT8 scalar or vector, defines output data type
+         *
+         * Int arguments:
+         *      0 - optional, channels axis for per-channel parameters, default is last axis
+         *
+         * Output:
+         *      0 - INT8 or UINT8 array of the same shape as input
+         */
+        #if NOT_EXCLUDED(OP_quantize_linear)
+        DECLARE_CUSTOM_OP(quantize_linear, 3, 1, false, 0, 0);
+        #endif
+
+        /**
+         * Inverse of quantize_linear: real = scale * (q - zeroPoint)
+         *
+         * Input:
+         *      0 - INT8 or UINT8 input
+         *      1 - scale, scalar or vector, defines output data type
+         *      2 - zero point, scalar or vector
+         *
+         * Int arguments:
+         *      0 - optional, channels axis for per-channel parameters, default is last axis
+         */
+        #if NOT_EXCLUDED(OP_dequantize_linear)
+        DECLARE_CUSTOM_OP(dequantize_linear, 3, 1, false, 0, 0);
+        #endif
+
+        /**
+         * Calibration pass: records range of activations, and derives quantization parameters from it.
+         * Range of previous batches is either widened, or updated as moving average when momentum is given
+         *
+         * Input:
+         *      0 - float activations
+         *      1 - optional, [min, max] range recorded so far
+         *
+         * T arguments:
+         *      0 - optional, momentum of moving average, default is 0
+         *
+         * Int arguments:
+         *      0 - optional, target data type: 0 - UINT8 (asymmetric, default), 1 - INT8 (symmetric, zero point is 0)
+         *
+         * Output:
+         *      0 - updated [min, max] range
+         *      1 - FLOAT32 scalar scale
+         *      2 - UINT8 or INT8 scalar zero point
+         */
+        #if NOT_EXCLUDED(OP_quantization_range)
+        DECLARE_CUSTOM_OP(quantization_range, 1, 3, false, -2, -2);
+        #endif
+
+        /**
+         * Integer matrix multiplication: int8/uint8 operands, int32 accumulation, and requantization fused into output.
+         * Parameters of b can be per column
+         *
+         * Input:
+         *      0 - a, [M, K]
+         *      1 - scale of a, scalar
+         *      2 - zero point of a, scalar
+         *      3 - b, [K, N]
+         *      4 - scale of b, scalar or [N]
+         *      5 - zero point of b, scalar or [N]
+         *      6 - optional, scale of output, scalar
+         *      7 - optional, zero point of output, INT8 or UINT8 scalar
+         *
+         * Int arguments:
+         *      0 - optional, if 1 - a is transposed
+         *      1 - optional, if 1 - b is transposed
+         *
+         * Output:
+         *      0 - [M, N], FLOAT32 if output parameters aren't given, quantized with them otherwise
+         */
+        #if NOT_EXCLUDED(OP_quantized_matmul)
+        DECLARE_CUSTOM_OP(quantized_matmul, 6, 1, false, 0, -2);
+        #endif
+
+        /**
+         * Integer version of xw_plus_b, inputs 0-5 follow quantized_matmul
+         *
+         * Input:
+         *      6 - FLOAT bias, [N]
+         *      7 - optional, scale of output, scalar
+         *      8 - optional, zero point of output, INT8 or UINT8 scalar
+         *
+         * Int arguments:
+         *      0 - optional, if 1 - weights are given as [N, K]
+         */
+        #if NOT_EXCLUDED(OP_quantized_xw_plus_b)
+        DECLARE_CUSTOM_OP(quantized_xw_plus_b, 7, 1, false, 0, -2);
+        #endif
+
+        /**
+         * Integer 2D convolutions, arguments follow conv2d/depthwise_conv2d. Weights parameters can be per output channel
+         *
+         * Input:
+         *      0 - input, INT8 or UINT8
+         *      1 - scale of input, scalar
+         *      2 - zero point of input, scalar
+         *      3 - weights, INT8 or UINT8
+         *      4 - scale of weights, scalar or [oC]
+         *      5 - zero point of weights, scalar or [oC]
+         *      6 - optional, FLOAT bias [oC]
+         *      6, 7 or 7, 8 - optional, scale and zero point of output
+         *
+         * Output:
+         *      0 - FLOAT32 if output parameters aren't given, quantized with them otherwise
+         */
+        #if NOT_EXCLUDED(OP_quantized_conv2d)
+        DECLARE_CUSTOM_OP(quantized_conv2d, 6, 1, false, 0, 9);
+        #endif
+
+        #if NOT_EXCLUDED(OP_quantized_depthwise_conv2d)
+        DECLARE_CUSTOM_OP(quantized_depthwise_conv2d, 6, 1, false, 0, 9);
+        #endif
+    }
+}
+
+#endif //SD_HEADERS_QUANTIZATION_H
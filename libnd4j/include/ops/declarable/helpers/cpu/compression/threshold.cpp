@@ -26,7 +26,7 @@ namespace sd {
     namespace ops {
         namespace helpers {
             template <typename T>
-            static int32_t thresholdEstimate_(const NDArray &updates, const float threshold) {
+            static Nd4jLong thresholdEstimate_(const NDArray &updates, const float threshold) {
                 auto N = updates.lengthOf();
                 const auto buffer = updates.bufferAsT<T>();
 
@@ -44,12 +44,18 @@ namespace sd {
                 return samediff::Threads::parallel_long(func, LAMBDA_AL { return _old + _new; }, 0, N);
             }
 
-            int32_t thresholdEstimate(const NDArray &updates, const float threshold) {
+            Nd4jLong thresholdEstimate(const NDArray &updates, const float threshold) {
                 BUILD_SINGLE_SELECTOR(updates.dataType(), return thresholdEstimate_, (updates, threshold), FLOAT_TYPES);
 
                 return 0;
             }
 
+            Nd4jLong thresholdEstimateVarint(const NDArray &updates, const float threshold, Nd4jLong limit) {
+                BUILD_SINGLE_SELECTOR(updates.dataType(), return sd::TypeCast::estimateThresholdVarint, (updates.buffer(), updates.lengthOf(), threshold, limit), FLOAT_TYPES);
+
+                return 0;
+            }
+
             void thresholdEncode(NDArray &updates, NDArray &encoded, float threshold) {
                 BUILD_SINGLE_SELECTOR(updates.dataType(), sd::TypeCast::convertToThreshold, (nullptr, updates.buffer(), updates.lengthOf(), encoded.buffer()), FLOAT_TYPES);
             }
@@ -25,6 +25,8 @@
 #include <array/NDArrayFactory.h>
 #include <helpers/MmulHelper.h>
 #include <execution/Threads.h>
+#include <ops/declarable/helpers/cpu/convolutions_tiled.hpp>
+#include <ops/declarable/helpers/cpu/convolutions_winograd.hpp>
 
 namespace sd {
     namespace ops  {
@@ -58,45 +60,64 @@ static void conv2d_(sd::graph::Context& block, const NDArray* input, const NDArr
 
             nd4j_debug("MKL-DNN is not used for conv2d!\n", 0);
 
-            std::vector<int> permutForOutput;
-
-            if(isNCHW)
-                permutForOutput = {0, 3, 1, 2};                                             // [bS, oH, oW, oC] -> [bS, oC, oH, oW]
-            else
-                input = new NDArray(input->permute({0, 3, 1, 2}));                         // [bS, iH, iW, iC] -> [bS, iC, iH, iW] if NHWC
-
-            std::vector<int> wAxes;
-            if(0 == wFormat)
-                wAxes = {0, 1, 2};
-            else if(1 == wFormat)
-                wAxes = {2, 3, 1};
-            else
-                wAxes = {1, 2, 3};
-
-            NDArray col('c', {bS, oH, oW, kH, kW, iC}, input->dataType(), input->getContext());
-            NDArray colP = col.permute({0, 5, 3, 4, 1, 2});            // {bS, iC, kH, kW, oH, oW}
-            NDArray mmulResult('f', {bS*oH*oW, oC}, output->dataType(), output->getContext());
-
-            //----- calculation of output -----//
-            auto ctx = block.launchContext();
-            helpers::im2col(*ctx, *input, colP, kH, kW, sH, sW, pH, pW, dH, dW, NDArrayFactory::create(0.f, input->getContext()));  // [bS, iC, iH, iW] is convoluted to [bS, iC, kH, kW, oH, oW]
-            MmulHelper::tensorDot(&col, weights, &mmulResult, {3,4,5}, wAxes, {}); // [bS, oH, oW, kH, kW, iC] x [kH, kW, iC, oC] = [bS, oH, oW, oC]
-
-            //----- assign outTemp to output  -----//
-            if(isNCHW) {
-                mmulResult.reshapei({bS, oH, oW, oC});
-                mmulResult.permutei(permutForOutput);
+            // 3x3 stride-1 convolutions go through Winograd transform
+            if(helpers::winogradEligible(*input, *weights, kH, kW, sH, sW, dH, dW, iC, oC)) {
+                helpers::winogradConv2d(*input, *weights, *output, pH, pW, isNCHW, wFormat, false);
+
+                if(bias)
+                    helpers::addBias(block, *output, *bias, *output, isNCHW);
+
+                return;
             }
-            output->assign(mmulResult);
+
+            // implicit GEMM: output pixels are processed in tiles, patches of each tile are packed into per-thread buffer
+            const helpers::ConvGeometry2D g(*input, *weights, *output, kH, kW, sH, sW, pH, pW, dH, dW, isNCHW, wFormat);
+            const int K = g.patchLength();
+            const Nd4jLong M = (Nd4jLong) bS * oH * oW;
+
+            typedef typename helpers::ConvGemm<X>::A A;
+            const auto packedW = helpers::convPackWeights<X>(weights->bufferAsT<X>(), g);
+
+            const int numThreads = sd::Environment::getInstance().maxMasterThreads();
+            const int tileRows = helpers::convTileRows<X>(M, K, numThreads);
+            const Nd4jLong numTiles = (M + tileRows - 1) / tileRows;
+
+            auto in = input->bufferAsT<X>();
+            auto out = output->bufferAsT<Y>();
+
+            auto func = PRAGMA_THREADS_FOR {
+                std::vector<X> patches((Nd4jLong) tileRows * K);
+                std::vector<A> tile((Nd4jLong) tileRows * oC);
+                std::vector<A> buffer(helpers::ConvGemm<X>::Engine::bufferLength(K));
+
+                for (auto t = start; t < stop; t++) {
+                    const Nd4jLong m0 = t * tileRows;
+                    const int mc = (int) std::min<Nd4jLong>(tileRows, M - m0);
+
+                    helpers::convPackPatches<X>(in, g, m0, mc, patches.data());
+                    helpers::convGemmTile<X>(patches.data(), mc, K, packedW.data(), oC, tile.data(), buffer.data());
+
+                    for (int r = 0; r < mc; r++) {
+                        const Nd4jLong m = m0 + r;
+                        const int b = (int) (m / ((Nd4jLong) oH * oW));
+                        const int oh = (int) ((m / oW) % oH);
+                        const int ow = (int) (m % oW);
+
+                        auto z = out + b * g.oSb + oh * g.oSh + ow * g.oSw;
+                        auto v = tile.data() + (Nd4jLong) r * oC;
+                        for (int n = 0; n < oC; n++)
+                            z[n * g.oSc] = static_cast<Y>(v[n]);
+                    }
+                }
+            };
+
+            samediff::Threads::parallel_tad(func, 0, numTiles, 1, numThreads);
 
             //----- add biases if required -----//
             if(bias)
                 // output->applyBroadcast(broadcast::Add, {indIOioC}, bias);
                 helpers::addBias(block, *output, *bias, *output, isNCHW);
 
-            if(!isNCHW)
-                delete input;
-
         }
 
 void ConvolutionUtils::conv2d(sd::graph::Context& block, const NDArray* input, const NDArray* weights, const NDArray* bias, NDArray* output, const int kH, const int kW, const int sH, const int sW, int pH, int pW, const int dH, const int dW, const int paddingMode, const int isNCHW, const int wFormat) {
@@ -24,6 +24,7 @@
 #include <array/NDArrayFactory.h>
 #include <helpers/MmulHelper.h>
 #include <execution/Threads.h>
+#include <ops/declarable/helpers/cpu/convolutions_tiled.hpp>
 
 namespace sd {
     namespace ops  {
@@ -61,42 +62,91 @@ static void conv2dBP_(sd::graph::Context& block, const NDArray* input, const NDA
 
             nd4j_debug("MKL-DNN is not used for conv2d_bp!\n", 0);
 
-            std::vector<int> gradOaxesForDot;
+            // implicit GEMM, same as forward pass: nothing of im2col size is allocated
+            const helpers::ConvGeometry2D g(*input, *weights, *gradO, kH, kW, sH, sW, pH, pW, dH, dW, isNCHW, wFormat);
+            const int K = g.patchLength();
+            const Nd4jLong M = (Nd4jLong) bS * oH * oW;
+            const int numThreads = sd::Environment::getInstance().maxMasterThreads();
 
-            if(!isNCHW) {
-                gradOaxesForDot  = {0, 1, 2};                                           // bS, oH, oW
-                input = new NDArray(input->permute({0, 3, 1, 2}));                      // [bS, iH, iW, iC] -> [bS, iC, iH, iW]
-                gradI = new NDArray(gradI->permute({0, 3, 1, 2}));                      // [bS, iH, iW, iC] -> [bS, iC, iH, iW]
-            } else {
-                gradOaxesForDot  = {0, 2, 3};                                           // bS, oH, oW
-            }
-
-            std::vector<int> wPermut, colPermut;
-
-            if(0 == wFormat) {
-                wPermut   = {2, 0, 1, 3};
-                colPermut = {2, 3, 1, 0, 4, 5};
-            }
-            else if(1 == wFormat) {
-                wPermut   = {1, 2, 3, 0};
-                colPermut = {1, 2, 3, 0, 4, 5};
-            }
-            else {
-                wPermut   = {3, 1, 2, 0};
-                colPermut = {2, 3, 1, 0, 4, 5};
-            }
+            typedef typename helpers::ConvGemm<X>::A A;
+            typedef typename helpers::ConvGemm<X>::Engine Engine;
 
-            NDArray columns(input->ordering(), {bS, iC, kH, kW, oH, oW}, input->dataType(), input->getContext());
+            auto in = input->bufferAsT<X>();
+            auto gO = gradO->bufferAsT<Y>();
 
             // ----- calculation of gradW ----- //
+            // gradW [kH*kW*iC, oC] = patches^T x gradO, every thread accumulates its own partial sum
             if(gradW) {
-                auto ctx = block.launchContext();
-                helpers::im2col(*ctx, *input, columns, kH, kW, sH, sW, pH, pW, dH, dW, NDArrayFactory::create(0.f, input->getContext()));   // [bS, iC, iH, iW] is convoluted to [bS, iC, kH, kW, oH, oW]
-                sd::MmulHelper::tensorDot(&columns, gradO, gradW, {0,4,5}, gradOaxesForDot, wPermut);       // [bS, iC, kH, kW, oH, oW] x [bS, oH, oW, oC]/[bS, oC, oH, oW] = [iC, kH, kW, oC]
+                const Nd4jLong wLength = (Nd4jLong) K * oC;
+
+                // partial sums are limited in total size, at the cost of parallelism
+                const int numPartials = (int) std::max<Nd4jLong>(1, std::min<Nd4jLong>(numThreads, (64L * 1024L * 1024L) / (wLength * (Nd4jLong) sizeof(A))));
+                const int tileRows = helpers::convTileRows<X>(M, K + oC, numPartials);
+                const Nd4jLong numTiles = (M + tileRows - 1) / tileRows;
+
+                std::vector<A> partials(numPartials * wLength, static_cast<A>(0));
+
+                auto func = PRAGMA_THREADS_FOR {
+                    std::vector<X> patches((Nd4jLong) tileRows * K);
+                    std::vector<X> grads((Nd4jLong) tileRows * oC);
+                    std::vector<A> packedGrads(Engine::packedLength(tileRows, oC));
+                    std::vector<A> buffer(Engine::bufferLength(tileRows));
+                    auto gW = partials.data() + thread_id * wLength;
+
+                    for (auto t = start; t < stop; t++) {
+                        const Nd4jLong m0 = t * tileRows;
+                        const int mc = (int) std::min<Nd4jLong>(tileRows, M - m0);
+
+                        helpers::convPackPatches<X>(in, g, m0, mc, patches.data());
+
+                        for (int r = 0; r < mc; r++) {
+                            const Nd4jLong m = m0 + r;
+                            const int b = (int) (m / ((Nd4jLong) oH * oW));
+                            const int oh = (int) ((m / oW) % oH);
+                            const int ow = (int) (m % oW);
+
+                            auto src = gO + b * g.oSb + oh * g.oSh + ow * g.oSw;
+                            auto dst = grads.data() + (Nd4jLong) r * oC;
+                            for (int n = 0; n < oC; n++)
+                                dst[n] = static_cast<X>(src[n * g.oSc]);
+                        }
+
+                        // gW[K, oC] += patches^T x grads
+                        Engine::packMatrixB(mc, oC, grads.data(), oC, 1, packedGrads.data());
+                        Engine::serial(K, oC, mc, 1.0, patches.data(), 1, K, packedGrads.data(), 1.0, gW, oC, 1, buffer.data());
+                    }
+                };
+
+                samediff::Threads::parallel_tad(func, 0, numTiles, 1, numPartials);
+
+                // summing partials up, and storing them in layout of gradW
+                auto gW = gradW->bufferAsT<X>();
+                const auto wG = helpers::ConvGeometry2D(*input, *gradW, *gradO, kH, kW, sH, sW, pH, pW, dH, dW, isNCHW, wFormat);
+
+                auto reduce = PRAGMA_THREADS_FOR {
+                    for (auto k = start; k < stop; k++) {
+                        const int kh = (int) (k / ((Nd4jLong) kW * iC));
+                        const int kw = (int) ((k / iC) % kW);
+                        const int c = (int) (k % iC);
+
+                        auto z = gW + kh * wG.wSkh + kw * wG.wSkw + c * wG.wSic;
+                        for (int n = 0; n < oC; n++) {
+                            A sum = static_cast<A>(0);
+                            for (int e = 0; e < numPartials; e++)
+                                sum += partials[e * wLength + k * oC + n];
+
+                            z[n * wG.wSoc] = static_cast<X>(sum);
+                        }
+                    }
+                };
+
+                samediff::Threads::parallel_tad(reduce, 0, K);
             }
 
             // ----- calculation of gradB ----- //
             if(gradB) {
+                std::vector<int> gradOaxesForDot = isNCHW ? std::vector<int>({0, 2, 3}) : std::vector<int>({0, 1, 2});   // bS, oH, oW
+
                 NDArray* gradBR = gradB;
                 if(gradB->rankOf() == 2)
                     gradBR = new NDArray(gradB->reshape(gradB->ordering(), {(int)gradB->lengthOf()}));
@@ -106,16 +156,130 @@ static void conv2dBP_(sd::graph::Context& block, const NDArray* input, const NDA
             }
 
             //----- calculation of gradI -----//
-            // [kH, kW, iC, oC] x [bS, oH, oW, oC]/[bS, oC, oH, oW] = [kH, kW, iC, bS, oH, oW]
-            // [oC, iC, kH, kW] x [bS, oH, oW, oC]/[bS, oC, oH, oW] = [iC, kH, kW, bS, oH, oW]
-            // [oC, kH, kW, iC] x [bS, oH, oW, oC]/[bS, oC, oH, oW] = [kH, kW, iC, bS, oH, oW]
-            sd::MmulHelper::tensorDot(weights, gradO, &columns, {indWoC}, {indIOioC}, colPermut);
+            // every input pixel gathers gradients of outputs it contributed to: [taps*oC] row x weights [taps*oC, iC],
+            // so tiles write disjoint parts of gradI, and no col2im scatter is needed. With strides only taps with
+            // (ih + pH - kh*dH) % sH == 0 hit given pixel, so pixels are split into sH*sW phases, each with its own set of taps
+            if(gradI) {
+                struct Phase {
+                    int firstH, firstW, nH, nW;
+                    std::vector<int> taps;                              // kh * kW + kw
+                    std::vector<A> packedW;
+                    Nd4jLong firstTile, numTiles;
+                    int tileRows;
+                };
+
+                const int numPhases = sH * sW;
+                std::vector<Phase> phases(numPhases);
+                auto w = weights->bufferAsT<X>();
+                Nd4jLong numTiles = 0;
+                int maxK2 = 1, maxRows = 1;
+
+                for (int p = 0; p < numPhases; p++) {
+                    auto &ph = phases[p];
+                    const int rh = p / sW, rw = p % sW;
+
+                    // first input row/column of the phase: (ih + pH) % sH == rh
+                    ph.firstH = ((rh - pH) % sH + sH) % sH;
+                    ph.firstW = ((rw - pW) % sW + sW) % sW;
+                    ph.nH = ph.firstH < iH ? (iH - ph.firstH + sH - 1) / sH : 0;
+                    ph.nW = ph.firstW < iW ? (iW - ph.firstW + sW - 1) / sW : 0;
+
+                    for (int kh = 0; kh < kH; kh++)
+                        for (int kw = 0; kw < kW; kw++)
+                            if ((kh * dH) % sH == rh && (kw * dW) % sW == rw)
+                                ph.taps.push_back(kh * kW + kw);
+
+                    const Nd4jLong Mp = (Nd4jLong) bS * ph.nH * ph.nW;
+                    const int K2 = (int) ph.taps.size() * oC;
+                    ph.firstTile = numTiles;
+                    ph.tileRows = helpers::convTileRows<X>(Mp, std::max(K2, 1), numThreads);
+                    ph.numTiles = (Mp + ph.tileRows - 1) / ph.tileRows;
+                    numTiles += ph.numTiles;
+
+                    if (K2 == 0)
+                        continue;
+
+                    // weights of phase taps as [taps, oC, iC]
+                    std::vector<X> denseW((Nd4jLong) K2 * iC);
+                    for (int e = 0; e < (int) ph.taps.size(); e++)
+                        for (int n = 0; n < oC; n++) {
+                            const int kh = ph.taps[e] / kW, kw = ph.taps[e] % kW;
+                            auto src = w + kh * g.wSkh + kw * g.wSkw + n * g.wSoc;
+                            auto dst = denseW.data() + (Nd4jLong) (e * oC + n) * iC;
+                            for (int c = 0; c < iC; c++)
+                                dst[c] = src[c * g.wSic];
+                        }
+
+                    ph.packedW = helpers::convPackMatrix<X>(denseW.data(), K2, iC);
+                    maxK2 = std::max(maxK2, K2);
+                    maxRows = std::max(maxRows, ph.tileRows);
+                }
+
+                const helpers::ConvGeometry2D gI(*gradI, *weights, *gradO, kH, kW, sH, sW, pH, pW, dH, dW, isNCHW, wFormat);
+                auto gI_ = gradI->bufferAsT<X>();
+
+                auto func = PRAGMA_THREADS_FOR {
+                    std::vector<X> rows((Nd4jLong) maxRows * maxK2);
+                    std::vector<A> tile((Nd4jLong) maxRows * iC);
+                    std::vector<A> buffer(Engine::bufferLength(maxK2));
+
+                    for (auto t = start; t < stop; t++) {
+                        int p = 0;
+                        while (t >= phases[p].firstTile + phases[p].numTiles)
+                            p++;
+
+                        const auto &ph = phases[p];
+                        const int numTaps = (int) ph.taps.size();
+                        const int K2 = numTaps * oC;
+                        const Nd4jLong Mp = (Nd4jLong) bS * ph.nH * ph.nW;
+                        const Nd4jLong m0 = (t - ph.firstTile) * ph.tileRows;
+                        const int mc = (int) std::min<Nd4jLong>(ph.tileRows, Mp - m0);
+
+                        for (int r = 0; r < mc; r++) {
+                            const Nd4jLong m = m0 + r;
+                            const int b = (int) (m / ((Nd4jLong) ph.nH * ph.nW));
+                            const int ih = ph.firstH + (int) ((m / ph.nW) % ph.nH) * sH;
+                            const int iw = ph.firstW + (int) (m % ph.nW) * sW;
+
+                            auto row = rows.data() + (Nd4jLong) r * K2;
+                            for (int e = 0; e < numTaps; e++) {
+                                const int kh = ph.taps[e] / kW, kw = ph.taps[e] % kW;
+                                const int y = ih + pH - kh * dH;
+                                const int x = iw + pW - kw * dW;
+                                auto dst = row + e * oC;
+
+                                // tap is aligned with stride by construction, only borders are left to check
+                                if (y < 0 || x < 0 || y / sH >= oH || x / sW >= oW) {
+                                    std::fill(dst, dst + oC, static_cast<X>(0));
+                                    continue;
+                                }
+
+                                auto src = gO + b * g.oSb + (y / sH) * g.oSh + (x / sW) * g.oSw;
+                                for (int n = 0; n < oC; n++)
+                                    dst[n] = static_cast<X>(src[n * g.oSc]);
+                            }
+                        }
+
+                        if (K2 > 0)
+                            helpers::convGemmTile<X>(rows.data(), mc, K2, ph.packedW.data(), iC, tile.data(), buffer.data());
+                        else
+                            std::fill(tile.begin(), tile.begin() + (Nd4jLong) mc * iC, static_cast<A>(0));
+
+                        for (int r = 0; r < mc; r++) {
+                            const Nd4jLong m = m0 + r;
+                            const int b = (int) (m / ((Nd4jLong) ph.nH * ph.nW));
+                            const int ih = ph.firstH + (int) ((m / ph.nW) % ph.nH) * sH;
+                            const int iw = ph.firstW + (int) (m % ph.nW) * sW;
 
-            helpers::col2im(*block.launchContext(), columns, *gradI, sH, sW, pH, pW, iH, iW, dH, dW);       // [bS, iC, kH, kW, oH, oW] is de-convoluted to [bS, iC, iH, iW]
+                            auto z = gI_ + b * gI.iSb + ih * gI.iSh + iw * gI.iSw;
+                            auto v = tile.data() + (Nd4jLong) r * iC;
+                            for (int c = 0; c < iC; c++)
+                                z[c * gI.iSc] = static_cast<X>(v[c]);
+                        }
+                    }
+                };
 
-            if(!isNCHW) {
-                delete input;
-                delete gradI;
+                samediff::Threads::parallel_tad(func, 0, numTiles, 1, numThreads);
             }
         }
 
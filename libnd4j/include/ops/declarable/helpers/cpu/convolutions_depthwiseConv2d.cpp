@@ -25,6 +25,7 @@
 #include <array/NDArrayFactory.h>
 #include <helpers/MmulHelper.h>
 #include <execution/Threads.h>
+#include <ops/declarable/helpers/cpu/convolutions_winograd.hpp>
 
 namespace sd {
     namespace ops  {
@@ -55,6 +56,18 @@ static void depthwiseConv2d_(sd::graph::Context& block, const NDArray* input, co
             ConvolutionUtils::getSizesAndIndexesConv2d(isNCHW, wFormat, *input, *output, bS, iC, iH, iW, oC, oH, oW, indIOioC, indIiH, indWiC, indWmC, indWkH, indOoH);
             mC = weights->sizeAt(indWmC);                           // channels multiplier
 
+            if(helpers::winogradEligible(*input, *weights, kH, kW, sH, sW, dH, dW, iC, oC)) {
+                if(paddingMode == 1)                   // SAME
+                    ConvolutionUtils::calcPadding2D(pH, pW, oH, oW, iH, iW, kH, kW, sH, sW, dH, dW);
+
+                helpers::winogradConv2d(*input, *weights, *output, pH, pW, isNCHW, wFormat, true);
+
+                if(bias)
+                    helpers::addBias(block, *output, *bias, *output, isNCHW);
+
+                return;
+            }
+
             std::vector<std::vector<Nd4jLong>> modifColumns = {{1,0,4,5,2,3}, {iC,bS*oH*oW,kH*kW}};  // [bS,iC,kH,kW,oH,oW] -> [iC,bS,oH,oW,kH,kW] -> [iC,bS*oH*oW,kH*kW]
             std::vector<std::vector<Nd4jLong>> modifOutput, modifWeights;
             std::vector<Nd4jLong> outReShape;
@@ -0,0 +1,190 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// @author raver119@gmail.com
+//
+// Implicit GEMM for 2D convolution: instead of materializing the whole im2col buffer,
+// output pixels are processed in tiles, and only patches of the current tile are packed into small per-thread buffer
+//
+
+#ifndef SD_CONVOLUTIONS_TILED_HPP
+#define SD_CONVOLUTIONS_TILED_HPP
+
+#include <array/NDArray.h>
+#include <ops/gemm.h>
+#include <system/openmp_pragmas.h>
+#include <algorithm>
+#include <vector>
+
+namespace sd {
+    namespace ops {
+        namespace helpers {
+
+            // packed patches of a tile are supposed to stay within L2 cache
+            static const Nd4jLong CONV_TILE_BYTES = 256 * 1024;
+
+            /**
+             * Sizes and strides of 2D convolution, with every array described in logical layout regardless of its format:
+             * input/output [bS, C, H, W], weights [kH, kW, iC, oC]
+             */
+            struct ConvGeometry2D {
+                int bS, iC, iH, iW, oC, oH, oW;
+                int kH, kW, sH, sW, pH, pW, dH, dW;
+
+                Nd4jLong iSb, iSc, iSh, iSw;
+                Nd4jLong oSb, oSc, oSh, oSw;
+                Nd4jLong wSkh, wSkw, wSic, wSoc;
+
+                ConvGeometry2D(const NDArray &input, const NDArray &weights, const NDArray &output, const int kH, const int kW, const int sH, const int sW, const int pH, const int pW, const int dH, const int dW, const int isNCHW, const int wFormat) {
+                    this->kH = kH; this->kW = kW;
+                    this->sH = sH; this->sW = sW;
+                    this->pH = pH; this->pW = pW;
+                    this->dH = dH; this->dW = dW;
+
+                    // axes of batch, channels, height and width
+                    const int c = isNCHW ? 1 : 3;
+                    const int h = isNCHW ? 2 : 1;
+                    const int w = isNCHW ? 3 : 2;
+
+                    bS = input.sizeAt(0);
+                    iC = input.sizeAt(c); iH = input.sizeAt(h); iW = input.sizeAt(w);
+                    oC = output.sizeAt(c); oH = output.sizeAt(h); oW = output.sizeAt(w);
+
+                    iSb = input.strideAt(0); iSc = input.strideAt(c); iSh = input.strideAt(h); iSw = input.strideAt(w);
+                    oSb = output.strideAt(0); oSc = output.strideAt(c); oSh = output.strideAt(h); oSw = output.strideAt(w);
+
+                    // [kH, kW, iC, oC], [oC, iC, kH, kW], [oC, kH, kW, iC]
+                    if (0 == wFormat) {
+                        wSkh = weights.strideAt(0); wSkw = weights.strideAt(1); wSic = weights.strideAt(2); wSoc = weights.strideAt(3);
+                    } else if (1 == wFormat) {
+                        wSoc = weights.strideAt(0); wSic = weights.strideAt(1); wSkh = weights.strideAt(2); wSkw = weights.strideAt(3);
+                    } else {
+                        wSoc = weights.strideAt(0); wSkh = weights.strideAt(1); wSkw = weights.strideAt(2); wSic = weights.strideAt(3);
+                    }
+                }
+
+                // length of single patch, patch is ordered as [kH, kW, iC]
+                FORCEINLINE int patchLength() const {
+                    return kH * kW * iC;
+                }
+            };
+
+            /**
+             * Number of rows in a tile, so that tile of rowLength elements fits CONV_TILE_BYTES, with enough tiles for all threads
+             */
+            template <typename T>
+            static int convTileRows(const Nd4jLong numRows, const int rowLength, const int numThreads) {
+                Nd4jLong rows = CONV_TILE_BYTES / std::max<Nd4jLong>(1, rowLength * (Nd4jLong) sizeof(T));
+                rows = std::min<Nd4jLong>(256, std::max<Nd4jLong>(4, rows));
+                rows = std::min<Nd4jLong>(rows, std::max<Nd4jLong>(1, (numRows + numThreads - 1) / numThreads));
+                return (int) rows;
+            }
+
+            /**
+             * This function packs patches of output pixels [m0, m0 + mc) into rows of patchLength() elements, zeros stand for padding
+             */
+            template <typename T>
+            static void convPackPatches(const T *in, const ConvGeometry2D &g, const Nd4jLong m0, const int mc, T *patches) {
+                const int K = g.patchLength();
+                const Nd4jLong oHW = (Nd4jLong) g.oH * g.oW;
+
+                for (int r = 0; r < mc; r++) {
+                    const Nd4jLong m = m0 + r;
+                    const int b = (int) (m / oHW);
+                    const int oh = (int) ((m % oHW) / g.oW);
+                    const int ow = (int) (m % g.oW);
+
+                    T *p = patches + (Nd4jLong) r * K;
+                    const T *img = in + b * g.iSb;
+
+                    for (int kh = 0; kh < g.kH; kh++) {
+                        const int ih = oh * g.sH - g.pH + kh * g.dH;
+
+                        for (int kw = 0; kw < g.kW; kw++) {
+                            const int iw = ow * g.sW - g.pW + kw * g.dW;
+                            T *dst = p + (kh * g.kW + kw) * g.iC;
+
+                            if (ih < 0 || ih >= g.iH || iw < 0 || iw >= g.iW) {
+                                std::fill(dst, dst + g.iC, static_cast<T>(0));
+                                continue;
+                            }
+
+                            const T *src = img + ih * g.iSh + iw * g.iSw;
+                            if (g.iSc == 1) {
+                                std::copy(src, src + g.iC, dst);
+                            } else {
+                                for (int c = 0; c < g.iC; c++)
+                                    dst[c] = src[c * g.iSc];
+                            }
+                        }
+                    }
+                }
+            }
+
+            /**
+             * Products of tiles go through packed BlockedGEMM micro-kernel, single-threaded since tiles are processed in parallel already.
+             * Tiles are accumulated (and stored) in GemmTraits accumulator type, i.e. fp32 for half/bfloat16
+             */
+            template <typename T>
+            struct ConvGemm {
+                typedef typename sd::blas::GemmTraits<T>::acc_type A;
+                typedef sd::blas::BlockedGEMM<T, T, A> Engine;
+            };
+
+            /**
+             * This function packs dense row-major [K, N] matrix into BlockedGEMM panels, ready for convGemmTile
+             */
+            template <typename T>
+            static std::vector<typename ConvGemm<T>::A> convPackMatrix(const T *b, const int K, const int N) {
+                std::vector<typename ConvGemm<T>::A> packed(ConvGemm<T>::Engine::packedLength(K, N));
+                ConvGemm<T>::Engine::packMatrixB(K, N, b, N, 1, packed.data());
+                return packed;
+            }
+
+            /**
+             * This function packs weights as [kH * kW * iC, oC] matrix, matching order of patches
+             */
+            template <typename T>
+            static std::vector<typename ConvGemm<T>::A> convPackWeights(const T *w, const ConvGeometry2D &g) {
+                std::vector<T> dense((Nd4jLong) g.patchLength() * g.oC);
+
+                for (int kh = 0; kh < g.kH; kh++)
+                    for (int kw = 0; kw < g.kW; kw++)
+                        for (int c = 0; c < g.iC; c++) {
+                            const T *src = w + kh * g.wSkh + kw * g.wSkw + c * g.wSic;
+                            T *dst = dense.data() + (Nd4jLong) ((kh * g.kW + kw) * g.iC + c) * g.oC;
+
+                            for (int n = 0; n < g.oC; n++)
+                                dst[n] = src[n * g.wSoc];
+                        }
+
+                return convPackMatrix<T>(dense.data(), g.patchLength(), g.oC);
+            }
+
+            /**
+             * c[mc, N] = a[mc, K] x b[K, N], a and c are dense and row-major, b is packed with convPackMatrix.
+             * buffer holds ConvGemm<T>::Engine::bufferLength(K) elements, and is supposed to be reused for all tiles of a thread
+             */
+            template <typename T>
+            static FORCEINLINE void convGemmTile(const T *a, const int mc, const int K, const typename ConvGemm<T>::A *b, const int N, typename ConvGemm<T>::A *c, typename ConvGemm<T>::A *buffer) {
+                ConvGemm<T>::Engine::serial(mc, N, K, 1.0, a, K, 1, b, 0.0, c, N, 1, buffer);
+            }
+        }
+    }
+}
+
+#endif //SD_CONVOLUTIONS_TILED_HPP
@@ -0,0 +1,398 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// @author raver119@gmail.com
+//
+
+#include <ops/declarable/helpers/cpu/convolutions_winograd.hpp>
+#include <ops/declarable/helpers/cpu/convolutions_tiled.hpp>
+#include <execution/Threads.h>
+
+namespace sd {
+    namespace ops {
+        namespace helpers {
+
+            // Transform matrices from Lavin & Gray, "Fast Algorithms for Convolutional Neural Networks"
+            static const float WINOGRAD_BT_2[4 * 4] = { 1.f,  0.f, -1.f,  0.f,
+                                                        0.f,  1.f,  1.f,  0.f,
+                                                        0.f, -1.f,  1.f,  0.f,
+                                                        0.f,  1.f,  0.f, -1.f };
+
+            static const float WINOGRAD_G_2[4 * 3] = { 1.f,  0.f,  0.f,
+                                                       .5f,  .5f,  .5f,
+                                                       .5f, -.5f,  .5f,
+                                                       0.f,  0.f,  1.f };
+
+            static const float WINOGRAD_AT_2[2 * 4] = { 1.f, 1.f,  1.f,  0.f,
+                                                        0.f, 1.f, -1.f, -1.f };
+
+            static const float WINOGRAD_BT_4[6 * 6] = { 4.f,  0.f, -5.f,  0.f, 1.f, 0.f,
+                                                        0.f, -4.f, -4.f,  1.f, 1.f, 0.f,
+                                                        0.f,  4.f, -4.f, -1.f, 1.f, 0.f,
+                                                        0.f, -2.f, -1.f,  2.f, 1.f, 0.f,
+                                                        0.f,  2.f, -1.f, -2.f, 1.f, 0.f,
+                                                        0.f,  4.f,  0.f, -5.f, 0.f, 1.f };
+
+            static const float WINOGRAD_G_4[6 * 3] = { 1.f / 4.f,   0.f,         0.f,
+                                                       -1.f / 6.f,  -1.f / 6.f,  -1.f / 6.f,
+                                                       -1.f / 6.f,  1.f / 6.f,   -1.f / 6.f,
+                                                       1.f / 24.f,  1.f / 12.f,  1.f / 6.f,
+                                                       1.f / 24.f,  -1.f / 12.f, 1.f / 6.f,
+                                                       0.f,         0.f,         1.f };
+
+            static const float WINOGRAD_AT_4[4 * 6] = { 1.f, 1.f,  1.f, 1.f,  1.f, 0.f,
+                                                        0.f, 1.f, -1.f, 2.f, -2.f, 0.f,
+                                                        0.f, 1.f,  1.f, 4.f,  4.f, 0.f,
+                                                        0.f, 1.f, -1.f, 8.f, -8.f, 1.f };
+
+            // F(MxM, 3x3): every tile of MxM outputs is computed from (M+2)x(M+2) inputs
+            template <int M>
+            struct WinogradTransform {
+                static const int A = M + 2;
+
+                static FORCEINLINE const float* BT() { return M == 2 ? WINOGRAD_BT_2 : WINOGRAD_BT_4; }
+                static FORCEINLINE const float* G()  { return M == 2 ? WINOGRAD_G_2  : WINOGRAD_G_4; }
+                static FORCEINLINE const float* AT() { return M == 2 ? WINOGRAD_AT_2 : WINOGRAD_AT_4; }
+
+                // v = BT x d x B
+                static void input(const float *d, float *v) {
+                    float t[A * A];
+                    auto bt = BT();
+
+                    for (int i = 0; i < A; i++)
+                        for (int j = 0; j < A; j++) {
+                            float s = 0.f;
+                            for (int k = 0; k < A; k++)
+                                s += bt[i * A + k] * d[k * A + j];
+                            t[i * A + j] = s;
+                        }
+
+                    for (int i = 0; i < A; i++)
+                        for (int j = 0; j < A; j++) {
+                            float s = 0.f;
+                            for (int k = 0; k < A; k++)
+                                s += t[i * A + k] * bt[j * A + k];
+                            v[i * A + j] = s;
+                        }
+                }
+
+                // u = G x g x GT
+                static void weights(const float *g, float *u) {
+                    float t[A * 3];
+                    auto gm = G();
+
+                    for (int i = 0; i < A; i++)
+                        for (int j = 0; j < 3; j++)
+                            t[i * 3 + j] = gm[i * 3] * g[j] + gm[i * 3 + 1] * g[3 + j] + gm[i * 3 + 2] * g[6 + j];
+
+                    for (int i = 0; i < A; i++)
+                        for (int j = 0; j < A; j++)
+                            u[i * A + j] = t[i * 3] * gm[j * 3] + t[i * 3 + 1] * gm[j * 3 + 1] + t[i * 3 + 2] * gm[j * 3 + 2];
+                }
+
+                // y = AT x m x A
+                static void output(const float *m, float *y) {
+                    float t[M * A];
+                    auto at = AT();
+
+                    for (int i = 0; i < M; i++)
+                        for (int j = 0; j < A; j++) {
+                            float s = 0.f;
+                            for (int k = 0; k < A; k++)
+                                s += at[i * A + k] * m[k * A + j];
+                            t[i * A + j] = s;
+                        }
+
+                    for (int i = 0; i < M; i++)
+                        for (int j = 0; j < M; j++) {
+                            float s = 0.f;
+                            for (int k = 0; k < A; k++)
+                                s += t[i * A + k] * at[j * A + k];
+                            y[i * M + j] = s;
+                        }
+                }
+            };
+
+            //////////////////////////////////////////////////////////////////////////
+            bool WinogradWeightsCache::Key::operator==(const Key &other) const {
+                return sameWeights(other) && generation == other.generation;
+            }
+
+            bool WinogradWeightsCache::Key::sameWeights(const Key &other) const {
+                return bufferId == other.bufferId && offset == other.offset && dataType == other.dataType && wFormat == other.wFormat
+                       && tile == other.tile && iC == other.iC && oC == other.oC && depthwise == other.depthwise;
+            }
+
+            WinogradWeightsCache& WinogradWeightsCache::getInstance() {
+                static WinogradWeightsCache instance;
+                return instance;
+            }
+
+            std::shared_ptr<const std::vector<float>> WinogradWeightsCache::get(const Key &key) {
+                std::lock_guard<std::mutex> lock(_mutex);
+
+                for (auto &e: _entries)
+                    if (e.key == key) {
+                        _hits++;
+                        return e.weights;
+                    }
+
+                _misses++;
+                return nullptr;
+            }
+
+            void WinogradWeightsCache::put(const Key &key, const std::shared_ptr<const std::vector<float>> &weights) {
+                std::lock_guard<std::mutex> lock(_mutex);
+
+                // entry for the same weights is outdated now
+                for (auto it = _entries.begin(); it != _entries.end(); it++)
+                    if (it->key.sameWeights(key)) {
+                        _entries.erase(it);
+                        break;
+                    }
+
+                // the oldest entry goes away
+                if ((int) _entries.size() >= MAX_ENTRIES)
+                    _entries.erase(_entries.begin());
+
+                _entries.emplace_back(Entry{key, weights});
+            }
+
+            Nd4jLong WinogradWeightsCache::hits() {
+                std::lock_guard<std::mutex> lock(_mutex);
+                return _hits;
+            }
+
+            Nd4jLong WinogradWeightsCache::misses() {
+                std::lock_guard<std::mutex> lock(_mutex);
+                return _misses;
+            }
+
+            void WinogradWeightsCache::clear() {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _entries.clear();
+                _hits = 0;
+                _misses = 0;
+            }
+
+            //////////////////////////////////////////////////////////////////////////
+            bool winogradEligible(const NDArray &input, const NDArray &weights, const int kH, const int kW, const int sH, const int sW, const int dH, const int dW, const int iC, const int oC) {
+                if (kH != 3 || kW != 3 || sH != 1 || sW != 1 || dH != 1 || dW != 1)
+                    return false;
+
+                if (iC < WINOGRAD_MIN_CHANNELS || oC < WINOGRAD_MIN_CHANNELS)
+                    return false;
+
+                if (input.dataType() != weights.dataType() || input.isEmpty())
+                    return false;
+
+                auto dtype = input.dataType();
+                return dtype == sd::DataType::FLOAT32 || dtype == sd::DataType::HALF || dtype == sd::DataType::BFLOAT16;
+            }
+
+            // transformed weights are stored as [A*A, iC, oC]
+            template <int M, typename X>
+            static std::shared_ptr<const std::vector<float>> winogradWeights(const NDArray &weights, const ConvGeometry2D &g, const int iC, const int oC, const int wFormat, const bool depthwise) {
+                const int A = WinogradTransform<M>::A;
+                auto w = weights.bufferAsT<X>();
+
+                auto buffer = weights.getDataBuffer();
+                WinogradWeightsCache::Key key = {buffer->uniqueId(), buffer->generation(), weights.bufferOffset(), weights.dataType(), wFormat, M, iC, oC, depthwise};
+
+                auto cached = WinogradWeightsCache::getInstance().get(key);
+                if (cached != nullptr)
+                    return cached;
+
+                auto result = std::make_shared<std::vector<float>>((Nd4jLong) A * A * iC * oC);
+                auto u = result->data();
+
+                auto func = PRAGMA_THREADS_FOR {
+                    float gk[9];
+                    float uk[A * A];
+
+                    for (auto c = start; c < stop; c++)
+                        for (int n = 0; n < oC; n++) {
+                            for (int kh = 0; kh < 3; kh++)
+                                for (int kw = 0; kw < 3; kw++)
+                                    gk[kh * 3 + kw] = static_cast<float>(w[kh * g.wSkh + kw * g.wSkw + c * g.wSic + n * g.wSoc]);
+
+                            WinogradTransform<M>::weights(gk, uk);
+
+                            for (int xi = 0; xi < A * A; xi++)
+                                u[((Nd4jLong) xi * iC + c) * oC + n] = uk[xi];
+                        }
+                };
+
+                samediff::Threads::parallel_tad(func, 0, iC);
+
+                WinogradWeightsCache::getInstance().put(key, result);
+                return result;
+            }
+
+            //////////////////////////////////////////////////////////////////////////
+            template <int M, typename X>
+            static void winogradConv2d_(const NDArray &input, const NDArray &weights, NDArray &output, const int pH, const int pW, const int isNCHW, const int wFormat, const bool depthwise) {
+                const int A = WinogradTransform<M>::A;
+                const int AA = A * A;
+
+                const ConvGeometry2D g(input, weights, output, 3, 3, 1, 1, pH, pW, 1, 1, isNCHW, wFormat);
+                const int iC = g.iC;
+                const int oC = g.oC;
+
+                // number of weights per input channel: oC for regular convolution, channels multiplier for depthwise one
+                const int wC = depthwise ? oC / iC : oC;
+
+                auto transformed = winogradWeights<M, X>(weights, g, iC, wC, wFormat, depthwise);
+                auto u = transformed->data();
+
+                const int tilesH = (g.oH + M - 1) / M;
+                const int tilesW = (g.oW + M - 1) / M;
+                const Nd4jLong numTiles = (Nd4jLong) g.bS * tilesH * tilesW;
+
+                // number of tiles processed at once, transformed inputs and products of a block are supposed to fit into L2
+                const int numThreads = sd::Environment::getInstance().maxMasterThreads();
+                Nd4jLong block = (2 * CONV_TILE_BYTES) / ((Nd4jLong) AA * (iC + oC) * sizeof(float));
+                block = std::min<Nd4jLong>(64, std::max<Nd4jLong>(4, block));
+                block = std::min<Nd4jLong>(block, std::max<Nd4jLong>(1, (numTiles + numThreads - 1) / numThreads));
+                const int T = (int) block;
+                const Nd4jLong numBlocks = (numTiles + T - 1) / T;
+
+                auto in = input.bufferAsT<X>();
+                auto out = output.bufferAsT<X>();
+
+                // transformed weights of every tile element are packed for gemm once per call
+                typedef ConvGemm<float>::Engine Engine;
+                const Nd4jLong uLength = depthwise ? 0 : Engine::packedLength(iC, oC);
+                std::vector<float> packedU(AA * uLength);
+                if (!depthwise)
+                    for (int xi = 0; xi < AA; xi++)
+                        Engine::packMatrixB(iC, oC, u + (Nd4jLong) xi * iC * oC, oC, 1, packedU.data() + xi * uLength);
+
+                auto func = PRAGMA_THREADS_FOR {
+                    std::vector<float> v((Nd4jLong) AA * T * iC);
+                    std::vector<float> m((Nd4jLong) AA * T * oC);
+                    std::vector<float> buffer(depthwise ? 0 : Engine::bufferLength(iC));
+                    float d[A * A], vt[A * A], mt[A * A], y[M * M];
+
+                    for (auto bl = start; bl < stop; bl++) {
+                        const Nd4jLong t0 = bl * T;
+                        const int tc = (int) std::min<Nd4jLong>(T, numTiles - t0);
+
+                        // input transform
+                        for (int t = 0; t < tc; t++) {
+                            const Nd4jLong tile = t0 + t;
+                            const int b = (int) (tile / ((Nd4jLong) tilesH * tilesW));
+                            const int ih0 = (int) ((tile / tilesW) % tilesH) * M - pH;
+                            const int iw0 = (int) (tile % tilesW) * M - pW;
+
+                            for (int c = 0; c < iC; c++) {
+                                auto src = in + b * g.iSb + c * g.iSc;
+
+                                for (int i = 0; i < A; i++) {
+                                    const int ih = ih0 + i;
+                                    for (int j = 0; j < A; j++) {
+                                        const int iw = iw0 + j;
+                                        d[i * A + j] = (ih >= 0 && ih < g.iH && iw >= 0 && iw < g.iW) ? static_cast<float>(src[ih * g.iSh + iw * g.iSw]) : 0.f;
+                                    }
+                                }
+
+                                WinogradTransform<M>::input(d, vt);
+
+                                for (int xi = 0; xi < AA; xi++)
+                                    v[((Nd4jLong) xi * T + t) * iC + c] = vt[xi];
+                            }
+                        }
+
+                        // element-wise products in transformed space: one gemm per tile element for regular convolution
+                        if (depthwise) {
+                            for (int xi = 0; xi < AA; xi++)
+                                for (int t = 0; t < tc; t++) {
+                                    auto vx = v.data() + ((Nd4jLong) xi * T + t) * iC;
+                                    auto mx = m.data() + ((Nd4jLong) xi * T + t) * oC;
+                                    auto ux = u + (Nd4jLong) xi * iC * wC;
+
+                                    for (int c = 0; c < iC; c++)
+                                        for (int j = 0; j < wC; j++)
+                                            mx[c * wC + j] = vx[c] * ux[c * wC + j];
+                                }
+                        } else {
+                            for (int xi = 0; xi < AA; xi++)
+                                convGemmTile<float>(v.data() + (Nd4jLong) xi * T * iC, tc, iC, packedU.data() + xi * uLength, oC, m.data() + (Nd4jLong) xi * T * oC, buffer.data());
+                        }
+
+                        // output transform
+                        for (int t = 0; t < tc; t++) {
+                            const Nd4jLong tile = t0 + t;
+                            const int b = (int) (tile / ((Nd4jLong) tilesH * tilesW));
+                            const int oh0 = (int) ((tile / tilesW) % tilesH) * M;
+                            const int ow0 = (int) (tile % tilesW) * M;
+                            const int mh = std::min(M, g.oH - oh0);
+                            const int mw = std::min(M, g.oW - ow0);
+
+                            for (int n = 0; n < oC; n++) {
+                                for (int xi = 0; xi < AA; xi++)
+                                    mt[xi] = m[((Nd4jLong) xi * T + t) * oC + n];
+
+                                WinogradTransform<M>::output(mt, y);
+
+                                auto z = out + b * g.oSb + n * g.oSc;
+                                for (int i = 0; i < mh; i++)
+                                    for (int j = 0; j < mw; j++)
+                                        z[(oh0 + i) * g.oSh + (ow0 + j) * g.oSw] = static_cast<X>(y[i * M + j]);
+                            }
+                        }
+                    }
+                };
+
+                samediff::Threads::parallel_tad(func, 0, numBlocks, 1, numThreads);
+            }
+
+            //////////////////////////////////////////////////////////////////////////
+            template <typename X>
+            static void winogradConv2dSelect(const NDArray &input, const NDArray &weights, NDArray &output, const int pH, const int pW, const int isNCHW, const int wFormat, const bool depthwise) {
+                const int c = isNCHW ? 1 : 3;
+                const int iC = input.sizeAt(c);
+                const int oC = output.sizeAt(c);
+                const int oH = output.sizeAt(isNCHW ? 2 : 1);
+                const int oW = output.sizeAt(isNCHW ? 3 : 2);
+
+                // F(4x4, 3x3) cuts multiplications by 4x instead of 2.25x, but its transforms are less accurate and cost more,
+                // so it's used only for wide layers of float32 models
+                if (!depthwise && input.dataType() == sd::DataType::FLOAT32 && iC >= 32 && oC >= 32 && oH >= 8 && oW >= 8)
+                    winogradConv2d_<4, X>(input, weights, output, pH, pW, isNCHW, wFormat, depthwise);
+                else
+                    winogradConv2d_<2, X>(input, weights, output, pH, pW, isNCHW, wFormat, depthwise);
+            }
+
+            void winogradConv2d(const NDArray &input, const NDArray &weights, NDArray &output, const int pH, const int pW, const int isNCHW, const int wFormat, const bool depthwise) {
+                switch (input.dataType()) {
+                    case sd::DataType::FLOAT32:
+                        winogradConv2dSelect<float>(input, weights, output, pH, pW, isNCHW, wFormat, depthwise);
+                        break;
+                    case sd::DataType::HALF:
+                        winogradConv2dSelect<float16>(input, weights, output, pH, pW, isNCHW, wFormat, depthwise);
+                        break;
+                    case sd::DataType::BFLOAT16:
+                        winogradConv2dSelect<bfloat16>(input, weights, output, pH, pW, isNCHW, wFormat, depthwise);
+                        break;
+                    default:
+                        throw std::runtime_error("winogradConv2d: only FLOAT32, HALF and BFLOAT16 are supported");
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,109 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// @author raver119@gmail.com
+//
+// Winograd F(2x2, 3x3) and F(4x4, 3x3) engine for 3x3 stride-1 convolutions
+//
+
+#ifndef SD_CONVOLUTIONS_WINOGRAD_HPP
+#define SD_CONVOLUTIONS_WINOGRAD_HPP
+
+#include <array/NDArray.h>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace sd {
+    namespace ops {
+        namespace helpers {
+
+            static const int WINOGRAD_MIN_CHANNELS = 8;
+
+            /**
+             * This class holds Winograd-transformed weights, so that repeated calls with the same weights don't transform them again.
+             * Entries are looked up by unique id of weights buffer and its write generation, so in-place updates
+             * of weights (i.e. during training) or reuse of freed memory never produce stale results.
+             */
+            class ND4J_EXPORT WinogradWeightsCache {
+            public:
+                struct Key {
+                    Nd4jLong bufferId;
+                    Nd4jLong generation;
+                    Nd4jLong offset;
+                    sd::DataType dataType;
+                    int wFormat;
+                    int tile;
+                    int iC;
+                    int oC;
+                    bool depthwise;
+
+                    bool operator==(const Key &other) const;
+
+                    // same weights view, regardless of generation
+                    bool sameWeights(const Key &other) const;
+                };
+
+            private:
+                struct Entry {
+                    Key key;
+                    std::shared_ptr<const std::vector<float>> weights;
+                };
+
+                static const int MAX_ENTRIES = 64;
+
+                std::mutex _mutex;
+                std::vector<Entry> _entries;
+                Nd4jLong _hits = 0;
+                Nd4jLong _misses = 0;
+
+                WinogradWeightsCache() = default;
+            public:
+                static WinogradWeightsCache& getInstance();
+
+                /**
+                 * This method returns transformed weights, or nullptr if there's no valid entry
+                 */
+                std::shared_ptr<const std::vector<float>> get(const Key &key);
+
+                /**
+                 * This method stores transformed weights, entry of older generation of the same weights is replaced
+                 */
+                void put(const Key &key, const std::shared_ptr<const std::vector<float>> &weights);
+
+                Nd4jLong hits();
+                Nd4jLong misses();
+                void clear();
+            };
+
+            /**
+             * This method returns true if Winograd engine can be used for given convolution:
+             * 3x3 kernel, unit strides and dilations, float32/float16/bfloat16 input and weights of the same type,
+             * and at least WINOGRAD_MIN_CHANNELS input and output channels, since with fewer channels transforms cost more than they save
+             */
+            ND4J_EXPORT bool winogradEligible(const NDArray &input, const NDArray &weights, const int kH, const int kW, const int sH, const int sW, const int dH, const int dW, const int iC, const int oC);
+
+            /**
+             * Winograd conv2d, paddings are expected to be calculated already. Bias isn't applied.
+             * For depthwise convolution weights are [kH, kW, iC, mC] (or other wFormat), and output has iC*mC channels
+             */
+            ND4J_EXPORT void winogradConv2d(const NDArray &input, const NDArray &weights, NDArray &output, const int pH, const int pW, const int isNCHW, const int wFormat, const bool depthwise);
+        }
+    }
+}
+
+#endif //SD_CONVOLUTIONS_WINOGRAD_HPP
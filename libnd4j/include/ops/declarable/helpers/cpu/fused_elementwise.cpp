@@ -0,0 +1,107 @@
+/*******************************************************************************
+ * Copyright (c) 2015-2018 Skymind, Inc.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+#include <ops/declarable/helpers/fused_elementwise.h>
+#include <loops/transform_same.h>
+#include <loops/transform_float.h>
+#include <loops/transform_strict.h>
+#include <loops/scalar.h>
+#include <loops/pairwise_transform.h>
+#include <execution/Threads.h>
+#include <helpers/shape.h>
+
+namespace sd {
+namespace ops {
+namespace helpers {
+
+    // number of elements processed by the whole chain at once. input, output and operand blocks have to fit into L1 together
+    static const Nd4jLong FUSED_BLOCK_SIZE = 2048;
+
+    template <typename X>
+    static void fusedElementwise_(const std::vector<FusedStep> &steps, const NDArray &input, NDArray &output) {
+        auto x = input.bufferAsT<X>();
+        auto z = output.bufferAsT<X>();
+
+        const auto length = output.lengthOf();
+        const auto numBlocks = (length + FUSED_BLOCK_SIZE - 1) / FUSED_BLOCK_SIZE;
+        const auto dtype = output.dataType();
+
+        auto func = PRAGMA_THREADS_FOR {
+            // legacy transforms are shape-driven, so every block is described as standalone vector
+            Nd4jLong blockShape[MAX_SHAPEINFOLENGTH];
+            Nd4jLong blockLength = -1;
+
+            for (auto b = start; b < stop; b++) {
+                const auto offset = b * FUSED_BLOCK_SIZE;
+                Nd4jLong len = sd::math::nd4j_min<Nd4jLong>(FUSED_BLOCK_SIZE, length - offset);
+                if (len != blockLength) {
+                    shape::shapeBuffer(1, dtype, &len, blockShape);
+                    blockLength = len;
+                }
+
+                // first step reads the input, all the following ones work in-place within output block
+                const X *src = x + offset;
+                X *dst = z + offset;
+
+                for (const auto &step : steps) {
+                    switch (step.kind) {
+                        case FUSED_TRANSFORM_SAME:
+                            functions::transform::TransformSame<X>::exec(step.opNum, src, blockShape, dst, blockShape, step.extraParams, 0, 1);
+                            break;
+                        case FUSED_TRANSFORM_FLOAT:
+                            functions::transform::TransformFloat<X, X>::exec(step.opNum, src, blockShape, dst, blockShape, step.extraParams, 0, 1);
+                            break;
+                        case FUSED_TRANSFORM_STRICT:
+                            functions::transform::TransformStrict<X>::exec(step.opNum, src, blockShape, dst, blockShape, step.extraParams, 0, 1);
+                            break;
+                        case FUSED_SCALAR:
+                            functions::scalar::ScalarTransform<X, X, X>::transform(step.opNum, src, 1, dst, 1, step.operand, step.extraParams, len, 0, len);
+                            break;
+                        case FUSED_PAIRWISE: {
+                            auto y = reinterpret_cast<const X *>(step.operand) + offset;
+                            if (step.reversed)
+                                functions::pairwise_transforms::PairWiseTransform<X, X, X>::exec(step.opNum, y, 1, src, 1, dst, 1, step.extraParams, len, 0, len);
+                            else
+                                functions::pairwise_transforms::PairWiseTransform<X, X, X>::exec(step.opNum, src, 1, y, 1, dst, 1, step.extraParams, len, 0, len);
+                            }
+                            break;
+                        default:
+                            throw std::runtime_error("fusedElementwise: unknown step kind");
+                    }
+
+                    src = dst;
+                }
+            }
+        };
+
+        samediff::Threads::parallel_for(func, 0, numBlocks);
+    }
+
+    void fusedElementwise(sd::LaunchContext *context, const std::vector<FusedStep> &steps, const NDArray &input, NDArray &output) {
+        if (output.isEmpty() || steps.empty())
+            return;
+
+        NDArray::preparePrimaryUse({&output}, {&input});
+
+        BUILD_SINGLE_SELECTOR(output.dataType(), fusedElementwise_, (steps, input, output), FLOAT_TYPES);
+
+        NDArray::registerPrimaryUse({&output}, {&input});
+    }
+
+    BUILD_SINGLE_TEMPLATE(template void fusedElementwise_, (const std::vector<FusedStep> &steps, const NDArray &input, NDArray &output), FLOAT_TYPES);
+}
+}
+}
@@ -134,52 +134,17 @@ static void fusedTanh(NDArray *z, NDArray *i, NDArray *c, const NDArray *cLast,
 }
 
 //////////////////////////////////////////////////////////////////////////
+static void lstmBlockGates(NDArray& m, const NDArray* cLast, const NDArray* Wci, const NDArray* Wcf, const NDArray* Wco,
+                           NDArray* i, NDArray* c, NDArray* f, NDArray* o, NDArray* z, NDArray* h, NDArray* y, const std::vector<double>& params) {
 
-void lstmBlockCell(const NDArray* xt, const NDArray* cLast, const NDArray* yLast,
-                   const NDArray* W, const NDArray* Wci, const NDArray* Wcf, const NDArray* Wco, const NDArray* b,
-                   NDArray* i, NDArray* c, NDArray* f, NDArray* o, NDArray* z, NDArray* h, NDArray* y, const std::vector<double>& params) {
+    // m - gates pre-activations [bS, 4*nOut], modified in place
 
-    /* Input arrays:
-    *    0: xt              - input [bS, nIn] at time t
-    *    1: cLast (cs_prev) - previous cell state  [bS, nOut], time t-1
-    *    2: yLast (h_prev)  - previous output [bS, nOut], time t-1
-    *    3: W               - Weights - concatenated (input-to-hidden, hidden-to-hidden weights)  weights, [(nIn+nOut), 4*nOut]
-    *    4: Wci             - weights - cell peephole (t-1) connections to input modulation gate, [nOut]
-    *    5: Wcf             - weights - cell peephole (t-1) connections to forget gate, [nOut]
-    *    6: Wco             - weights - cell peephole (t) connections to output gate, [nOut]
-    *    7: b               - biases, [4*nOut]
-    *
-    *  Input integer arguments:
-    *    0: if not zero, provide peephole connections
-    *
-    *  Input float arguments:
-    *    0: the bias added to forget gates in order to reduce the scale of forgetting in the beginning of the training
-    *    1: clipping value for cell state, if it is not equal to zero, then cell state is clipped
-    *
-    * Output arrays:
-    *    0: i      - Input modulation gate activations [bS, nOut]
-    *    1: c (cs) - Cell state (pre tanh) [bs, nOut] (cs)
-    *    2: f      - Output - forget gate activations [bs, nOut]
-    *    3: o      - Output - output gate activations [bs, nOut]
-    *    4: z (ci) - Output - block input [bs, nOut]
-    *    5: h (co) - Cell state, post tanh [bs, nOut]
-    *    6: y (h)  - Current cell output [bS, nOut], time t
-    */
     const bool peephole            = (bool)params[0];        // if true, provide peephole connections
     const double forgetBias        = params[1];
     const double clippingCellValue = params[2];              // clipping value for ct, if it is not equal to zero, then cell state is clipped
 
-    const int bS   = xt->sizeAt(0);
-    const int nIn  = xt->sizeAt(1);
     const int nOut = cLast->sizeAt(1);
 
-    //Concat inputs: [xt, yt-1]: concat([bs,nIn],[bs,nOut]) -> [bs, (nIn+nOut)]
-    NDArray concatOut(xt->ordering(), {xt->sizeAt(0), xt->sizeAt(1) + yLast->sizeAt(1)}, xt->dataType(), xt->getContext());
-    helpers::concat(xt->getContext(), {const_cast<NDArray*>(xt), const_cast<NDArray*>(yLast)}, concatOut, {1});
-
-    auto m = mmul(concatOut, *W);       // mmul: [bs, (nIn+nOut)] * [(nIn+nOut), 4*nOut] = [bs, 4*nOut]
-    m += (*b);                          // addiRowVector
-
     //Note: weights are ordered [inputGate, blockInput, forgetGate, outputGate] to match TF (TF code comments state [i,f,z/ci,o] but behaviour is [i,z,f,o])
     auto zi = m({0,0, 0,        nOut});         // z for input modulation gate, [bS, nOut]
     auto zz = m({0,0, nOut,   2*nOut});      	// z for block input, [bS, nOut]
@@ -237,6 +202,62 @@ void lstmBlockCell(const NDArray* xt, const NDArray* cLast, const NDArray* yLast
     o->applyPairwiseTransform(pairwise::Multiply, *h, *y);   //y = o * h
 }
 
+//////////////////////////////////////////////////////////////////////////
+
+void lstmBlockCell(const NDArray* xt, const NDArray* cLast, const NDArray* yLast,
+                   const NDArray* W, const NDArray* Wci, const NDArray* Wcf, const NDArray* Wco, const NDArray* b,
+                   NDArray* i, NDArray* c, NDArray* f, NDArray* o, NDArray* z, NDArray* h, NDArray* y, const std::vector<double>& params) {
+
+    /* Input arrays:
+    *    0: xt              - input [bS, nIn] at time t
+    *    1: cLast (cs_prev) - previous cell state  [bS, nOut], time t-1
+    *    2: yLast (h_prev)  - previous output [bS, nOut], time t-1
+    *    3: W               - Weights - concatenated (input-to-hidden, hidden-to-hidden weights)  weights, [(nIn+nOut), 4*nOut]
+    *    4: Wci             - weights - cell peephole (t-1) connections to input modulation gate, [nOut]
+    *    5: Wcf             - weights - cell peephole (t-1) connections to forget gate, [nOut]
+    *    6: Wco             - weights - cell peephole (t) connections to output gate, [nOut]
+    *    7: b               - biases, [4*nOut]
+    *
+    *  Input integer arguments:
+    *    0: if not zero, provide peephole connections
+    *
+    *  Input float arguments:
+    *    0: the bias added to forget gates in order to reduce the scale of forgetting in the beginning of the training
+    *    1: clipping value for cell state, if it is not equal to zero, then cell state is clipped
+    *
+    * Output arrays:
+    *    0: i      - Input modulation gate activations [bS, nOut]
+    *    1: c (cs) - Cell state (pre tanh) [bs, nOut] (cs)
+    *    2: f      - Output - forget gate activations [bs, nOut]
+    *    3: o      - Output - output gate activations [bs, nOut]
+    *    4: z (ci) - Output - block input [bs, nOut]
+    *    5: h (co) - Cell state, post tanh [bs, nOut]
+    *    6: y (h)  - Current cell output [bS, nOut], time t
+    */
+
+    //Concat inputs: [xt, yt-1]: concat([bs,nIn],[bs,nOut]) -> [bs, (nIn+nOut)]
+    NDArray concatOut(xt->ordering(), {xt->sizeAt(0), xt->sizeAt(1) + yLast->sizeAt(1)}, xt->dataType(), xt->getContext());
+    helpers::concat(xt->getContext(), {const_cast<NDArray*>(xt), const_cast<NDArray*>(yLast)}, concatOut, {1});
+
+    auto m = mmul(concatOut, *W);       // mmul: [bs, (nIn+nOut)] * [(nIn+nOut), 4*nOut] = [bs, 4*nOut]
+    m += (*b);                          // addiRowVector
+
+    lstmBlockGates(m, cLast, Wci, Wcf, Wco, i, c, f, o, z, h, y, params);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void lstmBlockCellProjected(NDArray* xW, const NDArray* cLast, const NDArray* yLast,
+                            const NDArray* Wh, const NDArray* Wci, const NDArray* Wcf, const NDArray* Wco,
+                            NDArray* i, NDArray* c, NDArray* f, NDArray* o, NDArray* z, NDArray* h, NDArray* y, const std::vector<double>& params) {
+
+    // xW - input projection xt × Wx + b, [bS, 4*nOut], recurrent part is accumulated into it
+    // Wh - hidden-to-hidden part of concatenated weights, [nOut, 4*nOut]
+
+    MmulHelper::mmul(yLast, Wh, xW, 1.0, 1.0);      // [bs, nOut] * [nOut, 4*nOut] = [bs, 4*nOut]
+
+    lstmBlockGates(*xW, cLast, Wci, Wcf, Wco, i, c, f, o, z, h, y, params);
+}
+
 
 
 
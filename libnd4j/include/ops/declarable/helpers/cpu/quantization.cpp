@@ -0,0 +1,657 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// @author raver119@gmail.com
+//
+// Integer GEMM and convolutions. Zero points are subtracted while operands are packed, so both operands become int16
+// within [-255, 255], and padding of convolutions is plain zero. Pairs of int16 products are summed into int32 by pmaddwd,
+// which can't saturate for such values (unlike pmaddubsw, which saturates uint8 x int8 pairs into int16). Sums over K
+// are kept in int32 as well, so callers must keep K within QUANTIZED_MAX_DEPTH
+//
+
+#include <ops/declarable/helpers/quantization.h>
+#include <ops/declarable/helpers/convolutions.h>
+#include <helpers/IsaDispatch.h>
+#include <execution/Threads.h>
+#include "convolutions_tiled.hpp"
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#if defined(SD_ISA_DISPATCH)
+#define SD_QGEMM_AVX2 SD_TARGET_AVX2
+#define SD_QGEMM_AVX512 SD_TARGET_AVX512
+#elif defined(__AVX512BW__)
+#define SD_QGEMM_AVX512
+#elif defined(__AVX2__)
+#define SD_QGEMM_AVX2
+#endif
+
+#if defined(SD_QGEMM_AVX2) || defined(SD_QGEMM_AVX512)
+#include <immintrin.h>
+#endif
+
+#define REQUANTIZED_TYPES \
+        (sd::DataType::FLOAT32, float), \
+        QUANTIZED_TYPES
+
+namespace sd {
+    namespace ops {
+        namespace helpers {
+
+            // packed weights are padded to multiple of QGEMM_NR columns, micro-kernels process QGEMM_MR rows at once
+            static const int QGEMM_NR = 32;
+            static const int QGEMM_MR = 4;
+
+            /**
+             * Weights packed by pairs of rows: [K2, NP, 2] int16 matrix, element (k, n) is at (k / 2, n, k % 2)
+             */
+            struct PackedWeights {
+                int K, N, K2, NP;
+                std::shared_ptr<const std::vector<int16_t>> data;
+
+                PackedWeights(const int K, const int N) : K(K), N(N) {
+                    K2 = (K + 1) / 2;
+                    NP = (N + QGEMM_NR - 1) / QGEMM_NR * QGEMM_NR;
+                }
+
+                FORCEINLINE Nd4jLong length() const {
+                    return (Nd4jLong) K2 * NP * 2;
+                }
+            };
+
+            /**
+             * Requantization, fused into GEMM epilogue: real = acc * inScale * wScale[n] + bias[n], optionally quantized with output parameters
+             */
+            struct Requantization {
+                std::vector<float> multipliers;
+                std::vector<float> offsets;
+
+                Requantization(const QuantizationParams &inParams, const QuantizationParams &wParams, const NDArray *bias, const QuantizationParams *outParams, const int N) {
+                    multipliers.resize(N);
+                    offsets.resize(N);
+
+                    const float outScale = outParams != nullptr ? outParams->scale(0) : 1.f;
+                    const float outZero = outParams != nullptr ? static_cast<float>(outParams->zeroPoint(0)) : 0.f;
+
+                    for (int n = 0; n < N; n++) {
+                        multipliers[n] = inParams.scale(0) * wParams.scale(n) / outScale;
+                        offsets[n] = (bias != nullptr ? bias->e<float>(n) : 0.f) / outScale + outZero;
+                    }
+                }
+            };
+
+            static FORCEINLINE int32_t pairAt(const int16_t *a, const int k) {
+                int32_t v;
+                memcpy(&v, a + 2 * k, sizeof(int32_t));
+                return v;
+            }
+
+            //////////////////////////////////////////////////////////////////////////
+            bool QuantizedWeightsCache::Key::operator==(const Key &other) const {
+                return sameWeights(other) && generation == other.generation;
+            }
+
+            bool QuantizedWeightsCache::Key::sameWeights(const Key &other) const {
+                return bufferId == other.bufferId && offset == other.offset && layout == other.layout && wFormat == other.wFormat
+                       && shapeInfo == other.shapeInfo && zeroPoints == other.zeroPoints;
+            }
+
+            QuantizedWeightsCache& QuantizedWeightsCache::getInstance() {
+                static QuantizedWeightsCache instance;
+                return instance;
+            }
+
+            std::shared_ptr<const std::vector<int16_t>> QuantizedWeightsCache::get(const Key &key) {
+                std::lock_guard<std::mutex> lock(_mutex);
+
+                for (auto &e: _entries)
+                    if (e.key == key) {
+                        _hits++;
+                        return e.weights;
+                    }
+
+                _misses++;
+                return nullptr;
+            }
+
+            void QuantizedWeightsCache::put(const Key &key, const std::shared_ptr<const std::vector<int16_t>> &weights) {
+                std::lock_guard<std::mutex> lock(_mutex);
+
+                // entry for the same weights is outdated now
+                for (auto it = _entries.begin(); it != _entries.end(); it++)
+                    if (it->key.sameWeights(key)) {
+                        _entries.erase(it);
+                        break;
+                    }
+
+                // the oldest entry goes away
+                if ((int) _entries.size() >= MAX_ENTRIES)
+                    _entries.erase(_entries.begin());
+
+                _entries.emplace_back(Entry{key, weights});
+            }
+
+            Nd4jLong QuantizedWeightsCache::hits() {
+                std::lock_guard<std::mutex> lock(_mutex);
+                return _hits;
+            }
+
+            Nd4jLong QuantizedWeightsCache::misses() {
+                std::lock_guard<std::mutex> lock(_mutex);
+                return _misses;
+            }
+
+            void QuantizedWeightsCache::clear() {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _entries.clear();
+                _hits = 0;
+                _misses = 0;
+            }
+
+            /**
+             * Returns packed weights from cache, or packs them with pack(data) into zero-filled buffer of given length and caches the result
+             */
+            template <typename Pack>
+            static std::shared_ptr<const std::vector<int16_t>> cachedWeights(const NDArray &weights, const int layout, const int wFormat, const QuantizationParams &params, const Nd4jLong length, const Pack &pack) {
+                auto buffer = weights.getDataBuffer();
+                QuantizedWeightsCache::Key key = {buffer->uniqueId(), buffer->generation(), weights.bufferOffset(), layout, wFormat,
+                                                  std::vector<Nd4jLong>(weights.shapeInfo(), weights.shapeInfo() + shape::shapeInfoLength(weights.shapeInfo())),
+                                                  params.zeroPoints};
+
+                auto cached = QuantizedWeightsCache::getInstance().get(key);
+                if (cached != nullptr)
+                    return cached;
+
+                auto result = std::make_shared<std::vector<int16_t>>(length, static_cast<int16_t>(0));
+                pack(result->data());
+
+                QuantizedWeightsCache::getInstance().put(key, result);
+                return result;
+            }
+
+            template <typename W>
+            static void packWeights_(const void *vw, const std::vector<Nd4jLong> &kOffsets, const Nd4jLong nStride, const QuantizationParams &params, const PackedWeights &packed, int16_t *data) {
+                auto w = reinterpret_cast<const W *>(vw);
+
+                for (int k = 0; k < packed.K; k++) {
+                    auto dst = data + (Nd4jLong) (k >> 1) * packed.NP * 2 + (k & 1);
+                    auto src = w + kOffsets[k];
+
+                    for (int n = 0; n < packed.N; n++)
+                        dst[2 * n] = static_cast<int16_t>(static_cast<int>(src[n * nStride]) - params.zeroPoint(n));
+                }
+            }
+
+            template <typename X>
+            static void packRows_(const void *va, const Nd4jLong m0, const int mc, const int K, const Nd4jLong sM, const Nd4jLong sK, const int zeroPoint, int16_t *rows, const int rowLength) {
+                auto a = reinterpret_cast<const X *>(va);
+
+                for (int r = 0; r < mc; r++) {
+                    auto src = a + (m0 + r) * sM;
+                    auto dst = rows + (Nd4jLong) r * rowLength;
+
+                    for (int k = 0; k < K; k++)
+                        dst[k] = static_cast<int16_t>(static_cast<int>(src[k * sK]) - zeroPoint);
+
+                    std::fill(dst + K, dst + rowLength, static_cast<int16_t>(0));
+                }
+            }
+
+            /**
+             * Depthwise weights are packed into [kH * kW, iC * mC], and shifted by zero point of corresponding output channel
+             */
+            template <typename W>
+            static void packDepthwiseWeights_(const void *vw, const ConvGeometry2D &g, const int mC, const QuantizationParams &params, int16_t *packed) {
+                auto w = reinterpret_cast<const W *>(vw);
+                const int oC = g.iC * mC;
+
+                for (int kh = 0; kh < g.kH; kh++)
+                    for (int kw = 0; kw < g.kW; kw++)
+                        for (int c = 0; c < g.iC; c++)
+                            for (int m = 0; m < mC; m++) {
+                                const int n = c * mC + m;
+                                auto src = w + kh * g.wSkh + kw * g.wSkw + c * g.wSic + m * g.wSoc;
+                                packed[(Nd4jLong) (kh * g.kW + kw) * oC + n] = static_cast<int16_t>(static_cast<int>(*src) - params.zeroPoint(n));
+                            }
+            }
+
+            /**
+             * Same as convPackPatches, but values are shifted by zero point, so padding becomes zero
+             */
+            template <typename X>
+            static void packPatches_(const void *vin, const ConvGeometry2D &g, const Nd4jLong m0, const int mc, const int zeroPoint, int16_t *rows, const int rowLength) {
+                auto in = reinterpret_cast<const X *>(vin);
+                const int K = g.patchLength();
+                const Nd4jLong oHW = (Nd4jLong) g.oH * g.oW;
+
+                for (int r = 0; r < mc; r++) {
+                    const Nd4jLong m = m0 + r;
+                    const int b = (int) (m / oHW);
+                    const int oh = (int) ((m % oHW) / g.oW);
+                    const int ow = (int) (m % g.oW);
+
+                    auto p = rows + (Nd4jLong) r * rowLength;
+                    auto img = in + b * g.iSb;
+
+                    for (int kh = 0; kh < g.kH; kh++) {
+                        const int ih = oh * g.sH - g.pH + kh * g.dH;
+
+                        for (int kw = 0; kw < g.kW; kw++) {
+                            const int iw = ow * g.sW - g.pW + kw * g.dW;
+                            auto dst = p + (kh * g.kW + kw) * g.iC;
+
+                            if (ih < 0 || ih >= g.iH || iw < 0 || iw >= g.iW) {
+                                std::fill(dst, dst + g.iC, static_cast<int16_t>(0));
+                                continue;
+                            }
+
+                            auto src = img + ih * g.iSh + iw * g.iSw;
+                            for (int c = 0; c < g.iC; c++)
+                                dst[c] = static_cast<int16_t>(static_cast<int>(src[c * g.iSc]) - zeroPoint);
+                        }
+                    }
+
+                    std::fill(p + K, p + rowLength, static_cast<int16_t>(0));
+                }
+            }
+
+            template <typename Z>
+            static void requantize_(const int32_t *tile, const int mc, const int NP, const int N, const Nd4jLong *rowOffsets, const Nd4jLong nStride, const Requantization &rq, void *vz) {
+                auto z = reinterpret_cast<Z *>(vz);
+                const float qMin = static_cast<float>(std::numeric_limits<Z>::lowest());
+                const float qMax = static_cast<float>(std::numeric_limits<Z>::max());
+
+                for (int r = 0; r < mc; r++) {
+                    auto acc = tile + (Nd4jLong) r * NP;
+                    auto dst = z + rowOffsets[r];
+
+                    for (int n = 0; n < N; n++) {
+                        float v = static_cast<float>(acc[n]) * rq.multipliers[n] + rq.offsets[n];
+
+                        if (!std::is_floating_point<Z>::value) {
+                            v = std::nearbyint(v);
+                            v = v < qMin ? qMin : v > qMax ? qMax : v;
+                        }
+
+                        dst[n * nStride] = static_cast<Z>(v);
+                    }
+                }
+            }
+
+            /**
+             * C[mc, NP] = A[mc, 2 * K2] x B[K2, NP, 2], int32 accumulators
+             */
+            static void gemmTileGeneric(const int16_t *A, const int mc, const int K2, const int16_t *B, const int NP, int32_t *C) {
+                for (int r = 0; r < mc; r++) {
+                    auto a = A + (Nd4jLong) r * K2 * 2;
+                    auto c = C + (Nd4jLong) r * NP;
+                    std::fill(c, c + NP, 0);
+
+                    for (int k = 0; k < K2; k++) {
+                        const int32_t a0 = a[2 * k];
+                        const int32_t a1 = a[2 * k + 1];
+                        if (a0 == 0 && a1 == 0)
+                            continue;
+
+                        auto b = B + (Nd4jLong) k * NP * 2;
+
+                        PRAGMA_OMP_SIMD
+                        for (int n = 0; n < NP; n++)
+                            c[n] += a0 * b[2 * n] + a1 * b[2 * n + 1];
+                    }
+                }
+            }
+
+#ifdef SD_QGEMM_AVX2
+            SD_QGEMM_AVX2 static void gemmTileAvx2(const int16_t *A, const int mc, const int K2, const int16_t *B, const int NP, int32_t *C) {
+                const Nd4jLong KP = (Nd4jLong) K2 * 2;
+
+                for (int n0 = 0; n0 < NP; n0 += 16) {
+                    int r = 0;
+                    for (; r + QGEMM_MR <= mc; r += QGEMM_MR) {
+                        auto a = A + r * KP;
+                        __m256i c00 = _mm256_setzero_si256(), c01 = _mm256_setzero_si256();
+                        __m256i c10 = _mm256_setzero_si256(), c11 = _mm256_setzero_si256();
+                        __m256i c20 = _mm256_setzero_si256(), c21 = _mm256_setzero_si256();
+                        __m256i c30 = _mm256_setzero_si256(), c31 = _mm256_setzero_si256();
+
+                        for (int k = 0; k < K2; k++) {
+                            auto b = B + ((Nd4jLong) k * NP + n0) * 2;
+                            const __m256i b0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b));
+                            const __m256i b1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + 16));
+
+                            __m256i v = _mm256_set1_epi32(pairAt(a, k));
+                            c00 = _mm256_add_epi32(c00, _mm256_madd_epi16(v, b0));
+                            c01 = _mm256_add_epi32(c01, _mm256_madd_epi16(v, b1));
+
+                            v = _mm256_set1_epi32(pairAt(a + KP, k));
+                            c10 = _mm256_add_epi32(c10, _mm256_madd_epi16(v, b0));
+                            c11 = _mm256_add_epi32(c11, _mm256_madd_epi16(v, b1));
+
+                            v = _mm256_set1_epi32(pairAt(a + 2 * KP, k));
+                            c20 = _mm256_add_epi32(c20, _mm256_madd_epi16(v, b0));
+                            c21 = _mm256_add_epi32(c21, _mm256_madd_epi16(v, b1));
+
+                            v = _mm256_set1_epi32(pairAt(a + 3 * KP, k));
+                            c30 = _mm256_add_epi32(c30, _mm256_madd_epi16(v, b0));
+                            c31 = _mm256_add_epi32(c31, _mm256_madd_epi16(v, b1));
+                        }
+
+                        auto c = C + (Nd4jLong) r * NP + n0;
+                        _mm256_storeu_si256(reinterpret_cast<__m256i *>(c), c00);
+                        _mm256_storeu_si256(reinterpret_cast<__m256i *>(c + 8), c01);
+                        _mm256_storeu_si256(reinterpret_cast<__m256i *>(c + NP), c10);
+                        _mm256_storeu_si256(reinterpret_cast<__m256i *>(c + NP + 8), c11);
+                        _mm256_storeu_si256(reinterpret_cast<__m256i *>(c + 2 * NP), c20);
+                        _mm256_storeu_si256(reinterpret_cast<__m256i *>(c + 2 * NP + 8), c21);
+                        _mm256_storeu_si256(reinterpret_cast<__m256i *>(c + 3 * NP), c30);
+                        _mm256_storeu_si256(reinterpret_cast<__m256i *>(c + 3 * NP + 8), c31);
+                    }
+
+                    for (; r < mc; r++) {
+                        auto a = A + r * KP;
+                        __m256i c0 = _mm256_setzero_si256(), c1 = _mm256_setzero_si256();
+
+                        for (int k = 0; k < K2; k++) {
+                            auto b = B + ((Nd4jLong) k * NP + n0) * 2;
+                            const __m256i v = _mm256_set1_epi32(pairAt(a, k));
+                            c0 = _mm256_add_epi32(c0, _mm256_madd_epi16(v, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b))));
+                            c1 = _mm256_add_epi32(c1, _mm256_madd_epi16(v, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + 16))));
+                        }
+
+                        auto c = C + (Nd4jLong) r * NP + n0;
+                        _mm256_storeu_si256(reinterpret_cast<__m256i *>(c), c0);
+                        _mm256_storeu_si256(reinterpret_cast<__m256i *>(c + 8), c1);
+                    }
+                }
+            }
+#endif
+
+#ifdef SD_QGEMM_AVX512
+            SD_QGEMM_AVX512 static void gemmTileAvx512(const int16_t *A, const int mc, const int K2, const int16_t *B, const int NP, int32_t *C) {
+                const Nd4jLong KP = (Nd4jLong) K2 * 2;
+
+                for (int n0 = 0; n0 < NP; n0 += 32) {
+                    int r = 0;
+                    for (; r + QGEMM_MR <= mc; r += QGEMM_MR) {
+                        auto a = A + r * KP;
+                        __m512i c00 = _mm512_setzero_si512(), c01 = _mm512_setzero_si512();
+                        __m512i c10 = _mm512_setzero_si512(), c11 = _mm512_setzero_si512();
+                        __m512i c20 = _mm512_setzero_si512(), c21 = _mm512_setzero_si512();
+                        __m512i c30 = _mm512_setzero_si512(), c31 = _mm512_setzero_si512();
+
+                        for (int k = 0; k < K2; k++) {
+                            auto b = B + ((Nd4jLong) k * NP + n0) * 2;
+                            const __m512i b0 = _mm512_loadu_si512(b);
+                            const __m512i b1 = _mm512_loadu_si512(b + 32);
+
+                            __m512i v = _mm512_set1_epi32(pairAt(a, k));
+                            c00 = _mm512_add_epi32(c00, _mm512_madd_epi16(v, b0));
+                            c01 = _mm512_add_epi32(c01, _mm512_madd_epi16(v, b1));
+
+                            v = _mm512_set1_epi32(pairAt(a + KP, k));
+                            c10 = _mm512_add_epi32(c10, _mm512_madd_epi16(v, b0));
+                            c11 = _mm512_add_epi32(c11, _mm512_madd_epi16(v, b1));
+
+                            v = _mm512_set1_epi32(pairAt(a + 2 * KP, k));
+                            c20 = _mm512_add_epi32(c20, _mm512_madd_epi16(v, b0));
+                            c21 = _mm512_add_epi32(c21, _mm512_madd_epi16(v, b1));
+
+                            v = _mm512_set1_epi32(pairAt(a + 3 * KP, k));
+                            c30 = _mm512_add_epi32(c30, _mm512_madd_epi16(v, b0));
+                            c31 = _mm512_add_epi32(c31, _mm512_madd_epi16(v, b1));
+                        }
+
+                        auto c = C + (Nd4jLong) r * NP + n0;
+                        _mm512_storeu_si512(c, c00);
+                        _mm512_storeu_si512(c + 16, c01);
+                        _mm512_storeu_si512(c + NP, c10);
+                        _mm512_storeu_si512(c + NP + 16, c11);
+                        _mm512_storeu_si512(c + 2 * NP, c20);
+                        _mm512_storeu_si512(c + 2 * NP + 16, c21);
+                        _mm512_storeu_si512(c + 3 * NP, c30);
+                        _mm512_storeu_si512(c + 3 * NP + 16, c31);
+                    }
+
+                    for (; r < mc; r++) {
+                        auto a = A + r * KP;
+                        __m512i c0 = _mm512_setzero_si512(), c1 = _mm512_setzero_si512();
+
+                        for (int k = 0; k < K2; k++) {
+                            auto b = B + ((Nd4jLong) k * NP + n0) * 2;
+                            const __m512i v = _mm512_set1_epi32(pairAt(a, k));
+                            c0 = _mm512_add_epi32(c0, _mm512_madd_epi16(v, _mm512_loadu_si512(b)));
+                            c1 = _mm512_add_epi32(c1, _mm512_madd_epi16(v, _mm512_loadu_si512(b + 32)));
+                        }
+
+                        auto c = C + (Nd4jLong) r * NP + n0;
+                        _mm512_storeu_si512(c, c0);
+                        _mm512_storeu_si512(c + 16, c1);
+                    }
+                }
+            }
+#endif
+
+            typedef void (*GemmTileKernel)(const int16_t *, const int, const int, const int16_t *, const int, int32_t *);
+
+            static GemmTileKernel gemmTileKernel() {
+#if defined(SD_ISA_DISPATCH)
+                const int level = sd::Environment::getInstance().isaLevel();
+                if (level >= ISA_AVX512)
+                    return gemmTileAvx512;
+
+                if (level >= ISA_AVX2)
+                    return gemmTileAvx2;
+
+                return gemmTileGeneric;
+#elif defined(SD_QGEMM_AVX512)
+                return gemmTileAvx512;
+#elif defined(SD_QGEMM_AVX2)
+                return gemmTileAvx2;
+#else
+                return gemmTileGeneric;
+#endif
+            }
+
+            namespace kernels {
+
+                // tile[r, c * mC + m] = sum over taps of patches[r, tap, c] * weights[tap, c * mC + m]
+                struct QuantizedDepthwiseKernel {
+                    static FORCEINLINE void run(const int16_t *patches, const int mc, const int taps, const int iC, const int mC, const int16_t *weights, int32_t *tile) {
+                        const int oC = iC * mC;
+
+                        for (int r = 0; r < mc; r++) {
+                            auto p = patches + (Nd4jLong) r * taps * iC;
+                            auto acc = tile + (Nd4jLong) r * oC;
+                            std::fill(acc, acc + oC, 0);
+
+                            for (int t = 0; t < taps; t++) {
+                                auto x = p + (Nd4jLong) t * iC;
+                                auto w = weights + (Nd4jLong) t * oC;
+
+                                if (mC == 1) {
+                                    PRAGMA_OMP_SIMD
+                                    for (int c = 0; c < iC; c++)
+                                        acc[c] += static_cast<int32_t>(x[c]) * w[c];
+                                } else {
+                                    for (int c = 0; c < iC; c++) {
+                                        const int32_t v = x[c];
+
+                                        PRAGMA_OMP_SIMD
+                                        for (int m = 0; m < mC; m++)
+                                            acc[c * mC + m] += v * w[c * mC + m];
+                                    }
+                                }
+                            }
+                        }
+                    }
+                };
+            }
+
+            /**
+             * Rows of output are processed in tiles: pack(m0, mc, rows) fills int16 rows, compute(rows, mc, tile) produces int32 accumulators,
+             * and accumulators are requantized right into output, row r goes to rowOffset(m0 + r)
+             */
+            template <typename Pack, typename Compute, typename RowOffset>
+            static void processTiles(const Nd4jLong M, const int rowLength, const int N, const int tileStride, const Requantization &rq, NDArray &output, const Nd4jLong nStride, const Pack &pack, const Compute &compute, const RowOffset &rowOffset) {
+                const int numThreads = sd::Environment::getInstance().maxMasterThreads();
+                const int tileRows = convTileRows<int16_t>(M, rowLength, numThreads);
+                const Nd4jLong numTiles = (M + tileRows - 1) / tileRows;
+
+                auto func = PRAGMA_THREADS_FOR {
+                    std::vector<int16_t> rows((Nd4jLong) tileRows * rowLength);
+                    std::vector<int32_t> tile((Nd4jLong) tileRows * tileStride);
+                    std::vector<Nd4jLong> offsets(tileRows);
+
+                    for (auto t = start; t < stop; t++) {
+                        const Nd4jLong m0 = t * tileRows;
+                        const int mc = (int) std::min<Nd4jLong>(tileRows, M - m0);
+
+                        pack(m0, mc, rows.data());
+                        compute(rows.data(), mc, tile.data());
+
+                        for (int r = 0; r < mc; r++)
+                            offsets[r] = rowOffset(m0 + r);
+
+                        BUILD_SINGLE_SELECTOR(output.dataType(), requantize_, (tile.data(), mc, tileStride, N, offsets.data(), nStride, rq, output.buffer()), REQUANTIZED_TYPES);
+                    }
+                };
+
+                samediff::Threads::parallel_tad(func, 0, numTiles, 1, numThreads);
+            }
+
+            void quantizedMatmul(const NDArray &a, const QuantizationParams &aParams, const NDArray &b, const QuantizationParams &bParams, const NDArray *bias, const QuantizationParams *outParams, NDArray &output) {
+                const Nd4jLong M = a.sizeAt(0);
+                const int K = a.sizeAt(1);
+                const int N = b.sizeAt(1);
+
+                std::vector<Nd4jLong> kOffsets(K);
+                for (int k = 0; k < K; k++)
+                    kOffsets[k] = k * b.strideAt(0);
+
+                PackedWeights packed(K, N);
+                packed.data = cachedWeights(b, QuantizedWeightsCache::MATMUL, 0, bParams, packed.length(), [&](int16_t *data) {
+                    BUILD_SINGLE_SELECTOR(b.dataType(), packWeights_, (b.buffer(), kOffsets, b.strideAt(1), bParams, packed, data), QUANTIZED_TYPES);
+                });
+
+                const Requantization rq(aParams, bParams, bias, outParams, N);
+                const auto kernel = gemmTileKernel();
+                const auto aType = a.dataType();
+                const auto aBuffer = a.buffer();
+                const auto sM = a.strideAt(0);
+                const auto sK = a.strideAt(1);
+                const auto zS0 = output.strideAt(0);
+                const int rowLength = packed.K2 * 2;
+
+                auto pack = [&](const Nd4jLong m0, const int mc, int16_t *rows) {
+                    BUILD_SINGLE_SELECTOR(aType, packRows_, (aBuffer, m0, mc, K, sM, sK, aParams.zeroPoint(0), rows, rowLength), QUANTIZED_TYPES);
+                };
+
+                auto compute = [&](const int16_t *rows, const int mc, int32_t *tile) {
+                    kernel(rows, mc, packed.K2, packed.data->data(), packed.NP, tile);
+                };
+
+                auto rowOffset = [&](const Nd4jLong m) -> Nd4jLong {
+                    return m * zS0;
+                };
+
+                processTiles(M, rowLength, N, packed.NP, rq, output, output.strideAt(1), pack, compute, rowOffset);
+            }
+
+            void quantizedConv2d(const NDArray &input, const QuantizationParams &inParams, const NDArray &weights, const QuantizationParams &wParams, const NDArray *bias, const QuantizationParams *outParams, NDArray &output, const int kH, const int kW, const int sH, const int sW, int pH, int pW, const int dH, const int dW, const int paddingMode, const int isNCHW, const int wFormat) {
+                int bS, iC, iH, iW, oC, oH, oW;
+                int indIOioC, indIiH, indWoC, indWiC, indWkH, indOoH;
+                ConvolutionUtils::getSizesAndIndexesConv2d(isNCHW, wFormat, input, output, bS, iC, iH, iW, oC, oH, oW, indIOioC, indIiH, indWiC, indWoC, indWkH, indOoH);
+                ConvolutionUtils::calcPadding2D(pH, pW, oH, oW, iH, iW, kH, kW, sH, sW, dH, dW, paddingMode);
+
+                const ConvGeometry2D g(input, weights, output, kH, kW, sH, sW, pH, pW, dH, dW, isNCHW, wFormat);
+                const int K = g.patchLength();
+                const Nd4jLong M = (Nd4jLong) bS * oH * oW;
+
+                // patches are ordered as [kH, kW, iC]
+                std::vector<Nd4jLong> kOffsets(K);
+                for (int kh = 0; kh < kH; kh++)
+                    for (int kw = 0; kw < kW; kw++)
+                        for (int c = 0; c < iC; c++)
+                            kOffsets[(kh * kW + kw) * iC + c] = kh * g.wSkh + kw * g.wSkw + c * g.wSic;
+
+                PackedWeights packed(K, oC);
+                packed.data = cachedWeights(weights, QuantizedWeightsCache::CONV2D, wFormat, wParams, packed.length(), [&](int16_t *data) {
+                    BUILD_SINGLE_SELECTOR(weights.dataType(), packWeights_, (weights.buffer(), kOffsets, g.wSoc, wParams, packed, data), QUANTIZED_TYPES);
+                });
+
+                const Requantization rq(inParams, wParams, bias, outParams, oC);
+                const auto kernel = gemmTileKernel();
+                const auto inType = input.dataType();
+                const auto inBuffer = input.buffer();
+                const int rowLength = packed.K2 * 2;
+
+                auto pack = [&](const Nd4jLong m0, const int mc, int16_t *rows) {
+                    BUILD_SINGLE_SELECTOR(inType, packPatches_, (inBuffer, g, m0, mc, inParams.zeroPoint(0), rows, rowLength), QUANTIZED_TYPES);
+                };
+
+                auto compute = [&](const int16_t *rows, const int mc, int32_t *tile) {
+                    kernel(rows, mc, packed.K2, packed.data->data(), packed.NP, tile);
+                };
+
+                auto rowOffset = [&](const Nd4jLong m) -> Nd4jLong {
+                    return (m / ((Nd4jLong) oH * oW)) * g.oSb + ((m / oW) % oH) * g.oSh + (m % oW) * g.oSw;
+                };
+
+                processTiles(M, rowLength, oC, packed.NP, rq, output, g.oSc, pack, compute, rowOffset);
+            }
+
+            void quantizedDepthwiseConv2d(const NDArray &input, const QuantizationParams &inParams, const NDArray &weights, const QuantizationParams &wParams, const NDArray *bias, const QuantizationParams *outParams, NDArray &output, const int kH, const int kW, const int sH, const int sW, int pH, int pW, const int dH, const int dW, const int paddingMode, const int isNCHW, const int wFormat) {
+                int bS, iC, iH, iW, oC, oH, oW;
+                int indIOioC, indIiH, indWmC, indWiC, indWkH, indOoH;
+                ConvolutionUtils::getSizesAndIndexesConv2d(isNCHW, wFormat, input, output, bS, iC, iH, iW, oC, oH, oW, indIOioC, indIiH, indWiC, indWmC, indWkH, indOoH);
+                ConvolutionUtils::calcPadding2D(pH, pW, oH, oW, iH, iW, kH, kW, sH, sW, dH, dW, paddingMode);
+
+                // weights formats of depthwise convolution match conv2d ones with oC replaced by mC, so wSoc is stride of mC here
+                const ConvGeometry2D g(input, weights, output, kH, kW, sH, sW, pH, pW, dH, dW, isNCHW, wFormat);
+                const int mC = weights.sizeAt(indWmC);
+                const int taps = kH * kW;
+                const int K = g.patchLength();
+                const Nd4jLong M = (Nd4jLong) bS * oH * oW;
+
+                auto packedW = cachedWeights(weights, QuantizedWeightsCache::DEPTHWISE_CONV2D, wFormat, wParams, (Nd4jLong) taps * oC, [&](int16_t *data) {
+                    BUILD_SINGLE_SELECTOR(weights.dataType(), packDepthwiseWeights_, (weights.buffer(), g, mC, wParams, data), QUANTIZED_TYPES);
+                });
+
+                const Requantization rq(inParams, wParams, bias, outParams, oC);
+                const auto inType = input.dataType();
+                const auto inBuffer = input.buffer();
+
+                auto pack = [&](const Nd4jLong m0, const int mc, int16_t *rows) {
+                    BUILD_SINGLE_SELECTOR(inType, packPatches_, (inBuffer, g, m0, mc, inParams.zeroPoint(0), rows, K), QUANTIZED_TYPES);
+                };
+
+                auto compute = [&](const int16_t *rows, const int mc, int32_t *tile) {
+                    IsaDispatch<kernels::QuantizedDepthwiseKernel>::exec(rows, mc, taps, iC, mC, packedW->data(), tile);
+                };
+
+                auto rowOffset = [&](const Nd4jLong m) -> Nd4jLong {
+                    return (m / ((Nd4jLong) oH * oW)) * g.oSb + ((m / oW) % oH) * g.oSh + (m % oW) * g.oSw;
+                };
+
+                processTiles(M, K, oC, oC, rq, output, g.oSc, pack, compute, rowOffset);
+            }
+        }
+    }
+}
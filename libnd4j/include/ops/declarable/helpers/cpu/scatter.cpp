@@ -22,6 +22,7 @@
 #include <numeric>
 #include <helpers/ShapeUtils.h>
 #include <execution/Threads.h>
+#include <algorithm>
 
 namespace sd    {
 namespace ops     {
@@ -69,6 +70,67 @@ Nd4jLong checkIndices(sd::LaunchContext *context, const NDArray& indices, const
     BUILD_SINGLE_SELECTOR(indices.dataType(), return checkIndices_, (indices, output, axis), INDEXING_TYPES);
 }
 
+///////////////////////////////////////////////////////////////////
+// with fewer updates than this locked scatter stays serial: grouping wouldn't pay off
+static const Nd4jLong SCATTER_LOCK_PARALLEL_THRESHOLD = 64;
+
+///////////////////////////////////////////////////////////////////
+// applies updates [0, numOfUpdates), target(i) is position in output hit by i-th update
+// without lock updates go in parallel as is, it's up to caller to guarantee indices are unique
+// with lock updates are grouped by target, and each group is applied by single thread in original order of updates,
+// so repeated indices give exactly the same result as serial loop for any op, while distinct targets are processed in parallel
+template <typename Target, typename Apply>
+static void scatterApply(const Nd4jLong numOfUpdates, const bool lock, const Target &target, const Apply &apply) {
+
+    const int numThreads = sd::Environment::getInstance().maxThreads();
+
+    if (!lock) {
+        auto func = PRAGMA_THREADS_FOR {
+            for (auto i = start; i < stop; i++)
+                apply(i);
+        };
+
+        samediff::Threads::parallel_tad(func, 0, numOfUpdates, 1, numThreads);
+        return;
+    }
+
+    if (numOfUpdates < SCATTER_LOCK_PARALLEL_THRESHOLD || numThreads == 1) {
+        for (Nd4jLong i = 0; i < numOfUpdates; i++)
+            apply(i);
+        return;
+    }
+
+    std::vector<std::pair<Nd4jLong, Nd4jLong>> order(numOfUpdates);
+    for (Nd4jLong i = 0; i < numOfUpdates; i++)
+        order[i] = std::make_pair(target(i), i);
+
+    // pairs are unique, so plain sort keeps original order of updates within each target
+    std::sort(order.begin(), order.end());
+
+    std::vector<Nd4jLong> groups;
+    for (Nd4jLong i = 0; i < numOfUpdates; i++)
+        if (i == 0 || order[i].first != order[i - 1].first)
+            groups.push_back(i);
+    groups.push_back(numOfUpdates);
+
+    const Nd4jLong numOfGroups = groups.size() - 1;
+
+    // all updates hit the same target, nothing to parallelize
+    if (numOfGroups == 1) {
+        for (Nd4jLong i = 0; i < numOfUpdates; i++)
+            apply(i);
+        return;
+    }
+
+    auto func = PRAGMA_THREADS_FOR {
+        for (auto g = start; g < stop; g++)
+            for (Nd4jLong j = groups[g]; j < groups[g + 1]; j++)
+                apply(order[j].second);
+    };
+
+    samediff::Threads::parallel_tad(func, 0, numOfGroups, 1, numThreads);
+}
+
 ///////////////////////////////////////////////////////////////////
 void scatter(sd::LaunchContext  *context, pairwise::Ops op, const NDArray& indices, const NDArray& updates, NDArray& output, const bool lock) {
 
@@ -77,17 +139,17 @@ void scatter(sd::LaunchContext  *context, pairwise::Ops op, const NDArray& indic
     const int updRank = updates.rankOf();
     const Nd4jLong indLen = indices.lengthOf();
 
+    auto target = [&](Nd4jLong i) -> Nd4jLong { return indices.e<Nd4jLong>(i); };
+
     if(outRank == 1) {
-        auto func = PRAGMA_THREADS_FOR {
-            for (auto i = start; i < stop; i++) {
-                Nd4jLong idx = indices.e<Nd4jLong>(i);
-                NDArray out = output({idx, idx + 1});
+        auto apply = [&](Nd4jLong i) {
+            Nd4jLong idx = indices.e<Nd4jLong>(i);
+            NDArray out = output({idx, idx + 1});
 
-                out.applyPairwiseTransform(op, updates.e(i));
-            }
+            out.applyPairwiseTransform(op, updates.e(i));
         };
 
-        samediff::Threads::parallel_tad(func, 0, indLen, 1, lock ? 1 : sd::Environment::getInstance().maxThreads());
+        scatterApply(indLen, lock, target, apply);
     }
     else {      // outRank > 1
 
@@ -98,16 +160,14 @@ void scatter(sd::LaunchContext  *context, pairwise::Ops op, const NDArray& indic
         std::vector<int> dimsToExcludeUpd(sizeOfDims);
         std::iota(dimsToExcludeUpd.begin(), dimsToExcludeUpd.end(), 0);
 
-        auto func = PRAGMA_THREADS_FOR {
-            for (auto i = start; i < stop; i++) {
-                NDArray outSubArr = output(indices.e<Nd4jLong>(i), std::vector<int>({0}));
-                NDArray updSubArr = updates(i, dimsToExcludeUpd);
+        auto apply = [&](Nd4jLong i) {
+            NDArray outSubArr = output(indices.e<Nd4jLong>(i), std::vector<int>({0}));
+            NDArray updSubArr = updates(i, dimsToExcludeUpd);
 
-                outSubArr.applyPairwiseTransform(op, updSubArr);
-            }
+            outSubArr.applyPairwiseTransform(op, updSubArr);
         };
 
-        samediff::Threads::parallel_tad(func, 0, indLen, 1, lock ? 1 : sd::Environment::getInstance().maxThreads());
+        scatterApply(indLen, lock, target, apply);
     }
 }
 
@@ -120,41 +180,45 @@ void scatterND(sd::LaunchContext  *context, pairwise::Ops op, const NDArray& ind
     const Nd4jLong indLastDim = indices.sizeAt(-1);
 
     if(outRank == 1) {
-        auto func = PRAGMA_THREADS_FOR {
-            for (auto i = start; i < stop; i++) {
-                Nd4jLong idx = indices.e<Nd4jLong>(i);
-                NDArray out = output({idx, idx + 1});
+        auto target = [&](Nd4jLong i) -> Nd4jLong { return indices.e<Nd4jLong>(i); };
+        auto apply = [&](Nd4jLong i) {
+            Nd4jLong idx = indices.e<Nd4jLong>(i);
+            NDArray out = output({idx, idx + 1});
 
-                out.applyPairwiseTransform(op, updates.e(i), nullptr);
-            }
+            out.applyPairwiseTransform(op, updates.e(i), nullptr);
         };
 
-        samediff::Threads::parallel_tad(func, 0, indLen, 1, lock ? 1 : sd::Environment::getInstance().maxThreads());
+        scatterApply(indLen, lock, target, apply);
     }
     else {
         std::vector<int> dimsToExcludeInd = ShapeUtils::evalDimsToExclude(indRank, {indRank-1});
         std::vector<int> dimsToExcludeUpd(indRank - 1);
         std::iota(dimsToExcludeUpd.begin(), dimsToExcludeUpd.end(), 0);
 
-        auto func = PRAGMA_THREADS_FOR {
-            std::vector<Nd4jLong> idxRangeOut(2*outRank, 0);
+        // linear position of sub-array addressed by i-th tuple of indices
+        auto target = [&](Nd4jLong i) -> Nd4jLong {
+            Nd4jLong pos = 0;
+            for (Nd4jLong j = 0; j < indLastDim; ++j)
+                pos = pos * output.sizeAt(j) + indices.e<Nd4jLong>(i * indLastDim + j);
+            return pos;
+        };
 
-            for (auto i = start; i < stop; i++) {
-                NDArray indSubArr = indices(i, dimsToExcludeInd);
+        auto apply = [&](Nd4jLong i) {
+            std::vector<Nd4jLong> idxRangeOut(2*outRank, 0);
+            NDArray indSubArr = indices(i, dimsToExcludeInd);
 
-                for (Nd4jLong j = 0; j < indLastDim; ++j) {
-                    idxRangeOut[2 * j] = indSubArr.e<Nd4jLong>(j);
-                    idxRangeOut[2 * j + 1] = idxRangeOut[2 * j] + 1;
-                }
+            for (Nd4jLong j = 0; j < indLastDim; ++j) {
+                idxRangeOut[2 * j] = indSubArr.e<Nd4jLong>(j);
+                idxRangeOut[2 * j + 1] = idxRangeOut[2 * j] + 1;
+            }
 
-                NDArray outSubArr = output(idxRangeOut);
-                NDArray updSubArr = updates(i, dimsToExcludeUpd);
+            NDArray outSubArr = output(idxRangeOut);
+            NDArray updSubArr = updates(i, dimsToExcludeUpd);
 
-                outSubArr.applyPairwiseTransform(op, updSubArr);
-            }
+            outSubArr.applyPairwiseTransform(op, updSubArr);
         };
 
-        samediff::Threads::parallel_tad(func, 0, indLen / indLastDim, 1, lock ? 1 : sd::Environment::getInstance().maxThreads());
+        scatterApply(indLen / indLastDim, lock, target, apply);
     }
 }
 
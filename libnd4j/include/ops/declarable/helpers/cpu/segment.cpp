@@ -21,294 +21,440 @@
 
 #include <ops/declarable/helpers/segment.h>
 #include <helpers/ShapeUtils.h>
+#include <helpers/ConstantTadHelper.h>
 #include <execution/Threads.h>
-#include <unordered_map>
+#include <memory>
+#include <stdexcept>
+#include <vector>
 
 namespace sd {
 namespace ops {
 namespace helpers {
 
-    // segment max
-    template <typename T>
-    static void segmentMaxFunctor_(NDArray* input, NDArray* indices, NDArray* output) {
-        //int numClasses = output->sizeAt(0);
-        // if input is a vector: (as if in doc sample)
-        Nd4jLong idx = indices->e<Nd4jLong>(0);
-        if (input->isVector()) {
-            T val = input->e<T>(0);
-
-            for (Nd4jLong e = 1; e < indices->lengthOf(); e++) {
-                if (idx == indices->e<Nd4jLong>(e)) {
-                   // max
-                   val = sd::math::nd4j_max<T>(val, input->t<T>(e));
-                }
-                else {
-                    idx = indices->e<Nd4jLong>(e);
-                    val = input->t<T>(e);
-                }
-                output->r<T>(idx) = val;
+    // -------------------------------------------------------------------------------------------------------------- //
+    // Segment reduction engine, shared by sorted, unsorted and backprop ops
+    // -------------------------------------------------------------------------------------------------------------- //
+
+    enum SegmentReduction {
+        SEGMENT_MAX,
+        SEGMENT_MIN,
+        SEGMENT_SUM,
+        SEGMENT_MEAN,
+        SEGMENT_PROD,
+        SEGMENT_SQRT_N
+    };
+
+    /**
+     * Rows of input (sub-arrays along dimension 0) grouped by segments with counting sort over indices:
+     * segment s owns rows[offsets[s]] ... rows[offsets[s + 1] - 1], in ascending order.
+     * Every segment is owned by single task, so segments are reduced in parallel without any synchronization
+     */
+    struct SegmentPartition {
+        std::vector<Nd4jLong> classes;
+        std::vector<Nd4jLong> offsets;
+        std::vector<Nd4jLong> rows;
+
+        SegmentPartition(NDArray* indices, const Nd4jLong numOfClasses) {
+            const Nd4jLong numOfRows = indices->lengthOf();
+
+            classes.resize(numOfRows);
+            offsets.assign(numOfClasses + 1, 0);
+            rows.resize(numOfRows);
+
+            for (Nd4jLong e = 0; e < numOfRows; e++) {
+                classes[e] = indices->e<Nd4jLong>(e);
+                if (classes[e] < 0 || classes[e] >= numOfClasses)
+                    throw std::runtime_error("segment: index is out of range of segments");
+
+                offsets[classes[e] + 1]++;
             }
-        }
-        else {
-            std::vector<int> restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), {0});
-            auto listOfTensors = input->allTensorsAlongDimension(restDims);
-            auto listOfOutTensors = output->allTensorsAlongDimension(restDims);
 
-            auto numOfClasses = output->sizeAt(0); // number of classes
-            std::vector<std::pair<NDArray*, int>> outputs(numOfClasses);
-            auto maxT = listOfOutTensors.at(idx);
+            // prefix sum turns counts into segment boundaries
+            for (Nd4jLong s = 0; s < numOfClasses; s++)
+                offsets[s + 1] += offsets[s];
 
-            //int pos = 0;
-            maxT->assign(listOfTensors.at(0));
+            std::vector<Nd4jLong> position(offsets.begin(), offsets.end() - 1);
+            for (Nd4jLong e = 0; e < numOfRows; e++)
+                rows[position[classes[e]]++] = e;
+        }
 
-            for (Nd4jLong i = 1; i < indices->lengthOf(); i++) {
-                if (indices->e<int>(i) == idx) {
+        FORCEINLINE Nd4jLong numOfClasses() const {
+            return offsets.size() - 1;
+        }
 
-                    for (Nd4jLong e = 0; e < maxT->lengthOf(); e++) {
-                       maxT->r<T>(e) = sd::math::nd4j_max(maxT->t<T>(e), listOfTensors.at(i)->t<T>(e));
-                    }
-                }
-                else {
-                    idx = indices->e<Nd4jLong>(i);
-                    maxT = listOfOutTensors.at(idx);
-                    maxT->assign(listOfTensors.at(i));
-                }
+        FORCEINLINE Nd4jLong count(const Nd4jLong s) const {
+            return offsets[s + 1] - offsets[s];
+        }
+    };
+
+    /**
+     * Rows of array along dimension 0: offset of each row, and offset of element within row
+     */
+    struct SegmentRows {
+        TadPack pack;
+        const Nd4jLong *offsets = nullptr;
+        const Nd4jLong *tadShapeInfo = nullptr;
+        Nd4jLong rowStride = 0;
+        Nd4jLong ews = 1;
+        Nd4jLong length = 1;
 
+        explicit SegmentRows(const NDArray& array) {
+            if (array.rankOf() == 1) {
+                rowStride = array.strideAt(0);
+                return;
             }
+
+            pack = ConstantTadHelper::getInstance().tadForDimensions(array.shapeInfo(), ShapeUtils::evalDimsToExclude(array.rankOf(), {0}));
+            offsets = pack.primaryOffsets();
+            tadShapeInfo = pack.primaryShapeInfo();
+            ews = shape::elementWiseStride(tadShapeInfo);
+            length = shape::length(tadShapeInfo);
         }
-    }
 
-    // segmen min
-    template <typename T>
-    static void segmentMinFunctor_(NDArray* input, NDArray* indices, NDArray* output) {
-        //int numClasses = output->sizeAt(0);
-        // if input is a vector: (as if in doc sample)
-        Nd4jLong idx = indices->e<Nd4jLong>(0);
-        if (input->isVector()) {
-            T val = input->e<T>(0);
-
-            for (Nd4jLong e = 1; e < indices->lengthOf(); e++) {
-                if (idx == indices->e<Nd4jLong>(e)) {
-                   // min
-                   val = sd::math::nd4j_min<T>(val, input->t<T>(e));
-                }
-                else {
-                    idx = indices->e<Nd4jLong>(e);
-                    val = input->t<T>(e);
-                }
-                output->r<T>(idx) = val;
-            }
+        // dense row-major buffer of rows
+        explicit SegmentRows(const Nd4jLong rowLength) {
+            rowStride = rowLength;
+            length = rowLength;
         }
-        else {
-            auto restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), {0});
 
-            ResultSet listOfTensors = input->allTensorsAlongDimension(restDims);
-            ResultSet listOfOutTensors = output->allTensorsAlongDimension(restDims);
+        FORCEINLINE Nd4jLong row(const Nd4jLong r) const {
+            return offsets != nullptr ? offsets[r] : r * rowStride;
+        }
 
-            int numOfClasses = output->sizeAt(0); // number of classes
-            std::vector<std::pair<NDArray*, int>> outputs(numOfClasses);
-            auto minT = listOfOutTensors.at(idx);
+        FORCEINLINE Nd4jLong element(const Nd4jLong j) const {
+            return ews > 0 ? j * ews : shape::getIndexOffset(j, tadShapeInfo);
+        }
+    };
 
-            int pos = 0;
-            minT->assign(listOfTensors.at(0));
+    template <typename T>
+    struct SegmentMaxOp {
+        static FORCEINLINE T combine(const T a, const T b) { return sd::math::nd4j_max<T>(a, b); }
+        static FORCEINLINE T finalize(const T v, const Nd4jLong count) { return v; }
+    };
 
-            for (Nd4jLong i = 1; i < indices->lengthOf(); i++) {
-                if (indices->e<Nd4jLong>(i) == idx) {
+    template <typename T>
+    struct SegmentMinOp {
+        static FORCEINLINE T combine(const T a, const T b) { return sd::math::nd4j_min<T>(a, b); }
+        static FORCEINLINE T finalize(const T v, const Nd4jLong count) { return v; }
+    };
 
-                    for (Nd4jLong e = 0; e < minT->lengthOf(); e++) {
-                       minT->p(e, sd::math::nd4j_min(minT->e<T>(e), listOfTensors.at(i)->e<T>(e)));
-                    }
-                }
-                else {
-                    idx = indices->e<Nd4jLong>(i);
-                    minT = listOfOutTensors.at(idx);
-                    minT->assign(listOfTensors.at(i));
-                }
-            }
-        }
-    }
+    template <typename T>
+    struct SegmentSumOp {
+        static FORCEINLINE T combine(const T a, const T b) { return static_cast<T>(a + b); }
+        static FORCEINLINE T finalize(const T v, const Nd4jLong count) { return v; }
+    };
 
-    // segmen mean
     template <typename T>
-    static void segmentMeanFunctor_(NDArray* input, NDArray* indices, NDArray* output) {
-        int numClasses = output->sizeAt(0);
-        // if input is a vector: (as if in doc sample)
-        int idx = indices->e<int>(0);
-        if (input->isVector()) {
-            T val = T(0.f);
-            int count = 0;
-
-            for (Nd4jLong e = 0; e < indices->lengthOf(); e++) {
-                if (idx == indices->e<int>(e)) {
-                   // mean
-                   val += input->e<T>(e);
-                   count++;
-                }
-                else {
-                   output->p<T>(idx, val / count);
-                    idx = indices->e<int>(e);
-                    val = input->e<T>(e);
-                    count = 1;
-                }
-                output->p<T>(idx, val / count);
+    struct SegmentMeanOp {
+        static FORCEINLINE T combine(const T a, const T b) { return static_cast<T>(a + b); }
+        static FORCEINLINE T finalize(const T v, const Nd4jLong count) { return static_cast<T>(v / static_cast<T>(count)); }
+    };
+
+    template <typename T>
+    struct SegmentProdOp {
+        static FORCEINLINE T combine(const T a, const T b) { return static_cast<T>(a * b); }
+        static FORCEINLINE T finalize(const T v, const Nd4jLong count) { return v; }
+    };
+
+    template <typename T>
+    struct SegmentSqrtNOp {
+        static FORCEINLINE T combine(const T a, const T b) { return static_cast<T>(a + b); }
+        static FORCEINLINE T finalize(const T v, const Nd4jLong count) { return static_cast<T>(static_cast<double>(v) / sd::math::nd4j_sqrt<Nd4jLong, double>(count)); }
+    };
+
+    // z row zRow, columns [j0, j1) = reduction of x rows listed in rows[0 ... numOfRows - 1]
+    template <typename T, typename Op>
+    static void segmentReduceRows(const T *x, const SegmentRows &in, const Nd4jLong *rows, const Nd4jLong numOfRows, T *z, const SegmentRows &out, const Nd4jLong zRow, const Nd4jLong j0, const Nd4jLong j1) {
+        auto zr = z + out.row(zRow);
+        auto first = x + in.row(rows[0]);
+
+        if (in.ews == 1 && out.ews == 1) {
+            for (Nd4jLong j = j0; j < j1; j++)
+                zr[j] = first[j];
+
+            for (Nd4jLong r = 1; r < numOfRows; r++) {
+                auto xr = x + in.row(rows[r]);
+
+                PRAGMA_OMP_SIMD
+                for (Nd4jLong j = j0; j < j1; j++)
+                    zr[j] = Op::combine(zr[j], xr[j]);
             }
         }
         else {
-            auto restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), {0});
-
-            auto listOfTensors = input->allTensorsAlongDimension(restDims);
-            auto listOfOutTensors = output->allTensorsAlongDimension(restDims);
-
-            int numOfClasses = output->sizeAt(0); // number of classes
-            std::vector<std::pair<NDArray*, int>> outputs(numOfClasses);
-            auto meanT = listOfOutTensors.at(idx);
-            int count = 1;
-            auto meanV = meanT->dup();
-            meanV.assign(listOfTensors.at(0));
-
-            for (Nd4jLong i = 1; i < indices->lengthOf(); i++) {
-                if (indices->e<int>(i) == idx) {
-                    auto func = PRAGMA_THREADS_FOR {
-                        for (auto e = start; e < stop; e++) {
-                            meanV.p<T>(e, meanV.e<T>(e) + listOfTensors.at(i)->e<T>(e));
-                        }
-                    };
-                    samediff::Threads::parallel_for(func, 0, meanT->lengthOf());
-
-                    count++;
-                }
-                else {
-                    //meanT->assign(meanV);
-                    meanV.applyScalar(scalar::Divide, count, *meanT);
-                    idx = indices->e<int>(i);
-                    meanT = listOfOutTensors.at(idx);
-                    meanV.assign(listOfTensors.at(i));
-                    count = 1;
-                }
-                meanV.applyScalar(scalar::Divide, count, *meanT);
+            for (Nd4jLong j = j0; j < j1; j++)
+                zr[out.element(j)] = first[in.element(j)];
+
+            for (Nd4jLong r = 1; r < numOfRows; r++) {
+                auto xr = x + in.row(rows[r]);
+
+                for (Nd4jLong j = j0; j < j1; j++)
+                    zr[out.element(j)] = Op::combine(zr[out.element(j)], xr[in.element(j)]);
             }
         }
     }
 
-    template <typename T>
-    static void segmentSumFunctor_(NDArray* input, NDArray* indices, NDArray* output) {
-        int numClasses = output->sizeAt(0);
-        // if input is a vector: (as if in doc sample)
-        int idx = indices->e<int>(0);
-        if (input->isVector()) {
-            T val = T(0.f);
-            int count = 0;
-            for (Nd4jLong e = 0; e < indices->lengthOf(); e++) {
-                if (idx == indices->e<int>(e)) {
-                   // sum
-                   val += input->t<T>(e);
+    template <typename T, typename Op>
+    static void segmentReduceKernel_(NDArray& input, const SegmentPartition& partition, NDArray& output) {
+        const SegmentRows in(input);
+        const SegmentRows out(output);
+
+        auto x = input.bufferAsT<T>();
+        auto z = output.bufferAsT<T>();
+
+        const Nd4jLong numOfClasses = partition.numOfClasses();
+        const Nd4jLong numOfRows = partition.rows.size();
+        const Nd4jLong rowLength = in.length;
+        const int numThreads = sd::Environment::getInstance().maxMasterThreads();
+
+        // few short segments with lots of rows: rows of every segment are split into chunks, each chunk is reduced
+        // into its own partial result, and partial results are combined afterwards
+        if (numThreads > 1 && numOfClasses * rowLength < numThreads * 64 && numOfRows >= numThreads * 64) {
+            const Nd4jLong numOfChunks = numThreads;
+            const SegmentRows dense(rowLength);
+            std::unique_ptr<T[]> partial(new T[numOfClasses * numOfChunks * rowLength]);
+
+            auto chunkStart = [&](Nd4jLong s, Nd4jLong c) -> Nd4jLong {
+                return partition.offsets[s] + partition.count(s) * c / numOfChunks;
+            };
+
+            auto reduceChunks = PRAGMA_THREADS_FOR {
+                for (auto t = start; t < stop; t++) {
+                    const Nd4jLong s = t / numOfChunks;
+                    const Nd4jLong c = t % numOfChunks;
+                    const Nd4jLong from = chunkStart(s, c);
+                    const Nd4jLong to = chunkStart(s, c + 1);
+
+                    if (from < to)
+                        segmentReduceRows<T, Op>(x, in, partition.rows.data() + from, to - from, partial.get(), dense, t, 0, rowLength);
                 }
-                else {
-                    idx = indices->e<int>(e);
-                    val = input->t<T>(e);
+            };
+
+            samediff::Threads::parallel_tad(reduceChunks, 0, numOfClasses * numOfChunks);
+
+            auto combineChunks = PRAGMA_THREADS_FOR {
+                for (auto s = start; s < stop; s++) {
+                    const Nd4jLong count = partition.count(s);
+                    if (count == 0)
+                        continue;
+
+                    auto zr = z + out.row(s);
+                    bool first = true;
+
+                    for (Nd4jLong c = 0; c < numOfChunks; c++) {
+                        if (chunkStart(s, c) == chunkStart(s, c + 1))
+                            continue;
+
+                        auto pr = partial.get() + (s * numOfChunks + c) * rowLength;
+                        for (Nd4jLong j = 0; j < rowLength; j++)
+                            zr[out.element(j)] = first ? pr[j] : Op::combine(zr[out.element(j)], pr[j]);
+
+                        first = false;
+                    }
+
+                    for (Nd4jLong j = 0; j < rowLength; j++)
+                        zr[out.element(j)] = Op::finalize(zr[out.element(j)], count);
                 }
-                output->p(idx, val);
-            }
+            };
+
+            samediff::Threads::parallel_tad(combineChunks, 0, numOfClasses);
+            return;
         }
-        else {
-            auto restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), {0});
-
-            auto listOfTensors = input->allTensorsAlongDimension(restDims);
-            auto listOfOutTensors = output->allTensorsAlongDimension(restDims);
-
-            int numOfClasses = output->sizeAt(0); // number of classes
-            std::vector<std::pair<NDArray*, int>> outputs(numOfClasses);
-            auto sumT = listOfOutTensors.at(idx);
-
-            for (Nd4jLong i = 0; i < indices->lengthOf(); i++) {
-                if (indices->e<int>(i) == idx) {
-                    auto func = PRAGMA_THREADS_FOR {
-                        for (auto e = start; e < stop; e++) {
-                            sumT->p(e, sumT->e<T>(e) + listOfTensors.at(i)->e<T>(e));
-                        }
-                    };
-                    samediff::Threads::parallel_for(func, 0, sumT->lengthOf());
-                }
-                else {
-                    idx = indices->e<int>(i);
-                    sumT = listOfOutTensors.at(idx);
-                    sumT->assign(listOfTensors.at(i));
-                }
+
+        // otherwise every task owns range of segments and range of columns
+        auto func = PRAGMA_THREADS_FOR_2D {
+            for (auto s = start_x; s < stop_x; s++) {
+                const Nd4jLong count = partition.count(s);
+                if (count == 0)
+                    continue;
+
+                segmentReduceRows<T, Op>(x, in, partition.rows.data() + partition.offsets[s], count, z, out, s, start_y, stop_y);
+
+                auto zr = z + out.row(s);
+                for (auto j = start_y; j < stop_y; j++)
+                    zr[out.element(j)] = Op::finalize(zr[out.element(j)], count);
             }
-        }
+        };
+
+        samediff::Threads::parallel_for(func, 0, numOfClasses, 1, 0, rowLength, 1);
     }
 
     template <typename T>
-    static void segmentProdFunctor_(NDArray* input, NDArray* indices, NDArray* output) {
-        //int numClasses = output->sizeAt(0);
-        // if input is a vector: (as if in doc sample)
-        int idx = indices->e<int>(0);
-        output->assign(1.f);
-        if (input->isVector()) {
-            T val = input->e<T>(0);
-            int count = 0;
-
-            for (Nd4jLong e = 1; e < indices->lengthOf(); e++) {
-                if (idx == indices->e<int>(e)) {
-                   // sum
-                   val *= input->e<T>(e);
+    static void segmentReduce_(const SegmentReduction op, NDArray& input, const SegmentPartition& partition, NDArray& output) {
+        switch (op) {
+            case SEGMENT_MAX:
+                segmentReduceKernel_<T, SegmentMaxOp<T>>(input, partition, output);
+                break;
+            case SEGMENT_MIN:
+                segmentReduceKernel_<T, SegmentMinOp<T>>(input, partition, output);
+                break;
+            case SEGMENT_SUM:
+                segmentReduceKernel_<T, SegmentSumOp<T>>(input, partition, output);
+                break;
+            case SEGMENT_MEAN:
+                segmentReduceKernel_<T, SegmentMeanOp<T>>(input, partition, output);
+                break;
+            case SEGMENT_PROD:
+                segmentReduceKernel_<T, SegmentProdOp<T>>(input, partition, output);
+                break;
+            case SEGMENT_SQRT_N:
+                segmentReduceKernel_<T, SegmentSqrtNOp<T>>(input, partition, output);
+                break;
+            default:
+                throw std::runtime_error("segment: unknown reduction");
+        }
+    }
+
+    // segments without rows are left untouched, so output is expected to be filled with default value already
+    static void segmentReduce(const SegmentReduction op, NDArray* input, const SegmentPartition& partition, NDArray* output) {
+        if (input->lengthOf() == 0)
+            return;
+
+        if (output->dataType() == input->dataType()) {
+            BUILD_SINGLE_SELECTOR(input->dataType(), segmentReduce_, (op, *input, partition, *output), LIBND4J_TYPES);
+            return;
+        }
+
+        NDArray result = output->cast(input->dataType());
+        BUILD_SINGLE_SELECTOR(input->dataType(), segmentReduce_, (op, *input, partition, result), LIBND4J_TYPES);
+        output->assign(result);
+    }
+
+    // output row i = f(input row i, gradOut row c, forward row c, number of rows in segment c), c is segment of row i
+    template <typename T, typename F>
+    static void segmentBPKernel_(NDArray& input, NDArray& gradOut, NDArray& forward, const SegmentPartition& partition, NDArray& output, const F& f) {
+        const SegmentRows in(input);
+        const SegmentRows gr(gradOut);
+        const SegmentRows fw(forward);
+        const SegmentRows out(output);
+
+        auto x = input.bufferAsT<T>();
+        auto g = gradOut.bufferAsT<T>();
+        auto y = forward.bufferAsT<T>();
+        auto z = output.bufferAsT<T>();
+
+        const bool contiguous = in.ews == 1 && gr.ews == 1 && fw.ews == 1 && out.ews == 1;
+
+        // every row of output depends on single row of input, so there's nothing to synchronize
+        auto func = PRAGMA_THREADS_FOR_2D {
+            for (auto i = start_x; i < stop_x; i++) {
+                const Nd4jLong c = partition.classes[i];
+                const Nd4jLong count = partition.count(c);
+
+                auto xr = x + in.row(i);
+                auto gc = g + gr.row(c);
+                auto yc = y + fw.row(c);
+                auto zr = z + out.row(i);
+
+                if (contiguous) {
+                    PRAGMA_OMP_SIMD
+                    for (auto j = start_y; j < stop_y; j++)
+                        zr[j] = f(xr[j], gc[j], yc[j], count);
                 }
                 else {
-                    idx = indices->e<int>(e);
-                    val = input->e<T>(e);
+                    for (auto j = start_y; j < stop_y; j++)
+                        zr[out.element(j)] = f(xr[in.element(j)], gc[gr.element(j)], yc[fw.element(j)], count);
                 }
-                output->p(idx, val);
             }
-        }
-        else {
-            auto restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), {0});
-
-            auto listOfTensors = input->allTensorsAlongDimension(restDims);
-            auto listOfOutTensors = output->allTensorsAlongDimension(restDims);
-
-            int numOfClasses = output->sizeAt(0); // number of classes
-            auto sumT = listOfOutTensors.at(idx);
-            sumT->assign(listOfTensors.at(0));
-            for (Nd4jLong i = 1; i < indices->lengthOf(); i++) {
-                if (indices->e<int>(i)  == idx) {
-                    auto func = PRAGMA_THREADS_FOR {
-                        for (auto e = start; e < stop; e++) {
-                            sumT->p(e, sumT->e<T>(e) * listOfTensors.at(i)->e<T>(e));
-                        }
-                    };
-                    samediff::Threads::parallel_for(func, 0, sumT->lengthOf());
-                }
-                else {
-                    idx = indices->e<int>(i);
-                    sumT = listOfOutTensors.at(idx);
-                    sumT->assign(listOfTensors.at(i));
-                }
-            }
-        }
+        };
+
+        samediff::Threads::parallel_for(func, 0, (Nd4jLong) partition.rows.size(), 1, 0, in.length, 1);
     }
 
-//    template <typename T>
-//    static bool segmentIndicesValidate_(NDArray* indices, NDArray& aexpected, NDArray& anOutput) {
-//      }
+    template <typename T>
+    static void segmentBP_(const SegmentReduction op, NDArray& input, NDArray& gradOut, NDArray& forward, const SegmentPartition& partition, NDArray& output) {
+        switch (op) {
+            case SEGMENT_MAX:
+            case SEGMENT_MIN:
+                segmentBPKernel_<T>(input, gradOut, forward, partition, output, [](const T x, const T g, const T y, const Nd4jLong count) -> T {
+                    return sd::math::nd4j_abs<T>(static_cast<T>(y - x)) <= static_cast<T>(1.e-6) ? g : static_cast<T>(0);
+                });
+                break;
+            case SEGMENT_SUM:
+                segmentBPKernel_<T>(input, gradOut, forward, partition, output, [](const T x, const T g, const T y, const Nd4jLong count) -> T {
+                    return g;
+                });
+                break;
+            case SEGMENT_MEAN:
+                segmentBPKernel_<T>(input, gradOut, forward, partition, output, [](const T x, const T g, const T y, const Nd4jLong count) -> T {
+                    return static_cast<T>(g / static_cast<T>(count));
+                });
+                break;
+            case SEGMENT_PROD:
+                segmentBPKernel_<T>(input, gradOut, forward, partition, output, [](const T x, const T g, const T y, const Nd4jLong count) -> T {
+                    return static_cast<T>(y * g / x);
+                });
+                break;
+            case SEGMENT_SQRT_N:
+                segmentBPKernel_<T>(input, gradOut, forward, partition, output, [](const T x, const T g, const T y, const Nd4jLong count) -> T {
+                    return static_cast<T>(static_cast<double>(g) / sd::math::nd4j_sqrt<Nd4jLong, double>(count));
+                });
+                break;
+            default:
+                throw std::runtime_error("segment: unknown reduction");
+        }
+    }
+
+    /**
+     * Backprop of segment reduction. Max, min and prod need result of forward pass, so it's calculated here,
+     * with the same partition of rows
+     */
+    static int segmentBP(const SegmentReduction op, NDArray* input, NDArray* indices, NDArray* gradOut, const Nd4jLong numOfClasses, NDArray* output) {
+        if (input->lengthOf() == 0)
+            return Status::OK();
+
+        const SegmentPartition partition(indices, numOfClasses);
+        const auto dataType = output->dataType();
+
+        // copies are made only if types differ
+        NDArray xCast, gCast, forward;
+        NDArray *x = input, *g = gradOut, *y = gradOut;
+
+        if (input->dataType() != dataType) {
+            xCast = input->cast(dataType);
+            x = &xCast;
+        }
+
+        if (gradOut->dataType() != dataType) {
+            gCast = gradOut->cast(dataType);
+            g = y = &gCast;
+        }
+
+        if (op == SEGMENT_MAX || op == SEGMENT_MIN || op == SEGMENT_PROD) {
+            forward = g->ulike();
+            segmentReduce(op, x, partition, &forward);
+            y = &forward;
+        }
+
+        BUILD_SINGLE_SELECTOR(dataType, segmentBP_, (op, *x, *g, *y, partition, *output), NUMERIC_TYPES);
+        return Status::OK();
+    }
+
+    // -------------------------------------------------------------------------------------------------------------- //
+    // Sorted segment ops
+    // -------------------------------------------------------------------------------------------------------------- //
 
+    // segment max
     void segmentMaxFunctor(sd::LaunchContext * context, NDArray* input, NDArray* indices, NDArray* output) {
-        BUILD_SINGLE_SELECTOR(input->dataType(), segmentMaxFunctor_, (input, indices, output), LIBND4J_TYPES);
+        segmentReduce(SEGMENT_MAX, input, SegmentPartition(indices, output->sizeAt(0)), output);
     }
 
+    // segmen min
     void segmentMinFunctor(sd::LaunchContext * context, NDArray* input, NDArray* indices, NDArray* output) {
-        BUILD_SINGLE_SELECTOR(input->dataType(), segmentMinFunctor_, (input, indices, output), LIBND4J_TYPES);
+        segmentReduce(SEGMENT_MIN, input, SegmentPartition(indices, output->sizeAt(0)), output);
     }
 
+    // segmen mean
     void segmentMeanFunctor(sd::LaunchContext * context, NDArray* input, NDArray* indices, NDArray* output) {
-        BUILD_SINGLE_SELECTOR(input->dataType(), segmentMeanFunctor_, (input, indices, output), LIBND4J_TYPES);
+        segmentReduce(SEGMENT_MEAN, input, SegmentPartition(indices, output->sizeAt(0)), output);
     }
 
     void segmentSumFunctor(sd::LaunchContext * context, NDArray* input, NDArray* indices, NDArray* output) {
-        BUILD_SINGLE_SELECTOR(input->dataType(), segmentSumFunctor_, (input, indices, output), LIBND4J_TYPES);
+        segmentReduce(SEGMENT_SUM, input, SegmentPartition(indices, output->sizeAt(0)), output);
     }
 
     void segmentProdFunctor(sd::LaunchContext * context, NDArray* input, NDArray* indices, NDArray* output) {
-        BUILD_SINGLE_SELECTOR(input->dataType(), segmentProdFunctor_, (input, indices, output), LIBND4J_TYPES);
+        output->assign(1.f);
+        segmentReduce(SEGMENT_PROD, input, SegmentPartition(indices, output->sizeAt(0)), output);
     }
 
     bool segmentIndicesValidate(sd::LaunchContext * context, NDArray* indices, NDArray& expected, NDArray& output) {
@@ -323,12 +469,6 @@ namespace helpers {
         return true;
     }
 
-    //BUILD_SINGLE_TEMPLATE(template bool segmentIndicesValidate_, (NDArray*, NDArray&, NDArray&), LIBND4J_TYPES);
-    BUILD_SINGLE_TEMPLATE(template void segmentProdFunctor_, (NDArray* input, NDArray* indices, NDArray* output), LIBND4J_TYPES);
-    BUILD_SINGLE_TEMPLATE(template void segmentSumFunctor_, (NDArray* input, NDArray* indices, NDArray* output), LIBND4J_TYPES);
-    BUILD_SINGLE_TEMPLATE(template void segmentMeanFunctor_, (NDArray* input, NDArray* indices, NDArray* output), LIBND4J_TYPES);
-    BUILD_SINGLE_TEMPLATE(template void segmentMinFunctor_, (NDArray* input, NDArray* indices, NDArray* output), LIBND4J_TYPES);
-    BUILD_SINGLE_TEMPLATE(template void segmentMaxFunctor_, (NDArray* input, NDArray* indices, NDArray* output), LIBND4J_TYPES);
     // -------------------------------------------------------------------------------------------------------------- //
     // Unsorted segment ops
     // -------------------------------------------------------------------------------------------------------------- //
@@ -346,267 +486,36 @@ namespace helpers {
     }
 
     template <typename T>
-    static void unsortedSegmentMaxFunctor_(NDArray* input, NDArray* indices, Nd4jLong numOfClasses, NDArray* output) {
-
-        // if input is a vector: (as if in doc sample)
-        //int idx = static_cast<int>((*indices)(0.));
-        MAP_IMPL<Nd4jLong, std::vector<Nd4jLong>> idxs;//(indices->lengthOf());
-        for (Nd4jLong e = 0; e < indices->lengthOf(); ++e)
-            idxs[indices->e<Nd4jLong>(e)].push_back(e);
-
-        //std::sort(idxs.begin(), idxs.end());
-
-        if (input->isVector()) { // 1D case
-            T maxVal = DataTypeUtils::max<T>();
-            output->assign(-maxVal);
-
-            for (auto fi = idxs.begin(); fi != idxs.end(); ++fi) {
-                T val = input->e<T>(fi->second.at(0));
-                for (Nd4jLong idx = 1; idx < static_cast<Nd4jLong>(fi->second.size()); ++idx) {
-                    val = sd::math::nd4j_max(val, input->e<T>(fi->second.at(idx)));
-                }
-                output->p(fi->first, val);
-            }
-        }
-        else {
-            auto restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), {0});
-
-            ResultSet listOfTensors = input->allTensorsAlongDimension(restDims);
-            ResultSet listOfOutTensors = output->allTensorsAlongDimension(restDims);
-
-            T maxVal = DataTypeUtils::max<T>();
-            output->assign(-maxVal);
-
-            for (auto fi = idxs.begin(); fi != idxs.end(); ++fi) {
-                auto outputT = listOfOutTensors.at(fi->first);
-                outputT->assign(listOfTensors.at(fi->second.at(0)));
-                for (Nd4jLong idx = 1; idx < static_cast<Nd4jLong>(fi->second.size()); ++idx) {
-                    auto maxT = listOfTensors.at(fi->second.at(idx));
-                    for (Nd4jLong e = 0; e < outputT->lengthOf(); ++e) {
-                        T val = sd::math::nd4j_max(maxT->e<T>(e), outputT->e<T>(e));
-
-                        outputT->p(e, val);
-                    }
-                }
-            }
-        }
+    static void unsortedSegmentFill_(NDArray* output, const bool lowest) {
+        T maxVal = DataTypeUtils::max<T>();
+        output->assign(lowest ? -maxVal : maxVal);
     }
+
     void unsortedSegmentMaxFunctor(sd::LaunchContext * context, NDArray* input, NDArray* indices, Nd4jLong numOfClasses, NDArray* output) {
-        BUILD_SINGLE_SELECTOR(input->dataType(), unsortedSegmentMaxFunctor_, (input, indices, numOfClasses, output), NUMERIC_TYPES);
+        BUILD_SINGLE_SELECTOR(input->dataType(), unsortedSegmentFill_, (output, true), NUMERIC_TYPES);
+        segmentReduce(SEGMENT_MAX, input, SegmentPartition(indices, numOfClasses), output);
     }
-    BUILD_SINGLE_TEMPLATE(template void unsortedSegmentMaxFunctor_, (NDArray* input, NDArray* indices, Nd4jLong numOfClasses, NDArray* output), NUMERIC_TYPES);
-
-    template <typename T>
-    static void unsortedSegmentMinFunctor_(NDArray* input, NDArray* indices, Nd4jLong numOfClasses, NDArray* output) {
-        // if input is a vector: (as if in doc sample)
-        //int idx = static_cast<int>((*indices)(0.));
-        MAP_IMPL<Nd4jLong, std::vector<Nd4jLong>> idxs;//(indices->lengthOf());
-
-        for (Nd4jLong e = 0; e < indices->lengthOf(); ++e)
-            idxs[indices->e<Nd4jLong>(e)].push_back(e);
-
-        //std::sort(idxs.begin(), idxs.end());
 
-        if (input->isVector()) { // 1D case
-            T maxVal = DataTypeUtils::max<T>();
-            output->assign(maxVal);
-
-            for (auto fi = idxs.begin(); fi != idxs.end(); ++fi) {
-                T val = input->t<T>(fi->second.at(0));
-
-                for (size_t idx = 1; idx < fi->second.size(); ++idx) {
-                    val = sd::math::nd4j_min(val, input->t<T>(fi->second.at(idx)));
-                }
-                output->r<T>(fi->first) = val;
-            }
-        }
-        else {
-            auto restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), {0});
-
-            ResultSet listOfTensors = input->allTensorsAlongDimension(restDims);
-            ResultSet listOfOutTensors = output->allTensorsAlongDimension(restDims);
-
-            T maxVal = DataTypeUtils::max<T>();
-            output->assign(maxVal);
-
-            for (auto fi = idxs.begin(); fi != idxs.end(); ++fi) {
-                auto outputT = listOfOutTensors.at(fi->first);
-                outputT->assign(listOfTensors.at(fi->second.at(0)));
-                for (size_t idx = 1; idx < fi->second.size(); ++idx) {
-                    auto minT = listOfTensors.at(fi->second.at(idx));
-
-                    for (Nd4jLong e = 0; e < outputT->lengthOf(); ++e) {
-                        outputT->r<T>(e) = sd::math::nd4j_min(minT->t<T>(e), outputT->t<T>(e));
-                    }
-                }
-                //outputT->assign(maxT);
-            }
-        }
-
-    }
     void unsortedSegmentMinFunctor(sd::LaunchContext * context, NDArray* input, NDArray* indices, Nd4jLong numOfClasses, NDArray* output) {
-        BUILD_SINGLE_SELECTOR(input->dataType(), unsortedSegmentMinFunctor_, (input, indices, numOfClasses, output),
-                              NUMERIC_TYPES);
+        BUILD_SINGLE_SELECTOR(input->dataType(), unsortedSegmentFill_, (output, false), NUMERIC_TYPES);
+        segmentReduce(SEGMENT_MIN, input, SegmentPartition(indices, numOfClasses), output);
     }
 
-    BUILD_SINGLE_TEMPLATE(template void unsortedSegmentMinFunctor_, (NDArray* input, NDArray* indices, Nd4jLong numOfClasses, NDArray* output), NUMERIC_TYPES);
-
     void unsortedSegmentMeanFunctor(sd::LaunchContext * context, NDArray* input, NDArray* indices, Nd4jLong numOfClasses, NDArray* output) {
-        MAP_IMPL<Nd4jLong, std::vector<Nd4jLong>> idxs;//(indices->lengthOf());
-        for (Nd4jLong e = 0; e < indices->lengthOf(); ++e)
-            idxs[indices->e<Nd4jLong>(e)].push_back(e);
-
-        //std::sort(idxs.begin(), idxs.end());
-
-        if (input->isVector()) { // 1D case
-
-            for (auto fi = idxs.begin(); fi != idxs.end(); ++fi) {
-                double sumValue = input->e<double>(fi->second.at(0));
-                int loop_size = fi->second.size();
-
-                // FIXME: parallelism here?
-                for (size_t idx = 1; idx < loop_size; ++idx) {
-                    sumValue += input->e<double>(fi->second.at(idx));
-                }
-
-                output->p(fi->first, sumValue / fi->second.size());
-            }
-        }
-        else {
-            auto restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), {0});
-
-            ResultSet listOfTensors = input->allTensorsAlongDimension(restDims);
-            ResultSet listOfOutTensors = output->allTensorsAlongDimension(restDims);
-
-            // FIXME: parallelism here?
-            for (auto fi = idxs.begin(); fi != idxs.end(); ++fi) {
-                auto outputT = listOfOutTensors.at(fi->first);
-                outputT->assign(listOfTensors.at(fi->second.at(0)));
-                Nd4jLong loopSize = fi->second.size();
-
-                for (Nd4jLong idx = 1; idx < loopSize; ++idx) {
-                    auto current = listOfTensors.at(fi->second.at(idx));
-                    *outputT += *current;
-                }
-                (*outputT) /= double(fi->second.size());
-            }
-        }
+        segmentReduce(SEGMENT_MEAN, input, SegmentPartition(indices, numOfClasses), output);
     }
 
     void unsortedSegmentSumFunctor(sd::LaunchContext * context, NDArray* input, NDArray* indices, Nd4jLong numOfClasses, NDArray* output) {
-        MAP_IMPL<Nd4jLong, std::vector<Nd4jLong>> idxs;//(indices->lengthOf());
-        for (Nd4jLong e = 0; e < indices->lengthOf(); ++e)
-            idxs[indices->e<Nd4jLong>(e)].push_back(e);
-
-        if (input->isVector()) { // 1D case
-
-            for (auto fi = idxs.begin(); fi != idxs.end(); ++fi) {
-                double sumValue = input->e<double>(fi->second.at(0));
-                Nd4jLong loop_size = fi->second.size();
-
-                // FIXME: parallelism here?
-                for (Nd4jLong idx = 1; idx < loop_size; ++idx) {
-                    sumValue += input->e<double>(fi->second.at(idx));
-                }
-                output->p(fi->first, sumValue);
-            }
-        }
-        else {
-            auto restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), {0});
-
-            ResultSet listOfTensors = input->allTensorsAlongDimension(restDims);
-            ResultSet listOfOutTensors = output->allTensorsAlongDimension(restDims);
-
-            for (auto fi = idxs.begin(); fi != idxs.end(); ++fi) {
-                auto outputT = listOfOutTensors.at(fi->first);
-                outputT->assign(listOfTensors.at(fi->second.at(0)));
-                Nd4jLong loop_size = fi->second.size();
-
-                // FIXME: parallelism here?
-                for (Nd4jLong idx = 1; idx < loop_size; ++idx) {
-                    auto current = listOfTensors.at(fi->second.at(idx));
-                    *(outputT) += *current;
-                }
-                //outputT->assign(maxT);
-            }
-        }
-    }
-
-    template <typename T>
-    void unsortedSegmentProdFunctor_(NDArray* input, NDArray* indices, Nd4jLong numOfClasses, NDArray* output) {
-        MAP_IMPL<Nd4jLong, std::vector<Nd4jLong>> idxs;//(indices->lengthOf());
-        for (Nd4jLong e = 0; e < indices->lengthOf(); ++e)
-            idxs[indices->e<Nd4jLong>(e)].push_back(e);
-
-        //std::sort(idxs.begin(), idxs.end());
-
-        output->assign(1.f);
-
-        if (input->isVector()) { // 1D case
-            for (auto fi = idxs.begin(); fi != idxs.end(); ++fi) {
-                T prodValue = input->e<T>(fi->second.at(0));
-                for (size_t idx = 1; idx < fi->second.size(); ++idx) {
-                    prodValue *= input->e<T>(fi->second.at(idx));
-                }
-                output->p(fi->first, prodValue);
-            }
-        }
-        else {
-            auto restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), {0});
-
-            ResultSet listOfTensors = input->allTensorsAlongDimension(restDims);
-            ResultSet listOfOutTensors = output->allTensorsAlongDimension(restDims);
-
-            for (auto fi = idxs.begin(); fi != idxs.end(); ++fi) {
-                auto outputT = listOfOutTensors.at(fi->first);
-                outputT->assign(listOfTensors.at(fi->second.at(0)));
-                for (size_t idx = 1; idx < fi->second.size(); ++idx) {
-                    auto current = listOfTensors.at(fi->second.at(idx));
-
-                    *outputT *= *current;
-                }
-            }
-        }
+        segmentReduce(SEGMENT_SUM, input, SegmentPartition(indices, numOfClasses), output);
     }
 
     void unsortedSegmentProdFunctor(sd::LaunchContext * context, NDArray* input, NDArray* indices, Nd4jLong numOfClasses, NDArray* output) {
-        BUILD_SINGLE_SELECTOR(input->dataType(), unsortedSegmentProdFunctor_, (input, indices, numOfClasses, output), NUMERIC_TYPES);
+        output->assign(1.f);
+        segmentReduce(SEGMENT_PROD, input, SegmentPartition(indices, numOfClasses), output);
     }
-    BUILD_SINGLE_TEMPLATE(template void unsortedSegmentProdFunctor_, (NDArray* input, NDArray* indices, Nd4jLong numOfClasses, NDArray* output), NUMERIC_TYPES);
 
     void unsortedSegmentSqrtNFunctor(sd::LaunchContext * context, NDArray* input, NDArray* indices, Nd4jLong numOfClasses, NDArray* output) {
-        MAP_IMPL<Nd4jLong, std::vector<Nd4jLong>> idxs;//(indices->lengthOf());
-        for (Nd4jLong e = 0; e < indices->lengthOf(); ++e)
-            idxs[indices->e<Nd4jLong>(e)].push_back(e);
-
-        //std::sort(idxs.begin(), idxs.end());
-
-        if (input->isVector()) { // 1D case
-            for (auto fi = idxs.begin(); fi != idxs.end(); ++fi) {
-                double sumValue = input->e<double>(fi->second.at(0));
-                for (size_t idx = 1; idx < fi->second.size(); ++idx) {
-                    sumValue += input->e<double>(fi->second.at(idx));
-                }
-                output->p(fi->first, sumValue / sd::math::nd4j_sqrt<Nd4jLong, double>(fi->second.size()));
-            }
-        }
-        else {
-            auto restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), {0});
-
-            ResultSet listOfTensors = input->allTensorsAlongDimension(restDims);
-            ResultSet listOfOutTensors = output->allTensorsAlongDimension(restDims);
-
-            for (auto fi = idxs.begin(); fi != idxs.end(); ++fi) {
-                auto outputT = listOfOutTensors.at(fi->first);
-                outputT->assign(listOfTensors.at(fi->second.at(0)));
-                for (size_t idx = 1; idx < fi->second.size(); ++idx) {
-                    auto current = listOfTensors.at(fi->second.at(idx));
-                    *outputT += *current;
-                }
-                //outputT->assign(maxT);
-                (*outputT) /= sd::math::nd4j_sqrt<size_t, double>(fi->second.size());
-            }
-        }
+        segmentReduce(SEGMENT_SQRT_N, input, SegmentPartition(indices, numOfClasses), output);
     }
 
     // -------------------------------------------------------------------------------------------------------------- //
@@ -615,475 +524,54 @@ namespace helpers {
     // Sorted backpropagate ops
     //
     // segment max
-    template <typename T>
-    int segmentMaxFunctorBP_(sd::LaunchContext * context, NDArray* input, NDArray* indices, NDArray* gradOut, NDArray* output) {
-        //int numOfClasses = gradOut->sizeAt(0);
-        // if input is a vector: (as if in doc sample)
-        auto tempRes = gradOut->dup();
-        segmentMaxFunctor_<T>(input, indices, &tempRes);
-        if (input->isVector()) {
-            Nd4jLong loop_size = input->lengthOf();
-
-            auto func = PRAGMA_THREADS_FOR {
-                for (auto e = start; e < stop; e++) {
-                    auto classNum = indices->e<Nd4jLong>(e);
-                    if (sd::math::nd4j_abs(tempRes.e<T>(classNum) - input->e<T>(e)) <= T(1.e-6))
-                        output->p(e, gradOut->e<T>(classNum));
-                }
-            };
-            samediff::Threads::parallel_for(func, 0, loop_size);
-        }
-        else {
-            std::vector<int> restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), {0});
-
-            ResultSet listOfBPTensors = tempRes.allTensorsAlongDimension(restDims);
-            ResultSet listOfGradOuts = gradOut->allTensorsAlongDimension(restDims);
-            ResultSet listOfTensors = input->allTensorsAlongDimension(restDims);
-            ResultSet listOfOutTensors = output->allTensorsAlongDimension(restDims);
-
-            //int numOfClasses = tempRes.sizeAt(0); // number of classes
-            //std::vector<std::pair<NDArray*, int>> outputs(numOfClasses);
-
-            auto func = PRAGMA_THREADS_FOR {
-                for (auto i = start; i < stop; i++) {
-                    auto classNum = indices->e<Nd4jLong>(i);
-                    auto current = listOfTensors.at(i);
-                    auto currentOut = listOfOutTensors.at(i);
-                    auto currentGradOut = listOfGradOuts.at(classNum);
-
-                    for (Nd4jLong e = 0; e < current->lengthOf(); e++) {
-                        if (sd::math::nd4j_abs(listOfBPTensors.at(classNum)->e<T>(e) - current->e<T>(e)) <= T(1.e-6))
-                            currentOut->p(e, currentGradOut->e<T>(e));
-                    }
-                }
-            };
-
-            samediff::Threads::parallel_tad(func, 0, indices->lengthOf());
-        }
-
-        return ND4J_STATUS_OK;
-    }
-
     int segmentMaxFunctorBP(sd::LaunchContext * context, NDArray* input, NDArray* indices, NDArray* gradOut, NDArray* output) {
-        BUILD_SINGLE_SELECTOR(output->dataType(), return segmentMaxFunctorBP_, (context, input, indices, gradOut, output), NUMERIC_TYPES);
+        return segmentBP(SEGMENT_MAX, input, indices, gradOut, gradOut->sizeAt(0), output);
     }
-    BUILD_SINGLE_TEMPLATE(template int segmentMaxFunctorBP_, (sd::LaunchContext * context, NDArray* input, NDArray* indices, NDArray* gradOut, NDArray* output), NUMERIC_TYPES);
 
     // segmen min
     int segmentMinFunctorBP(sd::LaunchContext * context, NDArray* input, NDArray* indices, NDArray* gradOut, NDArray* output) {
-        NDArray tempRes = gradOut->dup();
-        segmentMinFunctor(context, input, indices, &tempRes);
-        if (input->isVector()) {
-            auto func = PRAGMA_THREADS_FOR {
-                for (auto e = start; e < stop; e++) {
-                    auto classNum = indices->e<Nd4jLong>(e);
-                    if (sd::math::nd4j_abs(tempRes.e<double>(classNum) - input->e<double>(e)) < 1.e-5)
-                        output->p(e, gradOut->e<double>(classNum));
-                }
-            };
-            samediff::Threads::parallel_for(func, 0, input->lengthOf());
-        }
-        else {
-            auto restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), {0});
-
-            ResultSet listOfBPTensors = tempRes.allTensorsAlongDimension(restDims);
-            ResultSet listOfGradOuts = gradOut->allTensorsAlongDimension(restDims);
-            ResultSet listOfTensors = input->allTensorsAlongDimension(restDims);
-            ResultSet listOfOutTensors = output->allTensorsAlongDimension(restDims);
-
-            //int numOfClasses = tempRes.sizeAt(0); // number of classes
-            //std::vector<std::pair<NDArray*, int>> outputs(numOfClasses);
-            output->assign(0.);
-            int pos = 0;
-
-            auto func = PRAGMA_THREADS_FOR {
-                for (auto i = start; i < stop; i++) {
-                    auto classNum = indices->e<Nd4jLong>(i);
-                    auto current = listOfTensors.at(i);
-                    auto currentOut = listOfOutTensors.at(i);
-                    auto currentGradOut = listOfGradOuts.at(classNum);
-
-                    for (Nd4jLong e = 0; e < current->lengthOf(); e++) {
-                        if (sd::math::nd4j_abs(listOfBPTensors.at(classNum)->e<double>(e) - current->e<double>(e)) <
-                            1.e-5)
-                            currentOut->p(e, currentGradOut->e<double>(e));
-                    }
-                }
-            };
-
-            samediff::Threads::parallel_tad(func, 0, indices->lengthOf());
-        }
-        return ND4J_STATUS_OK;
+        return segmentBP(SEGMENT_MIN, input, indices, gradOut, gradOut->sizeAt(0), output);
     }
 
     // segmen mean
     int segmentMeanFunctorBP(sd::LaunchContext * context, NDArray* input, NDArray* indices, NDArray* gradOut, NDArray* output) {
-        int numClasses = output->sizeAt(0);
-        MAP_IMPL<Nd4jLong, Nd4jLong> classCount;//(numClasses);
-
-        for (Nd4jLong count = 0; count < numClasses; ++count) {
-            classCount[count] = 0;
-        }
-
-        for (Nd4jLong e = 0; e < indices->lengthOf(); ++e) {
-            classCount[indices->e<Nd4jLong>(e)] ++;
-        }
-
-        // if input is a vector: (as if in doc sample)
-        if (input->isVector()) {
-            for (Nd4jLong e = 0; e < indices->lengthOf(); ++e) {
-                Nd4jLong classNum = indices->e<Nd4jLong>(e);
-                output->p(e, gradOut->e<double>(classNum) / classCount[classNum]);
-            }
-        }
-        else {
-            auto restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), {0});
-
-            ResultSet listOfGradOuts = gradOut->allTensorsAlongDimension(restDims);
-            ResultSet listOfTensors = input->allTensorsAlongDimension(restDims);
-            ResultSet listOfOutTensors = output->allTensorsAlongDimension(restDims);
-;
-
-            int pos = 0;
-            //auto func = [&](uint64_t thread_id, uint64_t start, uint64_t stop, uint64_t increment) -> void {
-                for (Nd4jLong i = 0; i < indices->lengthOf(); i++) {
-                    auto classNum = indices->e<Nd4jLong>(i);
-                    auto current = listOfTensors.at(i);
-                    auto currentOut = listOfOutTensors.at(i);
-                    auto currentGradOut = listOfGradOuts.at(classNum);
-
-                    for (Nd4jLong e = 0; e < current->lengthOf(); e++) {
-                        currentOut->p(e, currentGradOut->e<double>(e) / classCount.at(classNum));
-                    }
-                }
-            //};
-
-            //samediff::Threads::parallel_for(func, 0, indices->lengthOf());
-        }
-        return ND4J_STATUS_OK;
+        return segmentBP(SEGMENT_MEAN, input, indices, gradOut, gradOut->sizeAt(0), output);
     }
 
     int segmentSumFunctorBP(sd::LaunchContext * context, NDArray* input, NDArray* indices, NDArray* gradOut, NDArray* output) {
-//        int numClasses = output->sizeAt(0);
-        // if input is a vector: (as if in doc sample)
-        Nd4jLong idx = indices->e<Nd4jLong>(0);
-        if (input->isVector()) {
-            for (Nd4jLong e = 0; e < indices->lengthOf(); ++e) {
-                Nd4jLong classNum = indices->e<Nd4jLong>(e);
-                output->p(e, gradOut->e<double>(classNum));
-            }
-        }
-        else {
-            auto restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), {0});
-
-            ResultSet listOfGradOuts = gradOut->allTensorsAlongDimension(restDims);
-            ResultSet listOfTensors = input->allTensorsAlongDimension(restDims);
-            ResultSet listOfOutTensors = output->allTensorsAlongDimension(restDims);
-
-            //auto func = PRAGMA_THREADS_FOR {
-                for (Nd4jLong i = 0; i < indices->lengthOf(); i++) {
-                    auto classNum = indices->e<Nd4jLong>(i);
-                    auto current = listOfTensors.at(i);
-                    auto currentOut = listOfOutTensors.at(i);
-                    auto currentGradOut = listOfGradOuts.at(classNum);
-
-                    currentOut->assign(currentGradOut);
-                }
-            //};
-
-            //samediff::Threads::parallel_for(func, 0, indices->lengthOf());
-        }
-        return Status::OK();
+        return segmentBP(SEGMENT_SUM, input, indices, gradOut, gradOut->sizeAt(0), output);
     }
 
     int segmentProdFunctorBP(sd::LaunchContext * context, NDArray* input, NDArray* indices, NDArray* gradOut, NDArray* output) {
-        auto tempRes = gradOut->dup();
-        segmentProdFunctor(context, input, indices, &tempRes);
-        if (input->isVector()) {
-            for (Nd4jLong e = 0; e < indices->lengthOf(); ++e) {
-                Nd4jLong classNum = indices->e<Nd4jLong>(e);
-                output->p(e, gradOut->e<double>(classNum) * tempRes.e<double>(classNum)/ input->e<double>(e));
-            }
-        }
-        else {
-            auto restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), {0});
-
-            ResultSet listOfBPTensors = tempRes.allTensorsAlongDimension(restDims);
-            ResultSet listOfGradOuts = gradOut->allTensorsAlongDimension(restDims);
-            ResultSet listOfTensors = input->allTensorsAlongDimension(restDims);
-            ResultSet listOfOutTensors = output->allTensorsAlongDimension(restDims);
-
-            //int numOfClasses = tempRes.sizeAt(0); // number of classes
-            //std::vector<std::pair<NDArray*, int>> outputs(numOfClasses);
-
-            //auto func = PRAGMA_THREADS_FOR {
-                for (Nd4jLong i = 0; i < indices->lengthOf(); i++) {
-                    auto classNum = indices->e<Nd4jLong>(i);
-                    auto current = listOfTensors.at(i);
-                    auto currentOut = listOfOutTensors.at(i);
-                    auto currentGradOut = listOfGradOuts.at(classNum);
-                    auto currentFFOut = listOfBPTensors.at(classNum);
-
-                    currentOut->assign((*currentFFOut) * (*currentGradOut) / (*current));
-                }
-            //};
-
-            //samediff::Threads::parallel_for(func, 0, indices->lengthOf());
-        }
-
-        return ND4J_STATUS_OK;
+        return segmentBP(SEGMENT_PROD, input, indices, gradOut, gradOut->sizeAt(0), output);
     }
 
     // -------------------------------------------------------------------------------------------------------------- //
     // Unsorted backpropagate segment ops
     // -------------------------------------------------------------------------------------------------------------- //
 
-    template <typename T>
-    static int unsortedSegmentMaxFunctorBP_(sd::LaunchContext * context, NDArray* input, NDArray* indices, NDArray* gradOut, Nd4jLong numOfClasses, NDArray* output) {
-//        int numOfClasses = gradOut->sizeAt(0);
-        // if input is a vector: (as if in doc sample)
-        auto tempRes = gradOut->dup();
-        unsortedSegmentMaxFunctor(context, input, indices, numOfClasses, &tempRes);
-        if (input->isVector()) {
-
-            for (Nd4jLong e = 0; e < input->lengthOf(); ++e) {
-                Nd4jLong classNum = indices->e<Nd4jLong>(e);
-                if (sd::math::nd4j_abs(tempRes.e<double>(classNum) - input->e<double>(e)) < 1.e-5)
-                    output->p(e, gradOut->e<T>(classNum));
-            }
-        }
-        else {
-            auto restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), {0});
-
-            ResultSet listOfBPTensors = tempRes.allTensorsAlongDimension(restDims);
-            ResultSet listOfGradOuts = gradOut->allTensorsAlongDimension(restDims);
-            ResultSet listOfTensors = input->allTensorsAlongDimension(restDims);
-            ResultSet listOfOutTensors = output->allTensorsAlongDimension(restDims);
-
-            for (Nd4jLong i = 0; i < indices->lengthOf(); i++) {
-                Nd4jLong classNum = indices->e<Nd4jLong>(i);
-                NDArray* current = listOfTensors.at(i);
-                NDArray* currentOut = listOfOutTensors.at(i);
-                NDArray* currentGradOut = listOfGradOuts.at(classNum);
-                for (int e = 0; e < current->lengthOf(); e++) {
-                    if (sd::math::nd4j_abs(listOfBPTensors.at(classNum)->e<double>(e) - current->e<double>(e)) < 1.e-5)
-                        currentOut->p(e, currentGradOut->e<T>(e));
-                }
-            }
-        }
-
-        return ND4J_STATUS_OK;
-    }
-
     int unsortedSegmentMaxFunctorBP(sd::LaunchContext * context, NDArray* input, NDArray* indices, NDArray* gradOut, Nd4jLong numOfClasses, NDArray* output) {
-        BUILD_SINGLE_SELECTOR(output->dataType(), return unsortedSegmentMaxFunctorBP_, (context, input, indices, gradOut, numOfClasses, output), NUMERIC_TYPES);
-    }
-    BUILD_SINGLE_TEMPLATE(template int unsortedSegmentMaxFunctorBP_, (sd::LaunchContext * context, NDArray* input, NDArray* indices, NDArray* gradOut, Nd4jLong numOfClasses, NDArray* output), NUMERIC_TYPES);
-
-    template <typename T>
-    static int unsortedSegmentMinFunctorBP_(sd::LaunchContext * context, NDArray* input, NDArray* indices, NDArray* gradOut, Nd4jLong numOfClasses, NDArray* output) {
-        auto tempRes = gradOut->dup();
-        unsortedSegmentMinFunctor(context, input, indices, numOfClasses, &tempRes);
-        if (input->isVector()) {
-
-            auto func = PRAGMA_THREADS_FOR {
-                for (auto e = start; e < stop; e++) {
-                    auto classNum = indices->e<Nd4jLong>(e);
-                    if (sd::math::nd4j_abs(tempRes.t<T>(classNum) - input->t<T>(e)) < 1.e-6)
-                        output->r<T>(e) = gradOut->t<T>(classNum);
-                }
-            };
-
-            samediff::Threads::parallel_for(func, 0, input->lengthOf());
-        }
-        else {
-            auto restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), {0});
-
-            ResultSet listOfBPTensors = tempRes.allTensorsAlongDimension(restDims);
-            ResultSet listOfGradOuts = gradOut->allTensorsAlongDimension(restDims);
-            ResultSet listOfTensors = input->allTensorsAlongDimension(restDims);
-            ResultSet listOfOutTensors = output->allTensorsAlongDimension(restDims);
-
-            //auto func = PRAGMA_THREADS_FOR {
-                for (Nd4jLong i = 0; i < indices->lengthOf(); i++) {
-                    auto classNum = indices->e<Nd4jLong>(i);
-                    auto current = listOfTensors.at(i);
-                    auto currentOut = listOfOutTensors.at(i);
-                    auto currentGradOut = listOfGradOuts.at(classNum);
-
-                    for (Nd4jLong e = 0; e < current->lengthOf(); e++) {
-                        if (sd::math::nd4j_abs(listOfBPTensors.at(classNum)->t<T>(e) - current->t<T>(e)) < 1.e-6)
-                            currentOut->r<T>(e) = currentGradOut->t<T>(e);
-                    }
-                }
-            //};
-
-            //samediff::Threads::parallel_for(func, 0, indices->lengthOf());
-        }
-
-        return ND4J_STATUS_OK;
+        return segmentBP(SEGMENT_MAX, input, indices, gradOut, numOfClasses, output);
     }
 
     int unsortedSegmentMinFunctorBP(sd::LaunchContext * context, NDArray* input, NDArray* indices, NDArray* gradOut, Nd4jLong numOfClasses, NDArray* output) {
-        BUILD_SINGLE_SELECTOR(output->dataType(), return unsortedSegmentMinFunctorBP_, (context, input, indices, gradOut, numOfClasses, output), NUMERIC_TYPES);
+        return segmentBP(SEGMENT_MIN, input, indices, gradOut, numOfClasses, output);
     }
-    BUILD_SINGLE_TEMPLATE(template int unsortedSegmentMinFunctorBP_, (sd::LaunchContext * context, NDArray* input, NDArray* indices, NDArray* gradOut, Nd4jLong numOfClasses, NDArray* output), NUMERIC_TYPES);
 
     int unsortedSegmentMeanFunctorBP(sd::LaunchContext * context, NDArray* input, NDArray* indices, NDArray* gradOut, Nd4jLong numOfClasses, NDArray* output) {
-
-        MAP_IMPL<Nd4jLong, Nd4jLong> classCount;//(numClasses);
-
-        for (Nd4jLong count = 0; count < numOfClasses; ++count) {
-            classCount[count] = 0;
-        }
-
-        for (Nd4jLong e = 0; e < indices->lengthOf(); ++e) {
-            classCount[indices->e<Nd4jLong>(e)]++;
-        }
-
-        // if input is a vector: (as if in doc sample)
-        if (input->isVector()) {
-            for (Nd4jLong e = 0; e < indices->lengthOf(); ++e) {
-                Nd4jLong classNum = indices->e<Nd4jLong>(e);
-                output->p(e, gradOut->e<double>(classNum) / classCount[classNum]);
-            }
-        }
-        else {
-            auto restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), {0});
-
-            ResultSet listOfGradOuts = gradOut->allTensorsAlongDimension(restDims);
-            ResultSet listOfTensors = input->allTensorsAlongDimension(restDims);
-            ResultSet listOfOutTensors = output->allTensorsAlongDimension(restDims);
-
-            for (Nd4jLong i = 0; i < indices->lengthOf(); i++) {
-                Nd4jLong classNum = indices->e<Nd4jLong>(i);
-                NDArray* current = listOfTensors.at(i);
-                NDArray* currentOut = listOfOutTensors.at(i);
-                NDArray* currentGradOut = listOfGradOuts.at(classNum);
-                currentOut->assign(*currentGradOut / double(classCount[classNum]));
-            }
-        }
-        return ND4J_STATUS_OK;
+        return segmentBP(SEGMENT_MEAN, input, indices, gradOut, numOfClasses, output);
     }
 
     int unsortedSegmentSumFunctorBP(sd::LaunchContext * context, NDArray* input, NDArray* indices, NDArray* gradOut, Nd4jLong numOfClasses, NDArray* output) {
-
-        // if input is a vector: (as if in doc sample)
-        Nd4jLong idx = indices->e<Nd4jLong>(0);
-        if (input->isVector()) {
-            for (Nd4jLong e = 0; e < indices->lengthOf(); ++e) {
-                Nd4jLong classNum = indices->e<Nd4jLong>(e);
-                output->p(e, gradOut->e<double>(classNum));
-            }
-        }
-        else {
-            auto restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), {0});
-
-            ResultSet listOfGradOuts = gradOut->allTensorsAlongDimension(restDims);
-            ResultSet listOfTensors = input->allTensorsAlongDimension(restDims);
-            ResultSet listOfOutTensors = output->allTensorsAlongDimension(restDims);
-
-            //auto func = PRAGMA_THREADS_FOR {
-                for (Nd4jLong i = 0; i < indices->lengthOf(); i++) {
-                    auto classNum = indices->e<Nd4jLong>(i);
-                    auto currentOut = listOfOutTensors.at(i);
-                    auto currentGradOut = listOfGradOuts.at(classNum);
-
-                    currentOut->assign(currentGradOut);
-                }
-            //};
-
-            //samediff::Threads::parallel_for(func, 0, indices->lengthOf());
-        }
-        return Status::OK();
+        return segmentBP(SEGMENT_SUM, input, indices, gradOut, numOfClasses, output);
     }
 
     int unsortedSegmentProdFunctorBP(sd::LaunchContext * context, NDArray* input, NDArray* indices, NDArray* gradOut, Nd4jLong numOfClasses, NDArray* output) {
-
-        auto tempRes = gradOut->dup();
-        unsortedSegmentProdFunctor(context, input, indices, numOfClasses, &tempRes);
-        if (input->isVector()) {
-            auto func = PRAGMA_THREADS_FOR {
-                for (auto e = start; e < stop; e++) {
-                    auto classNum = indices->e<Nd4jLong>(e);
-                    output->p<double>(e, gradOut->e<double>(classNum) * tempRes.e<double>(classNum) / input->e<double>(e));
-                }
-            };
-
-            samediff::Threads::parallel_for(func, 0, indices->lengthOf());
-        }
-        else {
-            auto restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), {0});
-
-            ResultSet listOfBPTensors = tempRes.allTensorsAlongDimension(restDims);
-            ResultSet listOfGradOuts = gradOut->allTensorsAlongDimension(restDims);
-            ResultSet listOfTensors = input->allTensorsAlongDimension(restDims);
-            ResultSet listOfOutTensors = output->allTensorsAlongDimension(restDims);
-
-            //auto func = PRAGMA_THREADS_FOR {
-                for (Nd4jLong i = 0; i < indices->lengthOf(); i++) {
-                    auto classNum = indices->e<Nd4jLong>(i);
-                    auto current = listOfTensors.at(i);
-                    auto currentOut = listOfOutTensors.at(i);
-                    auto currentGradOut = listOfGradOuts.at(classNum);
-                    auto currentFFOut = listOfBPTensors.at(classNum);
-
-                    currentOut->assign((*currentFFOut) * (*currentGradOut) / (*current));
-                }
-            //};
-
-            //samediff::Threads::parallel_for(func, 0, indices->lengthOf());
-        }
-
-        return Status::OK();
+        return segmentBP(SEGMENT_PROD, input, indices, gradOut, numOfClasses, output);
     }
 
-//    template <typename T>
     int unsortedSegmentSqrtNFunctorBP(sd::LaunchContext * context, NDArray* input, NDArray* indices, NDArray* gradOut, Nd4jLong numOfClasses, NDArray* output) {
-            MAP_IMPL<Nd4jLong, Nd4jLong> classCount;//(numClasses);
-
-        for (Nd4jLong count = 0; count < numOfClasses; ++count) {
-            classCount[count] = 0;
-        }
-
-        for (Nd4jLong e = 0; e < indices->lengthOf(); ++e) {
-            classCount[indices->e<Nd4jLong>(e)]++;
-        }
-
-        // if input is a vector: (as if in doc sample)
-        if (input->isVector()) {
-            //auto func = PRAGMA_THREADS_FOR {
-                for (Nd4jLong e = 0; e < indices->lengthOf(); e++) {
-                    auto classNum = indices->e<Nd4jLong>(e);
-                    output->p(e, gradOut->e<double>(classNum) / sd::math::nd4j_sqrt<double, double>(classCount[classNum]));
-                }
-            //};
-
-            //samediff::Threads::parallel_for(func, 0, indices->lengthOf());
-        }
-        else {
-            auto restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), {0});
-
-            ResultSet listOfGradOuts  =gradOut->allTensorsAlongDimension(restDims);
-            ResultSet listOfTensors  =input->allTensorsAlongDimension(restDims);
-            ResultSet listOfOutTensors  =output->allTensorsAlongDimension(restDims);
-
-            //auto func = PRAGMA_THREADS_FOR {
-                for (Nd4jLong i = 0; i < indices->lengthOf(); i++) {
-                    auto classNum = indices->e<Nd4jLong>(i);
-                    auto current = listOfTensors.at(i);
-                    auto currentOut = listOfOutTensors.at(i);
-                    auto currentGradOut = listOfGradOuts.at(classNum);
-
-                    for (int e = 0; e < current->lengthOf(); e++) {
-                        currentOut->p<double>(e, currentGradOut->e<double>(e) / sd::math::nd4j_sqrt<double, double>(classCount[classNum]));
-                    }
-                }
-            //};
-
-            //samediff::Threads::parallel_for(func, 0, indices->lengthOf());
-        }
-        return Status::OK();
+        return segmentBP(SEGMENT_SQRT_N, input, indices, gradOut, numOfClasses, output);
     }
 
 }
@@ -22,162 +22,243 @@
 #include <ops/declarable/headers/parity_ops.h>
 #include <array/NDArrayFactory.h>
 #include <execution/Threads.h>
+#include <helpers/ConstantTadHelper.h>
+#include <algorithm>
+#include <vector>
 
 namespace sd {
 namespace ops {
 namespace helpers {
 
+    // rows shorter than this are never split between threads
+    static const Nd4jLong TOP_K_SPLIT_THRESHOLD = 32768;
+
+    /**
+     * Value order used by top_k and in_top_k: NaN is greater than any other value and equal to another NaN,
+     * so comparison stays strict weak ordering for sorting and selection
+     */
+    template <typename T>
+    FORCEINLINE static bool topKGreater(const T a, const T b) {
+        // half types compare bits, so NaN check goes through float
+        const bool aNaN = sd::math::nd4j_isnan<float>(static_cast<float>(a));
+        const bool bNaN = sd::math::nd4j_isnan<float>(static_cast<float>(b));
+        if (aNaN || bNaN)
+            return aNaN && !bNaN;
+
+        return a > b;
+    }
+
+    /**
+     * Ranking used by top_k and in_top_k: greater value goes first, equal values are ordered by index
+     */
     template <typename T>
+    FORCEINLINE static bool topKBetter(const std::pair<T, Nd4jLong> &a, const std::pair<T, Nd4jLong> &b) {
+        if (topKGreater(a.first, b.first))
+            return true;
+
+        return !topKGreater(b.first, a.first) && a.second < b.second;
+    }
+
+    /**
+     * This function selects top min(k, to - from) elements of x[from, to) into buffer, order of selected elements is unspecified.
+     * Small k goes through bounded heap, with worst selected element on top of it, large k goes through quickselect.
+     * Buffer is reused between calls, so it allocates only when it grows
+     */
+    template <typename T>
+    static void topKSelect(const T *x, const Nd4jLong stride, const Nd4jLong from, const Nd4jLong to, const uint k, std::vector<std::pair<T, Nd4jLong>> &buffer) {
+        const Nd4jLong length = to - from;
+        const Nd4jLong kk = sd::math::nd4j_min<Nd4jLong>(k, length);
+
+        buffer.clear();
+
+        if (kk * 16 > length) {
+            for (Nd4jLong i = from; i < to; i++)
+                buffer.emplace_back(x[i * stride], i);
+
+            if (kk < length) {
+                std::nth_element(buffer.begin(), buffer.begin() + (kk - 1), buffer.end(), topKBetter<T>);
+                buffer.resize(kk);
+            }
+            return;
+        }
+
+        for (Nd4jLong i = from; i < from + kk; i++)
+            buffer.emplace_back(x[i * stride], i);
+        std::make_heap(buffer.begin(), buffer.end(), topKBetter<T>);
+
+        // elements come in ascending order of indices, so equal value never beats the one on top
+        for (Nd4jLong i = from + kk; i < to; i++) {
+            const T v = x[i * stride];
+            if (topKGreater(v, buffer.front().first)) {
+                std::pop_heap(buffer.begin(), buffer.end(), topKBetter<T>);
+                buffer.back() = std::make_pair(v, i);
+                std::push_heap(buffer.begin(), buffer.end(), topKBetter<T>);
+            }
+        }
+    }
+
+    template <typename T, typename I>
+    static void topKStore(std::vector<std::pair<T, Nd4jLong>> &selected, const bool needSort, T *z, const Nd4jLong zStride, I *idx, const Nd4jLong iStride) {
+        if (needSort)
+            std::sort(selected.begin(), selected.end(), topKBetter<T>);
+        else
+            std::sort(selected.begin(), selected.end(), [](const std::pair<T, Nd4jLong> &a, const std::pair<T, Nd4jLong> &b) { return a.second < b.second; });
+
+        for (size_t e = 0; e < selected.size(); e++) {
+            if (z != nullptr)
+                z[e * zStride] = selected[e].first;
+            if (idx != nullptr)
+                idx[e * iStride] = static_cast<I>(selected[e].second);
+        }
+    }
+
+    template <typename T, typename I>
     static int topKFunctor_(const NDArray* input, NDArray* values, NDArray* indices, const uint k, bool needSort) {
-        Nd4jLong width = input->sizeAt(-1);
-        int lastDim = input->rankOf() - 1;
-// ----------------------------------------------------------------------------------------------- //
-// this assumption is right:
-//        if (values->lengthOf() != k * lastDimList->size()) {
-//            nd4j_printf("top_k: something is wrong. %i expected, but %i given.\n",
-//                values->lengthOf(), k * lastDimList->size());
-//        }
-// ----------------------------------------------------------------------------------------------- //
-        std::vector<int> dimsToExclude(input->rankOf() - 1);
-        for (size_t d = 0; d < dimsToExclude.size(); ++d)
-            dimsToExclude[d] = d;
+        const Nd4jLong width = input->sizeAt(-1);
+        const int lastDim = input->rankOf() - 1;
+
+        auto packX = ConstantTadHelper::getInstance().tadForDimensions(input->shapeInfo(), lastDim);
+        auto packV = values != nullptr ? ConstantTadHelper::getInstance().tadForDimensions(values->shapeInfo(), lastDim) : packX;
+        auto packI = indices != nullptr ? ConstantTadHelper::getInstance().tadForDimensions(indices->shapeInfo(), lastDim) : packX;
+
+        const Nd4jLong numOfRows = packX.numberOfTads();
+        const Nd4jLong xStride = input->strideAt(-1);
+        const Nd4jLong vStride = values != nullptr ? values->strideAt(-1) : 0;
+        const Nd4jLong iStride = indices != nullptr ? indices->strideAt(-1) : 0;
+
+        auto x = input->bufferAsT<T>();
+        auto xOffsets = packX.primaryOffsets();
+        auto vOffsets = packV.primaryOffsets();
+        auto iOffsets = packI.primaryOffsets();
 
-        const Nd4jLong numOfSubArrs = ShapeUtils::getNumOfSubArrs(input->shapeInfo(), dimsToExclude);
+        auto zRow = [&](Nd4jLong e) -> T* { return values != nullptr ? values->bufferAsT<T>() + vOffsets[e] : nullptr; };
+        auto iRow = [&](Nd4jLong e) -> I* { return indices != nullptr ? indices->bufferAsT<I>() + iOffsets[e] : nullptr; };
 
-            if (k == 1) {
-                for (Nd4jLong e = 0; e < numOfSubArrs; ++e) {
-                    auto trial = (*input)(e, dimsToExclude);
-                    //int maxPos = //lastDimList->at(e)->argMax();
+        if (k == 1) {
+            auto func = PRAGMA_THREADS_FOR {
+                for (auto e = start; e < stop; e++) {
+                    auto row = x + xOffsets[e];
                     Nd4jLong maxPos = 0;
-                    //trial.printIndexedBuffer("TRIAL:");
-                    T maxVal = trial.e<T>(0);
-                    for (Nd4jLong pos = 1; pos < trial.lengthOf(); pos++)
-                        if (maxVal < trial.e<T>(pos)) {
+                    T maxVal = row[0];
+                    for (Nd4jLong pos = 1; pos < width; pos++)
+                        if (topKGreater(row[pos * xStride], maxVal)) {
                             maxPos = pos;
-                            maxVal = trial.e<T>(pos);
+                            maxVal = row[pos * xStride];
                         }
-                    if (indices)
-                        indices->p(e, maxPos); //topIndex;
-                    if (values)
-                        values->p(e, maxVal);
+
+                    if (values != nullptr)
+                        *zRow(e) = maxVal;
+                    if (indices != nullptr)
+                        *iRow(e) = static_cast<I>(maxPos);
                 }
-            }
-            else {
-                int nextPos = 0;
-
-                for (Nd4jLong e = 0; e < numOfSubArrs; ++e) {
-                    auto trial = (*input)(e, dimsToExclude);
-
-                    // fill up the first k elements
-                    NDArray topValues = NDArrayFactory::create<T>('c', {k}, input->getContext());
-                    NDArray sortedVals = NDArrayFactory::create<T>('c', {k}, input->getContext());
-                    NDArray topIndices = NDArrayFactory::create<Nd4jLong>('c', {k}, input->getContext());
-                    for (uint pos = 0; pos < k; ++pos) {
-                        topIndices.r<Nd4jLong>(pos) = pos;
-                        topValues.r<T>(pos) = trial.t<T>(pos);
-                    }
-                    //std::vector<T> sortedVals(topValues);
-                    sortedVals.assign(topValues);// = NDArrayFactory::create<T>('c', {k});
-                    //std::sort(sortedVals.begin(), sortedVals.end()); // sorted in ascending order
-                    SpecialMethods<T>::sortGeneric(sortedVals.buffer(), sortedVals.shapeInfo(), false);
-                    for (Nd4jLong i = static_cast<Nd4jLong>(k); i < width; ++i) {
-                        T val = trial.e<T>(i);
-                        T minTopVal = sortedVals.t<T>(0);
-                        if (minTopVal < val) { // value should be inserted to top k
-                            // only if it is not contained in
-                            T* begin = reinterpret_cast<T*>(sortedVals.buffer());
-                            T* end = begin + k;
-                            bool exists = std::binary_search(begin, end, val);
-                            if (!exists) {
-                                //exchangePos - a distance between begin and minimal existed to be suppressed by val
-                                T* topBegin = reinterpret_cast<T*>(topValues.buffer());
-                                T* topEnd = topBegin + k;
-                                auto exchangePos = std::distance(topBegin, std::find(topBegin, topEnd, sortedVals.t<T>(0)));
-                                topValues.r<T>(exchangePos) = val; //*exchangeIt = val;
-                                topIndices.r<Nd4jLong>(exchangePos) = i;
-                                sortedVals.r<T>(0) = val; // suppress in sorted
-                                //std::sort(sortedVals.begin(), sortedVals.end()); // sorted in ascending order
-                                SpecialMethods<T>::sortGeneric(sortedVals.buffer(), sortedVals.shapeInfo(), false);
-                            }
-                        }
-                    }
-                    if (needSort) {
-                        SpecialMethods<T>::sortGeneric(topValues.buffer(), topValues.shapeInfo(), true);
+            };
 
-                        for (Nd4jLong j = 0; j < width; j++)
-                            for (uint pos = 0; pos < k; ++pos)
-                                if (topValues.t<T>(pos) == trial.t<T>(j))
-                                    topIndices.r<Nd4jLong>(pos) = j;
-                    }
-                    else { // else sort by indices
-                        std::map<Nd4jLong, T> sortValsMap;
-                        //std::vector<std::pair<int, T>> data(topValues.lengthOf());
-                        for (Nd4jLong e = 0; e < topValues.lengthOf(); ++e) {
-                            sortValsMap[topIndices.t<Nd4jLong>(e)] = topValues.t<T>(e);
-                        }
+            samediff::Threads::parallel_tad(func, 0, numOfRows);
+            return Status::OK();
+        }
 
-                        //std::sort(data.begin(), data.end(), [](std::pair<int, T> const& a, std::pair<int, T> const& b) {
-                        //    return a.first < b.first;
-                        //});
-                        Nd4jLong e = 0;
-                        for (auto it = sortValsMap.begin(); it != sortValsMap.end(); ++it, e++) {
-                            topIndices.r<Nd4jLong>(e) = it->first;
-                            topValues.r<T>(e) = it->second;
-                        }
+        const int numThreads = sd::Environment::getInstance().maxMasterThreads();
 
-                    }
-                    if (values)
-                    (*values)(e, dimsToExclude).assign(topValues);
-                    if (indices)
-                    (*indices)(e, dimsToExclude).assign(topIndices);
+        if (numOfRows >= numThreads || width < TOP_K_SPLIT_THRESHOLD) {
+            auto func = PRAGMA_THREADS_FOR {
+                // single buffer per thread, shared by all rows of this thread
+                std::vector<std::pair<T, Nd4jLong>> selected;
+                selected.reserve(k * 16 > width ? width : k);
+
+                for (auto e = start; e < stop; e++) {
+                    topKSelect<T>(x + xOffsets[e], xStride, 0, width, k, selected);
+                    topKStore<T, I>(selected, needSort, zRow(e), vStride, iRow(e), iStride);
                 }
-                //indices->printIndexedBuffer("Indices as is");
+            };
+
+            samediff::Threads::parallel_tad(func, 0, numOfRows);
+            return Status::OK();
         }
+
+        // few long rows: every row is split into chunks, top k of each chunk are selected in parallel, and then merged
+        const Nd4jLong numChunks = sd::math::nd4j_min<Nd4jLong>(numThreads, width / (k + 1) + 1);
+        const Nd4jLong chunkLength = (width + numChunks - 1) / numChunks;
+        std::vector<std::pair<T, Nd4jLong>> candidates(numChunks * k);
+        std::vector<Nd4jLong> candidatesLength(numChunks);
+        std::vector<std::pair<T, Nd4jLong>> selected;
+
+        for (Nd4jLong e = 0; e < numOfRows; e++) {
+            auto row = x + xOffsets[e];
+
+            auto func = PRAGMA_THREADS_FOR {
+                std::vector<std::pair<T, Nd4jLong>> local;
+                for (auto c = start; c < stop; c++) {
+                    const Nd4jLong from = c * chunkLength;
+                    const Nd4jLong to = sd::math::nd4j_min<Nd4jLong>(width, from + chunkLength);
+                    topKSelect<T>(row, xStride, from, sd::math::nd4j_max<Nd4jLong>(from, to), k, local);
+
+                    std::copy(local.begin(), local.end(), candidates.begin() + c * k);
+                    candidatesLength[c] = local.size();
+                }
+            };
+
+            samediff::Threads::parallel_for(func, 0, numChunks);
+
+            selected.clear();
+            for (Nd4jLong c = 0; c < numChunks; c++)
+                selected.insert(selected.end(), candidates.begin() + c * k, candidates.begin() + c * k + candidatesLength[c]);
+
+            std::nth_element(selected.begin(), selected.begin() + (k - 1), selected.end(), topKBetter<T>);
+            selected.resize(k);
+
+            topKStore<T, I>(selected, needSort, zRow(e), vStride, iRow(e), iStride);
+        }
+
         return Status::OK();
     }
 // ----------------------------------------------------------------------------------------------- //
 
     template <typename T>
     static int inTopKFunctor_(sd::LaunchContext* context, const NDArray* input, const NDArray* target, NDArray* result, const uint k) {
+        const Nd4jLong width = input->sizeAt(-1);
+        auto packX = ConstantTadHelper::getInstance().tadForDimensions(input->shapeInfo(), input->rankOf() - 1);
+        const Nd4jLong xStride = input->strideAt(-1);
+        auto x = input->bufferAsT<T>();
+        auto xOffsets = packX.primaryOffsets();
 
-            std::vector<Nd4jLong> shapeI(input->rankOf());
-            for (int i = 0; i < input->rankOf() - 1; i++)
-                shapeI[i] = input->sizeAt(i);
-            shapeI[input->rankOf() - 1] = k;
-            std::unique_ptr<NDArray> indices(NDArrayFactory::create_<Nd4jLong>(input->ordering(), shapeI, context));
-            NDArray* values = nullptr;
-            int status = topKFunctor(context, input, values, indices.get(), k, true);
-            result->assign(0);
-            if (status == ND4J_STATUS_OK) {
-                auto func = PRAGMA_THREADS_FOR {
-                    for (auto e = start; e < stop; e++) {
-                        bool found = false;
-                        for (uint j = 0; j < k; j++) {
-                            if (target->e<Nd4jLong>(e) == indices->e<Nd4jLong>(e * k + j)) {
-                                found = true;
-                                break;
-                            }
-                        }
-                        if (found)
-                            result->p<bool>(e, true);
+        // target is in top k if less than k elements are strictly greater than it, so ties with the k-th value count as hits, same as TF
+        auto func = PRAGMA_THREADS_FOR {
+            for (auto e = start; e < stop; e++) {
+                const auto t = target->e<Nd4jLong>(e);
+                bool found = false;
+
+                if (t >= 0 && t < width) {
+                    auto row = x + xOffsets[e];
+                    const T v = row[t * xStride];
+                    Nd4jLong before = 0;
+
+                    for (Nd4jLong j = 0; j < width && before < k; j++) {
+                        const T c = row[j * xStride];
+                        if (topKGreater(c, v))
+                            before++;
                     }
-                };
 
-                samediff::Threads::parallel_tad(func, 0, target->lengthOf());
+                    found = before < k;
+                }
+
+                result->p<bool>(e, found);
             }
-            return status;
+        };
 
+        samediff::Threads::parallel_tad(func, 0, target->lengthOf());
+        return Status::OK();
     }
 
         int topKFunctor(sd::LaunchContext * context, const NDArray* input, NDArray* values, NDArray* indices, const uint k, bool needSort) {
-            BUILD_SINGLE_SELECTOR(input->dataType(), return topKFunctor_, (input, values, indices, k, needSort), NUMERIC_TYPES);
+            auto indexType = indices != nullptr ? indices->dataType() : sd::DataType::INT64;
+            BUILD_DOUBLE_SELECTOR(input->dataType(), indexType, return topKFunctor_, (input, values, indices, k, needSort), NUMERIC_TYPES, INDEXING_TYPES);
         }
 
         int inTopKFunctor(sd::LaunchContext * context, const NDArray* input, const NDArray* target, NDArray* result, const uint k) {
             BUILD_SINGLE_SELECTOR(input->dataType(), return inTopKFunctor_, (context, input, target, result, k), NUMERIC_TYPES);
         }
 
-        BUILD_SINGLE_TEMPLATE(template int topKFunctor_, (const NDArray* input, NDArray* values, NDArray* indices, const uint k, bool needSort), NUMERIC_TYPES);
+        BUILD_DOUBLE_TEMPLATE(template int topKFunctor_, (const NDArray* input, NDArray* values, NDArray* indices, const uint k, bool needSort), NUMERIC_TYPES, INDEXING_TYPES);
         BUILD_SINGLE_TEMPLATE(template int inTopKFunctor_, (sd::LaunchContext * context, const NDArray* input, const NDArray* target, NDArray* result, const uint k), NUMERIC_TYPES);
 }
 }
@@ -145,8 +145,12 @@ namespace sd {
                 return std::move(tmp);
             }
 
-            int32_t thresholdEstimate(const NDArray &updates, const float threshold) {
-                return thresholdEstimate_(updates, threshold).e<int>(0);
+            Nd4jLong thresholdEstimate(const NDArray &updates, const float threshold) {
+                return thresholdEstimate_(updates, threshold).e<Nd4jLong>(0);
+            }
+
+            Nd4jLong thresholdEstimateVarint(const NDArray &updates, const float threshold, Nd4jLong limit) {
+                throw std::runtime_error("thresholdEstimateVarint: varint threshold encoding isn't supported on CUDA");
             }
 
             void thresholdEncode(NDArray &updates, NDArray &encoded, float threshold) {
@@ -31,6 +31,7 @@
 #include <ops/declarable/CustomOperations.h>
 #include<ops/declarable/helpers/transforms.h>
 #include <helpers/PointersManager.h>
+#include <helpers/MmulHelper.h>
 #include <array/NDArrayList.h>
 #include <iterator>
 
@@ -40,6 +41,59 @@ namespace helpers {
 
 
 
+//////////////////////////////////////////////////////////////////////////
+static void lstmBlockGates(NDArray& m, const NDArray* cLast, const NDArray* Wci, const NDArray* Wcf, const NDArray* Wco,
+                           NDArray* i, NDArray* c, NDArray* f, NDArray* o, NDArray* z, NDArray* h, NDArray* y, const std::vector<double>& params) {
+
+    // m - gates pre-activations [bS, 4*nOut], modified in place
+
+    const bool peephole            = (bool)params[0];        // if true, provide peephole connections
+    const double forgetBias        = params[1];
+    const double clippingCellValue = params[2];              // clipping value for ct, if it is not equal to zero, then cell state is clipped
+
+    const int nOut = cLast->sizeAt(1);
+
+    //Note: weights are ordered [inputGate, blockInput, forgetGate, outputGate] to match TF (TF code comments state [i,f,z/ci,o] but behaviour is [i,z,f,o])
+    auto zi = m({0,0, 0,        nOut});      	// z for input modulation gate, [bS, nOut]
+    auto zz = m({0,0, nOut,   2*nOut});         // z for block input, [bS, nOut]
+    auto zf = m({0,0, 2*nOut, 3*nOut});      	// z for forget gate, [bS, nOut]
+    auto zo = m({0,0, 3*nOut, 4*nOut});      	// z for output gate, [bS, nOut]
+
+    if(peephole) {                                              // add peephole connections: z  +  ct_1*Wc
+        zi += (*cLast) * (*Wci);       // add peephole connections to input gate
+        zf += (*cLast) * (*Wcf);       // add peephole connections to forget gate
+    }
+
+    // current sell state = ft*cLast + it*tanh(mmul(Wxc,xt) + mmul(Whc,ht_1) + bc
+    if(forgetBias != 0.0)
+        zf += forgetBias;
+
+    zz.applyTransform(transform::Tanh, *z);      //z = tanh(zz)
+    zi.applyTransform(transform::Sigmoid, *i);   //i = sigmoid(zi)
+    zf.applyTransform(transform::Sigmoid, *f);   //f = sigmoid(zf);
+
+    //cell state = blockInput .* inputGate + prevCellState .* forgetGate
+    z->applyPairwiseTransform(pairwise::Multiply, *i, *c);       //c = z * i
+    auto temp = (*f) * (*cLast);
+    *c += temp;                              //c = (i * z) + (zf * (*cLast))
+    c->applyTransform(transform::Tanh, *h);  //h = tanh(c)
+
+    // if clipping value is provided then cell state is clipped by this value prior to the cell output activation
+    if(clippingCellValue > 0.0)
+        c->applyScalar(scalar::LstmClip, clippingCellValue, *c);
+
+    if(peephole) {
+        // add peephole connections to output gate zot + ct*Wc
+        auto prod = *c * (*Wco);
+        zo += prod;
+    }
+    zo.applyTransform(transform::Sigmoid, *o);   // o = sigmoid(zo)
+
+    // current cell output = ot*tanh(ct)
+    c->applyTransform(transform::Tanh, *h);  //h = tanh(c)
+    o->applyPairwiseTransform(pairwise::Multiply, *h, *y);   //y = o * h
+}
+
 //////////////////////////////////////////////////////////////////////////
 void lstmCell(sd::LaunchContext * context, const NDArray* xt, const NDArray* ht_1, const NDArray* ct_1, const NDArray* Wx, const NDArray* Wh, const NDArray* Wc, const NDArray* Wp, const NDArray* b,
               NDArray* ht, NDArray* ct, const std::vector<double>& params) {
@@ -135,13 +189,6 @@ void lstmBlockCell(const NDArray* xt, const NDArray* cLast, const NDArray* yLast
     *    5: h (co) - Cell state, post tanh [bs, nOut]
     *    6: y (h)  - Current cell output [bS, nOut], time t
     */
-    const bool peephole            = (bool)params[0];        // if true, provide peephole connections
-    const double forgetBias        = params[1];
-    const double clippingCellValue = params[2];              // clipping value for ct, if it is not equal to zero, then cell state is clipped
-
-    const int bS   = xt->sizeAt(0);
-    const int nIn  = xt->sizeAt(1);
-    const int nOut = cLast->sizeAt(1);
 
     //Concat inputs: [xt, yt-1]: concat([bs,nIn],[bs,nOut]) -> [bs, (nIn+nOut)]
     NDArray concatOut(xt->ordering(), {xt->sizeAt(0), xt->sizeAt(1) + yLast->sizeAt(1)}, xt->dataType(), xt->getContext());
@@ -150,45 +197,20 @@ void lstmBlockCell(const NDArray* xt, const NDArray* cLast, const NDArray* yLast
     auto m = mmul(concatOut, *W);       // mmul: [bs, (nIn+nOut)] * [(nIn+nOut), 4*nOut] = [bs, 4*nOut]
     m += (*b);                          // addiRowVector
 
-    //Note: weights are ordered [inputGate, blockInput, forgetGate, outputGate] to match TF (TF code comments state [i,f,z/ci,o] but behaviour is [i,z,f,o])
-    auto zi = m({0,0, 0,        nOut});      	// z for input modulation gate, [bS, nOut]
-    auto zz = m({0,0, nOut,   2*nOut});         // z for block input, [bS, nOut]
-    auto zf = m({0,0, 2*nOut, 3*nOut});      	// z for forget gate, [bS, nOut]
-    auto zo = m({0,0, 3*nOut, 4*nOut});      	// z for output gate, [bS, nOut]
-
-    if(peephole) {                                              // add peephole connections: z  +  ct_1*Wc
-        zi += (*cLast) * (*Wci);       // add peephole connections to input gate
-        zf += (*cLast) * (*Wcf);       // add peephole connections to forget gate
-    }
-
-    // current sell state = ft*cLast + it*tanh(mmul(Wxc,xt) + mmul(Whc,ht_1) + bc
-    if(forgetBias != 0.0)
-        zf += forgetBias;
-
-    zz.applyTransform(transform::Tanh, *z);      //z = tanh(zz)
-    zi.applyTransform(transform::Sigmoid, *i);   //i = sigmoid(zi)
-    zf.applyTransform(transform::Sigmoid, *f);   //f = sigmoid(zf);
+    lstmBlockGates(m, cLast, Wci, Wcf, Wco, i, c, f, o, z, h, y, params);
+}
 
-    //cell state = blockInput .* inputGate + prevCellState .* forgetGate
-    z->applyPairwiseTransform(pairwise::Multiply, *i, *c);       //c = z * i
-    auto temp = (*f) * (*cLast);
-    *c += temp;                              //c = (i * z) + (zf * (*cLast))
-    c->applyTransform(transform::Tanh, *h);  //h = tanh(c)
+//////////////////////////////////////////////////////////////////////////
+void lstmBlockCellProjected(NDArray* xW, const NDArray* cLast, const NDArray* yLast,
+                            const NDArray* Wh, const NDArray* Wci, const NDArray* Wcf, const NDArray* Wco,
+                            NDArray* i, NDArray* c, NDArray* f, NDArray* o, NDArray* z, NDArray* h, NDArray* y, const std::vector<double>& params) {
 
-    // if clipping value is provided then cell state is clipped by this value prior to the cell output activation
-    if(clippingCellValue > 0.0)
-        c->applyScalar(scalar::LstmClip, clippingCellValue, *c);
+    // xW - input projection xt × Wx + b, [bS, 4*nOut], recurrent part is accumulated into it
+    // Wh - hidden-to-hidden part of concatenated weights, [nOut, 4*nOut]
 
-    if(peephole) {
-        // add peephole connections to output gate zot + ct*Wc
-        auto prod = *c * (*Wco);
-        zo += prod;
-    }
-    zo.applyTransform(transform::Sigmoid, *o);   // o = sigmoid(zo)
+    MmulHelper::mmul(yLast, Wh, xW, 1.0, 1.0);      // [bs, nOut] * [nOut, 4*nOut] = [bs, 4*nOut]
 
-    // current cell output = ot*tanh(ct)
-    c->applyTransform(transform::Tanh, *h);  //h = tanh(c)
-    o->applyPairwiseTransform(pairwise::Multiply, *h, *y);   //y = o * h
+    lstmBlockGates(*xW, cLast, Wci, Wcf, Wco, i, c, f, o, z, h, y, params);
 }
 
 
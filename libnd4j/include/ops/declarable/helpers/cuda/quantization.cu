@@ -0,0 +1,40 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// @author raver119@gmail.com
+//
+
+#include <ops/declarable/helpers/quantization.h>
+
+namespace sd {
+    namespace ops {
+        namespace helpers {
+
+            void quantizedMatmul(const NDArray &a, const QuantizationParams &aParams, const NDArray &b, const QuantizationParams &bParams, const NDArray *bias, const QuantizationParams *outParams, NDArray &output) {
+                throw std::runtime_error("quantizedMatmul: integer GEMM isn't supported on CUDA");
+            }
+
+            void quantizedConv2d(const NDArray &input, const QuantizationParams &inParams, const NDArray &weights, const QuantizationParams &wParams, const NDArray *bias, const QuantizationParams *outParams, NDArray &output, const int kH, const int kW, const int sH, const int sW, int pH, int pW, const int dH, const int dW, const int paddingMode, const int isNCHW, const int wFormat) {
+                throw std::runtime_error("quantizedConv2d: integer convolution isn't supported on CUDA");
+            }
+
+            void quantizedDepthwiseConv2d(const NDArray &input, const QuantizationParams &inParams, const NDArray &weights, const QuantizationParams &wParams, const NDArray *bias, const QuantizationParams *outParams, NDArray &output, const int kH, const int kW, const int sH, const int sW, int pH, int pW, const int dH, const int dW, const int paddingMode, const int isNCHW, const int wFormat) {
+                throw std::runtime_error("quantizedDepthwiseConv2d: integer convolution isn't supported on CUDA");
+            }
+        }
+    }
+}
@@ -45,29 +45,22 @@ namespace helpers {
 
 
 //////////////////////////////////////////////////////////////////////////
-void sruCell(sd::LaunchContext * context, const NDArray* x, const NDArray* c0, const NDArray* w, const NDArray* b, NDArray* h, NDArray* c) {
+// sru cell with input projection z = x × w already computed
+static void sruCellProjected(const NDArray* z, const NDArray* x, const NDArray* c0, const NDArray* b, NDArray* h, NDArray* c) {
 
-    // x   input [bS x inSize], bS - batch size, inSize - number of features
-    // c0  previous cell state c  [bS x inSize], that is at previous time step t-1
-    // w   weights [inSize x 3*inSize]
-    // b   biases [2*inSize]
-
-    // h   current cell output [bS x inSize], that is at current time step t
-    // c   current cell state  [bS x inSize], that is at current time step t
+    // z   input projection [bS x 3*inSize]
 
     const int inSize = x->sizeAt(1);           // inSize - number of features
 
-    auto z = mmul(*x, *w);               //  [bS x 3*inSize]
-
     // forget gate = sigmoid(x*Wf + bf)
-    auto f = sigmoid(z({0,0, inSize,   2*inSize}) + (*b)({0, inSize}));
+    auto f = sigmoid((*z)({0,0, inSize,   2*inSize}) + (*b)({0, inSize}));
 
     // reset gate = sigmoid(x*Wr + br)
-    auto r = sigmoid(z({0,0, 2*inSize, 3*inSize}) + (*b)({inSize, 2*inSize}));
+    auto r = sigmoid((*z)({0,0, 2*inSize, 3*inSize}) + (*b)({inSize, 2*inSize}));
 
     // ◦ means element-wise product or so called Hadamard product
     // current sell state = f◦c0 + (1 - f)◦(x*Wc)
-    c->assign(f * (*c0) + (1.f - f) * z({0, 0 ,0, inSize}) );
+    c->assign(f * (*c0) + (1.f - f) * (*z)({0, 0 ,0, inSize}) );
     // *c = f*(*c0 - z({},{0, inSize})) + z({{},{0, inSize}});
 
     // current cell output = r◦activation(c) + (1 - r)◦x
@@ -75,6 +68,22 @@ void sruCell(sd::LaunchContext * context, const NDArray* x, const NDArray* c0, c
     // *h = r * (activation<T>(c) - *x) + *x;
 }
 
+//////////////////////////////////////////////////////////////////////////
+void sruCell(sd::LaunchContext * context, const NDArray* x, const NDArray* c0, const NDArray* w, const NDArray* b, NDArray* h, NDArray* c) {
+
+    // x   input [bS x inSize], bS - batch size, inSize - number of features
+    // c0  previous cell state c  [bS x inSize], that is at previous time step t-1
+    // w   weights [inSize x 3*inSize]
+    // b   biases [2*inSize]
+
+    // h   current cell output [bS x inSize], that is at current time step t
+    // c   current cell state  [bS x inSize], that is at current time step t
+
+    auto z = mmul(*x, *w);               //  [bS x 3*inSize]
+
+    sruCellProjected(&z, x, c0, b, h, c);
+}
+
 //////////////////////////////////////////////////////////////////////////
 void sruTimeLoop(sd::LaunchContext * context, const NDArray* x, const NDArray* c0, const NDArray* w, const NDArray* b, NDArray* h, NDArray* c) {
 
@@ -88,7 +97,13 @@ void sruTimeLoop(sd::LaunchContext * context, const NDArray* x, const NDArray* c
 
     auto wT = w->transpose();                             // [3*inSize x inSize] -> [inSize x 3*inSize]
 
-    const int time  = x->sizeAt(2);
+    const int bS     = x->sizeAt(0);
+    const int inSize = x->sizeAt(1);
+    const int time   = x->sizeAt(2);
+
+    // input projection for all time steps at once: [time*bS x inSize] × [inSize x 3*inSize] = [time*bS x 3*inSize]
+    auto z = mmul(x->permute({2, 0, 1}).reshape('c', {time * bS, inSize}), wT);
+    auto zSet = z.reshape('c', {time, bS, 3 * inSize}, false).allTensorsAlongDimension({1, 2});     // sub-arrays with shape [bS x 3*inSize]
 
     NDArray ct_1(*c0);
 
@@ -99,12 +114,11 @@ void sruTimeLoop(sd::LaunchContext * context, const NDArray* x, const NDArray* c
         auto ht = (*h)({0,0, 0,0, t,t+1});
         auto ct = (*c)({0,0, 0,0, t,t+1});
 
-        helpers::sruCell(context, &xt, &ct_1, &wT, b,  &ht, &ct);
+        sruCellProjected(zSet.at(t), &xt, &ct_1, b,  &ht, &ct);
         ct_1.assign(ct);
     }
 }
 
-
 //////////////////////////////////////////////////////////////////////////
 template <typename T>
 __global__ static void sruBICuda(const void* vx,    const Nd4jLong* xShapeInfo,
@@ -0,0 +1,63 @@
+/*******************************************************************************
+ * Copyright (c) 2015-2018 Skymind, Inc.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+#ifndef LIBND4J_FUSED_ELEMENTWISE_H
+#define LIBND4J_FUSED_ELEMENTWISE_H
+
+#include <system/op_boilerplate.h>
+#include <array/NDArray.h>
+#include <vector>
+
+namespace sd {
+namespace ops {
+namespace helpers {
+
+    enum FusedStepKind {
+        FUSED_TRANSFORM_SAME = 0,
+        FUSED_TRANSFORM_FLOAT = 1,
+        FUSED_TRANSFORM_STRICT = 2,
+        FUSED_SCALAR = 3,
+        FUSED_PAIRWISE = 4,
+    };
+
+    /**
+     * Single legacy op within fused chain. All pointers refer to data of the same type as the chain itself
+     */
+    struct FusedStep {
+        FusedStepKind kind;
+        int opNum;
+
+        // scalar value for scalar steps, or contiguous buffer of the second operand for pairwise steps
+        const void *operand = nullptr;
+
+        // pairwise steps only: chain value is used as Y operand
+        bool reversed = false;
+
+        void *extraParams = nullptr;
+    };
+
+    /**
+     * This method applies given steps to the input one after another, in a single pass over memory:
+     * each block of elements goes through the whole chain while it's still in cache.
+     * Input, output and all pairwise operands must have the same floating point type, length and contiguous layout
+     */
+    ND4J_EXPORT void fusedElementwise(sd::LaunchContext *context, const std::vector<FusedStep> &steps, const NDArray &input, NDArray &output);
+
+}
+}
+}
+
+#endif //LIBND4J_FUSED_ELEMENTWISE_H
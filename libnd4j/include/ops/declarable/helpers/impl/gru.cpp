@@ -145,6 +145,39 @@ void gruCell(sd::LaunchContext * context, const NDArray* x, const NDArray* hI, c
     h->assign(u * *hI + (1.f - u) * c);
 }
 
+//////////////////////////////////////////////////////////////////////////
+// same as gruCell above, but input projection x × Wx + b is already computed
+static void gruCellProjected(const NDArray* xW, const NDArray* hI, const NDArray* Wh, NDArray* gates, NDArray* h) {
+
+    // xW       input projection [bS, 3*nOut]
+    // hI       previous cell output [bS, nOut], must not be the same array as h
+    // Wh       weights for h - [nOut, 3*nOut]
+
+    const int nOut = hI->sizeAt(1);
+
+    MmulHelper::mmul(hI, Wh, gates);                // [bS, nOut] × [nOut, 3*nOut] = [bS, 3*nOut]
+
+    NDArray ru = (*gates)({0,0, 0,2*nOut});             // [bS, 2*nOut]
+
+    NDArray r  = (*gates)({0,0, 0,nOut});               // [bS, nOut]
+    NDArray u  = (*gates)({0,0, nOut,2*nOut});          // [bS, nOut]
+    NDArray c  = (*gates)({0,0, 2*nOut,3*nOut});        // [bS, nOut]
+
+    // reset and update gates
+    ru += (*xW)({0,0, 0,2*nOut});
+    ru.applyTransform(transform::Sigmoid, ru);
+
+    // cell gate
+    c *= r;
+    c += (*xW)({0,0, 2*nOut, 3*nOut});
+    c.applyTransform(transform::Tanh, c);
+
+    // cell output, h = u * hI + (1 - u) * c = (hI - c) * u + c
+    hI->applyPairwiseTransform(pairwise::Subtract, c, *h);
+    *h *= u;
+    *h += c;
+}
+
 //////////////////////////////////////////////////////////////////////////
 void gruTimeLoop(sd::LaunchContext * context, const NDArray* x, const NDArray* hI, const NDArray* Wx, const NDArray* Wh, const NDArray* b, NDArray* h) {
 
@@ -160,16 +193,21 @@ void gruTimeLoop(sd::LaunchContext * context, const NDArray* x, const NDArray* h
 
     const int sL   = x->sizeAt(0);
     const int bS   = x->sizeAt(1);
+    const int nIn  = x->sizeAt(2);
     const int nOut = hI->sizeAt(1);
 
     NDArray gates(h->ordering(), {bS, 3*nOut}, h->dataType(), context);
 
-    auto xSet = x->allTensorsAlongDimension({1,2});       // sub-arrays with shape [bS, nIn]
-    auto hSet = h->allTensorsAlongDimension({1,2});       // sub-arrays with shape [bS, nOut]
+    // input projection for all time steps at once: [sL*bS, nIn] × [nIn, 3*nOut] = [sL*bS, 3*nOut]
+    auto xW = mmul(x->reshape('c', {sL*bS, nIn}), *Wx);
+    xW += *b;
+
+    auto xWSet = xW.reshape('c', {sL, bS, 3*nOut}, false).allTensorsAlongDimension({1,2});    // sub-arrays with shape [bS, 3*nOut]
+    auto hSet  = h->allTensorsAlongDimension({1,2});       // sub-arrays with shape [bS, nOut]
 
-    // time loop
+    // time loop, only recurrent part is left here
     for (int t = 0; t < sL; ++t)
-        gruCell(context, xSet.at(t), t == 0 ? hI : hSet.at(t-1), Wx, Wh, b, &gates, hSet.at(t));
+        gruCellProjected(xWSet.at(t), t == 0 ? hI : hSet.at(t-1), Wh, &gates, hSet.at(t));
 }
 
 //////////////////////////////////////////////////////////////////////////
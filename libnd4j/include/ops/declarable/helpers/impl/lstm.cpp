@@ -72,11 +72,20 @@ namespace sd {
                 auto c_t1 = const_cast<NDArray*>(c0);
                 auto y_t1 = const_cast<NDArray*>(y0);
 
+                // input projection for all time steps is single gemm: [seqLen*bS, nIn] × [nIn, 4*nOut] = [seqLen*bS, 4*nOut]
+                const auto Wx = (*W)({0,nIn,       0,0});        // input-to-hidden part of weights
+                const auto Wh = (*W)({nIn,nIn+nOut, 0,0});       // hidden-to-hidden part of weights
+
+                const std::vector<int> permut = dataFormat == 0 ? std::vector<int>({0, 1, 2}) : (dataFormat == 1 ? std::vector<int>({2, 0, 1}) : std::vector<int>({1, 0, 2}));
+                auto xTBS = xSeq->permute(permut);                    // [seqLen, bS, nIn]
+                auto xW = mmul(xTBS.reshape('c', {seqLen * bS, nIn}), Wx);
+                xW += *b;
+
+                auto xWSet = xW.reshape('c', {seqLen, bS, 4*nOut}, false).allTensorsAlongDimension({1, 2});       // sub-arrays with shape [bS, 4*nOut]
+
                 // loop through time steps
                 for (int t = 0; t < seqLen; ++t) {
 
-                    auto xt = timeSubset(xSeq, t, dataFormat);
-
                     auto it = timeSubset(iSeq, t, dataFormat);
                     auto ct = timeSubset(cSeq, t, dataFormat);
                     auto ft = timeSubset(fSeq, t, dataFormat);
@@ -85,7 +94,7 @@ namespace sd {
                     auto ht = timeSubset(hSeq, t, dataFormat);
                     auto yt = timeSubset(ySeq, t, dataFormat);
 
-                    helpers::lstmBlockCell(&xt, c_t1, y_t1, W, Wci, Wcf, Wco, b, &it, &ct, &ft, &ot, &zt, &ht, &yt, params);
+                    helpers::lstmBlockCellProjected(xWSet.at(t), c_t1, y_t1, &Wh, Wci, Wcf, Wco, &it, &ct, &ft, &ot, &zt, &ht, &yt, params);
 
                     if(t != 0) {
                         delete c_t1;
@@ -189,6 +189,73 @@ static FORCEINLINE int getBatchTimeTotalIndex(const int dataFormat, const int sL
     return b * sL + t;       // NTS, NST: shape [bS, sL, nIn], [bS, nIn, sL]
 }
 
+//////////////////////////////////////////////////////////////////////////
+// input projection for all time steps at once: x × Wx + b, [sL*bS, nIn] × [nIn, 4*nOut] = [sL*bS, 4*nOut]
+// rows are ordered the same way as getBatchTimeTotalIndex enumerates them
+static NDArray inputProjection(const NDArray* x, const NDArray* Wx, const NDArray* b, const int dataFormat) {
+
+    const Nd4jLong nIn = Wx->sizeAt(0);
+
+    auto x2 = dataFormat == 2 ? x->permute({0, 2, 1}).reshape('c', {-1, nIn}) : x->reshape('c', {-1, nIn});    // NST: [bS, nIn, sL] -> [bS, sL, nIn]
+
+    auto xW = mmul(x2, *Wx);
+
+    if(b != nullptr)
+        xW += *b;
+
+    return xW;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// same as lstmLayerCell, but input projection x × Wx + b is already computed, and gates are evaluated in preallocated z
+static void lstmLayerCellProjected(const NDArray* xW, const NDArray* Wr, const NDArray* hI, const NDArray* cI, const NDArray* Wp,
+                                   const std::vector<float>& params,
+                                   NDArray* z, NDArray* h, NDArray* c) {
+
+    // xW - input projection at time t, [bS, 4*nOut] or [4*nOut] if seqLen != nullptr
+    // z  - gates buffer, same shape as xW
+
+    const Nd4jLong nOut = Wr->sizeAt(-1) / 4;
+
+    z->assign(xW);
+    MmulHelper::mmul(hI, Wr, z, 1.0, 1.0);        // z += [bS, nOut] * [nOut, 4*nOut] = [bS, 4*nOut], or [nOut] * [nOut, 4*nOut] = [4*nOut]
+
+    const bool isVector = z->rankOf() == 1;
+
+    auto zif = isVector ? (*z)({0,      2*nOut}) : (*z)({0,0, 0,      2*nOut});      // input and forget gates, [bS, 2*nOut](or[2*nOut])
+    auto zi  = isVector ? (*z)({0,        nOut}) : (*z)({0,0, 0,        nOut});      // input gate it, [bS, nOut](or[nOut])
+    auto zf  = isVector ? (*z)({nOut,   2*nOut}) : (*z)({0,0, nOut,   2*nOut});      // forget gate ft, [bS, nOut](or[nOut])
+    auto zg  = isVector ? (*z)({2*nOut, 3*nOut}) : (*z)({0,0, 2*nOut, 3*nOut});      // cell gate c't, [bS, nOut](or[nOut])
+    auto zo  = isVector ? (*z)({3*nOut, 4*nOut}) : (*z)({0,0, 3*nOut, 4*nOut});      // output gate ot, [bS, nOut](or[nOut])
+
+    // peephole connections for input and forget gates
+    if(Wp != nullptr) {
+        zi += *cI * (*Wp)({0,      nOut});      // broadcast: [bS, nOut] + [bS, nOut] * [nOut] = [bS, nOut](or[nOut])
+        zf += *cI * (*Wp)({nOut, 2*nOut});      // broadcast: [bS, nOut] + [bS, nOut] * [nOut] = [bS, nOut](or[nOut])
+    }
+
+    applyActivation(zif, params[3], params[4], params[5], zif);  // input and forget gates share activation, inplace
+    applyActivation(zg,  params[6], params[7], params[8], zg);   // inplace
+
+    // c = f * cI + i * c', c may be the same array as cI
+    zf.applyPairwiseTransform(pairwise::Multiply, *cI, *c);
+    zi *= zg;
+    *c += zi;
+
+    // if clipping value is non-zero then cell state is clipped by this value prior to the cell output activation
+    if(params[2] != 0)
+        c->applyScalar(scalar::LstmClip, params[2], *c);
+
+    // peephole connections for output gate
+    if(Wp != nullptr)
+        zo += *c * (*Wp)({2*nOut, 3*nOut});    // broadcast: [bS, nOut] + [bS, nOut] * [nOut] = [bS, nOut](or[nOut])
+
+    applyActivation(zo, params[3], params[4], params[5], zo);
+
+    applyActivation(*c, params[9], params[10], params[11], *h);
+    *h *= zo;                               // [bS, nOut] * [bS, nOut](or[nOut])
+}
+
 
 //////////////////////////////////////////////////////////////////////////
 void lstmLayerCell(const NDArray* x, const NDArray* Wx, const NDArray* Wr,
@@ -639,23 +706,34 @@ void lstmLayerTimeLoop(const NDArray* x, const NDArray* Wx, const NDArray* Wr,
     if(!h && !hL)
         ht = new NDArray(x->ordering(), shapeOut, type, x->getContext());
 
+    // only recurrent part h × Wr stays in time loop, input projection is single gemm
+    auto xW = inputProjection(x, Wx, b, dataFormat);       // [sL*bS, 4*nOut]
+
     // create sets of required (depends on seqLen presence) sub-arrays
     std::vector<int> dims;
     ResultSet *xSet(nullptr), *hSet(nullptr), *h0Set(nullptr), *c0Set(nullptr), *htSet(nullptr), *ctSet(nullptr);
+    NDArray* z(nullptr);
 
     if(!seqLen) {
 
         dims = ShapeUtils::evalDimsToExclude(x->rankOf(), {dataFormat < 3 ? dataFormat : 0});    // points on bS and nIn/nOut axes
 
-        xSet = new ResultSet(x->allTensorsAlongDimension(dims));       // sub-arrays with shape [bS, nIn]
+        if(dataFormat == 0 || dataFormat == 3)
+            xSet = new ResultSet(xW.reshape('c', {sL, bS, 4*nOut}, false).allTensorsAlongDimension({1, 2}));    // sub-arrays with shape [bS, 4*nOut]
+        else
+            xSet = new ResultSet(xW.reshape('c', {bS, sL, 4*nOut}, false).allTensorsAlongDimension({0, 2}));    // sub-arrays with shape [bS, 4*nOut]
+
         if(h)
             hSet = new ResultSet(h->allTensorsAlongDimension(dims));   // sub-arrays with shape [bS, nOut]
+
+        z = new NDArray('c', {bS, 4*nOut}, type, x->getContext());
     }
     else {
 
         dims = dataFormat == 2 ? std::vector<int>({1}) : std::vector<int>({2});    // points on nIn/nOut axis
 
-        xSet  = new ResultSet(x->allTensorsAlongDimension(dims));               //  sub-arrays with shape [nIn]
+        xSet  = new ResultSet(xW.allTensorsAlongDimension({1}));                //  sub-arrays with shape [4*nOut]
+        z = new NDArray('c', {4*nOut}, type, x->getContext());
         h0Set = new ResultSet(h0->allTensorsAlongDimension({1}));              //  sub-arrays with shape [nOut]
         c0Set = new ResultSet(c0->allTensorsAlongDimension({1}));              //  sub-arrays with shape [nOut]
         ctSet = new ResultSet(ct->allTensorsAlongDimension({1}));              //  sub-arrays with shape [nOut]
@@ -672,15 +750,15 @@ void lstmLayerTimeLoop(const NDArray* x, const NDArray* Wx, const NDArray* Wr,
 
             if(!h) {    // seqLen and h are absent
 
-                lstmLayerCell(xSet->at(0), Wx, Wr, b, h0, c0, Wp, params, ht, ct); // first time step
+                lstmLayerCellProjected(xSet->at(0), Wr, h0, c0, Wp, params, z, ht, ct); // first time step
                 for (Nd4jLong t = 1; t < sL; ++t)
-                    lstmLayerCell(xSet->at(t), Wx, Wr, b, ht, ct, Wp, params, ht, ct); // rest time steps
+                    lstmLayerCellProjected(xSet->at(t), Wr, ht, ct, Wp, params, z, ht, ct); // rest time steps
             }
             else {      // seqLen is absent and h is present
 
-                lstmLayerCell(xSet->at(0), Wx, Wr, b, h0, c0, Wp, params, hSet->at(0), ct); // first time step
+                lstmLayerCellProjected(xSet->at(0), Wr, h0, c0, Wp, params, z, hSet->at(0), ct); // first time step
                 for (Nd4jLong t = 1; t < sL; ++t)
-                    lstmLayerCell(xSet->at(t), Wx, Wr, b, hSet->at(t - 1), ct, Wp, params, hSet->at(t), ct); // rest time steps
+                    lstmLayerCellProjected(xSet->at(t), Wr, hSet->at(t - 1), ct, Wp, params, z, hSet->at(t), ct); // rest time steps
 
                 if(hL)
                     hL->assign(hSet->at(sL - 1));     // assign last output to hL if it is not nullptr
@@ -703,11 +781,11 @@ void lstmLayerTimeLoop(const NDArray* x, const NDArray* Wx, const NDArray* Wr,
                     }
 
                     auto ind = getBatchTimeTotalIndex(dataFormat, sL, bS, 0, e);
-                    lstmLayerCell(xSet->at(ind), Wx, Wr, b, h0Set->at(e), c0Set->at(e), Wp, params, htSet->at(e), ctSet->at(e)); // first time step
+                    lstmLayerCellProjected(xSet->at(ind), Wr, h0Set->at(e), c0Set->at(e), Wp, params, z, htSet->at(e), ctSet->at(e)); // first time step
 
                     for (int t = 1; t < limit; ++t) {
                         ind = getBatchTimeTotalIndex(dataFormat, sL, bS, t, e);
-                        lstmLayerCell(xSet->at(ind), Wx, Wr, b, htSet->at(e), ctSet->at(e), Wp, params, htSet->at(e), ctSet->at(e)); // rest time steps
+                        lstmLayerCellProjected(xSet->at(ind), Wr, htSet->at(e), ctSet->at(e), Wp, params, z, htSet->at(e), ctSet->at(e)); // rest time steps
                     }
                 }
             }
@@ -730,11 +808,11 @@ void lstmLayerTimeLoop(const NDArray* x, const NDArray* Wx, const NDArray* Wr,
                     }
 
                     auto indPrev = getBatchTimeTotalIndex(dataFormat, sL, bS, 0, e);
-                    lstmLayerCell(xSet->at(indPrev), Wx, Wr, b, h0Set->at(e), c0Set->at(e), Wp, params, hSet->at(indPrev), ctSet->at(e)); // first time step
+                    lstmLayerCellProjected(xSet->at(indPrev), Wr, h0Set->at(e), c0Set->at(e), Wp, params, z, hSet->at(indPrev), ctSet->at(e)); // first time step
 
                     for (int t = 1; t < limit; ++t) {
                         auto indCurr = getBatchTimeTotalIndex(dataFormat, sL, bS, t, e);
-                        lstmLayerCell(xSet->at(indCurr), Wx, Wr, b, hSet->at(indPrev), ctSet->at(e), Wp, params, hSet->at(indCurr), ctSet->at(e)); // rest time steps
+                        lstmLayerCellProjected(xSet->at(indCurr), Wr, hSet->at(indPrev), ctSet->at(e), Wp, params, z, hSet->at(indCurr), ctSet->at(e)); // rest time steps
                         indPrev = indCurr;
                     }
 
@@ -753,15 +831,15 @@ void lstmLayerTimeLoop(const NDArray* x, const NDArray* Wx, const NDArray* Wr,
 
             if(!h) {    // seqLen and h are absent
 
-                lstmLayerCell(xSet->at(sL - 1), Wx, Wr, b, h0, c0, Wp, params, ht, ct); // first time step
+                lstmLayerCellProjected(xSet->at(sL - 1), Wr, h0, c0, Wp, params, z, ht, ct); // first time step
                 for (Nd4jLong t = sL - 2; t >= 0; --t)
-                    lstmLayerCell(xSet->at(t), Wx, Wr, b, ht, ct, Wp, params, ht, ct); // rest time steps
+                    lstmLayerCellProjected(xSet->at(t), Wr, ht, ct, Wp, params, z, ht, ct); // rest time steps
             }
             else {  // seqLen is absent and h is present
 
-                lstmLayerCell(xSet->at(sL - 1), Wx, Wr, b, h0, c0, Wp, params, hSet->at(sL - 1), ct); // first time step
+                lstmLayerCellProjected(xSet->at(sL - 1), Wr, h0, c0, Wp, params, z, hSet->at(sL - 1), ct); // first time step
                 for (Nd4jLong t = sL - 2; t >= 0; --t)
-                    lstmLayerCell(xSet->at(t), Wx, Wr, b, hSet->at(t + 1), ct, Wp, params, hSet->at(t), ct); // rest time steps
+                    lstmLayerCellProjected(xSet->at(t), Wr, hSet->at(t + 1), ct, Wp, params, z, hSet->at(t), ct); // rest time steps
 
                 if(hL)
                     hL->assign(hSet->at(0));     // assign last output to hL if it is not nullptr
@@ -784,11 +862,11 @@ void lstmLayerTimeLoop(const NDArray* x, const NDArray* Wx, const NDArray* Wr,
                     }
 
                     auto ind = getBatchTimeTotalIndex(dataFormat, sL, bS, sL - 1, e);
-                    lstmLayerCell(xSet->at(ind), Wx, Wr, b, h0Set->at(e), c0Set->at(e), Wp, params, htSet->at(e), ctSet->at(e)); // first time step
+                    lstmLayerCellProjected(xSet->at(ind), Wr, h0Set->at(e), c0Set->at(e), Wp, params, z, htSet->at(e), ctSet->at(e)); // first time step
 
                     for (Nd4jLong t = sL - 2; t >= sL - limit; --t) {
                         ind = getBatchTimeTotalIndex(dataFormat, sL, bS, t, e);
-                        lstmLayerCell(xSet->at(ind), Wx, Wr, b, htSet->at(e), ctSet->at(e), Wp, params, htSet->at(e), ctSet->at(e)); // rest time steps
+                        lstmLayerCellProjected(xSet->at(ind), Wr, htSet->at(e), ctSet->at(e), Wp, params, z, htSet->at(e), ctSet->at(e)); // rest time steps
                     }
                 }
             }
@@ -811,11 +889,11 @@ void lstmLayerTimeLoop(const NDArray* x, const NDArray* Wx, const NDArray* Wr,
                     }
 
                     auto indPrev = getBatchTimeTotalIndex(dataFormat, sL, bS, sL - 1, e);
-                    lstmLayerCell(xSet->at(indPrev), Wx, Wr, b, h0Set->at(e), c0Set->at(e), Wp, params, hSet->at(indPrev), ctSet->at(e)); // first time step
+                    lstmLayerCellProjected(xSet->at(indPrev), Wr, h0Set->at(e), c0Set->at(e), Wp, params, z, hSet->at(indPrev), ctSet->at(e)); // first time step
 
                     for (Nd4jLong t = sL - 2; t >= sL - limit; --t) {
                         auto indCurr = getBatchTimeTotalIndex(dataFormat, sL, bS, t, e);
-                        lstmLayerCell(xSet->at(indCurr), Wx, Wr, b, hSet->at(indPrev), ctSet->at(e), Wp, params, hSet->at(indCurr), ctSet->at(e)); // rest time steps
+                        lstmLayerCellProjected(xSet->at(indCurr), Wr, hSet->at(indPrev), ctSet->at(e), Wp, params, z, hSet->at(indCurr), ctSet->at(e)); // rest time steps
                         indPrev = indCurr;
                     }
 
@@ -844,11 +922,11 @@ void lstmLayerTimeLoop(const NDArray* x, const NDArray* Wx, const NDArray* Wr,
                     }
 
                     auto ind = getBatchTimeTotalIndex(dataFormat, sL, bS, limit - 1, e);
-                    lstmLayerCell(xSet->at(ind), Wx, Wr, b, h0Set->at(e), c0Set->at(e), Wp, params, htSet->at(e), ctSet->at(e)); // first time step
+                    lstmLayerCellProjected(xSet->at(ind), Wr, h0Set->at(e), c0Set->at(e), Wp, params, z, htSet->at(e), ctSet->at(e)); // first time step
 
                     for (int t = limit - 2; t >= 0; --t) {
                         ind = getBatchTimeTotalIndex(dataFormat, sL, bS, t, e);
-                        lstmLayerCell(xSet->at(ind), Wx, Wr, b, htSet->at(e), ctSet->at(e), Wp, params, htSet->at(e), ctSet->at(e)); // rest time steps
+                        lstmLayerCellProjected(xSet->at(ind), Wr, htSet->at(e), ctSet->at(e), Wp, params, z, htSet->at(e), ctSet->at(e)); // rest time steps
                     }
                 }
             }
@@ -871,11 +949,11 @@ void lstmLayerTimeLoop(const NDArray* x, const NDArray* Wx, const NDArray* Wr,
                     }
 
                     auto indPrev = getBatchTimeTotalIndex(dataFormat, sL, bS, limit - 1, e);
-                    lstmLayerCell(xSet->at(indPrev), Wx, Wr, b, h0Set->at(e), c0Set->at(e), Wp, params, hSet->at(indPrev), ctSet->at(e)); // first time step
+                    lstmLayerCellProjected(xSet->at(indPrev), Wr, h0Set->at(e), c0Set->at(e), Wp, params, z, hSet->at(indPrev), ctSet->at(e)); // first time step
 
                     for (int t = limit - 2; t >= 0; --t) {
                         auto indCurr = getBatchTimeTotalIndex(dataFormat, sL, bS, t, e);
-                        lstmLayerCell(xSet->at(indCurr), Wx, Wr, b, hSet->at(indPrev), ctSet->at(e), Wp, params, hSet->at(indCurr), ctSet->at(e)); // rest time steps
+                        lstmLayerCellProjected(xSet->at(indCurr), Wr, hSet->at(indPrev), ctSet->at(e), Wp, params, z, hSet->at(indCurr), ctSet->at(e)); // rest time steps
                         indPrev = indCurr;
                     }
 
@@ -895,6 +973,7 @@ void lstmLayerTimeLoop(const NDArray* x, const NDArray* Wx, const NDArray* Wr,
     delete c0Set;
     delete htSet;
     delete ctSet;
+    delete z;
 
     if(!hI)
         delete h0;
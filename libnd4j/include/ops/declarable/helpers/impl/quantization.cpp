@@ -0,0 +1,164 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// @author raver119@gmail.com
+//
+
+#include <ops/declarable/helpers/quantization.h>
+#include <execution/Threads.h>
+#include <helpers/ShapeUtils.h>
+#include <cmath>
+#include <limits>
+
+namespace sd {
+    namespace ops {
+        namespace helpers {
+
+            QuantizationParams::QuantizationParams(const NDArray &scale, const NDArray &zeroPoint) {
+                scales.resize(scale.lengthOf());
+                zeroPoints.resize(zeroPoint.lengthOf());
+
+                for (Nd4jLong e = 0; e < scale.lengthOf(); e++)
+                    scales[e] = scale.e<float>(e);
+
+                for (Nd4jLong e = 0; e < zeroPoint.lengthOf(); e++)
+                    zeroPoints[e] = zeroPoint.e<int>(e);
+            }
+
+            /**
+             * Maps logical index of element to index of its channel along given axis
+             */
+            struct ChannelIndex {
+                Nd4jLong inner = 1;
+                Nd4jLong channels = 1;
+
+                ChannelIndex(const NDArray &array, const QuantizationParams &params, const int axis) {
+                    if (params.length() == 1)
+                        return;
+
+                    channels = array.sizeAt(axis);
+                    for (int e = axis + 1; e < array.rankOf(); e++)
+                        inner *= array.sizeAt(e);
+                }
+
+                FORCEINLINE Nd4jLong operator()(const Nd4jLong index) const {
+                    return (index / inner) % channels;
+                }
+            };
+
+            template <typename X, typename Z>
+            static void quantizeLinear_(const NDArray &input, const QuantizationParams &params, const int axis, NDArray &output) {
+                auto x = input.bufferAsT<X>();
+                auto z = output.bufferAsT<Z>();
+                const ChannelIndex channel(input, params, axis);
+
+                const float qMin = static_cast<float>(std::numeric_limits<Z>::min());
+                const float qMax = static_cast<float>(std::numeric_limits<Z>::max());
+                const bool direct = input.ews() == 1 && output.ews() == 1 && input.ordering() == 'c' && output.ordering() == 'c';
+
+                auto func = PRAGMA_THREADS_FOR {
+                    for (auto i = start; i < stop; i++) {
+                        const auto c = channel(i);
+                        const auto xOffset = direct ? i : shape::getIndexOffset(i, input.shapeInfo());
+                        const auto zOffset = direct ? i : shape::getIndexOffset(i, output.shapeInfo());
+
+                        // round half to even, same as ONNX QuantizeLinear
+                        float q = std::nearbyint(static_cast<float>(x[xOffset]) / params.scale(c)) + static_cast<float>(params.zeroPoint(c));
+                        z[zOffset] = static_cast<Z>(q < qMin ? qMin : q > qMax ? qMax : q);
+                    }
+                };
+
+                samediff::Threads::parallel_for(func, 0, input.lengthOf());
+            }
+
+            template <typename X, typename Z>
+            static void dequantizeLinear_(const NDArray &input, const QuantizationParams &params, const int axis, NDArray &output) {
+                auto x = input.bufferAsT<X>();
+                auto z = output.bufferAsT<Z>();
+                const ChannelIndex channel(input, params, axis);
+                const bool direct = input.ews() == 1 && output.ews() == 1 && input.ordering() == 'c' && output.ordering() == 'c';
+
+                auto func = PRAGMA_THREADS_FOR {
+                    for (auto i = start; i < stop; i++) {
+                        const auto c = channel(i);
+                        const auto xOffset = direct ? i : shape::getIndexOffset(i, input.shapeInfo());
+                        const auto zOffset = direct ? i : shape::getIndexOffset(i, output.shapeInfo());
+
+                        z[zOffset] = static_cast<Z>(params.scale(c) * static_cast<float>(static_cast<int>(x[xOffset]) - params.zeroPoint(c)));
+                    }
+                };
+
+                samediff::Threads::parallel_for(func, 0, input.lengthOf());
+            }
+
+            void quantizeLinear(const NDArray &input, const QuantizationParams &params, const int axis, NDArray &output) {
+                NDArray::preparePrimaryUse({&output}, {&input});
+
+                BUILD_DOUBLE_SELECTOR(input.dataType(), output.dataType(), quantizeLinear_, (input, params, axis, output), FLOAT_TYPES, QUANTIZED_TYPES);
+
+                NDArray::registerPrimaryUse({&output}, {&input});
+            }
+
+            void dequantizeLinear(const NDArray &input, const QuantizationParams &params, const int axis, NDArray &output) {
+                NDArray::preparePrimaryUse({&output}, {&input});
+
+                BUILD_DOUBLE_SELECTOR(input.dataType(), output.dataType(), dequantizeLinear_, (input, params, axis, output), QUANTIZED_TYPES, FLOAT_TYPES);
+
+                NDArray::registerPrimaryUse({&output}, {&input});
+            }
+
+            void quantizationRange(const NDArray &input, const NDArray *range, const float momentum, NDArray &outRange, NDArray &scale, NDArray &zeroPoint) {
+                float lo = input.reduceNumber(reduce::Min).e<float>(0);
+                float hi = input.reduceNumber(reduce::Max).e<float>(0);
+
+                if (range != nullptr) {
+                    const float rLo = range->e<float>(0);
+                    const float rHi = range->e<float>(1);
+
+                    if (momentum > 0.f) {
+                        lo = momentum * rLo + (1.f - momentum) * lo;
+                        hi = momentum * rHi + (1.f - momentum) * hi;
+                    } else {
+                        lo = sd::math::nd4j_min<float>(lo, rLo);
+                        hi = sd::math::nd4j_max<float>(hi, rHi);
+                    }
+                }
+
+                outRange.p(0, lo);
+                outRange.p(1, hi);
+
+                // zero must be exactly representable, so range always includes it
+                lo = sd::math::nd4j_min<float>(lo, 0.f);
+                hi = sd::math::nd4j_max<float>(hi, 0.f);
+
+                float s;
+                int zp;
+                if (zeroPoint.dataType() == DataType::INT8) {
+                    s = sd::math::nd4j_max<float>(-lo, hi) / 127.f;
+                    zp = 0;
+                } else {
+                    s = (hi - lo) / 255.f;
+                    zp = s > 0.f ? static_cast<int>(std::nearbyint(-lo / s)) : 0;
+                    zp = sd::math::nd4j_min<int>(255, sd::math::nd4j_max<int>(0, zp));
+                }
+
+                scale.p(0, s > 0.f ? s : 1.f);
+                zeroPoint.p(0, zp);
+            }
+        }
+    }
+}
@@ -69,6 +69,11 @@ namespace helpers {
                        const NDArray* W, const NDArray* Wci, const NDArray* Wcf, const NDArray* Wco, const NDArray* b,
                        NDArray* i, NDArray* c, NDArray* f, NDArray* o, NDArray* z, NDArray* h, NDArray* y, const std::vector<double>& params);
 
+    // same as lstmBlockCell, with input part of projection (xt × Wx + b) already computed into xW, xW is overwritten
+    void lstmBlockCellProjected(NDArray* xW, const NDArray* cLast, const NDArray* yLast,
+                                const NDArray* Wh, const NDArray* Wci, const NDArray* Wcf, const NDArray* Wco,
+                                NDArray* i, NDArray* c, NDArray* f, NDArray* o, NDArray* z, NDArray* h, NDArray* y, const std::vector<double>& params);
+
 
 
 }
@@ -0,0 +1,177 @@
+/*******************************************************************************
+ * Copyright (c) 2020 Konduit K.K.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// @author raver119@gmail.com
+//
+
+#ifndef SD_HELPERS_QUANTIZATION_H
+#define SD_HELPERS_QUANTIZATION_H
+
+#include <system/op_boilerplate.h>
+#include <array/NDArray.h>
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace sd {
+    namespace ops {
+        namespace helpers {
+
+            /**
+             * Affine quantization parameters: real = scale * (q - zeroPoint). There's either one pair for whole tensor,
+             * or one pair per channel
+             */
+            struct QuantizationParams {
+                std::vector<float> scales;
+                std::vector<int> zeroPoints;
+
+                QuantizationParams() = default;
+                QuantizationParams(const NDArray &scale, const NDArray &zeroPoint);
+
+                FORCEINLINE Nd4jLong length() const {
+                    return (Nd4jLong) std::max(scales.size(), zeroPoints.size());
+                }
+
+                FORCEINLINE float scale(const Nd4jLong channel) const {
+                    return scales.size() == 1 ? scales[0] : scales[channel];
+                }
+
+                FORCEINLINE int zeroPoint(const Nd4jLong channel) const {
+                    return zeroPoints.size() == 1 ? zeroPoints[0] : zeroPoints[channel];
+                }
+
+                /**
+                 * Scales and zero points are both non-empty, and each of them holds either single value or one value per channel
+                 */
+                FORCEINLINE bool isValid(const Nd4jLong channels) const {
+                    return !scales.empty() && !zeroPoints.empty()
+                           && (scales.size() == 1 || (Nd4jLong) scales.size() == channels)
+                           && (zeroPoints.size() == 1 || (Nd4jLong) zeroPoints.size() == channels);
+                }
+
+                /**
+                 * Zero points are representable by quantized data type: [-128, 127] for INT8, [0, 255] for UINT8
+                 */
+                FORCEINLINE bool zeroPointsFit(const sd::DataType dataType) const {
+                    const int lo = dataType == sd::DataType::INT8 ? -128 : 0;
+                    const int hi = dataType == sd::DataType::INT8 ? 127 : 255;
+
+                    for (auto zp : zeroPoints)
+                        if (zp < lo || zp > hi)
+                            return false;
+
+                    return true;
+                }
+            };
+
+            /**
+             * This class holds zero-point adjusted int16 weights packed for integer GEMM/depthwise kernels, so repeated calls
+             * with the same weights don't pack them again. Entries are looked up by unique id of weights buffer and its write
+             * generation, so in-place updates of weights or reuse of freed memory never produce stale results
+             */
+            class ND4J_EXPORT QuantizedWeightsCache {
+            public:
+                enum Layout {
+                    MATMUL = 0,
+                    CONV2D = 1,
+                    DEPTHWISE_CONV2D = 2,
+                };
+
+                struct Key {
+                    Nd4jLong bufferId;
+                    Nd4jLong generation;
+                    Nd4jLong offset;
+                    int layout;
+                    int wFormat;
+                    std::vector<Nd4jLong> shapeInfo;
+                    std::vector<int> zeroPoints;
+
+                    bool operator==(const Key &other) const;
+
+                    // same weights view packed the same way, regardless of generation
+                    bool sameWeights(const Key &other) const;
+                };
+
+            private:
+                struct Entry {
+                    Key key;
+                    std::shared_ptr<const std::vector<int16_t>> weights;
+                };
+
+                static const int MAX_ENTRIES = 64;
+
+                std::mutex _mutex;
+                std::vector<Entry> _entries;
+                Nd4jLong _hits = 0;
+                Nd4jLong _misses = 0;
+
+                QuantizedWeightsCache() = default;
+            public:
+                static QuantizedWeightsCache& getInstance();
+
+                /**
+                 * This method returns packed weights, or nullptr if there's no valid entry
+                 */
+                std::shared_ptr<const std::vector<int16_t>> get(const Key &key);
+
+                /**
+                 * This method stores packed weights, entry of older generation of the same weights is replaced
+                 */
+                void put(const Key &key, const std::shared_ptr<const std::vector<int16_t>> &weights);
+
+                Nd4jLong hits();
+                Nd4jLong misses();
+                void clear();
+            };
+
+            /**
+             * Integer GEMM accumulates in int32, and zero-point adjusted operands are within [-255, 255], so reduction length
+             * (K of quantized_matmul, kH * kW * iC of quantized_conv2d, kH * kW of quantized_depthwise_conv2d) can't exceed 2^31 / 255^2
+             */
+            static const Nd4jLong QUANTIZED_MAX_DEPTH = 33025;
+
+            /**
+             * Elementwise quantization/dequantization, per-channel parameters are applied along given axis
+             */
+            void quantizeLinear(const NDArray &input, const QuantizationParams &params, const int axis, NDArray &output);
+            void dequantizeLinear(const NDArray &input, const QuantizationParams &params, const int axis, NDArray &output);
+
+            /**
+             * Calibration: updates [min, max] range with values of input. With momentum > 0 range is updated as moving average,
+             * otherwise it's widened to include both. Scale and zero point for the range are stored into scale/zeroPoint,
+             * zeroPoint data type defines target type: UINT8 gives asymmetric quantization, INT8 gives symmetric one
+             */
+            void quantizationRange(const NDArray &input, const NDArray *range, const float momentum, NDArray &outRange, NDArray &scale, NDArray &zeroPoint);
+
+            /**
+             * Integer GEMM: output = requantize(a x b + bias). a is [M, K], b is [K, N], int8 or uint8 both, b may have per-column parameters.
+             * bias is optional float [N], output is either float, or int8/uint8 quantized with outParams. K must not exceed QUANTIZED_MAX_DEPTH
+             */
+            void quantizedMatmul(const NDArray &a, const QuantizationParams &aParams, const NDArray &b, const QuantizationParams &bParams, const NDArray *bias, const QuantizationParams *outParams, NDArray &output);
+
+            /**
+             * Integer 2D convolutions, arguments follow ConvolutionUtils::conv2d/depthwiseConv2d, weights may have per-output-channel parameters.
+             * Patch length must not exceed QUANTIZED_MAX_DEPTH
+             */
+            void quantizedConv2d(const NDArray &input, const QuantizationParams &inParams, const NDArray &weights, const QuantizationParams &wParams, const NDArray *bias, const QuantizationParams *outParams, NDArray &output, const int kH, const int kW, const int sH, const int sW, int pH, int pW, const int dH, const int dW, const int paddingMode, const int isNCHW, const int wFormat);
+            void quantizedDepthwiseConv2d(const NDArray &input, const QuantizationParams &inParams, const NDArray &weights, const QuantizationParams &wParams, const NDArray *bias, const QuantizationParams *outParams, NDArray &output, const int kH, const int kW, const int sH, const int sW, int pH, int pW, const int dH, const int dW, const int paddingMode, const int isNCHW, const int wFormat);
+        }
+    }
+}
+
+#endif //SD_HELPERS_QUANTIZATION_H
@@ -26,7 +26,15 @@
 namespace sd {
     namespace ops {
         namespace helpers {
-            int32_t thresholdEstimate(const NDArray &updates, float threshold);
+            /**
+             * This method returns number of elements of updates with absolute value >= threshold
+             */
+            Nd4jLong thresholdEstimate(const NDArray &updates, float threshold);
+
+            /**
+             * This method returns length (in bytes) of varint index stream for at most limit elements of updates
+             */
+            Nd4jLong thresholdEstimateVarint(const NDArray &updates, float threshold, Nd4jLong limit);
 
             void thresholdEncode(NDArray &updates, NDArray &encoded, float threshold);
             void thresholdDecode(const NDArray &encoded, NDArray &updates);
@@ -24,13 +24,33 @@
 #include <array/NDArrayFactory.h>
 #include <exceptions/graph_exception.h>
 #include <graph/exceptions/unresolved_input_exception.h>
+#include <graph/MemoryPlan.h>
 #include <ops/declarable/OpRegistrator.h>
 #include <exceptions/datatype_exception.h>
 #include <helpers/StringUtils.h>
+#include <execution/AffinityManager.h>
 #include <cstdarg>
 
 namespace sd {
     namespace ops {
+        // keeps calling thread assigned to the NUMA node of op workspace for the duration of the op
+        class NumaNodeGuard {
+        private:
+            bool _active;
+            int _previous = -1;
+        public:
+            explicit NumaNodeGuard(sd::memory::Workspace *workspace) {
+                _active = workspace != nullptr && Environment::getInstance().isNumaAware();
+                if (_active)
+                    _previous = AffinityManager::setCurrentNumaNode(workspace->numaNode());
+            }
+
+            ~NumaNodeGuard() {
+                if (_active)
+                    AffinityManager::setCurrentNumaNode(_previous);
+            }
+        };
+
         Nd4jStatus conditionHelper(const char *file, int line, int condition, int argNumber, const char *format, ...) {
             if (!condition) {
                 va_list args;
@@ -302,8 +322,14 @@ namespace sd {
                             if (Environment::getInstance().isDebugAndVerbose())
                                 shape::printShapeInfoLinear("Going to create variable with shape", out);
 
-                            // we're creating non-initialized array here
-                            auto outArr = new NDArray(out, true, ctx.launchContext(), false);
+                            // we're creating non-initialized array here, within graph arena if this variable is planned
+                            NDArray *outArr = nullptr;
+                            auto vs = ctx.getVariableSpace();
+                            if (vs != nullptr && vs->flowPath() != nullptr && vs->flowPath()->memoryPlan() != nullptr)
+                                outArr = vs->flowPath()->memoryPlan()->allocate(pair, out, vs->flowPath()->arena(), ctx.launchContext());
+
+                            if (outArr == nullptr)
+                                outArr = new NDArray(out, true, ctx.launchContext(), false);
 
                             ctx.pushNDArrayToVariableSpace(pair, outArr);
 
@@ -592,6 +618,28 @@ namespace sd {
             return ND4J_STATUS_OK;
         }
 
+        static std::vector<NDArray*> outputsOf(Context &block, int numOutputs) {
+            std::vector<NDArray*> result;
+            if (block.isFastPath()) {
+                const auto &outputs = block.fastpath_out().empty() && block.isInplace() ? block.fastpath_in() : block.fastpath_out();
+                for (auto array : outputs)
+                    if (array != nullptr && array->getDataBuffer() != nullptr)
+                        result.emplace_back(array);
+            } else if (block.getVariableSpace() != nullptr) {
+                auto vs = block.getVariableSpace();
+                for (int e = 0; e < numOutputs; e++) {
+                    if (!vs->hasVariable(block.nodeId(), e))
+                        break;
+
+                    auto array = vs->getVariable(block.nodeId(), e)->getNDArray();
+                    if (array != nullptr && array->getDataBuffer() != nullptr)
+                        result.emplace_back(array);
+                }
+            }
+
+            return result;
+        }
+
         Nd4jStatus sd::ops::DeclarableOp::execute(Context* block) {
             nd4j_debug("Executing op: [%s]\n", this->getOpName()->c_str());
 
@@ -621,14 +669,24 @@ namespace sd {
             }
 
 
+#ifndef __CUDABLAS__
+            // arrays backed by read-only memory (i.e. mapped weights updated in place) get own copies before op writes into them
+            auto hostOutputs = outputsOf(*block, numOutputs);
+            for (auto array : hostOutputs)
+                array->getDataBuffer()->makePrimaryWritable();
+#endif
+
             Nd4jStatus status;
             bool hasHelper = false;
 
+            // with NUMA awareness enabled op threads are running on the node its workspace memory belongs to
+            NumaNodeGuard numaGuard(block->workspace());
+
             // platform helpers use might be forbidden for various reasons, so we'll check it out first
             if (block->helpersAllowed() && sd::Environment::getInstance().helpersAllowed()) {
                 // if we have platform-specific helper for this op - invoke it
-                if (OpRegistrator::getInstance().hasHelper(this->getOpHash(), block->engine())) {
-                    auto helper = OpRegistrator::getInstance().getPlatformHelper(this->getOpHash(), block->engine());
+                auto helper = this->platformHelper(block->engine());
+                if (helper != nullptr) {
                     if (helper->isUsable(*block)) {
                         status = helper->invokeHelper(*block);
                         hasHelper = true;
@@ -640,6 +698,14 @@ namespace sd {
             if (!hasHelper)
                 status = this->validateAndExecute(*block);
 
+#ifndef __CUDABLAS__
+            // outputs were written on host side: bump their buffer generations, so caches keyed on them get invalidated.
+            // cuda ops account their writes via registerSpecialUse already
+            if (status == Status::OK())
+                for (auto array : hostOutputs)
+                    array->tickWriteHost();
+#endif
+
             // optionally saving execution time
             if (Environment::getInstance().isProfiling()) {
                 timeEnd = std::chrono::system_clock::now();
@@ -696,6 +762,23 @@ namespace sd {
             return status;
         }
 
+        sd::ops::platforms::PlatformHelper* DeclarableOp::platformHelper(samediff::Engine engine) {
+            const auto e = static_cast<int>(engine);
+            if (!_helpersResolved[e].load(std::memory_order_acquire)) {
+                auto &registrator = OpRegistrator::getInstance();
+                auto helper = registrator.hasHelper(this->getOpHash(), engine) ? registrator.getPlatformHelper(this->getOpHash(), engine) : nullptr;
+
+                _helpers[e].store(helper, std::memory_order_relaxed);
+                _helpersResolved[e].store(true, std::memory_order_release);
+            }
+
+            return _helpers[e].load(std::memory_order_relaxed);
+        }
+
+        bool DeclarableOp::hasStaticShapes() {
+            return true;
+        }
+
         void DeclarableOp::overwriteResult(Context &block, int outputIdx, NDArray *array) {
             throw std::runtime_error("Overwrite result used!");
             //block.pushNDArrayToVariableSpace(block.nodeId(), outputIdx, array);
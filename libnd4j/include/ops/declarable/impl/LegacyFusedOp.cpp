@@ -0,0 +1,202 @@
+/*******************************************************************************
+ * Copyright (c) 2015-2018 Skymind, Inc.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+#include <ops/declarable/LegacyFusedOp.h>
+#include <ops/declarable/LegacyScalarOp.h>
+#include <array/NDArrayFactory.h>
+#include <array/ExtraArguments.h>
+#include <graph/Status.h>
+#include <memory>
+
+
+namespace sd {
+    namespace ops {
+        LegacyFusedOp::LegacyFusedOp() : LegacyOp::LegacyOp(-1) {
+            //
+        }
+
+        LegacyFusedOp::~LegacyFusedOp() {
+            for (auto &step: _steps)
+                delete step.op;
+        }
+
+        void LegacyFusedOp::appendStep(helpers::FusedStepKind kind, int opNum, LegacyOp *op, const std::vector<double> &tArgs, const std::vector<Nd4jLong> &iArgs, int operand, bool reversed) {
+            if (op == nullptr)
+                throw std::runtime_error("LegacyFusedOp: op can't be null");
+
+            if (kind == helpers::FUSED_PAIRWISE && operand < 1)
+                throw std::runtime_error("LegacyFusedOp: pairwise step requires operand");
+
+            Step step;
+            step.kind = kind;
+            step.opNum = opNum;
+            step.op = op;
+            step.tArgs = tArgs;
+            step.iArgs = iArgs;
+            step.operand = kind == helpers::FUSED_PAIRWISE ? operand : -1;
+            step.reversed = kind == helpers::FUSED_PAIRWISE && reversed;
+
+            _steps.emplace_back(step);
+        }
+
+        int LegacyFusedOp::numberOfSteps() {
+            return (int) _steps.size();
+        }
+
+        LegacyOp* LegacyFusedOp::clone() {
+            auto clone = new LegacyFusedOp();
+            for (auto &step: _steps)
+                clone->appendStep(step.kind, step.opNum, step.op->clone(), step.tArgs, step.iArgs, step.operand, step.reversed);
+
+            return clone;
+        }
+
+        /**
+        *   Every op within chain produces array of the same shape as its X operand, so output follows X of the last step
+        */
+        ShapeList *LegacyFusedOp::calculateOutputShape(ShapeList *inputShape, sd::graph::Context &block) {
+            auto outShape = inputShape->at(0);
+            for (auto &step: _steps)
+                if (step.reversed)
+                    outShape = inputShape->at(step.operand);
+
+            Nd4jLong *newShape;
+            COPY_SHAPE(outShape, newShape);
+
+            return SHAPELIST(CONSTANT(newShape));
+        }
+
+        bool LegacyFusedOp::canFuse(Context &block) {
+#ifdef __CUDABLAS__
+            // fused pass is host-only for now
+            return false;
+#endif
+
+            auto x = INPUT_VARIABLE(0);
+            auto z = OUTPUT_VARIABLE(0);
+
+            if (!z->isR() || z->isEmpty() || z->ews() != 1 || x->dataType() != z->dataType() || x->ews() != 1 || x->ordering() != z->ordering() || !x->isSameShape(z))
+                return false;
+
+            for (auto &step: _steps) {
+                if (step.kind == helpers::FUSED_PAIRWISE) {
+                    auto y = INPUT_VARIABLE(step.operand);
+
+                    // operands are read after output block was overwritten by previous steps, so they can't share memory with output
+                    if (y->dataType() != z->dataType() || y->ews() != 1 || y->ordering() != z->ordering() || !y->isSameShape(z) || y->buffer() == z->buffer())
+                        return false;
+                } else if (step.kind == helpers::FUSED_SCALAR && step.tArgs.empty()) {
+                    auto scalar = dynamic_cast<LegacyScalarOp*>(step.op)->scalar();
+                    if (scalar == nullptr || scalar->dataType() != z->dataType())
+                        return false;
+                }
+            }
+
+            return true;
+        }
+
+        Nd4jStatus LegacyFusedOp::executeFused(Context &block) {
+            auto x = INPUT_VARIABLE(0);
+            auto z = OUTPUT_VARIABLE(0);
+
+            const auto numSteps = _steps.size();
+            std::vector<helpers::FusedStep> steps(numSteps);
+            std::vector<NDArray> scalars;
+            std::vector<std::unique_ptr<ExtraArguments>> extras;
+            scalars.reserve(numSteps);
+
+            for (size_t e = 0; e < numSteps; e++) {
+                auto &step = _steps[e];
+                auto &fused = steps[e];
+
+                fused.kind = step.kind;
+                fused.opNum = step.opNum;
+
+                if (step.kind == helpers::FUSED_SCALAR) {
+                    // T argument takes precedence over scalar stored within op, same as in LegacyScalarOp
+                    if (!step.tArgs.empty()) {
+                        scalars.emplace_back(NDArrayFactory::create(z->dataType(), step.tArgs[0], block.launchContext()));
+                        fused.operand = scalars.back().buffer();
+                    } else {
+                        fused.operand = dynamic_cast<LegacyScalarOp*>(step.op)->scalar()->buffer();
+                    }
+                } else {
+                    extras.emplace_back(new ExtraArguments(step.tArgs));
+                    fused.extraParams = extras.back()->argumentsAsT(z->dataType());
+
+                    if (step.kind == helpers::FUSED_PAIRWISE) {
+                        fused.operand = INPUT_VARIABLE(step.operand)->buffer();
+                        fused.reversed = step.reversed;
+                    }
+                }
+            }
+
+#ifndef __CUDABLAS__
+            helpers::fusedElementwise(block.launchContext(), steps, *x, *z);
+#endif
+
+            return Status::OK();
+        }
+
+        Nd4jStatus LegacyFusedOp::executeSequential(Context &block) {
+            auto z = OUTPUT_VARIABLE(0);
+
+            NDArray *current = INPUT_VARIABLE(0);
+            ResultSet intermediate;
+
+            for (size_t e = 0; e < _steps.size(); e++) {
+                auto &step = _steps[e];
+
+                std::vector<NDArray*> inputs;
+                if (step.operand > 0) {
+                    auto y = INPUT_VARIABLE(step.operand);
+                    if (step.reversed)
+                        inputs = {y, current};
+                    else
+                        inputs = {current, y};
+                } else
+                    inputs = {current};
+
+                // last op writes straight into output of the chain
+                if (e == _steps.size() - 1)
+                    return step.op->execute(inputs, {z}, step.tArgs, step.iArgs);
+
+                auto result = step.op->evaluate(inputs, step.tArgs, step.iArgs);
+                if (result.status() != Status::OK())
+                    return result.status();
+
+                intermediate = std::move(result);
+                current = intermediate.at(0);
+            }
+
+            return Status::OK();
+        }
+
+        Nd4jStatus LegacyFusedOp::validateAndExecute(Context &block) {
+            REQUIRE_TRUE(!_steps.empty(), 0, "Node_%i: fused chain has no ops", block.getNodeId());
+
+            auto z = OUTPUT_VARIABLE(0);
+
+            auto status = canFuse(block) ? executeFused(block) : executeSequential(block);
+            if (status != Status::OK())
+                return status;
+
+            STORE_RESULT(*z);
+
+            return Status::OK();
+        }
+    }
+}
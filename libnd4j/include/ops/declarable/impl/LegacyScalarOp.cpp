@@ -41,6 +41,10 @@ namespace sd {
             _scalar = new NDArray(scalar.dup(scalar.ordering()));
         }
 
+        NDArray* LegacyScalarOp::scalar() {
+            return _scalar;
+        }
+
         ShapeList *LegacyScalarOp::calculateOutputShape(ShapeList *inputShape, sd::graph::Context &block) {
             auto inShape = inputShape->at(0);
 
@@ -36,5 +36,10 @@ namespace sd {
             // FIXME: we probably want these ops to evaluate scopes
             return SHAPELIST();
         }
+
+        bool LogicOp::hasStaticShapes() {
+            // control flow is resolved by LogicExecutor at runtime
+            return false;
+        }
     }
 }
\ No newline at end of file
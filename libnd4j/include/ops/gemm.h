@@ -24,6 +24,10 @@
 #include <cblas.h>
 #include <math/templatemath.h>
 #include <system/op_boilerplate.h>
+#include <execution/Threads.h>
+#include <helpers/IsaDispatch.h>
+#include <algorithm>
+#include <vector>
 
 
 namespace sd {
@@ -47,6 +51,281 @@ namespace sd {
              static void op(int TRANS, int M, int N, double alpha, void* vA, int lda, void* vX, int incx, double beta, void* vY, int incy );
          };
 
+         /**
+          * Register tile sizes and accumulator type used by BlockedGEMM micro-kernels.
+          * Low precision floats are accumulated in fp32, small integers in int32.
+          */
+         template <typename T>
+         struct GemmTraits {
+             typedef T acc_type;
+             static const int MR = 4;
+             static const int NR = 8;
+         };
+
+         template <> struct GemmTraits<float>    { typedef float acc_type;  static const int MR = 6; static const int NR = 16; };
+         template <> struct GemmTraits<float16>  { typedef float acc_type;  static const int MR = 6; static const int NR = 16; };
+         template <> struct GemmTraits<bfloat16> { typedef float acc_type;  static const int MR = 6; static const int NR = 16; };
+         template <> struct GemmTraits<double>   { typedef double acc_type; static const int MR = 4; static const int NR = 8; };
+         template <> struct GemmTraits<int8_t>   { typedef int acc_type;    static const int MR = 4; static const int NR = 16; };
+         template <> struct GemmTraits<uint8_t>  { typedef int acc_type;    static const int MR = 4; static const int NR = 16; };
+         template <> struct GemmTraits<int16_t>  { typedef int acc_type;    static const int MR = 4; static const int NR = 16; };
+         template <> struct GemmTraits<uint16_t> { typedef int acc_type;    static const int MR = 4; static const int NR = 16; };
+         template <> struct GemmTraits<int>      { typedef int acc_type;    static const int MR = 4; static const int NR = 16; };
+
+         /**
+          * Cache-blocked GEMM used whenever BLAS can't be used (half, bfloat16, integer types):
+          * C = alpha * A x B + beta * C, where A is MxK, B is KxN and C is MxN.
+          *
+          * Every matrix is described by a pointer and two element strides, so any 2D view
+          * (c/f order, transposed, strided) can be passed as is. The MxN space is split into MC x NC
+          * macro-tiles that are processed in parallel, A and B are packed into contiguous MR/NR panels
+          * of the accumulator type and multiplied by a register-tiled MR x NR micro-kernel.
+          */
+         template <typename X, typename Y, typename Z>
+         class BlockedGEMM {
+         public:
+             typedef typename GemmTraits<Z>::acc_type A;
+
+             static const int MR = GemmTraits<Z>::MR;
+             static const int NR = GemmTraits<Z>::NR;
+             static const int KC = 256;
+             static const int MC = MR * 16;
+             static const int NC = NR * 16;
+
+             static void op(Nd4jLong M, Nd4jLong N, Nd4jLong K, double alpha,
+                            const X *a, Nd4jLong aStrideM, Nd4jLong aStrideK,
+                            const Y *b, Nd4jLong bStrideK, Nd4jLong bStrideN,
+                            double beta,
+                            Z *c, Nd4jLong cStrideM, Nd4jLong cStrideN);
+
+             /**
+              * These methods are for callers that multiply many small blocks of A by the same B, and parallelize on their own
+              * (i.e. implicit GEMM convolutions): B is packed once with packMatrixB() into packedLength(K, N) elements,
+              * and every product is computed by single-threaded serial(), using buffer of bufferLength(K) elements
+              */
+             static FORCEINLINE Nd4jLong packedLength(Nd4jLong K, Nd4jLong N) {
+                 return ((N + NR - 1) / NR) * NR * K;
+             }
+
+             static FORCEINLINE Nd4jLong bufferLength(Nd4jLong K) {
+                 return MC * sd::math::nd4j_max<Nd4jLong>(1, sd::math::nd4j_min<Nd4jLong>(KC, K)) + MC * NC;
+             }
+
+             static void packMatrixB(Nd4jLong K, Nd4jLong N, const Y *b, Nd4jLong bStrideK, Nd4jLong bStrideN, A *packed);
+
+             static void serial(Nd4jLong M, Nd4jLong N, Nd4jLong K, double alpha,
+                                const X *a, Nd4jLong aStrideM, Nd4jLong aStrideK,
+                                const A *packedB,
+                                double beta,
+                                Z *c, Nd4jLong cStrideM, Nd4jLong cStrideN,
+                                A *buffer);
+
+         private:
+             // packs mc x kc block of A into MR-row panels: panel-major, then k, then row within panel; tail rows are zero-padded
+             static void packA(Nd4jLong mc, Nd4jLong kc, const X *a, Nd4jLong aStrideM, Nd4jLong aStrideK, A *buffer);
+
+             // packs kc x nc block of B into NR-column panels: panel-major, then k, then column within panel; tail columns are zero-padded
+             static void packB(Nd4jLong kc, Nd4jLong nc, const Y *b, Nd4jLong bStrideK, Nd4jLong bStrideN, A *buffer);
+
+             // tile[MR x NR] += panelA[MR x kc] x panelB[kc x NR], tile is row-major with leading dimension ldt
+             static void microKernel(Nd4jLong kc, const A *panelA, const A *panelB, A *tile, Nd4jLong ldt);
+
+             // stores mc x nc tile into C, applying alpha/beta in accumulator precision
+             static void storeTile(Nd4jLong mc, Nd4jLong nc, const A *tile, A alpha, A beta, bool betaPresent, Z *c, Nd4jLong cStrideM, Nd4jLong cStrideN);
+
+             // multiplies packed mc x kc block of A by packed kc x nc block of B into MC x NC tile, NR-column panels of B are panelStride apart.
+             // this is the part that's compiled once per ISA and picked at runtime
+             struct TileKernel {
+                 static FORCEINLINE void run(Nd4jLong mc, Nd4jLong nc, Nd4jLong kc, const A *packedA, const A *packedB, Nd4jLong panelStride, A *tile) {
+                     for (Nd4jLong jr = 0; jr < nc; jr += NR)
+                         for (Nd4jLong ir = 0; ir < mc; ir += MR)
+                             microKernel(kc, packedA + ir * kc, packedB + (jr / NR) * panelStride, tile + ir * NC + jr, NC);
+                 }
+             };
+         };
+
+         template <typename X, typename Y, typename Z>
+         void BlockedGEMM<X, Y, Z>::packA(Nd4jLong mc, Nd4jLong kc, const X *a, Nd4jLong aStrideM, Nd4jLong aStrideK, A *buffer) {
+             for (Nd4jLong ir = 0; ir < mc; ir += MR) {
+                 const Nd4jLong mr = sd::math::nd4j_min<Nd4jLong>(MR, mc - ir);
+                 auto panel = buffer + ir * kc;
+
+                 for (Nd4jLong p = 0; p < kc; p++) {
+                     auto dst = panel + p * MR;
+                     auto src = a + ir * aStrideM + p * aStrideK;
+
+                     for (Nd4jLong i = 0; i < mr; i++)
+                         dst[i] = static_cast<A>(src[i * aStrideM]);
+
+                     for (Nd4jLong i = mr; i < MR; i++)
+                         dst[i] = static_cast<A>(0);
+                 }
+             }
+         }
+
+         template <typename X, typename Y, typename Z>
+         void BlockedGEMM<X, Y, Z>::packB(Nd4jLong kc, Nd4jLong nc, const Y *b, Nd4jLong bStrideK, Nd4jLong bStrideN, A *buffer) {
+             for (Nd4jLong jr = 0; jr < nc; jr += NR) {
+                 const Nd4jLong nr = sd::math::nd4j_min<Nd4jLong>(NR, nc - jr);
+                 auto panel = buffer + jr * kc;
+
+                 for (Nd4jLong p = 0; p < kc; p++) {
+                     auto dst = panel + p * NR;
+                     auto src = b + p * bStrideK + jr * bStrideN;
+
+                     if (bStrideN == 1) {
+                         for (Nd4jLong j = 0; j < nr; j++)
+                             dst[j] = static_cast<A>(src[j]);
+                     } else {
+                         for (Nd4jLong j = 0; j < nr; j++)
+                             dst[j] = static_cast<A>(src[j * bStrideN]);
+                     }
+
+                     for (Nd4jLong j = nr; j < NR; j++)
+                         dst[j] = static_cast<A>(0);
+                 }
+             }
+         }
+
+         template <typename X, typename Y, typename Z>
+         FORCEINLINE void BlockedGEMM<X, Y, Z>::microKernel(Nd4jLong kc, const A *panelA, const A *panelB, A *tile, Nd4jLong ldt) {
+             A acc[MR][NR];
+
+             for (int i = 0; i < MR; i++) {
+                 PRAGMA_OMP_SIMD
+                 for (int j = 0; j < NR; j++)
+                     acc[i][j] = tile[i * ldt + j];
+             }
+
+             for (Nd4jLong p = 0; p < kc; p++) {
+                 auto pa = panelA + p * MR;
+                 auto pb = panelB + p * NR;
+
+                 for (int i = 0; i < MR; i++) {
+                     const A ai = pa[i];
+
+                     PRAGMA_OMP_SIMD
+                     for (int j = 0; j < NR; j++)
+                         acc[i][j] += ai * pb[j];
+                 }
+             }
+
+             for (int i = 0; i < MR; i++) {
+                 PRAGMA_OMP_SIMD
+                 for (int j = 0; j < NR; j++)
+                     tile[i * ldt + j] = acc[i][j];
+             }
+         }
+
+         template <typename X, typename Y, typename Z>
+         void BlockedGEMM<X, Y, Z>::op(Nd4jLong M, Nd4jLong N, Nd4jLong K, double alpha,
+                                       const X *a, Nd4jLong aStrideM, Nd4jLong aStrideK,
+                                       const Y *b, Nd4jLong bStrideK, Nd4jLong bStrideN,
+                                       double beta,
+                                       Z *c, Nd4jLong cStrideM, Nd4jLong cStrideN) {
+             if (M <= 0 || N <= 0)
+                 return;
+
+             const A alphaA = static_cast<A>(alpha);
+             const A betaA = static_cast<A>(beta);
+             const bool betaPresent = beta != 0.0;
+
+             const Nd4jLong mBlocks = (M + MC - 1) / MC;
+             const Nd4jLong nBlocks = (N + NC - 1) / NC;
+             const Nd4jLong kcMax = sd::math::nd4j_max<Nd4jLong>(1, sd::math::nd4j_min<Nd4jLong>(KC, K));
+
+             auto func = PRAGMA_THREADS_FOR_2D {
+                 // per-thread packing buffers and fp accumulation tile, reused for all macro-tiles of this thread
+                 std::vector<A> packedA(MC * kcMax);
+                 std::vector<A> packedB(NC * kcMax);
+                 std::vector<A> tile(MC * NC);
+
+                 for (auto bm = start_x; bm < stop_x; bm += inc_x) {
+                     for (auto bn = start_y; bn < stop_y; bn += inc_y) {
+                         const Nd4jLong ic = bm * MC;
+                         const Nd4jLong jc = bn * NC;
+                         const Nd4jLong mc = sd::math::nd4j_min<Nd4jLong>(MC, M - ic);
+                         const Nd4jLong nc = sd::math::nd4j_min<Nd4jLong>(NC, N - jc);
+
+                         std::fill(tile.begin(), tile.end(), static_cast<A>(0));
+
+                         for (Nd4jLong pc = 0; pc < K; pc += KC) {
+                             const Nd4jLong kc = sd::math::nd4j_min<Nd4jLong>(KC, K - pc);
+
+                             packA(mc, kc, a + ic * aStrideM + pc * aStrideK, aStrideM, aStrideK, packedA.data());
+                             packB(kc, nc, b + pc * bStrideK + jc * bStrideN, bStrideK, bStrideN, packedB.data());
+
+                             sd::IsaDispatch<TileKernel>::exec(mc, nc, kc, (const A *) packedA.data(), (const A *) packedB.data(), (Nd4jLong) NR * kc, tile.data());
+                         }
+
+                         storeTile(mc, nc, tile.data(), alphaA, betaA, betaPresent, c + ic * cStrideM + jc * cStrideN, cStrideM, cStrideN);
+                     }
+                 }
+             };
+
+             samediff::Threads::parallel_for(func, 0, mBlocks, 1, 0, nBlocks, 1);
+         }
+
+         template <typename X, typename Y, typename Z>
+         void BlockedGEMM<X, Y, Z>::storeTile(Nd4jLong mc, Nd4jLong nc, const A *tile, A alpha, A beta, bool betaPresent, Z *c, Nd4jLong cStrideM, Nd4jLong cStrideN) {
+             for (Nd4jLong i = 0; i < mc; i++) {
+                 auto t = tile + i * NC;
+                 auto z = c + i * cStrideM;
+
+                 if (betaPresent) {
+                     for (Nd4jLong j = 0; j < nc; j++)
+                         z[j * cStrideN] = static_cast<Z>(alpha * t[j] + beta * static_cast<A>(z[j * cStrideN]));
+                 } else {
+                     for (Nd4jLong j = 0; j < nc; j++)
+                         z[j * cStrideN] = static_cast<Z>(alpha * t[j]);
+                 }
+             }
+         }
+
+         template <typename X, typename Y, typename Z>
+         void BlockedGEMM<X, Y, Z>::packMatrixB(Nd4jLong K, Nd4jLong N, const Y *b, Nd4jLong bStrideK, Nd4jLong bStrideN, A *packed) {
+             // whole K at once: every NR-column panel is K x NR, so any kc block of it is contiguous
+             packB(K, N, b, bStrideK, bStrideN, packed);
+         }
+
+         template <typename X, typename Y, typename Z>
+         void BlockedGEMM<X, Y, Z>::serial(Nd4jLong M, Nd4jLong N, Nd4jLong K, double alpha,
+                                           const X *a, Nd4jLong aStrideM, Nd4jLong aStrideK,
+                                           const A *packedB,
+                                           double beta,
+                                           Z *c, Nd4jLong cStrideM, Nd4jLong cStrideN,
+                                           A *buffer) {
+             if (M <= 0 || N <= 0)
+                 return;
+
+             const A alphaA = static_cast<A>(alpha);
+             const A betaA = static_cast<A>(beta);
+             const bool betaPresent = beta != 0.0;
+
+             const Nd4jLong kcMax = sd::math::nd4j_max<Nd4jLong>(1, sd::math::nd4j_min<Nd4jLong>(KC, K));
+             auto packedA = buffer;
+             auto tile = buffer + MC * kcMax;
+
+             for (Nd4jLong ic = 0; ic < M; ic += MC) {
+                 const Nd4jLong mc = sd::math::nd4j_min<Nd4jLong>(MC, M - ic);
+
+                 for (Nd4jLong jc = 0; jc < N; jc += NC) {
+                     const Nd4jLong nc = sd::math::nd4j_min<Nd4jLong>(NC, N - jc);
+
+                     std::fill(tile, tile + MC * NC, static_cast<A>(0));
+
+                     for (Nd4jLong pc = 0; pc < K; pc += KC) {
+                         const Nd4jLong kc = sd::math::nd4j_min<Nd4jLong>(KC, K - pc);
+
+                         packA(mc, kc, a + ic * aStrideM + pc * aStrideK, aStrideM, aStrideK, packedA);
+                         sd::IsaDispatch<TileKernel>::exec(mc, nc, kc, (const A *) packedA, packedB + jc * K + pc * NR, (Nd4jLong) NR * K, tile);
+                     }
+
+                     storeTile(mc, nc, tile, alphaA, betaA, betaPresent, c + ic * cStrideM + jc * cStrideN, cStrideM, cStrideN);
+                 }
+             }
+         }
+
 
          int FORCEINLINE linearIndexC(int rows, int cols, int r, int c) {
              return (r * cols + c);
@@ -62,53 +62,29 @@ namespace sd {
             auto B = reinterpret_cast<Y *>(vB);
             auto C = reinterpret_cast<Z *>(vC);
 
-            bool transAFlag = TransA == CblasTrans;
-            bool transBFlag = TransB == CblasTrans;
-
-            if (beta == 0.0) {
-                Z z = 0.f;
-                int length = M*N;
-                if (length <= Environment::getInstance().elementwiseThreshold()) {
-                    for (int r = 0; r < length; r++)
-                        C[r] = z;
-                } else {
-                    auto func = PRAGMA_THREADS_FOR {
-                        for (auto r = start; r < stop; r++)
-                            C[r] = z;
-                    };
-                    samediff::Threads::parallel_for(func, 0, length);
-                }
+            const bool transAFlag = TransA == CblasTrans;
+            const bool transBFlag = TransB == CblasTrans;
+
+            // express BLAS order/transpose/leading dimension as element strides of op(A), op(B) and C
+            Nd4jLong aStrideM, aStrideK, bStrideK, bStrideN, cStrideM, cStrideN;
+
+            if (Order == CblasColMajor) {
+                aStrideM = transAFlag ? lda : 1;
+                aStrideK = transAFlag ? 1 : lda;
+                bStrideK = transBFlag ? ldb : 1;
+                bStrideN = transBFlag ? 1 : ldb;
+                cStrideM = 1;
+                cStrideN = ldc;
+            } else {
+                aStrideM = transAFlag ? 1 : lda;
+                aStrideK = transAFlag ? lda : 1;
+                bStrideK = transBFlag ? 1 : ldb;
+                bStrideN = transBFlag ? ldb : 1;
+                cStrideM = ldc;
+                cStrideN = 1;
             }
 
-
-            auto func = PRAGMA_THREADS_FOR_2D {
-                for (auto r = start_x; r < stop_x; r += inc_x) {
-                    for (auto c = start_y; c < stop_y; c += inc_y) {
-                        int zIdx = linearIndexF(M, N, r, c);
-
-                        Z dot = static_cast<Z>(0.0f);
-
-                        if (alpha != 0.0) {
-                            int bIdx; // = linearIndexF(K, N, 0, c);
-                            int aIdx;
-
-                            for (int k = 0; k < K; k++) {
-                                aIdx = (transAFlag ? linearIndexC(M, K, r, k) : linearIndexF(M, K, r, k));
-                                bIdx = (transBFlag ? linearIndexC(K, N, k, c) : linearIndexF(K, N, k, c));
-                                dot += static_cast<Z>(alpha) * static_cast<Z>(A[aIdx]) * static_cast<Z>(B[bIdx]);//A[aIdx]sd::math::nd4j_dot<T>(aX, bX, K) * alpha;
-                            }
-                        }
-
-                        if (beta != 0.0) {
-                            C[zIdx] = static_cast<Z>(dot + static_cast<Z>(beta) * C[zIdx]);
-                        } else {
-                            C[zIdx] = static_cast<Z>(dot);
-                        }
-                    }
-                }
-            };
-
-            samediff::Threads::parallel_for(func, 0, M, 1, 0, N, 1);
+            BlockedGEMM<X, Y, Z>::op(M, N, K, alpha, A, aStrideM, aStrideK, B, bStrideK, bStrideN, beta, C, cStrideM, cStrideN);
         }
 
 
@@ -42,6 +42,13 @@ namespace sd{
         std::atomic<bool> _precBoost;
         std::atomic<bool> _useMKLDNN{true};
         std::atomic<bool> _allowHelpers{true};
+        std::atomic<bool> _numaAware{false};
+        std::atomic<bool> _elementwiseFusion{false};
+        std::atomic<bool> _memoryPlanning{true};
+
+        // ISA level supported by host, and level actually used by dispatched loops
+        int _maxIsaLevel = 0;
+        std::atomic<int> _isaLevel{0};
 
         std::atomic<int> _maxThreads;
         std::atomic<int> _maxMasterThreads;
@@ -100,6 +107,36 @@ namespace sd{
         int maxMasterThreads();
         void setMaxMasterThreads(int max);
 
+        /**
+         * If NUMA awareness is enabled, worker threads are grouped and pinned per NUMA node, and ops are executed on the node
+         * their Workspace memory belongs to. Must be enabled before first parallel call, i.e. via SD_NUMA_AWARE env var
+         */
+        bool isNumaAware();
+        void setNumaAware(bool reallyAware);
+
+        /**
+         * If elementwise fusion is enabled, graphs built afterwards execute chains of transform/scalar/pairwise ops as single op,
+         * so intermediate results of such chains are never materialized. Can be enabled via SD_FUSE_ELEMENTWISE env var
+         */
+        bool isElementwiseFusion();
+        void setElementwiseFusion(bool reallyFuse);
+
+        /**
+         * If memory planning is enabled, graphs with static shapes place intermediate results into single preallocated arena
+         * on CPU. Enabled by default, can be disabled via SD_DISABLE_MEMORY_PLANNING env var
+         */
+        bool isMemoryPlanning();
+        void setMemoryPlanning(bool reallyPlan);
+
+        /**
+         * ISA level used by hot loops with runtime dispatch: 1 for generic x86-64, 2 for AVX2, 3 for AVX-512, 0 if unknown.
+         * Detected once at startup, can be capped via SD_MAX_ISA_LEVEL env var.
+         * setIsaLevel() can only lower the level below the one supported by host
+         */
+        int isaLevel();
+        int maxIsaLevel();
+        void setIsaLevel(int level);
+
         /*
          * Legacy memory limits API, still used in new API as simplified version
          */
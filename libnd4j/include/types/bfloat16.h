@@ -84,13 +84,12 @@
         }
 
         local_def bfloat16& operator=(const float& rhs) {
-            #ifdef __CUDACC__
-            if(::isnan(rhs)) {
-                _data = bfloat16::nan();
+            auto x = *reinterpret_cast<int32_t*>(& const_cast<float&>(rhs));
+            // rounding bias would carry NaN payload into exponent or sign
+            if((x & 0x7fffffff) > 0x7f800000) {
+                _data = 0x7FC0;
                 return *this;
             }
-            #endif
-            auto x = *reinterpret_cast<int32_t*>(& const_cast<float&>(rhs));
             uint32_t lsb = (x >> 16) & 1;
             uint32_t rounding_bias = 0x7fff + lsb;
             x += rounding_bias;
@@ -144,6 +144,10 @@
         (sd::DataType::INT32, int32_t), \
         (sd::DataType::INT64, Nd4jLong)
 
+#define QUANTIZED_TYPES \
+        (sd::DataType::INT8, int8_t), \
+        (sd::DataType::UINT8, uint8_t)
+
 #define INTEGER_TYPES_0 \
         (sd::DataType::INT8, int8_t)
 
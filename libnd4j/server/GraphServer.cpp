@@ -24,7 +24,9 @@
 #include <graph/generated/result_generated.h>
 #include <helpers/StringUtils.h>
 #include <algorithm>
+#include <chrono>
 #include <stdexcept>
+#include <thread>
 
 #include <graph/exceptions/unknown_graph_exception.h>
 #include <graph/exceptions/graph_exists_exception.h>
@@ -110,11 +112,12 @@ namespace sd {
                 auto request = request_msg->GetRoot();
 
                 try {
-                    // GraphHolder
-                    auto response_offset = GraphHolder::getInstance().execute(request->id(), mb_, request);
+                    // concurrent requests wait for each other within batcher, so each one needs its own builder
+                    flatbuffers::grpc::MessageBuilder mb;
+                    auto response_offset = batcher_.execute(request->id(), mb, request);
 
-                    mb_.Finish(response_offset);
-                    *response_msg = mb_.ReleaseMessage<FlatResult>();
+                    mb.Finish(response_offset);
+                    *response_msg = mb.ReleaseMessage<FlatResult>();
                     assert(response_msg->Verify());
 
                     return grpc::Status::OK;
@@ -135,15 +138,25 @@ namespace sd {
     }
 }
 
-void RunServer(int port) {
+void RunServer(int port, int maxBatchSize, Nd4jLong maxDelay, int statsInterval) {
   assert(port > 0 && port < 65535);
 
   std::string server_address("0.0.0.0:");
   server_address += sd::StringUtils::valueToString<int>(port);
 
-  sd::graph::GraphInferenceServerImpl service;
+  sd::graph::GraphInferenceServerImpl service(maxBatchSize, maxDelay);
   auto registrator = sd::ops::OpRegistrator::getInstance();
 
+  // batching histograms are printed out periodically, if requested
+  if (statsInterval > 0) {
+      std::thread([&service, statsInterval] {
+          while (true) {
+              std::this_thread::sleep_for(std::chrono::seconds(statsInterval));
+              service.batcher().printOut();
+          }
+      }).detach();
+  }
+
   grpc::ServerBuilder builder;
   builder.AddListeningPort(server_address, grpc::InsecureServerCredentials());
   builder.RegisterService(&service);
@@ -180,11 +193,24 @@ int main(int argc, char *argv[]) {
 
     if(cmdOptionExists(argv, argv+argc, "-f")) {
         auto file = getCmdOption(argv, argv + argc, "-f");
-        auto graph = GraphExecutioner<float>::importFromFlatBuffers(file);
-        sd::graph::GraphHolder::getInstance().registerGraph<float>(0L, graph);
+        // weights are referenced within mapped file, so several server instances share page cache
+        auto graph = sd::graph::GraphExecutioner::importFromMappedFlatBuffers(file);
+        sd::graph::GraphHolder::getInstance().registerGraph(0L, graph);
     }
 
-    RunServer(port);
+    int maxBatchSize = 32;
+    if(cmdOptionExists(argv, argv+argc, "-b"))
+        maxBatchSize = atoi(getCmdOption(argv, argv + argc, "-b"));
+
+    Nd4jLong maxDelay = 1000L;
+    if(cmdOptionExists(argv, argv+argc, "-d"))
+        maxDelay = atol(getCmdOption(argv, argv + argc, "-d"));
+
+    int statsInterval = 0;
+    if(cmdOptionExists(argv, argv+argc, "-s"))
+        statsInterval = atoi(getCmdOption(argv, argv + argc, "-s"));
+
+    RunServer(port, maxBatchSize, maxDelay, statsInterval);
 
     return 0;
 }
\ No newline at end of file
@@ -22,6 +22,7 @@
 #include <grpc++/grpc++.h>
 #include <array/NDArray.h>
 #include <graph/Graph.h>
+#include <graph/GraphBatcher.h>
 #include <ops/declarable/CustomOperations.h>
 
 #include <graph/generated/graph.grpc.fb.h>
@@ -31,7 +32,14 @@ namespace sd {
         class GraphInferenceServerImpl final : public GraphInferenceServer::Service {
         private:
             flatbuffers::grpc::MessageBuilder mb_;
+
+            // inference requests are batched per graph
+            GraphBatcher batcher_;
         public:
+            GraphInferenceServerImpl(int maxBatchSize, Nd4jLong maxDelay) : batcher_(maxBatchSize, maxDelay) { };
+
+            GraphBatcher& batcher() { return batcher_; }
+
             virtual grpc::Status RegisterGraph( grpc::ServerContext *context, const flatbuffers::grpc::Message<FlatGraph> *request_msg, flatbuffers::grpc::Message<FlatResponse> *response_msg);
 
             virtual grpc::Status ForgetGraph( grpc::ServerContext *context, const flatbuffers::grpc::Message<FlatDropRequest> *request_msg, flatbuffers::grpc::Message<FlatResponse> *response_msg);
@@ -23,6 +23,7 @@
 #include <graph/Graph.h>
 #include <graph/Node.h>
 #include <ops/declarable/CustomOperations.h>
+#include <ops/declarable/LegacyBroadcastOp.h>
 
 using namespace sd;
 using namespace sd::graph;
@@ -853,3 +854,56 @@ TEST_F(BroadcastableOpsTests, test_bert_multiply_2) {
 
     ASSERT_EQ(e, z);
 }
+
+//////////////////////////////////////////////////////////////////////
+// NHWC-like view of c-ordered array, so none of the operands has element-wise stride along broadcasted dimensions
+TEST_F(BroadcastableOpsTests, test_permuted_broadcast_1) {
+    auto x = NDArrayFactory::create<float>('c', {2, 3, 4, 5, 2, 2});
+    auto y = NDArrayFactory::create<float>('c', {4, 3});
+    auto z = NDArrayFactory::create<float>('c', {2, 4, 5, 3, 2, 2});
+    auto axis = NDArrayFactory::create<int>('c', {2}, {1, 3});
+    x.linspace(1);
+    y.linspace(1);
+
+    auto xp = x.permute({0, 2, 3, 1, 4, 5});
+
+    std::vector<float> e;
+    for (int n = 0; n < 2; n++)
+        for (int h = 0; h < 4; h++)
+            for (int w = 0; w < 5; w++)
+                for (int c = 0; c < 3; c++)
+                    for (int a = 0; a < 4; a++)
+                        e.push_back(1 + n * 240 + c * 80 + h * 20 + w * 4 + a + 1 + h * 3 + c);
+
+    sd::ops::LegacyBroadcastOp op(broadcast::Add);
+    auto status = op.execute({&xp, &y, &axis}, {&z}, {}, {}, {});
+    ASSERT_EQ(Status::OK(), status);
+
+    auto exp = NDArrayFactory::create<float>('c', {2, 4, 5, 3, 2, 2}, e);
+    ASSERT_EQ(exp, z);
+}
+
+//////////////////////////////////////////////////////////////////////
+TEST_F(BroadcastableOpsTests, test_permuted_broadcast_2) {
+    auto x = NDArrayFactory::create<float>('c', {2, 3, 4, 5, 2, 2});
+    auto y = NDArrayFactory::create<float>('c', {1, 4, 1, 3, 1, 2});
+    auto z = NDArrayFactory::create<float>('c', {2, 4, 5, 3, 2, 2});
+    x.linspace(1);
+    y.linspace(1);
+
+    auto xp = x.permute({0, 2, 3, 1, 4, 5});
+
+    std::vector<float> e;
+    for (int n = 0; n < 2; n++)
+        for (int h = 0; h < 4; h++)
+            for (int w = 0; w < 5; w++)
+                for (int c = 0; c < 3; c++)
+                    for (int a = 0; a < 2; a++)
+                        for (int b = 0; b < 2; b++)
+                            e.push_back(1 + n * 240 + c * 80 + h * 20 + w * 4 + a * 2 + b + 1 + h * 6 + c * 2 + b);
+
+    xp.applyTrueBroadcast(BroadcastOpsTuple::Add(), y, z);
+
+    auto exp = NDArrayFactory::create<float>('c', {2, 4, 5, 3, 2, 2}, e);
+    ASSERT_EQ(exp, z);
+}
@@ -21,9 +21,11 @@
 #include "testlayers.h"
 #include <ops/declarable/CustomOperations.h>
 #include <helpers/ConstantShapeHelper.h>
+#include <helpers/ConstantTadHelper.h>
 #include <array/ShapeDescriptor.h>
 #include <array/ConstantDataBuffer.h>
 #include <helpers/PointersManager.h>
+#include <thread>
 
 using namespace sd;
 using namespace sd::ops;
@@ -240,4 +242,123 @@ TEST_F(ConstantShapeHelperTests, ShapeDescriptor_1) {
     ShapeDescriptor descr2(shapeInfo2);
 
     ASSERT_FALSE(descr1 == descr2);
-}
\ No newline at end of file
+}
+//////////////////////////////////////////////////////////////////////
+TEST_F(ConstantShapeHelperTests, test_cache_counters_1) {
+    auto &helper = ConstantShapeHelper::getInstance();
+
+    ShapeDescriptor descriptor(sd::DataType::FLOAT32, 'c', {17, 3, 19});
+    helper.bufferForShapeInfo(descriptor);
+
+    auto hits = helper.cacheHits();
+    auto misses = helper.cacheMisses();
+
+    helper.bufferForShapeInfo(descriptor);
+    helper.bufferForShapeInfo(descriptor);
+
+    ASSERT_EQ(hits + 2, helper.cacheHits());
+    ASSERT_EQ(misses, helper.cacheMisses());
+    ASSERT_TRUE(helper.checkBufferExistenceForShapeInfo(descriptor));
+}
+
+//////////////////////////////////////////////////////////////////////
+TEST_F(ConstantShapeHelperTests, test_sharded_cache_eviction_1) {
+    sd::ShardedCache<int, int> cache(true);
+    cache.setLimit(1);
+
+    for (int e = 0; e < 10000; e++)
+        ASSERT_EQ(e * 2, cache.getOrCreate(e, [e]() -> int { return e * 2; }));
+
+    ASSERT_EQ(10000, cache.misses());
+    ASSERT_TRUE(cache.evictions() > 0);
+    ASSERT_EQ(10000, cache.size() + cache.evictions());
+    typedef sd::ShardedCache<int, int> IntCache;
+    ASSERT_TRUE(cache.size() <= IntCache::NUM_SHARDS * IntCache::MIN_SHARD_LIMIT);
+
+    // most recent entry is never evicted
+    ASSERT_TRUE(cache.contains(9999));
+
+    int value = 0;
+    ASSERT_TRUE(cache.find(9999, value));
+    ASSERT_EQ(19998, value);
+    ASSERT_EQ(1, cache.hits());
+}
+
+//////////////////////////////////////////////////////////////////////
+TEST_F(ConstantShapeHelperTests, test_sharded_cache_eviction_2) {
+    // values outlive eviction of their entries while readers keep evicting each other
+    sd::ShardedCache<int, std::shared_ptr<std::vector<int>>> cache(true);
+    cache.setLimit(1);
+
+    std::atomic<int> failures(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&cache, &failures, t]() {
+            for (int e = 0; e < 20000; e++) {
+                const int key = (e * 7 + t * 13) % 3000;
+                auto value = cache.getOrCreate(key, [key]() { return std::make_shared<std::vector<int>>(64, key); });
+
+                if (value->front() != key || value->back() != key)
+                    failures++;
+            }
+        });
+    }
+
+    for (auto &thread: threads)
+        thread.join();
+
+    ASSERT_EQ(0, failures.load());
+    ASSERT_TRUE(cache.evictions() > 0);
+}
+
+//////////////////////////////////////////////////////////////////////
+TEST_F(ConstantShapeHelperTests, test_sharded_cache_references_1) {
+    // non-evicting cache hands out references that stay valid while other threads keep inserting
+    sd::ShardedCache<int, std::vector<int>> cache;
+    ASSERT_ANY_THROW(cache.setLimit(1));
+
+    auto &first = cache.entryFor(0, []() { return std::vector<int>(64, 0); });
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&cache, t]() {
+            for (int e = 0; e < 5000; e++) {
+                const int key = (e * 7 + t * 13) % 3000;
+                cache.entryFor(key, [key]() { return std::vector<int>(64, key); });
+            }
+        });
+    }
+
+    for (auto &thread: threads)
+        thread.join();
+
+    ASSERT_EQ(&first, &cache.entryFor(0, []() { return std::vector<int>(); }));
+    ASSERT_EQ(64, first.size());
+    ASSERT_EQ(3000, cache.size());
+    ASSERT_EQ(3000, cache.misses());
+    ASSERT_EQ(0, cache.evictions());
+
+    sd::ShardedCache<int, int> evicting(true);
+    ASSERT_ANY_THROW(evicting.entryFor(0, []() { return 0; }));
+}
+
+//////////////////////////////////////////////////////////////////////
+TEST_F(ConstantTadHelperTests, test_cached_memory_1) {
+    auto &helper = ConstantTadHelper::getInstance();
+    auto array = NDArrayFactory::create<float>('c', {9, 17, 23});
+
+    auto memBefore = helper.cachedMemory();
+    auto missesBefore = helper.cacheMisses();
+
+    auto pack = helper.tadForDimensions(array.shapeInfo(), {0, 2});
+    ASSERT_EQ(17, pack.numberOfTads());
+
+    // rank-2 TAD shape plus 17 offsets
+    ASSERT_EQ(missesBefore + 1, helper.cacheMisses());
+    ASSERT_EQ(memBefore + (shape::shapeInfoLength(2) + 17) * (Nd4jLong) sizeof(Nd4jLong), helper.cachedMemory());
+
+    auto hitsBefore = helper.cacheHits();
+    auto packB = helper.tadForDimensions(array.shapeInfo(), {0, 2});
+    ASSERT_EQ(hitsBefore + 1, helper.cacheHits());
+    ASSERT_EQ(pack.primaryOffsets(), packB.primaryOffsets());
+}
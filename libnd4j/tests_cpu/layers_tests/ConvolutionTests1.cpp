@@ -30,6 +30,7 @@
 #include <ops/declarable/CustomOperations.h>
 #include <ops/declarable/helpers/convolutions.h>
 #include <ops/declarable/helpers/col2im.h>
+#include <ops/declarable/helpers/cpu/convolutions_winograd.hpp>
 #include <helpers/PointersManager.h>
 #include <helpers/GradCheck.h>
 
@@ -1499,6 +1500,253 @@ TEST_F(ConvolutionTests1, conv2d_bp_6) {
     ASSERT_TRUE(expGradB.equalsTo(gradB));
 }
 
+////////////////////////////////////////////////////////////////////
+// strides, dilations and SAME padding together, both data formats are checked against the same reference
+TEST_F(ConvolutionTests1, conv2d_bp_8) {
+
+    int bS=2, iH=5,iW=5,  iC=2,oC=3,  kH=3,kW=3,  sH=2,sW=2,  pH=0,pW=0,  dH=2,dW=1;
+    int       oH=3,oW=3;
+    int paddingMode = 1;             // 1-SAME, 0-VALID;
+    int wFormat     = 0;             // 0-[kH, kW, iC, oC], 1-[oC, iC, kH, kW], 2-[oC, kH, kW, iC]
+
+    NDArray inputNHWC('c', {bS, iH, iW, iC}, sd::DataType::FLOAT32);
+    NDArray weights('c', {kH, kW, iC, oC}, sd::DataType::FLOAT32);
+    NDArray bias('c', {oC}, {0.1, -0.2, 0.3}, sd::DataType::FLOAT32);
+    NDArray gradONHWC('c', {bS, oH, oW, oC}, sd::DataType::FLOAT32);
+
+    NDArray expOutput('c', {bS, oH, oW, oC}, {-0.68, -1.048, -0.616, -0.002, -0.368, 0.066, 0.52, 0.2, 0.68, 3.268, 2.986, 3.504, 5.428, 5.209, 5.79,
+                                             3.7, 3.49, 4.08, 1.264, 1.056, 1.648, 1.546, 1.42, 2.094, 0.64, 0.48, 1.12, 8.32, 8.352, 9.184,
+                                             11.698, 11.932, 12.966, 7.12, 7.2, 8.08, 11.368, 11.686, 12.804, 14.878, 15.559, 17.04, 8.2, 8.59, 9.78,
+                                             3.064, 3.256, 4.248, 2.446, 2.92, 4.194, 0.04, 0.28, 1.32}, sd::DataType::FLOAT32);
+
+    NDArray expGradI('c', {bS, iH, iW, iC}, {0.1424, 0.2828, 0.3208, 0.58, 0.1352, 0.254, 0.3064, 0.5224, 0.128, 0.2252, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                                            0.9264, 1.0884, 1.8096, 2.1012, 0.8184, 0.948, 1.5936, 1.8204, 0.7104, 0.8076, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                                            0.5744, 0.65, 1.0552, 1.1848, 0.4376, 0.4916, 0.7816, 0.868, 0.3008, 0.3332, 0.0776, 0.0236, 0.1912, 0.0616, 0.0704,
+                                            -0.0052, 0.1768, 0.004, 0.0632, -0.034, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                                            -0.0456, -0.1752, -0.1344, -0.426, -0.1536, -0.3156, -0.3504, -0.7068, -0.2616, -0.456, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                                            -0.6568, -0.7756, -1.4072, -1.6664, -0.7936, -0.934, -1.6808, -1.9832, -0.9304, -1.0924}, sd::DataType::FLOAT32);
+
+    NDArray expGradW('c', {kH, kW, iC, oC}, {-4.072, -4.224, -4.376, -4.124, -4.284, -4.444, -5.826, -6.054, -6.282, -5.886, -6.126, -6.366,
+                                            -3.616, -3.768, -3.92, -3.644, -3.804, -3.964, -6.222, -6.57, -6.918, -6.246, -6.606, -6.966,
+                                            -8.64, -9.162, -9.684, -8.649, -9.189, -9.729, -5.178, -5.526, -5.874, -5.166, -5.526, -5.886,
+                                            -2.304, -2.616, -2.928, -2.284, -2.604, -2.924, -2.814, -3.282, -3.75, -2.766, -3.246, -3.726,
+                                            -1.368, -1.68, -1.992, -1.324, -1.644, -1.964}, sd::DataType::FLOAT32);
+
+    NDArray expGradB('c', {oC}, {-0.18, -0.54, -0.9}, sd::DataType::FLOAT32);
+
+    inputNHWC.linspace(-1, 0.05);
+    weights.linspace(-0.3, 0.02);
+    gradONHWC.linspace(0.5, -0.02);
+
+    auto inputNCHW = inputNHWC.permute({0, 3, 1, 2}).dup('c');
+    auto gradONCHW = gradONHWC.permute({0, 3, 1, 2}).dup('c');
+
+    sd::ops::conv2d opFF;
+    auto ffNHWC = opFF.evaluate({&inputNHWC, &weights, &bias}, {}, {kH,kW,  sH,sW,  pH,pW,  dH,dW, paddingMode, 1, wFormat});
+    auto ffNCHW = opFF.evaluate({&inputNCHW, &weights, &bias}, {}, {kH,kW,  sH,sW,  pH,pW,  dH,dW, paddingMode, 0, wFormat});
+    ASSERT_EQ(Status::OK(), ffNHWC.status());
+    ASSERT_EQ(Status::OK(), ffNCHW.status());
+
+    ASSERT_TRUE(expOutput.isSameShape(ffNHWC.at(0)));
+    ASSERT_TRUE(expOutput.equalsTo(ffNHWC.at(0)));
+    ASSERT_TRUE(expOutput.permute({0, 3, 1, 2}).equalsTo(ffNCHW.at(0)));
+
+    sd::ops::conv2d_bp op;
+    auto bpNHWC = op.evaluate({&inputNHWC, &weights, &bias, &gradONHWC}, {}, {kH,kW,  sH,sW,  pH,pW,  dH,dW, paddingMode, 1, wFormat});
+    auto bpNCHW = op.evaluate({&inputNCHW, &weights, &bias, &gradONCHW}, {}, {kH,kW,  sH,sW,  pH,pW,  dH,dW, paddingMode, 0, wFormat});
+    ASSERT_EQ(Status::OK(), bpNHWC.status());
+    ASSERT_EQ(Status::OK(), bpNCHW.status());
+
+    ASSERT_TRUE(expGradI.isSameShape(bpNHWC.at(0)));
+    ASSERT_TRUE(expGradI.equalsTo(bpNHWC.at(0)));
+    ASSERT_TRUE(expGradI.permute({0, 3, 1, 2}).equalsTo(bpNCHW.at(0)));
+
+    ASSERT_TRUE(expGradW.equalsTo(bpNHWC.at(1)));
+    ASSERT_TRUE(expGradW.equalsTo(bpNCHW.at(1)));
+
+    ASSERT_TRUE(expGradB.equalsTo(bpNHWC.at(2)));
+    ASSERT_TRUE(expGradB.equalsTo(bpNCHW.at(2)));
+}
+
+////////////////////////////////////////////////////////////////////
+// F(4x4, 3x3) path, compared against direct convolution
+TEST_F(ConvolutionTests1, conv2d_winograd_1) {
+
+    int bS=2, iH=10,iW=9,  iC=32,oC=32;
+    int       oH=10,oW=9;
+    int pH=1, pW=1;                  // SAME
+
+    NDArray input('c', {bS, iH, iW, iC}, sd::DataType::FLOAT32);
+    NDArray weights('c', {3, 3, iC, oC}, sd::DataType::FLOAT32);
+    NDArray output('c', {bS, oH, oW, oC}, sd::DataType::FLOAT32);
+    NDArray expected('c', {bS, oH, oW, oC}, sd::DataType::FLOAT32);
+
+    input.linspace(-1, 0.0003);
+    weights.linspace(0.5, -0.0001);
+
+    auto x = input.bufferAsT<float>();
+    auto w = weights.bufferAsT<float>();
+    auto e = expected.bufferAsT<float>();
+    for (int b = 0; b < bS; b++)
+        for (int oh = 0; oh < oH; oh++)
+            for (int ow = 0; ow < oW; ow++)
+                for (int n = 0; n < oC; n++) {
+                    float sum = 0.f;
+                    for (int kh = 0; kh < 3; kh++)
+                        for (int kw = 0; kw < 3; kw++) {
+                            int ih = oh - pH + kh;
+                            int iw = ow - pW + kw;
+                            if (ih < 0 || ih >= iH || iw < 0 || iw >= iW)
+                                continue;
+
+                            for (int c = 0; c < iC; c++)
+                                sum += x[((b * iH + ih) * iW + iw) * iC + c] * w[((kh * 3 + kw) * iC + c) * oC + n];
+                        }
+
+                    e[((b * oH + oh) * oW + ow) * oC + n] = sum;
+                }
+
+    ASSERT_TRUE(ops::helpers::winogradEligible(input, weights, 3, 3, 1, 1, 1, 1, iC, oC));
+    ASSERT_FALSE(ops::helpers::winogradEligible(input, weights, 3, 3, 1, 1, 1, 1, 3, oC));     // too few channels to pay off
+    ops::helpers::winogradConv2d(input, weights, output, pH, pW, 0, 0, false);
+
+    ASSERT_TRUE(expected.equalsTo(output, 1e-4));
+}
+
+////////////////////////////////////////////////////////////////////
+// depthwise F(2x2, 3x3) path, transformed weights must be reused, and updated after in-place change of weights
+TEST_F(ConvolutionTests1, conv2d_winograd_2) {
+
+    int bS=2, iH=7,iW=6,  iC=3,mC=2;
+    int       oH=5,oW=4;
+    int pH=0, pW=0;                  // VALID
+    int dataFormat = 0;              // 1-NHWC, 0-NCHW
+
+    NDArray input('c', {bS, iC, iH, iW}, sd::DataType::FLOAT32);
+    NDArray weights('c', {3, 3, iC, mC}, sd::DataType::FLOAT32);
+
+    input.linspace(-2, 0.05);
+    weights.linspace(0.3, -0.02);
+
+    sd::ops::depthwise_conv2d op;
+    auto expected = op.evaluate({&input, &weights}, {}, {3,3,  2,2,  pH,pW,  1,1, 0, dataFormat});     // strided: not Winograd
+    ASSERT_EQ(Status::OK(), expected.status());
+
+    NDArray output('c', {bS, iC * mC, oH, oW}, sd::DataType::FLOAT32);
+    auto &cache = ops::helpers::WinogradWeightsCache::getInstance();
+    cache.clear();
+
+    ops::helpers::winogradConv2d(input, weights, output, pH, pW, 1, 0, true);
+    ops::helpers::winogradConv2d(input, weights, output, pH, pW, 1, 0, true);
+    ASSERT_EQ(1, cache.misses());
+    ASSERT_EQ(1, cache.hits());
+
+    // every other output of stride 1 convolution is the output of stride 2 one
+    NDArray strided = output({0,bS,1, 0,iC*mC,1, 0,oH,2, 0,oW,2}, true, true);
+    ASSERT_TRUE(expected.at(0)->equalsTo(strided));
+
+    weights *= 2.f;
+    ops::helpers::winogradConv2d(input, weights, output, pH, pW, 1, 0, true);
+    ASSERT_EQ(2, cache.misses());
+
+    NDArray strided2 = output({0,bS,1, 0,iC*mC,1, 0,oH,2, 0,oW,2}, true, true);
+    auto doubled = (*expected.at(0)) * 2.f;
+    ASSERT_TRUE(doubled.equalsTo(strided2));
+}
+
+////////////////////////////////////////////////////////////////////
+// int8 path, SAME padding is filled with input zero point, weights have per output channel scales
+TEST_F(ConvolutionTests1, quantized_conv2d_1) {
+
+    int bS=2, iH=6,iW=6,  iC=3,oC=4;
+    int paddingMode = 1;             // 1-SAME, 0-VALID
+    int dataFormat  = 1;             // 1-NHWC, 0-NCHW
+
+    NDArray input('c', {bS, iH, iW, iC}, sd::DataType::FLOAT32);
+    NDArray weights('c', {3, 3, iC, oC}, sd::DataType::FLOAT32);
+    NDArray bias('c', {oC}, sd::DataType::FLOAT32);
+    input.linspace(-1, 0.013);
+    weights.linspace(0.5, -0.01);
+    bias.linspace(0.1, 0.1);
+
+    sd::ops::quantization_range calibrate;
+    auto range = calibrate.evaluate({&input});
+    auto inScale = range.at(1);
+    auto inZero = range.at(2);
+    ASSERT_NE(0, inZero->e<int>(0));
+
+    auto wScale = weights.reduceAlongDimension(reduce::AMax, {0, 1, 2});
+    wScale /= 127.f;
+    NDArray wZero('c', {oC}, sd::DataType::INT8);
+    wZero.assign(0);
+
+    sd::ops::quantize_linear quantize;
+    auto qInput = quantize.evaluate({&input, inScale, inZero});
+    auto qWeights = quantize.evaluate({&weights, &wScale, &wZero}, {}, {3});
+
+    sd::ops::dequantize_linear dequantize;
+    auto dInput = dequantize.evaluate({qInput.at(0), inScale, inZero});
+    auto dWeights = dequantize.evaluate({qWeights.at(0), &wScale, &wZero}, {}, {3});
+
+    sd::ops::conv2d reference;
+    auto expected = reference.evaluate({dInput.at(0), dWeights.at(0), &bias}, {}, {3,3,  1,1,  0,0,  1,1,  paddingMode, dataFormat});
+    ASSERT_EQ(Status::OK(), expected.status());
+
+    sd::ops::quantized_conv2d op;
+    auto result = op.evaluate({qInput.at(0), inScale, inZero, qWeights.at(0), &wScale, &wZero, &bias}, {}, {3,3,  1,1,  0,0,  1,1,  paddingMode, dataFormat});
+    ASSERT_EQ(Status::OK(), result.status());
+    ASSERT_TRUE(expected.at(0)->isSameShape(result.at(0)));
+    ASSERT_TRUE(expected.at(0)->equalsTo(result.at(0), 1e-3));
+
+    // requantized output stays within one quantization step from reference
+    auto outRange = calibrate.evaluate({expected.at(0)});
+    auto outScale = outRange.at(1);
+    auto quantized = op.evaluate({qInput.at(0), inScale, inZero, qWeights.at(0), &wScale, &wZero, &bias, outScale, outRange.at(2)}, {}, {3,3,  1,1,  0,0,  1,1,  paddingMode, dataFormat});
+    ASSERT_EQ(sd::DataType::UINT8, quantized.at(0)->dataType());
+
+    auto dOutput = dequantize.evaluate({quantized.at(0), outScale, outRange.at(2)});
+    for (Nd4jLong e = 0; e < dOutput.at(0)->lengthOf(); e++)
+        ASSERT_NEAR(expected.at(0)->e<float>(e), dOutput.at(0)->e<float>(e), outScale->e<float>(0));
+}
+
+////////////////////////////////////////////////////////////////////
+// int8 activations with uint8 weights, strided NCHW, channels multiplier 2
+TEST_F(ConvolutionTests1, quantized_depthwise_conv2d_1) {
+
+    int bS=1, iH=5,iW=5,  iC=4,mC=2;
+    int paddingMode = 0;             // 1-SAME, 0-VALID
+    int dataFormat  = 0;             // 1-NHWC, 0-NCHW
+
+    NDArray input('c', {bS, iC, iH, iW}, sd::DataType::FLOAT32);
+    NDArray weights('c', {3, 3, iC, mC}, sd::DataType::FLOAT32);
+    input.linspace(-2, 0.03);
+    weights.linspace(-0.3, 0.007);
+
+    sd::ops::quantization_range calibrate;
+    auto inRange = calibrate.evaluate({&input}, {}, {1});
+    auto wRange = calibrate.evaluate({&weights});
+
+    sd::ops::quantize_linear quantize;
+    auto qInput = quantize.evaluate({&input, inRange.at(1), inRange.at(2)});
+    auto qWeights = quantize.evaluate({&weights, wRange.at(1), wRange.at(2)});
+    ASSERT_EQ(sd::DataType::INT8, qInput.at(0)->dataType());
+    ASSERT_EQ(sd::DataType::UINT8, qWeights.at(0)->dataType());
+
+    sd::ops::dequantize_linear dequantize;
+    auto dInput = dequantize.evaluate({qInput.at(0), inRange.at(1), inRange.at(2)});
+    auto dWeights = dequantize.evaluate({qWeights.at(0), wRange.at(1), wRange.at(2)});
+
+    sd::ops::depthwise_conv2d reference;
+    auto expected = reference.evaluate({dInput.at(0), dWeights.at(0)}, {}, {3,3,  2,2,  0,0,  1,1,  paddingMode, dataFormat});
+    ASSERT_EQ(Status::OK(), expected.status());
+
+    sd::ops::quantized_depthwise_conv2d op;
+    auto result = op.evaluate({qInput.at(0), inRange.at(1), inRange.at(2), qWeights.at(0), wRange.at(1), wRange.at(2)}, {}, {3,3,  2,2,  0,0,  1,1,  paddingMode, dataFormat});
+    ASSERT_EQ(Status::OK(), result.status());
+    ASSERT_TRUE(expected.at(0)->isSameShape(result.at(0)));
+    ASSERT_TRUE(expected.at(0)->equalsTo(result.at(0), 1e-3));
+}
+
 ////////////////////////////////////////////////////////////////////
 TYPED_TEST(TypedConvolutionTests1, conv3d_bp_test1) {
 
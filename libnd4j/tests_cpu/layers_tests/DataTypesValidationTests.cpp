@@ -28,6 +28,7 @@
 #include <ops/declarable/helpers/convolutions.h>
 #include <ops/declarable/helpers/col2im.h>
 #include <helpers/RandomLauncher.h>
+#include <helpers/LowPrecision.h>
 
 using namespace sd;
 using namespace sd::graph;
@@ -153,4 +154,75 @@ TEST_F(DataTypesValidationTests, test_bits_hamming_distance_2) {
     sd::ops::bits_hamming_distance op;
     auto status = op.execute(&ctx);
     ASSERT_EQ(Status::OK(), status);
-}
\ No newline at end of file
+}
+
+////////////////////////////////////////////////////////////////////
+TEST_F(DataTypesValidationTests, test_low_precision_cast_1) {
+    const Nd4jLong length = 1037;
+    auto x = NDArrayFactory::create<float>('c', {length});
+    x.linspace(-500.f, 0.97f);
+
+    std::vector<float16> h(length);
+    std::vector<bfloat16> b(length);
+    std::vector<float> f(length);
+
+    LowPrecision::cast<float, float16>(x.bufferAsT<float>(), h.data(), length);
+    LowPrecision::cast<float, bfloat16>(x.bufferAsT<float>(), b.data(), length);
+
+    for (Nd4jLong e = 0; e < length; e++) {
+        ASSERT_EQ(static_cast<float16>(x.e<float>(e)), h[e]);
+        ASSERT_EQ(static_cast<bfloat16>(x.e<float>(e)), b[e]);
+    }
+
+    LowPrecision::cast<float16, float>(h.data(), f.data(), length);
+    for (Nd4jLong e = 0; e < length; e++)
+        ASSERT_EQ(static_cast<float>(h[e]), f[e]);
+
+    LowPrecision::cast<bfloat16, float>(b.data(), f.data(), length);
+    for (Nd4jLong e = 0; e < length; e++)
+        ASSERT_EQ(static_cast<float>(b[e]), f[e]);
+
+    // NaNs with any payload and sign, infinities, and values rounding up to infinity
+    const uint32_t special[] = {0x7fc00000u, 0x7f800001u, 0x7fffffffu, 0xffffffffu, 0xff800001u, 0x7f800000u, 0xff800000u, 0x7f7fffffu, 0xff7fffffu, 0x80000000u};
+    const int numSpecial = sizeof(special) / sizeof(special[0]);
+
+    std::vector<float> s(numSpecial);
+    memcpy(s.data(), special, sizeof(special));
+
+    LowPrecision::cast<float, float16>(s.data(), h.data(), numSpecial);
+    LowPrecision::cast<float, bfloat16>(s.data(), b.data(), numSpecial);
+
+    for (int e = 0; e < numSpecial; e++) {
+        bfloat16 exp;
+        exp = s[e];
+
+        ASSERT_EQ(exp._data, b[e]._data);
+        ASSERT_EQ(std::isnan(s[e]), std::isnan(static_cast<float>(b[e])));
+        ASSERT_EQ(std::isnan(s[e]), std::isnan(static_cast<float>(h[e])));
+
+        if (!std::isnan(s[e]))
+            ASSERT_EQ(static_cast<float>(static_cast<float16>(s[e])), static_cast<float>(h[e]));
+    }
+}
+
+////////////////////////////////////////////////////////////////////
+TEST_F(DataTypesValidationTests, test_low_precision_transform_1) {
+    auto x = NDArrayFactory::create<float>('c', {3, 347});
+    x.linspace(-8.f, 0.015f);
+
+    auto h = x.cast(sd::DataType::HALF);
+    auto b = x.cast(sd::DataType::BFLOAT16);
+
+    // half and bfloat16 loops compute in fp32, so results match fp32 ones rounded once
+    auto expH = h.cast(sd::DataType::FLOAT32).transform(transform::Sigmoid).cast(sd::DataType::HALF);
+    auto expB = b.cast(sd::DataType::FLOAT32).transform(transform::Sigmoid).cast(sd::DataType::BFLOAT16);
+
+    ASSERT_TRUE(expH.equalsTo(h.transform(transform::Sigmoid)));
+    ASSERT_TRUE(expB.equalsTo(b.transform(transform::Sigmoid)));
+
+    auto expSum = h.cast(sd::DataType::FLOAT32).reduceAlongDimension(reduce::Sum, {1});
+    auto sum = h.reduceAlongDimension(reduce::Sum, {1});
+
+    for (Nd4jLong e = 0; e < sum.lengthOf(); e++)
+        ASSERT_NEAR(expSum.e<float>(e), sum.e<float>(e), 1.f);
+}
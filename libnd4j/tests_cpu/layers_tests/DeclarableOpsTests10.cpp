@@ -707,6 +707,88 @@ TEST_F(DeclarableOpsTests10, top_k_permuted_test2) {
     ASSERT_TRUE(expSorted.equalsTo(z));
 }
 
+//////////////////////////////////////////////////////////////////////////////
+TEST_F(DeclarableOpsTests10, top_k_large_test1) {
+    // long rows with lots of equal values: both heap and quickselect paths, and split rows
+    const int rows = 3, width = 50000;
+    auto x = NDArrayFactory::create<float>('c', {rows, width});
+    for (int e = 0; e < x.lengthOf(); e++)
+        x.r<float>(e) = static_cast<float>((e * 7919) % 1000);
+
+    sd::ops::top_k op;
+
+    for (int k : {1, 20, 5000}) {
+        for (bool sorted : {true, false}) {
+            auto result = op.evaluate({&x}, {}, {k}, {sorted});
+            ASSERT_EQ(ND4J_STATUS_OK, result.status());
+
+            auto v = result.at(0);
+            auto i = result.at(1);
+
+            for (int r = 0; r < rows; r++) {
+                std::vector<int> order(width);
+                std::vector<float> row(width);
+                for (int e = 0; e < width; e++) {
+                    order[e] = e;
+                    row[e] = x.e<float>(r, e);
+                }
+
+                std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return row[a] > row[b]; });
+                order.resize(k);
+                if (!sorted)
+                    std::sort(order.begin(), order.end());
+
+                for (int e = 0; e < k; e++) {
+                    ASSERT_EQ(order[e], i->e<Nd4jLong>(r, e));
+                    ASSERT_EQ(row[order[e]], v->e<float>(r, e));
+                }
+            }
+        }
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+TEST_F(DeclarableOpsTests10, top_k_nan_test1) {
+    // NaN ranks above any other value, NaNs are ordered by index: covers k == 1, quickselect and heap paths
+    const int rows = 2, width = 100;
+    auto x = NDArrayFactory::create<float>('c', {rows, width});
+    for (int e = 0; e < x.lengthOf(); e++)
+        x.r<float>(e) = e % 7 == 3 ? std::numeric_limits<float>::quiet_NaN() : static_cast<float>((e * 31) % 37);
+
+    sd::ops::top_k op;
+
+    for (int k : {1, 2, 20, 90}) {
+        auto result = op.evaluate({&x}, {}, {k}, {true});
+        ASSERT_EQ(ND4J_STATUS_OK, result.status());
+
+        auto v = result.at(0);
+        auto i = result.at(1);
+
+        for (int r = 0; r < rows; r++) {
+            std::vector<int> order(width);
+            std::vector<float> row(width);
+            for (int e = 0; e < width; e++) {
+                order[e] = e;
+                row[e] = x.e<float>(r, e);
+            }
+
+            std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+                if (std::isnan(row[a]) || std::isnan(row[b]))
+                    return std::isnan(row[a]) && !std::isnan(row[b]);
+                return row[a] > row[b];
+            });
+
+            for (int e = 0; e < k; e++) {
+                ASSERT_EQ(order[e], i->e<Nd4jLong>(r, e));
+                if (std::isnan(row[order[e]]))
+                    ASSERT_TRUE(std::isnan(v->e<float>(r, e)));
+                else
+                    ASSERT_EQ(row[order[e]], v->e<float>(r, e));
+            }
+        }
+    }
+}
+
 ///////////////////////////////////////////////////////////////////
 TEST_F(DeclarableOpsTests10, sparse_softmax_cross_entropy_loss_with_logits_test1) {
 
@@ -1315,6 +1315,45 @@ TEST_F(DeclarableOpsTests12, inTopK_5) {
     
 }
 
+//////////////////////////////////////////////////////////////////////
+TEST_F(DeclarableOpsTests12, inTopK_6) {
+    // targets tied with the k-th largest value are in top k, same as TF
+    auto x = NDArrayFactory::create<double>('c', {4, 4}, {5.0, 5.0, 5.0, 1.0, 5.0, 5.0, 5.0, 1.0, 1.0, 2.0, 2.0, 3.0, 1.0, 2.0, 2.0, 3.0});
+    auto y = NDArrayFactory::create<Nd4jLong>('c', {4}, {1, 2, 1, 2});
+    auto expV = NDArrayFactory::create<bool>('c', {4}, {true, true, true, true});
+
+    sd::ops::in_top_k op;
+    auto result = op.evaluate({&x, &y}, {}, {2});
+
+    ASSERT_EQ(ND4J_STATUS_OK, result.status());
+
+    auto v = result.at(0);
+
+    ASSERT_TRUE(expV.isSameShape(v));
+    ASSERT_TRUE(expV.equalsTo(v));
+}
+
+//////////////////////////////////////////////////////////////////////
+TEST_F(DeclarableOpsTests12, inTopK_7) {
+    // NaN ranks above any other value, same way top_k does
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    auto x = NDArrayFactory::create<double>('c', {3, 4}, {nan, 5.0, 4.0, 1.0, 1.0, nan, nan, 3.0, 2.0, nan, 7.0, 3.0});
+    auto y = NDArrayFactory::create<Nd4jLong>('c', {3}, {1, 2, 2});
+    auto expV = NDArrayFactory::create<bool>('c', {3}, {true, true, true});
+
+    sd::ops::in_top_k op;
+    auto result = op.evaluate({&x, &y}, {}, {2});
+
+    ASSERT_EQ(ND4J_STATUS_OK, result.status());
+    ASSERT_TRUE(expV.equalsTo(result.at(0)));
+
+    auto result1 = op.evaluate({&x, &y}, {}, {1});
+    auto expV1 = NDArrayFactory::create<bool>('c', {3}, {false, true, false});
+
+    ASSERT_EQ(ND4J_STATUS_OK, result1.status());
+    ASSERT_TRUE(expV1.equalsTo(result1.at(0)));
+}
+
 ////////////////////////////////////////////////////////////////////
 TEST_F(DeclarableOpsTests12, cube_1) {
 
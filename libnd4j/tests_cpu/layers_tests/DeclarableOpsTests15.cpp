@@ -779,6 +779,49 @@ TEST_F(DeclarableOpsTests15, test_lstmBlock_2) {
 
 }
 
+//////////////////////////////////////////////////////////////////////
+// input projection is computed for all time steps at once, results must not depend on data format
+TEST_F(DeclarableOpsTests15, test_lstmBlock_4) {
+    int seqLen = 5;
+    int bS = 3;
+    int nIn = 4;
+    int nOut = 6;
+
+    auto maxTS = NDArrayFactory::create<Nd4jLong>(seqLen);
+    NDArray xTNS('c', {seqLen, bS, nIn}, sd::DataType::FLOAT32);
+    NDArray cLast('c', {bS, nOut}, sd::DataType::FLOAT32);
+    NDArray yLast('c', {bS, nOut}, sd::DataType::FLOAT32);
+    NDArray W('c', {nIn + nOut, 4 * nOut}, sd::DataType::FLOAT32);
+    NDArray Wci('c', {nOut}, sd::DataType::FLOAT32);
+    NDArray Wcf('c', {nOut}, sd::DataType::FLOAT32);
+    NDArray Wco('c', {nOut}, sd::DataType::FLOAT32);
+    NDArray b('c', {4 * nOut}, sd::DataType::FLOAT32);
+
+    xTNS.linspace(-1, 0.03);
+    cLast.linspace(0.1, 0.05);
+    yLast.linspace(-0.2, 0.04);
+    W.linspace(-0.5, 0.005);
+    Wci = 0.1;
+    Wcf = 0.2;
+    Wco = 0.3;
+    b.linspace(0.1, -0.01);
+
+    auto xNST = xTNS.permute({1, 2, 0}).dup('c');     // [bS, nIn, seqLen]
+    auto xNTS = xTNS.permute({1, 0, 2}).dup('c');     // [bS, seqLen, nIn]
+
+    sd::ops::lstmBlock op;
+    auto resTNS = op.evaluate({&maxTS, &xTNS, &cLast, &yLast, &W, &Wci, &Wcf, &Wco, &b}, {1.0, 0.0}, {1, 0});
+    auto resNST = op.evaluate({&maxTS, &xNST, &cLast, &yLast, &W, &Wci, &Wcf, &Wco, &b}, {1.0, 0.0}, {1, 1});
+    auto resNTS = op.evaluate({&maxTS, &xNTS, &cLast, &yLast, &W, &Wci, &Wcf, &Wco, &b}, {1.0, 0.0}, {1, 2});
+    ASSERT_EQ(Status::OK(), resTNS.status());
+    ASSERT_EQ(Status::OK(), resNST.status());
+    ASSERT_EQ(Status::OK(), resNTS.status());
+
+    auto yTNS = resTNS.at(6);
+    ASSERT_TRUE(yTNS->permute({1, 2, 0}).equalsTo(resNST.at(6)));
+    ASSERT_TRUE(yTNS->permute({1, 0, 2}).equalsTo(resNTS.at(6)));
+}
+
 TEST_F(DeclarableOpsTests15, test_lstmBlock_3) {
 
     int seqLen = 3;
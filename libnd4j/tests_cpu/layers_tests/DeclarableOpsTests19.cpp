@@ -21,11 +21,13 @@
 
 #include "testlayers.h"
 #include <ops/declarable/CustomOperations.h>
+#include <ops/declarable/helpers/quantization.h>
 #include <array/NDArray.h>
 #include <ops/ops.h>
 #include <helpers/GradCheck.h>
 #include <array>
 #include <helpers/RandomLauncher.h>
+#include <loops/type_conversions.h>
 
 
 using namespace sd;
@@ -133,6 +135,80 @@ TEST_F(DeclarableOpsTests19, test_threshold_decode_1) {
     ASSERT_EQ(exp_gradients, x);
 }
 
+TEST_F(DeclarableOpsTests19, test_threshold_encode_varint_1) {
+    auto initial = NDArrayFactory::create<float>('c', {200000});
+    for (int e = 0; e < initial.lengthOf(); e += 3)
+        initial.p(e, e % 2 == 0 ? 1.5f : -1.5f);
+
+    auto exp = initial.dup();
+
+    sd::ops::encode_threshold enc;
+    auto flexible = enc.evaluate({&exp}, {1.0f});
+    auto enc_result = enc.evaluate({&initial}, {1.0f}, {DataTypeUtils::max<int>(), 1});
+    ASSERT_EQ(Status::OK(), enc_result.status());
+
+    auto encoded = enc_result.at(1);
+
+    // every index delta takes single byte here
+    ASSERT_EQ(THRESHOLD_VARINT_ENCODING, encoded->e<int>(3));
+    ASSERT_GT(flexible.at(1)->lengthOf(), 3 * encoded->lengthOf());
+
+    for (int e = 0; e < initial.lengthOf(); e++)
+        ASSERT_EQ(e % 3 == 0 ? (e % 2 == 0 ? 0.5f : -0.5f) : 0.0f, initial.e<float>(e));
+
+    // both encodings must decode into the same updates
+    auto exp_decoded = exp.dup();
+    sd::ops::decode_threshold dec;
+    ASSERT_EQ(Status::OK(), dec.execute({&exp_decoded, flexible.at(1)}, {&exp_decoded}));
+    ASSERT_EQ(Status::OK(), dec.execute({&initial, encoded}, {&initial}));
+
+    ASSERT_EQ(exp_decoded, initial);
+}
+
+TEST_F(DeclarableOpsTests19, test_threshold_encode_varint_boundary_1) {
+    auto x = NDArrayFactory::create<float>('c', {1000});
+    x = 1.0f;
+
+    sd::ops::encode_threshold op;
+    auto result = op.evaluate({&x}, {1.0}, {100, 1});
+
+    auto encoded = result.at(1);
+
+    // first 100 elements are encoded, with 1 byte per element
+    ASSERT_EQ(THRESHOLD_VARINT_HEADER_LENGTH + 25, encoded->lengthOf());
+    ASSERT_EQ(900, x.sumNumber().e<int>(0));
+    ASSERT_EQ(0, x.e<int>(99));
+    ASSERT_EQ(1, x.e<int>(100));
+}
+
+TEST_F(DeclarableOpsTests19, test_threshold_decode_varint_malformed_1) {
+    auto x = NDArrayFactory::create<float>('c', {4});
+    auto exp = NDArrayFactory::create<float>('c', {4}, {1.0f, -1.0f, 0.0f, 0.0f});
+    auto encoded = NDArrayFactory::create<int>('c', {THRESHOLD_VARINT_HEADER_LENGTH + 1});
+
+    float threshold = 1.0f;
+    auto buffer = encoded.bufferAsT<int>();
+    buffer[0] = 3;
+    buffer[1] = 4;
+    buffer[2] = reinterpret_cast<int *>(&threshold)[0];
+    buffer[3] = THRESHOLD_VARINT_ENCODING;
+
+    auto header = reinterpret_cast<Nd4jLong *>(buffer + THRESHOLD_HEADER_LENGTH);
+    header[0] = 4;
+    header[1] = 3;
+    header[2] = 3;
+
+    // zero delta for the first element points at index -1, it must be skipped
+    auto stream = reinterpret_cast<uint8_t *>(buffer + THRESHOLD_VARINT_HEADER_LENGTH);
+    stream[0] = 0x00;
+    stream[1] = 0x02;
+    stream[2] = 0x03;
+
+    sd::ops::decode_threshold op;
+    ASSERT_EQ(Status::OK(), op.execute({&x, &encoded}, {&x}));
+    ASSERT_EQ(exp, x);
+}
+
 TEST_F(DeclarableOpsTests19, test_bitmap_encode_1) {
     auto initial = NDArrayFactory::create<float>('c', {6}, {0.0f, 0.0f, 1e-3f, -1e-3f, 0.0f, 0.0f});
     auto exp_0 = initial.like();
@@ -421,3 +497,151 @@ TEST_F(DeclarableOpsTests19, test_squeeze_1) {
     ASSERT_EQ(Status::OK(), status);
 }
 
+
+TEST_F(DeclarableOpsTests19, test_quantization_range_1) {
+    auto x0 = NDArrayFactory::create<float>('c', {4}, {-1.f, 0.5f, 2.f, 1.f});
+    auto x1 = NDArrayFactory::create<float>('c', {4}, {-3.f, 0.f, 1.f, 4.f});
+
+    sd::ops::quantization_range op;
+    auto first = op.evaluate({&x0});
+    ASSERT_EQ(Status::OK(), first.status());
+    ASSERT_EQ(NDArrayFactory::create<float>('c', {2}, {-1.f, 2.f}), *first.at(0));
+    ASSERT_NEAR(3.f / 255.f, first.at(1)->e<float>(0), 1e-6);
+    ASSERT_EQ(sd::DataType::UINT8, first.at(2)->dataType());
+    ASSERT_EQ(85, first.at(2)->e<int>(0));
+
+    // next batch widens recorded range
+    auto second = op.evaluate({&x1, first.at(0)});
+    ASSERT_EQ(NDArrayFactory::create<float>('c', {2}, {-3.f, 4.f}), *second.at(0));
+    ASSERT_NEAR(7.f / 255.f, second.at(1)->e<float>(0), 1e-6);
+    ASSERT_EQ(109, second.at(2)->e<int>(0));
+
+    // moving average
+    auto averaged = op.evaluate({&x1, first.at(0)}, {0.5});
+    ASSERT_EQ(NDArrayFactory::create<float>('c', {2}, {-2.f, 3.f}), *averaged.at(0));
+
+    // symmetric int8
+    auto symmetric = op.evaluate({&x0}, {}, {1});
+    ASSERT_NEAR(2.f / 127.f, symmetric.at(1)->e<float>(0), 1e-6);
+    ASSERT_EQ(sd::DataType::INT8, symmetric.at(2)->dataType());
+    ASSERT_EQ(0, symmetric.at(2)->e<int>(0));
+}
+
+TEST_F(DeclarableOpsTests19, test_quantized_matmul_1) {
+    auto a = NDArrayFactory::create<uint8_t>('c', {2, 2}, {1, 2, 3, 100});
+    auto b = NDArrayFactory::create<int8_t>('c', {2, 2}, {1, 0, 0, 1});
+    auto aScale = NDArrayFactory::create<float>(1.f);
+    auto aZero = NDArrayFactory::create<uint8_t>(0);
+    auto bScale = NDArrayFactory::create<float>(1.f);
+    auto bZero = NDArrayFactory::create<int8_t>(0);
+    auto outScale = NDArrayFactory::create<float>(0.5f);
+    auto outZero = NDArrayFactory::create<int8_t>(10);
+
+    // transposed a, requantized with saturation
+    auto exp = NDArrayFactory::create<int8_t>('c', {2, 2}, {12, 16, 14, 127});
+
+    sd::ops::quantized_matmul op;
+    auto result = op.evaluate({&a, &aScale, &aZero, &b, &bScale, &bZero, &outScale, &outZero}, {}, {1, 0});
+    ASSERT_EQ(Status::OK(), result.status());
+    ASSERT_EQ(exp, *result.at(0));
+}
+
+TEST_F(DeclarableOpsTests19, test_quantized_matmul_2) {
+    auto a = NDArrayFactory::create<uint8_t>('c', {2, 2}, {1, 2, 3, 4});
+    auto b = NDArrayFactory::create<int8_t>('c', {2, 2}, {1, 0, 0, 1});
+    auto scale = NDArrayFactory::create<float>(1.f);
+    auto aZero = NDArrayFactory::create<uint8_t>(0);
+    auto bZero = NDArrayFactory::create<int8_t>(0);
+
+    auto &cache = ops::helpers::QuantizedWeightsCache::getInstance();
+    cache.clear();
+
+    // packed b is reused by the second call
+    sd::ops::quantized_matmul op;
+    auto result = op.evaluate({&a, &scale, &aZero, &b, &scale, &bZero});
+    ASSERT_EQ(Status::OK(), result.status());
+    result = op.evaluate({&a, &scale, &aZero, &b, &scale, &bZero});
+    ASSERT_EQ(Status::OK(), result.status());
+    ASSERT_EQ(1, cache.misses());
+    ASSERT_EQ(1, cache.hits());
+    ASSERT_EQ(NDArrayFactory::create<float>('c', {2, 2}, {1.f, 2.f, 3.f, 4.f}), *result.at(0));
+
+    // in-place update of b must not be served from cache
+    b.p(1, (int8_t) 1);
+    result = op.evaluate({&a, &scale, &aZero, &b, &scale, &bZero});
+    ASSERT_EQ(Status::OK(), result.status());
+    ASSERT_EQ(2, cache.misses());
+    ASSERT_EQ(NDArrayFactory::create<float>('c', {2, 2}, {1.f, 3.f, 3.f, 7.f}), *result.at(0));
+}
+
+TEST_F(DeclarableOpsTests19, test_quantized_xw_plus_b_1) {
+    NDArray x('c', {5, 37}, sd::DataType::FLOAT32);
+    NDArray w('c', {11, 37}, sd::DataType::FLOAT32);
+    NDArray bias('c', {11}, sd::DataType::FLOAT32);
+    x.linspace(-1.5, 0.017);
+    w.linspace(0.8, -0.0043);
+    bias.linspace(-0.5, 0.1);
+
+    // calibrated activations, symmetric weights with per output channel scales
+    sd::ops::quantization_range calibrate;
+    auto range = calibrate.evaluate({&x});
+    auto xScale = range.at(1);
+    auto xZero = range.at(2);
+
+    auto wScale = w.reduceAlongDimension(reduce::AMax, {1});
+    wScale /= 127.f;
+    NDArray wZero('c', {11}, sd::DataType::INT8);
+    wZero.assign(0);
+
+    sd::ops::quantize_linear quantize;
+    auto qx = quantize.evaluate({&x, xScale, xZero});
+    auto qw = quantize.evaluate({&w, &wScale, &wZero}, {}, {0});
+    ASSERT_EQ(sd::DataType::UINT8, qx.at(0)->dataType());
+    ASSERT_EQ(sd::DataType::INT8, qw.at(0)->dataType());
+
+    sd::ops::quantized_xw_plus_b op;
+    auto result = op.evaluate({qx.at(0), xScale, xZero, qw.at(0), &wScale, &wZero, &bias}, {}, {1});
+    ASSERT_EQ(Status::OK(), result.status());
+    ASSERT_EQ(sd::DataType::FLOAT32, result.at(0)->dataType());
+
+    // integer path must match fp32 computation over dequantized operands
+    sd::ops::dequantize_linear dequantize;
+    auto dx = dequantize.evaluate({qx.at(0), xScale, xZero});
+    auto dw = dequantize.evaluate({qw.at(0), &wScale, &wZero}, {}, {0});
+
+    sd::ops::xw_plus_b reference;
+    auto exp = reference.evaluate({dx.at(0), dw.at(0), &bias}, {}, {1});
+
+    ASSERT_TRUE(exp.at(0)->isSameShape(result.at(0)));
+    ASSERT_TRUE(exp.at(0)->equalsTo(result.at(0), 1e-3));
+}
+
+TEST_F(DeclarableOpsTests19, test_quantized_matmul_validation_1) {
+    auto a = NDArrayFactory::create<uint8_t>('c', {2, 3});
+    auto b = NDArrayFactory::create<int8_t>('c', {3, 2});
+    auto scale = NDArrayFactory::create<float>(1.f);
+    auto aZero = NDArrayFactory::create<int>(0);
+    auto bZero = NDArrayFactory::create<int>(0);
+    auto empty = NDArrayFactory::empty<float>();
+    auto bScales = NDArrayFactory::create<float>('c', {2}, {1.f, 2.f});
+    auto bZeros = NDArrayFactory::create<int>('c', {3}, {0, 0, 0});
+    auto wideZero = NDArrayFactory::create<int>(200);
+
+    sd::ops::quantized_matmul op;
+
+    // scale and zero point are validated separately, so neither can be empty or of other length
+    ASSERT_ANY_THROW(op.evaluate({&a, &scale, &aZero, &b, &empty, &bZero}));
+    ASSERT_ANY_THROW(op.evaluate({&a, &scale, &aZero, &b, &bScales, &bZeros}));
+
+    // zero point must be representable by operand type
+    ASSERT_ANY_THROW(op.evaluate({&a, &scale, &aZero, &b, &scale, &wideZero}));
+
+    // int32 accumulator limits inner dimension
+    auto wideA = NDArrayFactory::create<uint8_t>('c', {1, 33026});
+    auto wideB = NDArrayFactory::create<int8_t>('c', {33026, 1});
+    ASSERT_ANY_THROW(op.evaluate({&wideA, &scale, &aZero, &wideB, &scale, &bZero}));
+
+    sd::ops::dequantize_linear dequantize;
+    auto zero = NDArrayFactory::create<int>(300);
+    ASSERT_ANY_THROW(dequantize.evaluate({&a, &scale, &zero}));
+}
@@ -2600,6 +2600,90 @@ TEST_F(DeclarableOpsTests7, TestUnsortedSegmentProdBP_4) {
     
 }
 
+////////////////////////////////////////////////////////////////////////////////
+TEST_F(DeclarableOpsTests7, TestSegmentReductions_Large_1) {
+    // many rows and few segments: rows of each segment are reduced in chunks
+    const int numOfRows = 4096, numOfClasses = 3;
+    auto x = NDArrayFactory::create<double>('c', {numOfRows, 3});
+    auto idx = NDArrayFactory::create<int>('c', {numOfRows});
+    auto sortedIdx = NDArrayFactory::create<int>('c', {numOfRows});
+
+    auto expSum = NDArrayFactory::create<double>('c', {numOfClasses, 3});
+    auto expMax = NDArrayFactory::create<double>('c', {numOfClasses, 3});
+    auto expSortedSum = NDArrayFactory::create<double>('c', {numOfClasses, 3});
+    expMax.assign(-1.e10);
+
+    for (int i = 0; i < numOfRows; i++) {
+        const int c = (i * 13) % numOfClasses;
+        const int sc = i / 1400;
+        idx.p(i, c);
+        sortedIdx.p(i, sc);
+
+        for (int j = 0; j < 3; j++) {
+            const double v = ((i * 31 + j * 7) % 101) - 50;
+            x.p(i, j, v);
+            expSum.p(c, j, expSum.e<double>(c, j) + v);
+            expMax.p(c, j, sd::math::nd4j_max<double>(expMax.e<double>(c, j), v));
+            expSortedSum.p(sc, j, expSortedSum.e<double>(sc, j) + v);
+        }
+    }
+
+    sd::ops::unsorted_segment_sum opSum;
+    auto resSum = opSum.evaluate({&x, &idx}, {}, {numOfClasses});
+    ASSERT_EQ(resSum.status(), Status::OK());
+    ASSERT_TRUE(expSum.equalsTo(resSum.at(0)));
+
+    sd::ops::unsorted_segment_max opMax;
+    auto resMax = opMax.evaluate({&x, &idx}, {}, {numOfClasses});
+    ASSERT_EQ(resMax.status(), Status::OK());
+    ASSERT_TRUE(expMax.equalsTo(resMax.at(0)));
+
+    sd::ops::segment_sum opSortedSum;
+    auto resSortedSum = opSortedSum.evaluate({&x, &sortedIdx});
+    ASSERT_EQ(resSortedSum.status(), Status::OK());
+    ASSERT_TRUE(expSortedSum.equalsTo(resSortedSum.at(0)));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TEST_F(DeclarableOpsTests7, TestSegmentReductionsBP_Large_1) {
+    const int numOfRows = 300, numOfClasses = 40;
+    auto x = NDArrayFactory::create<double>('c', {numOfRows, 5});
+    auto idx = NDArrayFactory::create<int>('c', {numOfRows});
+    auto gradO = NDArrayFactory::create<double>('c', {numOfClasses, 5});
+    auto max = NDArrayFactory::create<double>('c', {numOfClasses, 5});
+    auto count = NDArrayFactory::create<double>('c', {numOfClasses});
+    max.assign(-1.e10);
+    gradO.linspace(1.);
+
+    for (int i = 0; i < numOfRows; i++) {
+        const int c = (i * 7) % numOfClasses;
+        idx.p(i, c);
+        count.p(c, count.e<double>(c) + 1);
+
+        for (int j = 0; j < 5; j++) {
+            x.p(i, j, i * 5 + j);
+            max.p(c, j, sd::math::nd4j_max<double>(max.e<double>(c, j), i * 5 + j));
+        }
+    }
+
+    sd::ops::unsorted_segment_max_bp opMax;
+    auto resMax = opMax.evaluate({&x, &idx, &gradO}, {}, {numOfClasses});
+    ASSERT_EQ(resMax.status(), Status::OK());
+
+    sd::ops::unsorted_segment_mean_bp opMean;
+    auto resMean = opMean.evaluate({&x, &idx, &gradO}, {}, {numOfClasses});
+    ASSERT_EQ(resMean.status(), Status::OK());
+
+    for (int i = 0; i < numOfRows; i++) {
+        const int c = (i * 7) % numOfClasses;
+        for (int j = 0; j < 5; j++) {
+            const double expMax = x.e<double>(i, j) == max.e<double>(c, j) ? gradO.e<double>(c, j) : 0.;
+            ASSERT_NEAR(expMax, resMax.at(0)->e<double>(i, j), 1.e-5);
+            ASSERT_NEAR(gradO.e<double>(c, j) / count.e<double>(c), resMean.at(0)->e<double>(i, j), 1.e-5);
+        }
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 TEST_F(DeclarableOpsTests7, TestExtractImagePatches_1) {
     auto x = NDArrayFactory::create<double>('c', {2,4, 4, 4}, {
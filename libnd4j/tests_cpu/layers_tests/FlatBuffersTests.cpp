@@ -26,6 +26,9 @@
 #include <graph/Node.h>
 #include <graph/Graph.h>
 #include <graph/GraphExecutioner.h>
+#include <graph/FlatUtils.h>
+#include <graph/MappedFile.h>
+#include <fstream>
 #include <ops/declarable/CustomOperations.h>
 
 using namespace sd;
@@ -813,3 +816,51 @@ TEST_F(FlatBuffersTest, ReadLoops_SimpleWhile_1) {
 
  */
 #endif
+
+TEST_F(FlatBuffersTest, MappedGraph_1) {
+    auto x = NDArrayFactory::create<float>('c', {4, 5});
+    x.linspace(1.0);
+
+    flatbuffers::FlatBufferBuilder builder(4096);
+    auto fArray = FlatUtils::toFlatArray(builder, x);
+    auto fId = CreateIntPair(builder, -1, 0);
+    auto fVar = CreateFlatVariable(builder, fId, 0, DType_FLOAT, 0, fArray, 0, VarType_VARIABLE);
+    auto fVars = builder.CreateVector(std::vector<flatbuffers::Offset<FlatVariable>>{fVar});
+    builder.Finish(CreateFlatGraph(builder, 119, fVars));
+
+    const char *fileName = "./mapped_graph_1.fb";
+    {
+        std::ofstream out(fileName, std::ios::binary);
+        out.write(reinterpret_cast<char *>(builder.GetBufferPointer()), builder.GetSize());
+    }
+
+    // array data points straight into the mapping
+    auto mapping = std::make_shared<MappedFile>(fileName);
+    auto flatArray = GetFlatGraph(mapping->data())->variables()->Get(0)->ndarray();
+    auto array = FlatUtils::fromFlatArray(flatArray, mapping);
+
+    ASSERT_EQ(x, *array);
+    if (mapping->isMapped()) {
+        ASSERT_TRUE(mapping->contains(array->buffer(), x.lengthOf() * x.sizeOfT()));
+        ASSERT_TRUE(array->getDataBuffer()->isPrimaryReadOnly());
+    }
+
+    delete array;
+    mapping.reset();
+
+    // arrays keep mapping alive, and mutated arrays get own copy, so writes never reach the file
+    auto graph = GraphExecutioner::importFromMappedFlatBuffers(fileName);
+    auto z = graph->getVariableSpace()->getVariable(-1)->getNDArray();
+    ASSERT_EQ(x, *z);
+
+    z->assign(0.0f);
+    ASSERT_FALSE(z->getDataBuffer()->isPrimaryReadOnly());
+    ASSERT_EQ(0.0f, z->e<float>(0));
+    delete graph;
+
+    auto restored = GraphExecutioner::importFromFlatBuffers(fileName);
+    ASSERT_EQ(x, *restored->getVariableSpace()->getVariable(-1)->getNDArray());
+    delete restored;
+
+    std::remove(fileName);
+}
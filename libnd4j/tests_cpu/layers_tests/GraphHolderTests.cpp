@@ -20,6 +20,8 @@
 
 #include "testlayers.h"
 #include <graph/GraphHolder.h>
+#include <graph/GraphExecutioner.h>
+#include <graph/VariableProxy.h>
 
 using namespace sd;
 using namespace sd::ops;
@@ -83,4 +85,48 @@ TEST_F(GraphHolderTests, SimpleTests_3) {
 
 
     delete graph2;
-}
\ No newline at end of file
+}
+TEST_F(GraphHolderTests, SharedGraphTests_1) {
+    auto graph = new Graph();
+    auto vs = graph->getVariableSpace();
+
+    auto x = NDArrayFactory::create_<float>('c', {3, 3});
+    x->assign(-2.0);
+    vs->putVariable(-1, x);
+
+    graph->addNode(new Node(OpType_TRANSFORM_SAME, transform::Abs, 1, {-1}, {}));
+    graph->addNode(new Node(OpType_TRANSFORM_SAME, transform::Neg, 2, {1}, {}));
+    graph->buildGraph();
+
+    ASSERT_FALSE(graph->hasControlFlow());
+
+    // every request has own inputs, and all of them go through the same graph instance
+    for (int e = 1; e <= 3; e++) {
+        VariableProxy proxy(vs, graph->getMapped());
+
+        auto input = NDArrayFactory::create_<float>('c', {2, 2});
+        input->assign((float) e);
+        proxy.putVariable(-1, input);
+
+        // plan compiled after repeated requests is shared by later ones
+        ASSERT_EQ(e > 2, graph->executionPlan(&proxy) != nullptr);
+
+        ASSERT_EQ(Status::OK(), GraphExecutioner::execute(graph, &proxy));
+
+        auto outputs = graph->fetchOutputs(&proxy);
+        ASSERT_EQ(1, outputs->size());
+
+        auto exp = NDArrayFactory::create<float>('c', {2, 2});
+        exp.assign((float) -e);
+        ASSERT_EQ(exp, *outputs->at(0)->getNDArray());
+
+        delete outputs;
+    }
+
+    // node states of the shared graph stay untouched
+    ASSERT_FALSE(vs->getVariable(1)->hasNDArray());
+    ASSERT_FALSE(vs->getVariable(2)->hasNDArray());
+    ASSERT_EQ(-2.0f, x->e<float>(0));
+
+    delete graph;
+}
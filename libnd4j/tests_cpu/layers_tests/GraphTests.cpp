@@ -25,8 +25,11 @@
 #include <graph/Node.h>
 #include <graph/Graph.h>
 #include <graph/GraphUtils.h>
+#include <helpers/ConstantTadHelper.h>
+#include <helpers/ConstantShapeHelper.h>
 #include <array/NDArray.h>
 #include <ops/declarable/DeclarableOp.h>
+#include <ops/declarable/LegacyFusedOp.h>
 #include <ops/declarable/generic/parity_ops.cpp>
 
 using namespace sd;
@@ -413,6 +416,379 @@ TEST_F(GraphTests, ReductionsTest1) {
 }
 
 
+TEST_F(GraphTests, PrecomputeTads1) {
+    auto graph = new Graph();
+
+    auto x = NDArrayFactory::create_<float>('c', {7, 11, 13});
+    auto z = NDArrayFactory::create_<float>('c', {7, 11});
+
+    graph->getVariableSpace()->putVariable(-1, x);
+    graph->getVariableSpace()->putVariable(-2, z);
+
+    auto nodeA = new Node(OpType_REDUCE_FLOAT, reduce::Mean, 1, {-1}, {2}, {-1}, {});
+    auto nodeB = new Node(OpType_TRANSFORM_SAME, transform::Abs, 2, {1}, {-2});
+
+    graph->addNode(nodeA);
+    graph->addNode(nodeB);
+
+    ASSERT_EQ(Status::OK(), graph->buildGraph());
+
+    auto &helper = ConstantTadHelper::getInstance();
+    auto misses = helper.cacheMisses();
+
+    // TADs for node dimensions were built during buildGraph, so this is a cache hit
+    auto pack = helper.tadForDimensions(x->shapeInfo(), {2});
+    ASSERT_EQ(misses, helper.cacheMisses());
+    ASSERT_EQ(77, pack.numberOfTads());
+
+    ASSERT_EQ(1, helper.precomputeTads(*graph));
+    ASSERT_EQ(misses, helper.cacheMisses());
+
+    delete graph;
+}
+
+TEST_F(GraphTests, PrecomputeTads2) {
+    auto graph = new Graph();
+
+    auto x = NDArrayFactory::create_<float>('c', {5, 9, 6});
+    graph->getVariableSpace()->putVariable(-1, x);
+
+    // second reduction works on output of the first one, which doesn't exist before execution
+    auto nodeA = new Node(OpType_REDUCE_FLOAT, reduce::Mean, 1, {-1}, {2}, {-1}, {});
+    auto nodeB = new Node(OpType_REDUCE_FLOAT, reduce::Mean, 2, {1}, {}, {1}, {});
+
+    graph->addNode(nodeA);
+    graph->addNode(nodeB);
+
+    ASSERT_EQ(Status::OK(), graph->buildGraph());
+
+    auto &helper = ConstantTadHelper::getInstance();
+    auto misses = helper.cacheMisses();
+
+    // inferred shape of node 1 output is [5, 9]
+    auto shapeInfo = ConstantShapeHelper::getInstance().createShapeInfo(sd::DataType::FLOAT32, 'c', {5, 9});
+    auto pack = helper.tadForDimensions(shapeInfo, {1});
+    ASSERT_EQ(misses, helper.cacheMisses());
+    ASSERT_EQ(5, pack.numberOfTads());
+
+    ASSERT_EQ(2, helper.precomputeTads(*graph));
+
+    delete graph;
+}
+
+TEST_F(GraphTests, MemoryPlan1) {
+    if (!Environment::getInstance().isCPU())
+        return;
+
+    auto graph = new Graph();
+
+    auto x = NDArrayFactory::create_<float>('c', {5, 5});
+    x->assign(-2.0);
+
+    graph->getVariableSpace()->putVariable(-1, x);
+
+    // straight chain: intermediates 1 & 3 and 2 & 4 are never alive at the same time
+    graph->addNode(new Node(OpType_TRANSFORM_SAME, transform::Abs, 1, {-1}, {}));
+    graph->addNode(new Node(OpType_TRANSFORM_SAME, transform::Neg, 2, {1}, {}));
+    graph->addNode(new Node(OpType_TRANSFORM_SAME, transform::Abs, 3, {2}, {}));
+    graph->addNode(new Node(OpType_TRANSFORM_SAME, transform::Neg, 4, {3}, {}));
+    graph->addNode(new Node(OpType_TRANSFORM_SAME, transform::Abs, 5, {4}, {}));
+
+    ASSERT_EQ(Status::OK(), graph->buildGraph());
+
+    // clone shares memory plan with the original graph
+    auto clone = graph->clone();
+    ASSERT_FALSE(graph->memoryPlan()->isReady());
+
+    ASSERT_EQ(Status::OK(), GraphExecutioner::execute(graph));
+
+    auto plan = graph->memoryPlan();
+    ASSERT_TRUE(plan->isReady());
+    ASSERT_EQ(4, plan->numberOfSlots());
+    ASSERT_FALSE(plan->hasSlot({5, 0}));
+    ASSERT_EQ(plan->slot({1, 0}).offset, plan->slot({3, 0}).offset);
+    ASSERT_NE(plan->slot({1, 0}).offset, plan->slot({2, 0}).offset);
+    ASSERT_EQ(plan->plannedBytes() / 2, plan->arenaSize());
+
+    // second execution places intermediates within single arena
+    ASSERT_EQ(Status::OK(), GraphExecutioner::execute(clone));
+
+    auto vs = clone->getVariableSpace();
+    ASSERT_TRUE(vs->getVariable(1)->getNDArray()->getDataBuffer() == vs->getVariable(4)->getNDArray()->getDataBuffer());
+    ASSERT_FALSE(vs->getVariable(5)->getNDArray()->getDataBuffer() == vs->getVariable(4)->getNDArray()->getDataBuffer());
+
+    auto exp = NDArrayFactory::create<float>('c', {5, 5});
+    exp.assign(2.0);
+    ASSERT_EQ(exp, *vs->getVariable(5)->getNDArray());
+    ASSERT_EQ(exp, *graph->getVariableSpace()->getVariable(5)->getNDArray());
+
+    delete clone;
+    delete graph;
+}
+
+TEST_F(GraphTests, MemoryPlan2) {
+    if (!Environment::getInstance().isCPU())
+        return;
+
+    auto graph = new Graph();
+
+    auto x = NDArrayFactory::create_<float>('c', {5, 5});
+    x->assign(-2.0);
+
+    graph->getVariableSpace()->putVariable(-1, x);
+
+    graph->addNode(new Node(OpType_TRANSFORM_SAME, transform::Abs, 1, {-1}, {}));
+    graph->addNode(new Node(OpType_TRANSFORM_SAME, transform::Neg, 2, {1}, {}));
+    graph->addNode(new Node(OpType_TRANSFORM_SAME, transform::Abs, 3, {2}, {}));
+
+    ASSERT_EQ(Status::OK(), graph->buildGraph());
+
+    // with planner disabled plan is never built, and each intermediate gets its own buffer
+    Environment::getInstance().setMemoryPlanning(false);
+    auto status = GraphExecutioner::execute(graph);
+    auto status2 = GraphExecutioner::execute(graph);
+    Environment::getInstance().setMemoryPlanning(true);
+
+    ASSERT_EQ(Status::OK(), status);
+    ASSERT_EQ(Status::OK(), status2);
+    ASSERT_FALSE(graph->memoryPlan()->isReady());
+
+    auto vs = graph->getVariableSpace();
+    ASSERT_FALSE(vs->getVariable(1)->getNDArray()->getDataBuffer() == vs->getVariable(3)->getNDArray()->getDataBuffer());
+
+    auto exp = NDArrayFactory::create<float>('c', {5, 5});
+    exp.assign(2.0);
+    ASSERT_EQ(exp, *vs->getVariable(3)->getNDArray());
+
+    delete graph;
+}
+
+TEST_F(GraphTests, ExecutionPlan1) {
+    auto graph = new Graph();
+    auto vs = graph->getVariableSpace();
+
+    auto x = NDArrayFactory::create_<float>('c', {5, 5});
+    x->assign(-2.0);
+
+    vs->putVariable(-1, x);
+
+    graph->addNode(new Node(OpType_TRANSFORM_SAME, transform::Abs, 1, {-1}, {}));
+    graph->addNode(new Node(OpType_TRANSFORM_SAME, transform::Neg, 2, {1}, {}));
+    graph->addNode(new Node(OpType_TRANSFORM_SAME, transform::Abs, 3, {2}, {}));
+
+    // plan is compiled only once graph is executed repeatedly
+    ASSERT_EQ(Status::OK(), GraphExecutioner::execute(graph));
+    ASSERT_TRUE(graph->executionPlan(vs) == nullptr);
+
+    ASSERT_EQ(Status::OK(), GraphExecutioner::execute(graph));
+
+    auto plan = graph->executionPlan(vs);
+    ASSERT_TRUE(plan != nullptr);
+    ASSERT_EQ(3, plan->numberOfSteps());
+    ASSERT_EQ(3, plan->numberOfStaticSteps());
+
+    // third execution goes through the plan, and reuses output arrays
+    auto z = vs->getVariable(3)->getNDArray();
+    x->assign(-3.0);
+    ASSERT_EQ(Status::OK(), GraphExecutioner::execute(graph));
+
+    auto exp = NDArrayFactory::create<float>('c', {5, 5});
+    exp.assign(3.0);
+    ASSERT_TRUE(z == vs->getVariable(3)->getNDArray());
+    ASSERT_EQ(exp, *vs->getVariable(3)->getNDArray());
+
+    // different input shape doesn't match the plan
+    auto y = NDArrayFactory::create<float>('c', {3, 5});
+    vs->getVariable(-1)->setNDArray(&y);
+    ASSERT_TRUE(graph->executionPlan(vs) == nullptr);
+    vs->getVariable(-1)->setNDArray(x);
+
+    // VariableSpace without graph inputs doesn't match the plan either
+    VariableSpace other;
+    ASSERT_TRUE(graph->executionPlan(&other) == nullptr);
+
+    delete graph;
+}
+
+TEST_F(GraphTests, ExecutionPlan2) {
+    auto graph = new Graph();
+    auto vs = graph->getVariableSpace();
+
+    auto x = NDArrayFactory::create_<float>('c', {3, 4});
+    x->assign(1.0);
+    vs->putVariable(-1, x);
+    vs->putVariable(-2, NDArrayFactory::create_<int>('c', {1}, {0}));
+
+    // custom op with axis as argument has static shapes, while axis passed as array makes shape function read it
+    sd::ops::reduce_sum op;
+    graph->addNode(new Node(&op, 1, {-1}, {}, {}, 0.0f, {}, {1}));
+    graph->addNode(new Node(&op, 2, {-1, -2}, {}, {}, 0.0f, {}, {}));
+
+    for (int e = 0; e < 3; e++) {
+        x->assign(e + 1.0);
+        ASSERT_EQ(Status::OK(), GraphExecutioner::execute(graph));
+
+        auto exp1 = NDArrayFactory::create<float>('c', {3});
+        exp1.assign(4.0 * (e + 1));
+
+        auto exp2 = NDArrayFactory::create<float>('c', {4});
+        exp2.assign(3.0 * (e + 1));
+
+        ASSERT_EQ(exp1, *vs->getVariable(1)->getNDArray());
+        ASSERT_EQ(exp2, *vs->getVariable(2)->getNDArray());
+    }
+
+    auto plan = graph->executionPlan(vs);
+    ASSERT_TRUE(plan != nullptr);
+    ASSERT_EQ(2, plan->numberOfSteps());
+    ASSERT_EQ(1, plan->numberOfStaticSteps());
+    ASSERT_EQ(2, plan->numberOfWaves());
+
+    delete graph;
+}
+
+static Graph* fusedChainGraph(const NDArray &x, const NDArray &y0, const NDArray &y1) {
+    auto graph = new Graph();
+    auto vs = graph->getVariableSpace();
+
+    vs->putVariable(-1, new NDArray(x.dup(x.ordering())));
+    vs->putVariable(-2, new NDArray(y0.dup(y0.ordering())));
+    vs->putVariable(-3, new NDArray(y1.dup(y1.ordering())));
+
+    // cos(y1 - sqrt(|x| + 2) * y0), every op of each kind, with chain used as both X and Y of pairwise ops
+    graph->addNode(new Node(OpType_TRANSFORM_SAME, transform::Abs, 1, {-1}, {}));
+    graph->addNode(new Node(OpType_SCALAR, scalar::Add, 2, {1}, {}, {}, 2.0f));
+    graph->addNode(new Node(OpType_TRANSFORM_FLOAT, transform::Sqrt, 3, {2}, {}));
+    graph->addNode(new Node(OpType_PAIRWISE, pairwise::Multiply, 4, {3, -2}, {}));
+    graph->addNode(new Node(OpType_PAIRWISE, pairwise::Subtract, 5, {-3, 4}, {}));
+    graph->addNode(new Node(OpType_TRANSFORM_STRICT, transform::Cosine, 6, {5}, {}));
+
+    return graph;
+}
+
+TEST_F(GraphTests, FusedElementwise1) {
+    auto x = NDArrayFactory::create<float>('c', {100, 50});
+    auto y0 = NDArrayFactory::create<float>('c', {100, 50});
+    auto y1 = NDArrayFactory::create<float>('c', {100, 50});
+    x.linspace(-10.0, 0.01);
+    y0.linspace(0.5, 0.001);
+    y1.linspace(3.0, -0.002);
+
+    auto exp = x.ulike();
+    for (Nd4jLong e = 0; e < x.lengthOf(); e++)
+        exp.p(e, std::cos(y1.e<float>(e) - std::sqrt(std::abs(x.e<float>(e)) + 2.0f) * y0.e<float>(e)));
+
+    Environment::getInstance().setElementwiseFusion(true);
+
+    // contiguous arrays go through single pass, f-ordered operand makes chain fall back to op-by-op execution
+    for (auto order: {'c', 'f'}) {
+        auto graph = fusedChainGraph(x, y0, y1.dup(order));
+        ASSERT_EQ(Status::OK(), graph->buildGraph());
+
+        int numNodes = 0;
+        for (auto &l: *graph->getOnion())
+            numNodes += (int) l.second->size();
+
+        ASSERT_EQ(1, numNodes);
+        auto fused = dynamic_cast<ops::LegacyFusedOp*>(graph->nodeById(6)->getCustomOp());
+        ASSERT_TRUE(fused != nullptr);
+        ASSERT_EQ(6, fused->numberOfSteps());
+
+        // repeated executions go through execution plan
+        for (int e = 0; e < 3; e++) {
+            ASSERT_EQ(Status::OK(), GraphExecutioner::execute(graph));
+
+            auto z = graph->getVariableSpace()->getVariable(6)->getNDArray();
+            ASSERT_TRUE(exp.isSameShape(z));
+            ASSERT_TRUE(exp.equalsTo(z, 1e-5));
+        }
+
+        delete graph;
+    }
+
+    Environment::getInstance().setElementwiseFusion(false);
+
+    // without fusion all nodes are kept
+    auto graph = fusedChainGraph(x, y0, y1);
+    ASSERT_EQ(Status::OK(), GraphExecutioner::execute(graph));
+    ASSERT_TRUE(dynamic_cast<ops::LegacyFusedOp*>(graph->nodeById(6)->getCustomOp()) == nullptr);
+    ASSERT_TRUE(exp.equalsTo(graph->getVariableSpace()->getVariable(6)->getNDArray(), 1e-5));
+
+    delete graph;
+}
+
+TEST_F(GraphTests, FusedElementwise2) {
+    auto graph = new Graph();
+    auto vs = graph->getVariableSpace();
+
+    auto x = NDArrayFactory::create_<float>('c', {5, 5});
+    x->assign(-2.0);
+    vs->putVariable(-1, x);
+
+    Environment::getInstance().setElementwiseFusion(true);
+
+    // node 2 result is used twice, so it ends chain 1 -> 2, and chain 3 -> 5 starts from it
+    graph->addNode(new Node(OpType_TRANSFORM_SAME, transform::Abs, 1, {-1}, {}));
+    graph->addNode(new Node(OpType_TRANSFORM_SAME, transform::Neg, 2, {1}, {}));
+    graph->addNode(new Node(OpType_TRANSFORM_SAME, transform::Abs, 3, {2}, {}));
+    graph->addNode(new Node(OpType_TRANSFORM_SAME, transform::Square, 4, {3}, {}));
+    graph->addNode(new Node(OpType_PAIRWISE, pairwise::Add, 5, {4, 2}, {}));
+
+    auto status = GraphExecutioner::execute(graph);
+    Environment::getInstance().setElementwiseFusion(false);
+    ASSERT_EQ(Status::OK(), status);
+
+    ASSERT_EQ(2, dynamic_cast<ops::LegacyFusedOp*>(graph->nodeById(2)->getCustomOp())->numberOfSteps());
+    ASSERT_EQ(3, dynamic_cast<ops::LegacyFusedOp*>(graph->nodeById(5)->getCustomOp())->numberOfSteps());
+
+    auto exp = NDArrayFactory::create<float>('c', {5, 5});
+    exp.assign(2.0);
+    ASSERT_EQ(exp, *vs->getVariable(5)->getNDArray());
+
+    delete graph;
+}
+
+TEST_F(GraphTests, ConcurrentLayer1) {
+    auto graph = new Graph();
+    graph->getExecutorConfiguration()->_executionMode = ExecutionMode_AUTO;
+
+    auto x = NDArrayFactory::create_<float>('c', {5, 5});
+    x->assign(-2.0);
+
+    graph->getVariableSpace()->putVariable(-1, x);
+
+    // wide layer: 4 independent nodes, followed by nodes reducing them pairwise
+    graph->addNode(new Node(OpType_TRANSFORM_SAME, transform::Abs, 1, {-1}, {}));
+    graph->addNode(new Node(OpType_TRANSFORM_SAME, transform::Neg, 2, {-1}, {}));
+    graph->addNode(new Node(OpType_TRANSFORM_SAME, transform::Square, 3, {-1}, {}));
+    graph->addNode(new Node(OpType_TRANSFORM_SAME, transform::Abs, 4, {-1}, {}));
+    graph->addNode(new Node(OpType_PAIRWISE, pairwise::Add, 5, {1, 2}, {}));
+    graph->addNode(new Node(OpType_PAIRWISE, pairwise::Add, 6, {3, 4}, {}));
+
+    for (int e = 0; e < 3; e++) {
+        ASSERT_EQ(Status::OK(), GraphExecutioner::execute(graph));
+
+        auto vs = graph->getVariableSpace();
+        auto exp5 = NDArrayFactory::create<float>('c', {5, 5});
+        exp5.assign(4.0);
+
+        auto exp6 = NDArrayFactory::create<float>('c', {5, 5});
+        exp6.assign(6.0);
+
+        ASSERT_EQ(exp5, *vs->getVariable(5)->getNDArray());
+        ASSERT_EQ(exp6, *vs->getVariable(6)->getNDArray());
+    }
+
+    // last execution went through the plan, with independent steps grouped together
+    auto plan = graph->executionPlan(graph->getVariableSpace());
+    ASSERT_TRUE(plan != nullptr);
+    ASSERT_EQ(6, plan->numberOfSteps());
+    ASSERT_EQ(6, plan->numberOfStaticSteps());
+    ASSERT_EQ(2, plan->numberOfWaves());
+
+    delete graph;
+}
+
 TEST_F(GraphTests, IndexReductionsTest1) {
     auto graph = new Graph();
 
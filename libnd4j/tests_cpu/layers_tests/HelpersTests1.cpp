@@ -1541,6 +1541,51 @@ TEST_F(HelpersTests1, mmulHelper_test_7) {
 
 }
 
+////////////////////////////////////////////////////////////////////
+TEST_F(HelpersTests1, mmulHelper_test_8) {
+
+    // half goes through blocked gemm fallback, results are compared against double blas path
+    NDArray x('c', {37, 300}, sd::DataType::DOUBLE);
+    NDArray y('f', {300, 45}, sd::DataType::DOUBLE);
+    x.linspace(-1., 0.01);
+    y.linspace(1., -0.005);
+
+    NDArray expected('c', {37, 45}, sd::DataType::DOUBLE);
+    MmulHelper::mmul(&x, &y, &expected, 1., 0.);
+
+    auto xH = x.cast(sd::DataType::HALF);
+    auto yH = y.cast(sd::DataType::HALF);
+    NDArray result('c', {37, 45}, sd::DataType::HALF);
+
+    MmulHelper::mmul(&xH, &yH, &result, 1., 0.);
+
+    auto resultD = result.cast(sd::DataType::DOUBLE);
+    auto diff = (resultD - expected).reduceNumber(reduce::AMax).e<double>(0);
+    auto maxVal = expected.reduceNumber(reduce::AMax).e<double>(0);
+
+    ASSERT_TRUE(diff / maxVal < 5e-3);
+}
+
+////////////////////////////////////////////////////////////////////
+TEST_F(HelpersTests1, mmulHelper_test_9) {
+
+    // integer inputs given as transposed views, beta accumulation into 'f' ordered output
+    auto x = NDArrayFactory::create<int>('c', {3, 4});  x.linspace(1);
+    auto y = NDArrayFactory::create<int>('c', {5, 3});  y.linspace(1);
+    auto xT = x.transpose();
+    auto yT = y.transpose();
+
+    auto result = NDArrayFactory::create<int>('f', {4, 5});
+    result.assign(1);
+
+    auto expected = NDArrayFactory::create<int>('c', {4, 5}, {39, 84, 129, 174, 219, 45, 99, 153, 207, 261, 51, 114, 177, 240, 303, 57, 129, 201, 273, 345});
+
+    MmulHelper::mmul(&xT, &yT, &result, 1., 1.);
+
+    ASSERT_TRUE(expected.isSameShape(&result));
+    ASSERT_TRUE(expected.equalsTo(&result));
+}
+
 ////////////////////////////////////////////////////////////////////
 TEST_F(HelpersTests1, tensordot_test_1) {
 
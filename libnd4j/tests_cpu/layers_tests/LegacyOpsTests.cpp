@@ -31,6 +31,7 @@
 #include <ops/declarable/LegacyBroadcastOp.h>
 #include <helpers/TAD.h>
 #include <helpers/ConstantTadHelper.h>
+#include <helpers/MmulHelper.h>
 
 using namespace sd;
 using namespace sd::ops;
@@ -766,3 +767,47 @@ TEST_F(LegacyOpsTests, test_legacy_transform_float_1) {
 
     NativeOpExecutioner::execTransformFloat(LaunchContext::defaultContext(), transform::FloatOps::RSqrt, x.buffer(), x.shapeInfo(), x.specialBuffer(), x.specialShapeInfo(), x.buffer(), x.shapeInfo(), x.specialBuffer(), x.specialShapeInfo(), nullptr, nullptr, nullptr);
 }
+
+TEST_F(LegacyOpsTests, test_isa_dispatch_1) {
+    if (!Environment::getInstance().isCPU())
+        return;
+
+    auto x = NDArrayFactory::create<float>('c', {3, 1031});
+    auto y = NDArrayFactory::create<float>('c', {3, 1031});
+    auto row = NDArrayFactory::create<float>('c', {1031});
+    auto a = NDArrayFactory::create<float16>('c', {37, 129});
+    auto b = NDArrayFactory::create<float16>('c', {129, 41});
+    x.linspace(0.1, 0.01);
+    y.linspace(-2.0, 0.003);
+    row.linspace(1.0, 0.5);
+    a.linspace(-1.0, 0.0003);
+    b.linspace(0.5, -0.0002);
+
+    auto compute = [&]() {
+        std::vector<NDArray> result;
+        result.emplace_back(x.transform(transform::Sqrt));
+        result.emplace_back(x + 2.0f);
+        result.emplace_back(x * y);
+        result.emplace_back(x + row);
+        result.emplace_back(y.reduceAlongDimension(reduce::Sum, {1}));
+
+        auto c = MmulHelper::mmul(&a, &b);
+        result.emplace_back(*c);
+        delete c;
+
+        return result;
+    };
+
+    const auto level = Environment::getInstance().isaLevel();
+
+    // whatever variant host picks, it must match the generic one
+    auto best = compute();
+    Environment::getInstance().setIsaLevel(1);
+    auto generic = compute();
+    Environment::getInstance().setIsaLevel(level);
+
+    ASSERT_EQ(level, Environment::getInstance().isaLevel());
+    ASSERT_EQ(best.size(), generic.size());
+    for (size_t e = 0; e < best.size(); e++)
+        ASSERT_TRUE(best[e].equalsTo(generic[e], 1e-2));
+}
@@ -1304,4 +1304,32 @@ TEST_F(NDArrayTest2, test_numpy_import_1) {
     auto array = NDArrayFactory::fromNpyFile(fname.c_str());
 
     ASSERT_EQ(exp, array);
-}
\ No newline at end of file
+}
+
+//////////////////////////////////////////////////////////////////////
+TEST_F(NDArrayTest2, test_permuted_pairwise_1) {
+    auto x = NDArrayFactory::create<float>('c', {2, 3, 4, 5});
+    auto y = NDArrayFactory::create<float>('f', {2, 4, 5, 3});
+    x.linspace(1);
+    y.linspace(1);
+
+    // x is walked in permuted order, y in f order, result is c-ordered
+    auto xp = x.permute({0, 2, 3, 1});
+    auto z = xp * y;
+    auto s = xp * 2.f;
+
+    auto e = NDArrayFactory::create<float>('c', {2, 4, 5, 3});
+    auto es = NDArrayFactory::create<float>('c', {2, 4, 5, 3});
+    for (int n = 0; n < 2; n++)
+        for (int h = 0; h < 4; h++)
+            for (int w = 0; w < 5; w++)
+                for (int c = 0; c < 3; c++) {
+                    const float xv = 1 + n * 60 + c * 20 + h * 5 + w;
+                    const float yv = 1 + n * 60 + h * 15 + w * 3 + c;
+                    e.p(n, h, w, c, xv * yv);
+                    es.p(n, h, w, c, xv * 2.f);
+                }
+
+    ASSERT_EQ(e, z);
+    ASSERT_EQ(es, s);
+}
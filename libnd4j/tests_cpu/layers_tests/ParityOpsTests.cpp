@@ -1696,3 +1696,87 @@ TEST_F(ParityOpsTests, scatter_update_4) {
 
 
 }
+
+////////////////////////////////////////////////////////////////////////
+TEST_F(ParityOpsTests, scatter_add_lock_1) {
+    // lots of repeated indices with lock enabled
+    const int numOfUpdates = 1000;
+    auto input = NDArrayFactory::create<float>('c', {10, 4});
+    NDArray indices('c', {numOfUpdates}, sd::DataType::INT32);
+    auto updates = NDArrayFactory::create<float>('c', {numOfUpdates, 4});
+    auto exp = NDArrayFactory::create<float>('c', {10, 4});
+
+    for (int i = 0; i < numOfUpdates; i++) {
+        const int idx = (i * 7) % 10;
+        indices.p(i, idx);
+        for (int j = 0; j < 4; j++) {
+            updates.p(i, j, i + j);
+            exp.p(idx, j, exp.e<float>(idx, j) + i + j);
+        }
+    }
+
+    sd::ops::scatter_add op;
+    auto result = op.evaluate({&input, &indices, &updates}, {}, {}, {true});
+    ASSERT_EQ(ND4J_STATUS_OK, result.status());
+
+    auto z = result.at(0);
+
+    ASSERT_TRUE(exp.isSameShape(z));
+    ASSERT_TRUE(exp.equalsTo(z));
+}
+
+////////////////////////////////////////////////////////////////////////
+TEST_F(ParityOpsTests, scatter_upd_lock_1) {
+    // repeated indices must keep order of updates: last one wins
+    const int numOfUpdates = 500;
+    auto input = NDArrayFactory::create<float>('c', {7, 3});
+    NDArray indices('c', {numOfUpdates}, sd::DataType::INT64);
+    auto updates = NDArrayFactory::create<float>('c', {numOfUpdates, 3});
+    auto exp = NDArrayFactory::create<float>('c', {7, 3});
+
+    for (int i = 0; i < numOfUpdates; i++) {
+        const int idx = (i * 5) % 7;
+        indices.p(i, idx);
+        for (int j = 0; j < 3; j++) {
+            updates.p(i, j, i * 3 + j);
+            exp.p(idx, j, i * 3 + j);
+        }
+    }
+
+    sd::ops::scatter_upd op;
+    auto result = op.evaluate({&input, &indices, &updates}, {}, {}, {true});
+    ASSERT_EQ(ND4J_STATUS_OK, result.status());
+
+    auto z = result.at(0);
+
+    ASSERT_TRUE(exp.isSameShape(z));
+    ASSERT_TRUE(exp.equalsTo(z));
+}
+
+////////////////////////////////////////////////////////////////////////
+TEST_F(ParityOpsTests, scatterND_add_lock_1) {
+    const int numOfUpdates = 600;
+    auto input = NDArrayFactory::create<float>('c', {5, 6, 3});
+    NDArray indices('c', {numOfUpdates, 2}, sd::DataType::INT32);
+    auto updates = NDArrayFactory::create<float>('c', {numOfUpdates, 3});
+    auto exp = NDArrayFactory::create<float>('c', {5, 6, 3});
+
+    for (int i = 0; i < numOfUpdates; i++) {
+        const int a = (i * 3) % 5, b = (i * 11) % 6;
+        indices.p(i, 0, a);
+        indices.p(i, 1, b);
+        for (int j = 0; j < 3; j++) {
+            updates.p(i, j, i - j);
+            exp.p(a, b, j, exp.e<float>(a, b, j) + i - j);
+        }
+    }
+
+    sd::ops::scatter_nd_add op;
+    auto result = op.evaluate({&input, &indices, &updates}, {}, {}, {true});
+    ASSERT_EQ(ND4J_STATUS_OK, result.status());
+
+    auto z = result.at(0);
+
+    ASSERT_TRUE(exp.isSameShape(z));
+    ASSERT_TRUE(exp.equalsTo(z));
+}
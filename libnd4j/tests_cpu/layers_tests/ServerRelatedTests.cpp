@@ -22,6 +22,9 @@
 #include <graph/GraphExecutioner.h>
 #include <graph/GraphHolder.h>
 #include <graph/InferenceRequest.h>
+#include <graph/GraphBatcher.h>
+#include <atomic>
+#include <thread>
 
 using namespace sd;
 using namespace sd::graph;
@@ -186,3 +189,78 @@ TEST_F(ServerRelatedTests, BasicExecutionTests_3) {
     GraphHolder::getInstance().dropGraphAny(11903L);
 }
 #endif
+
+TEST_F(ServerRelatedTests, Batcher_Test_1) {
+    auto graph = new Graph();
+    auto x = NDArrayFactory::create_<float>('c', {1, 3});
+    graph->getVariableSpace()->putVariable(-1, x);
+
+    graph->addNode(new Node(OpType_TRANSFORM_SAME, transform::Abs, 1, {-1}, {}));
+    graph->addNode(new Node(OpType_TRANSFORM_SAME, transform::Neg, 2, {1}, {}));
+
+    GraphHolder::getInstance().registerGraph(11904L, graph);
+
+    // delay is long enough for all requests to meet within single batch
+    GraphBatcher batcher(4, 5000000L);
+
+    std::vector<std::vector<Variable*>> results(4);
+    std::vector<std::thread> threads;
+    for (int e = 0; e < 4; e++) {
+        threads.emplace_back([&, e] {
+            auto input = NDArrayFactory::create_<float>('c', {1, 3});
+            input->assign((float) e + 1);
+
+            results[e] = batcher.execute(11904L, {new Variable(input, nullptr, -1, 0)});
+        });
+    }
+
+    for (auto &t: threads)
+        t.join();
+
+    for (int e = 0; e < 4; e++) {
+        ASSERT_EQ(1, results[e].size());
+
+        auto exp = NDArrayFactory::create<float>('c', {1, 3});
+        exp.assign((float) -(e + 1));
+        ASSERT_EQ(exp, *results[e][0]->getNDArray());
+
+        delete results[e][0];
+    }
+
+    auto batchSizes = batcher.batchSizeHistogram();
+    ASSERT_EQ(1, batchSizes[4]);
+
+    Nd4jLong queued = 0;
+    for (auto v: batcher.queueTimeHistogram())
+        queued += v;
+
+    ASSERT_EQ(4, queued);
+
+    GraphHolder::getInstance().dropGraphAny(11904L);
+}
+
+TEST_F(ServerRelatedTests, Batcher_Test_2) {
+    // graph isn't registered: batch execution fails, and every queued request gets the error instead of waiting forever
+    GraphBatcher batcher(4, 5000000L);
+
+    std::atomic<int> failed(0);
+    std::vector<std::thread> threads;
+    for (int e = 0; e < 4; e++) {
+        threads.emplace_back([&, e] {
+            auto input = NDArrayFactory::create_<float>('c', {1, 3});
+            input->assign((float) e + 1);
+
+            try {
+                batcher.execute(11905L, {new Variable(input, nullptr, -1, 0)});
+            } catch (std::exception &) {
+                failed++;
+            }
+        });
+    }
+
+    for (auto &t: threads)
+        t.join();
+
+    ASSERT_EQ(4, failed.load());
+    ASSERT_EQ(1, batcher.batchSizeHistogram()[4]);
+}
@@ -24,6 +24,9 @@
 #include <execution/Threads.h>
 #include <chrono>
 #include <execution/ThreadPool.h>
+#include <execution/WorkStealingPool.h>
+#include <execution/NumaTopology.h>
+#include <execution/AffinityManager.h>
 
 using namespace samediff;
 using namespace sd;
@@ -208,6 +211,126 @@ TEST_F(ThreadsTests, reduction_test_1) {
     ASSERT_EQ(8192, sum);
 }
 
+TEST_F(ThreadsTests, nested_test_1) {
+    std::atomic<int64_t> cnt(0);
+
+    auto outer = PRAGMA_THREADS_FOR {
+        for (auto e = start; e < stop; e++) {
+            auto inner = PRAGMA_THREADS_FOR {
+                cnt += stop - start;
+            };
+
+            samediff::Threads::parallel_for(inner, 0, 4096, 1, 4);
+        }
+    };
+
+    samediff::Threads::parallel_tad(outer, 0, 16, 1, 8);
+    ASSERT_EQ(16 * 4096, cnt.load());
+}
+
+TEST_F(ThreadsTests, concurrent_callers_test_1) {
+    std::vector<std::thread> threads(4);
+    std::atomic<int> failures(0);
+
+    for (auto &t: threads)
+        t = std::thread([&] {
+            for (int r = 0; r < 20; r++) {
+                std::vector<int> buffer(65536, 0);
+                auto func = PRAGMA_THREADS_FOR {
+                    for (auto e = start; e < stop; e++)
+                        buffer[e]++;
+                };
+
+                samediff::Threads::parallel_for(func, 0, buffer.size());
+
+                for (auto v: buffer)
+                    if (v != 1)
+                        failures++;
+            }
+        });
+
+    for (auto &t: threads)
+        t.join();
+
+    ASSERT_EQ(0, failures.load());
+}
+
+TEST_F(ThreadsTests, exception_test_1) {
+    auto func = PRAGMA_THREADS_FOR {
+        if (thread_id == 0)
+            throw std::runtime_error("expected failure");
+    };
+
+    ASSERT_ANY_THROW(samediff::Threads::parallel_tad(func, 0, 8, 1, 4));
+}
+
+TEST_F(ThreadsTests, numa_cpulist_test_1) {
+    std::vector<int> cpus;
+    ASSERT_TRUE(NumaTopology::parseCpuList("0-3,8,10-11\n", cpus));
+
+    std::vector<int> exp = {0, 1, 2, 3, 8, 10, 11};
+    ASSERT_EQ(exp, cpus);
+
+    std::vector<int> bad;
+    ASSERT_FALSE(NumaTopology::parseCpuList("3-1", bad));
+    ASSERT_FALSE(NumaTopology::parseCpuList("a-b", bad));
+}
+
+TEST_F(ThreadsTests, numa_topology_test_1) {
+    auto &topology = NumaTopology::getInstance();
+    ASSERT_TRUE(topology.numberOfNodes() >= 1);
+
+    // every CPU maps back to the node it's listed in
+    for (int n = 0; n < topology.numberOfNodes(); n++)
+        for (auto cpu: topology.cpusOfNode(n))
+            ASSERT_EQ(n, topology.nodeOfCpu(cpu));
+
+    auto &pool = WorkStealingPool::getInstance();
+    int total = 0;
+    for (int n = 0; n < pool.numberOfNodes(); n++)
+        total += pool.numberOfWorkers(n);
+
+    ASSERT_EQ(pool.numberOfWorkers(), total);
+}
+
+TEST_F(ThreadsTests, numa_node_assignment_test_1) {
+    auto previous = AffinityManager::setCurrentNumaNode(0);
+    ASSERT_EQ(0, AffinityManager::currentNumaNode());
+
+    ASSERT_EQ(0, AffinityManager::setCurrentNumaNode(previous));
+    ASSERT_ANY_THROW(AffinityManager::setCurrentNumaNode(NumaTopology::getInstance().numberOfNodes()));
+}
+
+TEST_F(ThreadsTests, threads_limit_test_1) {
+    ASSERT_EQ(0, ThreadsLimit::current());
+
+    {
+        ThreadsLimit outer(2);
+        ASSERT_EQ(2, ThreadsLimit::current());
+
+        std::atomic<int> maxThread(0);
+        auto func = PRAGMA_THREADS_FOR {
+            int t = (int) thread_id;
+            int prev = maxThread.load();
+            while (t > prev && !maxThread.compare_exchange_weak(prev, t));
+        };
+
+        auto numThreads = samediff::Threads::parallel_for(func, 0, 1024 * 1024, 1, 8);
+        ASSERT_TRUE(numThreads <= 2);
+        ASSERT_TRUE(maxThread.load() < 2);
+
+        {
+            // nested limit can't extend outer one
+            ThreadsLimit inner(4);
+            ASSERT_EQ(2, ThreadsLimit::current());
+        }
+
+        ASSERT_EQ(2, ThreadsLimit::current());
+    }
+
+    ASSERT_EQ(0, ThreadsLimit::current());
+}
+
 static void _code(int thread_id) {
   auto x = NDArrayFactory::create<float>('c', {65536 * 16});
   x.assign(1.1f);
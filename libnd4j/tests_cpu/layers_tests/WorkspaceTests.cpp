@@ -26,6 +26,7 @@
 #include <memory/Workspace.h>
 #include <memory/MemoryRegistrator.h>
 #include <helpers/MmulHelper.h>
+#include <execution/Threads.h>
 
 using namespace sd;
 using namespace sd::memory;
@@ -146,6 +147,116 @@ TEST_F(WorkspaceTests, StretchTest1) {
     ASSERT_EQ(0, workspace.getSpilledSize());
 }
 
+TEST_F(WorkspaceTests, ChunkedTest1) {
+    if (!Environment::getInstance().isCPU())
+        return;
+
+    Workspace workspace(1024);
+    workspace.setChunked(true);
+    ASSERT_TRUE(workspace.isChunked());
+
+    workspace.scopeIn();
+    for (int e = 0; e < 10; e++) {
+        auto ptr = workspace.allocateBytes(1000);
+        ASSERT_EQ(0, reinterpret_cast<uintptr_t>(ptr) % 64);
+    }
+
+    // overflow goes to chained chunks, not to spills
+    ASSERT_TRUE(workspace.getSpilledSize() > 0);
+    ASSERT_TRUE(workspace.getCurrentOffset() >= 10000);
+    workspace.scopeOut();
+
+    // chunks are consolidated into single primary buffer
+    ASSERT_EQ(0, workspace.getSpilledSize());
+    ASSERT_EQ(0, workspace.getCurrentOffset());
+    ASSERT_TRUE(workspace.getCurrentSize() >= 10000);
+
+    workspace.scopeIn();
+    for (int e = 0; e < 10; e++)
+        workspace.allocateBytes(1000);
+
+    ASSERT_EQ(0, workspace.getSpilledSize());
+    workspace.scopeOut();
+}
+
+TEST_F(WorkspaceTests, ChunkedTest2) {
+    if (!Environment::getInstance().isCPU())
+        return;
+
+    Workspace workspace(1024);
+    workspace.allocateBytes(8);
+
+    // mode can't be switched once workspace holds allocations
+    ASSERT_ANY_THROW(workspace.setChunked(true));
+}
+
+TEST_F(WorkspaceTests, ChunkedTest3) {
+    if (!Environment::getInstance().isCPU())
+        return;
+
+    Workspace workspace(1024);
+    workspace.setChunked(true);
+
+    // primary chunk must follow reallocated buffer
+    workspace.expandTo(65536);
+    ASSERT_EQ(65536, workspace.getCurrentSize());
+
+    auto ptr = reinterpret_cast<char*>(workspace.allocateBytes(32768));
+    memset(ptr, 1, 32768);
+
+    // whole allocation fits into expanded primary buffer, so nothing was chained
+    ASSERT_EQ(0, workspace.getSpilledSize());
+    ASSERT_EQ(32768, workspace.getCurrentOffset());
+
+    // live allocations would be invalidated by reallocation
+    ASSERT_ANY_THROW(workspace.expandBy(65536));
+
+    workspace.scopeOut();
+    workspace.expandBy(65536);
+    ASSERT_EQ(131072, workspace.getCurrentSize());
+
+    ptr = reinterpret_cast<char*>(workspace.allocateBytes(100000));
+    memset(ptr, 2, 100000);
+    ASSERT_EQ(0, workspace.getSpilledSize());
+}
+
+TEST_F(WorkspaceTests, ThreadLocalTest1) {
+    if (!Environment::getInstance().isCPU())
+        return;
+
+    Workspace workspace(1024);
+    workspace.setThreadLocal(true, 4096);
+    ASSERT_TRUE(workspace.isThreadLocal());
+
+    for (int cycle = 0; cycle < 3; cycle++) {
+        workspace.scopeIn();
+
+        std::vector<int*> pointers(256);
+        auto func = PRAGMA_THREADS_FOR {
+            for (auto e = start; e < stop; e++) {
+                auto ptr = reinterpret_cast<int*>(workspace.allocateBytes(e % 2 == 0 ? 40 : 2000));
+                ptr[0] = e;
+                pointers[e] = ptr;
+            }
+        };
+        samediff::Threads::parallel_for(func, 0, 256);
+
+        // slab allocations are aligned and never overlap
+        for (int e = 0; e < 256; e++) {
+            ASSERT_EQ(e, pointers[e][0]);
+
+            if (e % 2 == 0)
+                ASSERT_EQ(0, reinterpret_cast<uintptr_t>(pointers[e]) % 64);
+        }
+
+        workspace.scopeOut();
+        ASSERT_EQ(0, workspace.getCurrentOffset());
+    }
+
+    // slabs of the first cycle were spilled, so workspace was resized for the next ones
+    ASSERT_TRUE(workspace.getCurrentSize() > 1024);
+}
+
 TEST_F(WorkspaceTests, NewInWorkspaceTest1) {
     if (!Environment::getInstance().isCPU())
         return;
@@ -1169,6 +1169,22 @@ public interface NativeOps {
 
     long getCachedMemory(int deviceId);
 
+    long getShapeCacheEntries();
+
+    long getShapeCacheHits();
+
+    long getShapeCacheMisses();
+
+    long getTadCacheMemory();
+
+    long getTadCacheHits();
+
+    long getTadCacheMisses();
+
+    long getTadCacheEvictions();
+
+    void setTadCacheLimit(long bytes);
+
     OpaqueLaunchContext defaultLaunchContext();
 
     Pointer lcScalarPointer(OpaqueLaunchContext lc);